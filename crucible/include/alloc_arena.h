@@ -0,0 +1,75 @@
+/**
+ * Bump Arena Allocator Header
+ *
+ * This header file declares a minimal bump-pointer arena. Allocation is a
+ * pointer increment; individual objects are never freed, the whole arena
+ * is reset at once. It is the baseline for request-scoped allocation in
+ * the allocator benchmark.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef ALLOC_ARENA_H
+#define ALLOC_ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "mem_buffer.h"
+
+/**
+ * Arena:
+ * One contiguous region handed out front to back.
+ */
+typedef struct
+{
+    MemBuffer buffer; /* Backing mapping */
+    char *base;       /* Start of the region */
+    size_t size;      /* Capacity in bytes */
+    size_t used;      /* Bytes handed out since the last reset */
+} Arena;
+
+/**
+ * Create an arena
+ *
+ * Parameters:
+ *   arena - Arena to initialise
+ *   size  - Capacity in bytes
+ *
+ * Returns:
+ *   true if successful, false if the region could not be mapped
+ */
+bool arena_init(Arena *arena, size_t size);
+
+/**
+ * Allocate from an arena
+ *
+ * Returns 16-byte aligned memory.
+ *
+ * Parameters:
+ *   arena - Arena to allocate from
+ *   size  - Number of bytes
+ *
+ * Returns:
+ *   Pointer to the memory, or NULL if the arena is exhausted
+ */
+void *arena_alloc(Arena *arena, size_t size);
+
+/**
+ * Release everything allocated from an arena
+ *
+ * Parameters:
+ *   arena - Arena to reset
+ */
+void arena_reset(Arena *arena);
+
+/**
+ * Destroy an arena
+ *
+ * Parameters:
+ *   arena - Arena previously initialised by arena_init()
+ */
+void arena_destroy(Arena *arena);
+
+#endif /* ALLOC_ARENA_H */
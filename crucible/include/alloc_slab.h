@@ -0,0 +1,76 @@
+/**
+ * Slab Allocator Header
+ *
+ * This header file declares a per-thread slab allocator with power-of-two
+ * size classes. Each thread owns a cache; objects freed by another thread
+ * are handed back to the owning cache through a lock-free list, so
+ * producer-consumer patterns work without locks on the fast path.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef ALLOC_SLAB_H
+#define ALLOC_SLAB_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Largest size served from slabs; bigger requests go to malloc() */
+#define SLAB_MAX_OBJECT 16384
+
+/* Opaque per-thread cache */
+typedef struct SlabCache SlabCache;
+
+/**
+ * Create a cache for the calling thread
+ *
+ * Returns:
+ *   New cache, or NULL if memory could not be allocated
+ */
+SlabCache *slab_cache_create(void);
+
+/**
+ * Allocate an object
+ *
+ * Parameters:
+ *   cache - The calling thread's cache
+ *   size  - Number of bytes
+ *
+ * Returns:
+ *   Pointer to at least size bytes, 16-byte aligned, or NULL on failure
+ */
+void *slab_alloc(SlabCache *cache, size_t size);
+
+/**
+ * Free an object
+ *
+ * The object may have been allocated by any thread's cache.
+ *
+ * Parameters:
+ *   cache - The calling thread's cache
+ *   ptr   - Object to free
+ *   size  - Size passed to slab_alloc()
+ */
+void slab_free(SlabCache *cache, void *ptr, size_t size);
+
+/**
+ * Report the memory mapped by a cache
+ *
+ * Returns:
+ *   Bytes of slab memory the cache has mapped
+ */
+size_t slab_cache_footprint(const SlabCache *cache);
+
+/**
+ * Destroy a cache
+ *
+ * Unmaps all of its slabs. Only call this once no thread can still free
+ * objects that belong to the cache.
+ *
+ * Parameters:
+ *   cache - Cache to destroy
+ */
+void slab_cache_destroy(SlabCache *cache);
+
+#endif /* ALLOC_SLAB_H */
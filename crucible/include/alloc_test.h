@@ -0,0 +1,46 @@
+/**
+ * Allocator Benchmark Header
+ *
+ * This header file declares the multi-threaded allocation benchmark. It
+ * compares the system malloc with the in-tree bump arena and per-thread
+ * slab allocator under fixed sizes, a size distribution, producer-consumer
+ * cross-thread frees and long-lived fragmentation churn.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef ALLOC_TEST_H
+#define ALLOC_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the allocator benchmark
+ *
+ * Options:
+ *   a:  allocation size for the fixed scenario (default 64), or the path
+ *       of a size histogram file with one "size weight" pair per line
+ *       (sizes accept k/m suffixes, '#' starts a comment). The histogram
+ *       drives the other scenarios and its most common size the fixed one.
+ *   th: worker threads, default one per online CPU; the producer-consumer
+ *       scenario pairs them up
+ *   sz: live data held across all threads in the churn scenario,
+ *       default 256 MB
+ *
+ * Every allocator and scenario pair reports ops/sec and allocation and
+ * free latency percentiles (mem_alloc). RSS and live bytes are sampled
+ * during each run (mem_alloc_rss). The arena only runs the scenarios that
+ * free in batches, since it cannot release individual objects.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if every run completed, false on setup or allocation errors
+ */
+bool alloc_test_run(const ComponentConfig *comp);
+
+#endif /* ALLOC_TEST_H */
@@ -0,0 +1,41 @@
+/**
+ * Memory Bandwidth Test Header
+ *
+ * This header file declares the STREAM-style memory bandwidth engine. It
+ * reports sustained bandwidth for copy, scale, add, triad, read-only and
+ * write-only kernels in scalar, AVX2 and AVX-512 form, each with regular
+ * and non-temporal stores, across a range of thread counts.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef BANDWIDTH_TEST_H
+#define BANDWIDTH_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the bandwidth engine
+ *
+ * The sz: option is the total size of the three working arrays (default
+ * 512 MB, capped at half of available memory) and al: their start
+ * alignment. Each kernel variant runs with 1, 2, 4, ... threads up to the
+ * online CPU count; the best and average of five timed repetitions are
+ * reported in GB/s (10^9 bytes, STREAM byte counting). With numa:true
+ * every thread sets a preferred policy for its own node before it
+ * first-touches its slice. hp: selects the page backing; with hp:all the
+ * whole suite runs once per page type and each type is compared with 4k.
+ * dTLB misses per KB are reported when perf counters are available.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if every variant ran, false on setup errors
+ */
+bool bandwidth_test_run(const ComponentConfig *comp);
+
+#endif /* BANDWIDTH_TEST_H */
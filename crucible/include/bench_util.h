@@ -0,0 +1,101 @@
+/**
+ * Benchmark Utilities Header
+ *
+ * This header file declares small helpers shared by the test modules:
+ * monotonic timing, CPU pinning, size-string parsing and latency
+ * summaries computed from raw samples.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef BENCH_UTIL_H
+#define BENCH_UTIL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Latency Summary:
+ * Order statistics computed from a set of latency samples (nanoseconds).
+ */
+typedef struct
+{
+    uint64_t count; /* Number of samples */
+    uint64_t min;   /* Smallest sample */
+    uint64_t p50;   /* Median */
+    uint64_t p90;   /* 90th percentile */
+    uint64_t p99;   /* 99th percentile */
+    uint64_t p999;  /* 99.9th percentile */
+    uint64_t p9999; /* 99.99th percentile */
+    uint64_t max;   /* Largest sample */
+    double mean;    /* Arithmetic mean */
+} LatencySummary;
+
+/**
+ * Read the monotonic clock
+ *
+ * Returns:
+ *   Current CLOCK_MONOTONIC time in nanoseconds
+ */
+uint64_t bench_now_ns(void);
+
+/**
+ * Pin the calling thread to a single CPU
+ *
+ * Parameters:
+ *   cpu - Logical CPU number to run on
+ *
+ * Returns:
+ *   true if the affinity was applied, false otherwise
+ */
+bool bench_pin_cpu(int cpu);
+
+/**
+ * Parse a human-readable size string
+ *
+ * Accepts a decimal number with an optional k/m/g/t suffix (powers of
+ * 1024, case-insensitive, optionally followed by 'b'), e.g. "4k" or "2g".
+ *
+ * Parameters:
+ *   str   - String to parse
+ *   bytes - Pointer to store the parsed size in bytes
+ *
+ * Returns:
+ *   true if successful, false if the string is empty or malformed
+ */
+bool bench_parse_size(const char *str, size_t *bytes);
+
+/**
+ * Read a /proc/meminfo field
+ *
+ * Parameters:
+ *   field - Field name without the colon, e.g. "MemTotal" or "SwapFree"
+ *
+ * Returns:
+ *   Value in bytes, or 0 if the field or the file cannot be read
+ */
+size_t bench_meminfo(const char *field);
+
+/**
+ * Read the kernel's estimate of available memory
+ *
+ * Returns:
+ *   MemAvailable from /proc/meminfo in bytes, or 0 if it cannot be read
+ */
+size_t bench_mem_available(void);
+
+/**
+ * Summarize latency samples
+ *
+ * Sorts the sample array in place and fills in the order statistics.
+ *
+ * Parameters:
+ *   samples - Array of latency samples in nanoseconds (reordered)
+ *   count   - Number of samples
+ *   summary - Pointer to the summary to fill in
+ */
+void bench_summarize(uint64_t *samples, size_t count, LatencySummary *summary);
+
+#endif /* BENCH_UTIL_H */
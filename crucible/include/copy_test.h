@@ -0,0 +1,48 @@
+/**
+ * Memory Copy Test Header
+ *
+ * This header file declares the memcpy/memset shoot-out. It times glibc
+ * memcpy and memset against rep movsb/stosb and explicit AVX2 and AVX-512
+ * loops, with and without non-temporal stores, over a sweep of sizes and
+ * source/destination misalignments. The point where one method overtakes
+ * another moves between CPU generations, so the test also reports the
+ * fastest method for every size range.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef COPY_TEST_H
+#define COPY_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the memory copy test
+ *
+ * Options:
+ *   sz: largest size in the sweep, default 1 GB; sizes run from 8 bytes
+ *       in steps of 1x and 1.5x powers of two
+ *   p:  comma-separated methods out of libc, rep, avx2, avx2nt, avx512
+ *       and avx512nt, or "all" (default); methods the CPU lacks are skipped
+ *   al: misalignment in bytes applied to the source, the destination and
+ *       both; by default 1 and 32 are swept next to the aligned case
+ *   hp: page backing for the buffers (one type per run)
+ *
+ * Every measurement reports GB/s and cycles per byte (mem_copy); core
+ * cycles come from perf when the kernel allows it, otherwise from the
+ * TSC. For each operation and alignment the fastest method per size
+ * range is logged as mem_copy_crossover.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if every method produced correct results, false on setup errors
+ *   or a miscompare
+ */
+bool copy_test_run(const ComponentConfig *comp);
+
+#endif /* COPY_TEST_H */
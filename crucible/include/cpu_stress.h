@@ -0,0 +1,132 @@
+/**
+ * CPU Stress Generator Header
+ *
+ * This header file defines a load generator that keeps a set of CPUs busy
+ * with pinned worker threads. Every workload kernel is deterministic: the
+ * same seed always produces the same 64-bit result, so workers can verify
+ * each iteration against a reference table to catch silent data corruption.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef CPU_STRESS_H
+#define CPU_STRESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <pthread.h>
+
+/**
+ * CPU Workloads:
+ * Kernels a stress worker can run.
+ */
+typedef enum
+{
+    CPU_WORK_INT,   /* 64-bit integer hash chain */
+    CPU_WORK_FP,    /* Double-precision matrix product checksum */
+    CPU_WORK_FFT,   /* Complex FFT forward/inverse round trip */
+    CPU_WORK_SIMD,  /* Vectorized integer lanes (AVX2 when available) */
+    CPU_WORK_MEM,   /* Dependent random loads over a table larger than cache */
+    CPU_WORK_BRANCH, /* Data-dependent, hard to predict branches */
+    CPU_WORK_MIX,   /* Rotate through all of the above */
+    CPU_WORK_INVALID
+} CpuWorkload;
+
+/**
+ * Stress Worker:
+ * State of one pinned load thread.
+ */
+typedef struct
+{
+    pthread_t thread;         /* Worker thread handle */
+    int cpu;                  /* CPU the worker is pinned to */
+    CpuWorkload workload;     /* Kernel to run */
+    bool verify;              /* Compare every result with the reference table */
+    const volatile int *stop; /* Points at the owning CpuStress stop flag */
+    void *scratch;            /* Per-worker kernel buffers */
+    uint64_t iterations;      /* Kernel iterations completed */
+    uint64_t mismatches;      /* Verification failures seen */
+} CpuStressWorker;
+
+/**
+ * Stress Generator:
+ * A group of workers started and stopped together.
+ */
+typedef struct
+{
+    CpuStressWorker *workers; /* One entry per worker thread */
+    int count;                /* Number of running workers */
+    volatile int stop;        /* Set to ask workers to exit */
+} CpuStress;
+
+/**
+ * Parse a workload name
+ *
+ * Accepts "int", "fp", "fft", "avx" (or "simd"), "mem", "branch" and "mix".
+ *
+ * Returns:
+ *   Workload enum value, or CPU_WORK_INVALID if the name is unknown
+ */
+CpuWorkload cpu_stress_parse_workload(const char *name);
+
+/**
+ * Convert a workload to its name
+ *
+ * Returns:
+ *   Constant string representation (do not free this memory)
+ */
+const char *cpu_stress_workload_name(CpuWorkload workload);
+
+/**
+ * Start loading a set of CPUs
+ *
+ * When verify is set, the reference results are computed on the calling
+ * thread before any worker starts.
+ *
+ * Parameters:
+ *   stress   - Generator state to initialize
+ *   cpus     - CPUs to load, one worker thread per entry
+ *   count    - Number of entries in cpus
+ *   workload - Kernel every worker runs
+ *   verify   - Check each iteration's result against the reference
+ *
+ * Returns:
+ *   true if every worker started, false otherwise (nothing is left running)
+ */
+bool cpu_stress_start(CpuStress *stress, const int *cpus, int count,
+                      CpuWorkload workload, bool verify);
+
+/**
+ * Total iterations completed so far
+ *
+ * Safe to call while the workers are running.
+ *
+ * Returns:
+ *   Sum of all workers' iteration counters
+ */
+uint64_t cpu_stress_iterations(const CpuStress *stress);
+
+/**
+ * Stop a running generator
+ *
+ * Signals every worker and waits for them to exit. Worker counters stay
+ * readable until cpu_stress_free() is called.
+ *
+ * Parameters:
+ *   stress - Generator previously started with cpu_stress_start()
+ *
+ * Returns:
+ *   Total kernel iterations completed by all workers
+ */
+uint64_t cpu_stress_stop(CpuStress *stress);
+
+/**
+ * Release a stopped generator
+ *
+ * Parameters:
+ *   stress - Generator previously stopped with cpu_stress_stop()
+ */
+void cpu_stress_free(CpuStress *stress);
+
+#endif /* CPU_STRESS_H */
@@ -1 +1,40 @@
-# CPU test declarations
+/**
+ * CPU Test Header
+ *
+ * This header file declares the entry point for CPU component tests. The
+ * specific test is chosen with the w: suboption of the component
+ * (e.g. *1c[t:baseline-d60-{w:ipc}]).
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef CPU_TEST_H
+#define CPU_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run a CPU component test
+ *
+ * Dispatches on CPUOptions.workload_type. Supported workloads:
+ *   int, fp, fft, avx, mem, branch, mix
+ *           - Stress workloads on the cr: cores (default: all online CPUs)
+ *             with th: threads per core; v:true verifies every iteration
+ *             and fails the run on a mismatch
+ *   ipc     - IPC/context-switch ping-pong latency suite
+ *   syscall - System call and vDSO overhead, idle and under load
+ *   spawn   - Thread and process creation rate
+ *   smt     - SMT sibling interference matrix
+ *
+ * Parameters:
+ *   comp - Component configuration (component_type 'c')
+ *
+ * Returns:
+ *   true if the test ran and passed, false otherwise
+ */
+bool cpu_test_run(const ComponentConfig *comp);
+
+#endif /* CPU_TEST_H */
@@ -0,0 +1,43 @@
+/**
+ * CRC32C Header
+ *
+ * This header file declares the CRC32C (Castagnoli) checksum used to
+ * verify storage blocks. The implementation is picked once at first use:
+ * the SSE4.2 crc32 instruction on x86-64, the ARMv8 CRC extension on
+ * AArch64, and a slice-by-8 table implementation everywhere else.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Checksum a buffer
+ *
+ * The usual pre- and post-inversion are applied, so a running checksum
+ * can be continued by passing the previous result back in as crc.
+ *
+ * Parameters:
+ *   crc  - 0 to start a checksum, or the result of the previous call
+ *   data - Bytes to checksum
+ *   len  - Number of bytes
+ *
+ * Returns:
+ *   The CRC32C of everything checksummed so far
+ */
+uint32_t crc32c(uint32_t crc, const void *data, size_t len);
+
+/**
+ * Name the implementation in use
+ *
+ * Returns:
+ *   "sse4.2", "armv8" or "slice8"
+ */
+const char *crc32c_impl(void);
+
+#endif /* CRC32C_H */
@@ -0,0 +1,44 @@
+/**
+ * Page Fault Test Header
+ *
+ * This header file declares the page fault and first-touch cost test. It
+ * times the ways a process gets anonymous memory backed: first touch,
+ * MAP_POPULATE, mlock(), refaulting after MADV_DONTNEED and reuse after
+ * MADV_FREE. Each method runs on one thread and then on several threads
+ * of one address space at once, where mmap_lock contention shows up.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef FAULT_TEST_H
+#define FAULT_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the page fault test
+ *
+ * Options:
+ *   sz: region mapped by each thread per iteration, default 256 MB
+ *   p:  comma-separated methods out of touch, populate, mlock, dontneed
+ *       and free, or "all" (default)
+ *   th: threads for the concurrent pass, default one per online CPU
+ *   hp: page backing, "4k", "thp" or both via "all"; hugetlbfs types are
+ *       skipped since they are reserved rather than faulted from the
+ *       page allocator
+ *
+ * Every method reports pages and faults per second and nanoseconds per
+ * 4 KB page and per counted fault (mem_fault).
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if every method ran, false on setup or mapping errors
+ */
+bool fault_test_run(const ComponentConfig *comp);
+
+#endif /* FAULT_TEST_H */
@@ -0,0 +1,142 @@
+/**
+ * Latency Histogram Header
+ *
+ * This header file declares a log-linear latency histogram in the style of
+ * HdrHistogram. Values are nanoseconds. Below 256 ns every value has its
+ * own bucket; above that each power of two is split into 128 linear
+ * buckets, so any recorded value is known to within 1/128 (under 0.8%).
+ * The range runs to 2^37 ns (about 137 s), which covers 100 ns to 100 s;
+ * larger values are clamped into the top bucket. Recording is a few
+ * instructions and never allocates.
+ *
+ * A histogram that one thread records into can be read by another while
+ * it is being written: the reader keeps a copy of the counts it has
+ * already seen and takes the difference, so per-thread histograms are
+ * merged each interval without locks.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bench_util.h"
+
+/* Define constants */
+#define HIST_SUB_BITS 8                    /* Linear buckets per power of two: 2^(HIST_SUB_BITS - 1) */
+#define HIST_MAX_BITS 37                   /* Values up to 2^37 - 1 ns */
+#define HIST_BUCKETS ((1 << HIST_SUB_BITS) + (HIST_MAX_BITS - HIST_SUB_BITS) * (1 << (HIST_SUB_BITS - 1)))
+
+/**
+ * Histogram:
+ * Bucket counts plus the exact count, sum, minimum and maximum.
+ */
+typedef struct
+{
+    uint64_t count;                 /* Values recorded */
+    uint64_t sum;                   /* Sum of the values, for the mean */
+    uint64_t min;                   /* Smallest value, UINT64_MAX when empty */
+    uint64_t max;                   /* Largest value, 0 when empty */
+    uint64_t counts[HIST_BUCKETS];
+} Histogram;
+
+/**
+ * Reset a histogram to empty
+ *
+ * Parameters:
+ *   hist - Histogram to reset
+ */
+void hist_init(Histogram *hist);
+
+/**
+ * Record one value
+ *
+ * Only one thread may record into a histogram, but another thread may
+ * read it concurrently with hist_collect().
+ *
+ * Parameters:
+ *   hist  - Histogram to record into
+ *   value - Latency in nanoseconds
+ */
+void hist_record(Histogram *hist, uint64_t value);
+
+/**
+ * Take what a live histogram recorded since the last collection
+ *
+ * The live histogram's counts only ever grow. The difference against
+ * seen, which the caller owns, is stored in interval and seen is brought
+ * up to date; min and max are swapped out of the live histogram. A value
+ * recorded while this runs lands in this interval or the next.
+ *
+ * Parameters:
+ *   live     - Histogram another thread records into
+ *   seen     - Counts already collected, initialised with hist_init()
+ *   interval - Filled with the values recorded since the last call
+ */
+void hist_collect(Histogram *live, Histogram *seen, Histogram *interval);
+
+/**
+ * Add one histogram into another
+ *
+ * Parameters:
+ *   dest - Histogram to add to
+ *   src  - Histogram to add
+ */
+void hist_merge(Histogram *dest, const Histogram *src);
+
+/**
+ * Look up a percentile
+ *
+ * Parameters:
+ *   hist - Histogram to query
+ *   pct  - Percentile, 0-100
+ *
+ * Returns:
+ *   Highest value equivalent to the percentile's bucket, capped at the
+ *   recorded maximum, or 0 if the histogram is empty
+ */
+uint64_t hist_percentile(const Histogram *hist, double pct);
+
+/**
+ * Summarize a histogram
+ *
+ * Parameters:
+ *   hist    - Histogram to summarize
+ *   summary - Filled with the count, mean, min, max and percentiles
+ */
+void hist_summarize(const Histogram *hist, LatencySummary *summary);
+
+/**
+ * Save a histogram into the log directory
+ *
+ * Writes <log dir>/<name>.hist: a header with the bucket layout, count,
+ * sum, min and max, then one "index value count" line per non-empty
+ * bucket. Files from several runs can be added together with hist_load().
+ *
+ * Parameters:
+ *   hist - Histogram to save
+ *   name - File name without extension, e.g. "storage.1.read"
+ *
+ * Returns:
+ *   true if the file was written, false otherwise
+ */
+bool hist_save(const Histogram *hist, const char *name);
+
+/**
+ * Add a saved histogram into another
+ *
+ * Parameters:
+ *   hist - Histogram to add to
+ *   path - File written by hist_save()
+ *
+ * Returns:
+ *   true on success, false if the file is missing, malformed or uses a
+ *   different bucket layout
+ */
+bool hist_load(Histogram *hist, const char *path);
+
+#endif /* HISTOGRAM_H */
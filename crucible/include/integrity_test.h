@@ -0,0 +1,47 @@
+/**
+ * Memory Integrity Test Header
+ *
+ * This header file declares the memtest-style integrity test. It writes
+ * and verifies classic fault-finding patterns over most of the free memory
+ * from every CPU at once, so it can run as a burn-in step on a normal OS
+ * image and still cover large hosts in reasonable time.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef INTEGRITY_TEST_H
+#define INTEGRITY_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the memory integrity test
+ *
+ * Options:
+ *   sz:   memory to test, as a size or a percentage of available memory
+ *         (e.g. "80%"), default 70%
+ *   p:    comma-separated patterns out of walk1, walk0, inv, rand and
+ *         addr, or "all" (default)
+ *   th:   worker threads, default one per online CPU; each owns a chunk
+ *   numa: true binds each chunk to its thread's node instead of relying
+ *         on first-touch placement
+ *   hp:   page backing for the chunks (one type per run)
+ *   sd:   seed for the random pattern, 0 picks one and logs it
+ *
+ * The pattern cycle repeats until the component duration has passed, at
+ * least once. Every mismatch is logged with its virtual and, when
+ * readable, physical address, the expected and actual value and the
+ * failing bit positions (mem_integrity_error).
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if all memory verified clean, false on errors or setup failure
+ */
+bool integrity_test_run(const ComponentConfig *comp);
+
+#endif /* INTEGRITY_TEST_H */
@@ -0,0 +1,53 @@
+/**
+ * I/O Test Header
+ *
+ * This header file declares the entry point for I/O component tests. The
+ * test drives a block device or a file with O_DIRECT I/O, either through
+ * Linux native AIO (io_setup/io_submit/io_getevents, called directly so
+ * no libaio is needed) with a configurable queue depth, or with blocking
+ * pread()/pwrite() for comparison.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef IO_TEST_H
+#define IO_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run an I/O component test
+ *
+ * Options:
+ *   dev: block device or file to test; a file that does not exist is
+ *        created for the run and removed afterwards (default: a file in
+ *        the current directory)
+ *   io:  "async" (native AIO, default) or "sync" (pread/pwrite)
+ *   qd:  I/Os in flight for async, default 32
+ *   bs:  I/O size, default 4 KB, a multiple of the logical block size
+ *   n:   stop after this many I/Os instead of running for the duration
+ *   wr:  share of I/Os that are writes, 0-100, default 0; refused on
+ *        block devices
+ *   sz:  size of a file created for the test, default 256 MB
+ *   if:  interface the device sits on, "usb3" or "pcie", for the logs
+ *
+ * Offsets are random and aligned to the I/O size. Every second one
+ * io_test metric per direction records IOPS, MB/s and latency (mean,
+ * p50, p90, p99, p99.9, p99.99 and max), and io_test_cpu the CPU cores
+ * used and how long io_submit() blocked, which shows when native AIO
+ * degrades to synchronous submission; the _summary variants cover the
+ * whole run. The run's latency histograms are saved as
+ * io.<order>.read.hist and io.<order>.write.hist in the log directory.
+ *
+ * Parameters:
+ *   comp - Component configuration (component_type 'i')
+ *
+ * Returns:
+ *   true if the workload ran without I/O errors, false otherwise
+ */
+bool io_test_run(const ComponentConfig *comp);
+
+#endif /* IO_TEST_H */
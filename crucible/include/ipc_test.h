@@ -0,0 +1,37 @@
+/**
+ * IPC Latency Test Header
+ *
+ * This header file declares the inter-process communication ping-pong
+ * benchmark. Two pinned endpoints (threads or processes) bounce a token
+ * back and forth over pipes, eventfd, raw futexes, Unix domain sockets and
+ * a shared-memory SPSC ring, and the round-trip time of every exchange is
+ * recorded.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef IPC_TEST_H
+#define IPC_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the IPC ping-pong suite
+ *
+ * Runs every mechanism in thread and process mode for each CPU placement
+ * the topology supports (same core, SMT sibling, same socket, cross socket).
+ * The first entry of the cr: core list, if given, anchors the placements.
+ * The component duration is divided evenly between the cases.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a CPU component)
+ *
+ * Returns:
+ *   true if every case completed, false on setup or protocol errors
+ */
+bool ipc_test_run(const ComponentConfig *comp);
+
+#endif /* IPC_TEST_H */
@@ -0,0 +1,41 @@
+/**
+ * Memory Latency Test Header
+ *
+ * This header file declares the pointer-chasing latency sweep. It measures
+ * the time per dependent load over working sets growing from 4 KB to
+ * several GB and marks the flat regions of the curve as the L1, L2, L3 and
+ * DRAM plateaus.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef LATENCY_TEST_H
+#define LATENCY_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the latency sweep
+ *
+ * The p: option selects the chain order (seq, rand or stride:N, default
+ * rand); random chains are measured in a TLB-friendly and a TLB-hostile
+ * variant. The sz: option is the largest working set (default 4 GB,
+ * capped at half of available memory). With numa:true the buffer is bound
+ * to the node of the measuring CPU. hp: selects the page backing; with
+ * hp:all the sweep runs once per page type and each type is compared with
+ * 4k (mem_latency_pages). Every point is reported as an mem_latency
+ * metric, with dTLB misses per load when perf counters are available, and
+ * every detected plateau as mem_latency_plateau.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if the sweep ran, false on setup errors
+ */
+bool latency_test_run(const ComponentConfig *comp);
+
+#endif /* LATENCY_TEST_H */
@@ -0,0 +1,44 @@
+/**
+ * Loaded Latency Test Header
+ *
+ * This header file declares the loaded-latency test. One pinned thread
+ * measures pointer-chase latency while the other threads generate memory
+ * traffic. Stepping the delay injected between their accesses traces
+ * memory latency as a function of bandwidth. The test also reports the
+ * knee, where latency starts to climb steeply.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef LOADED_LATENCY_TEST_H
+#define LOADED_LATENCY_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the loaded-latency test
+ *
+ * Options:
+ *   th: number of load threads, default one per remaining online CPU
+ *   wr: percentage of the load traffic that is writes, default 0
+ *   dl: comma-separated delays in spin iterations per 4 KB of traffic
+ *   sz: total load buffer size, default 1 GB
+ *   p:  chase pattern for the latency thread
+ *   hp: page backing for all buffers (one type per run)
+ *
+ * Every delay gives one point of the curve (mem_loaded_latency). The
+ * summary (mem_loaded_latency_knee) reports the bandwidth at which latency
+ * reaches twice the unloaded value.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if the curve was measured, false on setup errors
+ */
+bool loaded_latency_test_run(const ComponentConfig *comp);
+
+#endif /* LOADED_LATENCY_TEST_H */
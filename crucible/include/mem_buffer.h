@@ -0,0 +1,131 @@
+/**
+ * Memory Test Buffer Header
+ *
+ * This header file defines the buffer type used by the memory tests.
+ * Buffers are mapped directly with mmap() so their start alignment is
+ * exactly what the test asked for, independent of the malloc heap.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef MEM_BUFFER_H
+#define MEM_BUFFER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/* Largest number of page types a single hp: option can select */
+#define MEM_PAGE_TYPE_MAX 4
+
+/**
+ * Page Type:
+ * How a buffer is backed.
+ */
+typedef enum
+{
+    MEM_PAGES_DEFAULT, /* Whatever the system THP policy gives */
+    MEM_PAGES_4K,      /* Base pages only (MADV_NOHUGEPAGE) */
+    MEM_PAGES_THP,     /* Transparent huge pages (MADV_HUGEPAGE) */
+    MEM_PAGES_2M,      /* hugetlbfs 2 MB pages (MAP_HUGETLB) */
+    MEM_PAGES_1G       /* hugetlbfs 1 GB pages (MAP_HUGETLB) */
+} MemPageType;
+
+/**
+ * Memory Buffer:
+ * An anonymous mapping and the aligned region handed out to the test.
+ */
+typedef struct
+{
+    void *map;         /* Start of the underlying mapping */
+    size_t map_size;   /* Length of the underlying mapping */
+    void *data;        /* First usable byte, aligned as requested */
+    size_t size;       /* Usable length in bytes */
+    MemPageType pages; /* Backing page type */
+} MemBuffer;
+
+/**
+ * Parse a page type option
+ *
+ * Accepts "4k", "thp", "2m", "1g", or "all" for the four of them in that
+ * order. An empty string selects MEM_PAGES_DEFAULT.
+ *
+ * Parameters:
+ *   str   - Option string (hp: suboption)
+ *   types - Array of MEM_PAGE_TYPE_MAX entries to store the types in
+ *
+ * Returns:
+ *   Number of types stored, or 0 if the string is not recognised
+ */
+int mem_buffer_parse_pages(const char *str, MemPageType *types);
+
+/**
+ * Name a page type
+ *
+ * Returns:
+ *   Short name as accepted by mem_buffer_parse_pages(), "default" for
+ *   MEM_PAGES_DEFAULT
+ */
+const char *mem_buffer_page_name(MemPageType pages);
+
+/**
+ * Allocate a test buffer
+ *
+ * An alignment of 0 means page alignment. A smaller power of two places
+ * the buffer exactly that many bytes past a page boundary, so the start
+ * is a multiple of the alignment but not of twice the alignment. This lets
+ * tests measure deliberately misaligned buffers.
+ *
+ * Parameters:
+ *   buf       - Buffer descriptor to fill in
+ *   size      - Usable size in bytes
+ *   alignment - Requested start alignment in bytes (power of two or 0)
+ *
+ * Returns:
+ *   true if successful, false if the mapping failed or alignment is invalid
+ */
+bool mem_buffer_alloc(MemBuffer *buf, size_t size, size_t alignment);
+
+/**
+ * Allocate a test buffer backed by a specific page type
+ *
+ * Same as mem_buffer_alloc() but with explicit page backing. hugetlbfs
+ * types fail unless enough huge pages are reserved
+ * (/sys/kernel/mm/hugepages); the THP type fails if the kernel has no
+ * transparent huge page support.
+ *
+ * Parameters:
+ *   buf       - Buffer descriptor to fill in
+ *   size      - Usable size in bytes
+ *   alignment - Requested start alignment in bytes (power of two or 0)
+ *   pages     - Page type to back the buffer with
+ *
+ * Returns:
+ *   true if successful, false otherwise
+ */
+bool mem_buffer_alloc_pages(MemBuffer *buf, size_t size, size_t alignment, MemPageType pages);
+
+/**
+ * Bind a test buffer to a NUMA node
+ *
+ * Must be called before the buffer is first touched for the placement to
+ * be free; pages already present are migrated.
+ *
+ * Parameters:
+ *   buf  - Buffer previously filled in by mem_buffer_alloc()
+ *   node - NUMA node to place the pages on
+ *
+ * Returns:
+ *   true if the policy was applied, false otherwise
+ */
+bool mem_buffer_bind(MemBuffer *buf, int node);
+
+/**
+ * Release a test buffer
+ *
+ * Parameters:
+ *   buf - Buffer previously filled in by mem_buffer_alloc()
+ */
+void mem_buffer_free(MemBuffer *buf);
+
+#endif /* MEM_BUFFER_H */
@@ -1 +1,42 @@
-# Memory test declarations
+/**
+ * Memory Test Header
+ *
+ * This header file declares the entry point for memory component tests.
+ * The specific test is chosen with the w: suboption of the component
+ * (e.g. *2m[t:baseline-d60-{w:bw-sz:1g}]).
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef MEMORY_TEST_H
+#define MEMORY_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run a memory component test
+ *
+ * Dispatches on MemoryOptions.workload. Supported workloads:
+ *   bw        - STREAM-style bandwidth engine (default)
+ *   lat       - Pointer-chasing latency sweep
+ *   loaded    - Latency under increasing bandwidth load
+ *   numa      - Cross-node latency and bandwidth matrix
+ *   alloc     - malloc, arena and slab allocator benchmark
+ *   integrity - memtest-style pattern test over most of free memory
+ *   fault     - Page fault and first-touch costs
+ *   pressure  - Hold resident memory near a target and log PSI
+ *               (default for t:load)
+ *   copy      - memcpy/memset implementations across sizes and alignments
+ *
+ * Parameters:
+ *   comp - Component configuration (component_type 'm')
+ *
+ * Returns:
+ *   true if the test ran and passed, false otherwise
+ */
+bool memory_test_run(const ComponentConfig *comp);
+
+#endif /* MEMORY_TEST_H */
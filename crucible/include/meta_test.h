@@ -0,0 +1,54 @@
+/**
+ * Filesystem Metadata Test Header
+ *
+ * This header file declares the metadata workload of the storage
+ * component. Build and artifact systems spend their time creating,
+ * looking up and deleting many small files, which is bound by directory
+ * and inode operations rather than bandwidth. The test spreads a large
+ * number of small files over a directory tree and times every create,
+ * stat, open, rename and unlink from several threads.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef META_TEST_H
+#define META_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the metadata test
+ *
+ * Options (w:meta):
+ *   dir: directory to build the tree in, default the current one
+ *   fc:  number of files, default 100000
+ *   sz:  bytes written to each file when it is created, default 0
+ *   th:  threads, default 1; each works through every th:-th file
+ *   fo:  subdirectories per directory, default 16
+ *   dd:  directory levels below the tree's root, default 2; files are
+ *        spread evenly over the fo:^dd: leaf directories
+ *   cc:  true runs stat and open once more after dropping the page,
+ *        dentry and inode caches; needs root and is skipped with a
+ *        warning without it
+ *
+ * The phases run one after the other over every file: create (open with
+ * O_CREAT|O_EXCL, write, close), stat, open (open and close), the cold
+ * stat and open with cc:true, rename (to a new name in the same
+ * directory) and unlink. A phase lasts as long as its operations take,
+ * so the duration of the component is not used. Every second
+ * storage_meta records the running phase's operations per second and
+ * latency percentiles, and storage_meta_summary covers each phase;
+ * per-phase histograms are saved as storage.<order>.<phase>.hist.
+ *
+ * Parameters:
+ *   comp - Component configuration (component_type 's')
+ *
+ * Returns:
+ *   true if every operation succeeded, false otherwise
+ */
+bool meta_test_run(const ComponentConfig *comp);
+
+#endif /* META_TEST_H */
@@ -0,0 +1,75 @@
+/**
+ * NUMA Placement Header
+ *
+ * This header file declares thin wrappers around the kernel's memory
+ * policy system calls (mbind, set_mempolicy and move_pages). They are
+ * called through syscall() directly so Crucible does not depend on
+ * libnuma.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef NUMA_H
+#define NUMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * List the online NUMA nodes
+ *
+ * Parameters:
+ *   nodes - Array to store the node numbers in
+ *   max   - Capacity of the nodes array
+ *
+ * Returns:
+ *   Number of nodes stored; 1 (node 0) if the kernel has no NUMA support
+ */
+int numa_online_nodes(int *nodes, int max);
+
+/**
+ * Bind a memory range to one node
+ *
+ * Applies MPOL_BIND to the range. Pages already present are migrated, so
+ * this is best called before the range is first touched.
+ *
+ * Parameters:
+ *   addr - Page-aligned start of the range
+ *   len  - Length of the range in bytes
+ *   node - Node that must hold the pages
+ *
+ * Returns:
+ *   true if the policy was applied, false otherwise (errno is set)
+ */
+bool numa_bind_range(void *addr, size_t len, int node);
+
+/**
+ * Set the calling thread's default allocation node
+ *
+ * Parameters:
+ *   node - Preferred node, or -1 to restore the default local policy
+ *
+ * Returns:
+ *   true if the policy was applied, false otherwise (errno is set)
+ */
+bool numa_set_preferred(int node);
+
+/**
+ * Check where the pages of a range live
+ *
+ * Queries move_pages() for up to a few thousand pages spread evenly over
+ * the range. Pages must have been touched.
+ *
+ * Parameters:
+ *   addr - Start of the range
+ *   len  - Length of the range in bytes
+ *   node - Node the pages are expected on
+ *
+ * Returns:
+ *   Fraction of sampled pages found on the node (0.0 to 1.0), or -1.0 if
+ *   the query failed
+ */
+double numa_placement(const void *addr, size_t len, int node);
+
+#endif /* NUMA_H */
@@ -0,0 +1,36 @@
+/**
+ * NUMA Matrix Test Header
+ *
+ * This header file declares the cross-node memory test. For every pair of
+ * a CPU node and a memory node it measures pointer-chase latency and read
+ * bandwidth with the threads on the CPU node and the buffer bound to the
+ * memory node, producing a node-by-node matrix.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef NUMA_TEST_H
+#define NUMA_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the NUMA matrix test
+ *
+ * The sz: option is the buffer size per matrix cell (default 512 MB), p:
+ * the chase pattern for the latency measurement and hp: the page
+ * backing. Placement is checked with move_pages() before each cell is
+ * measured. On a single-node machine only the local cell is reported.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if every cell was measured, false on setup errors
+ */
+bool numa_test_run(const ComponentConfig *comp);
+
+#endif /* NUMA_TEST_H */
@@ -0,0 +1,79 @@
+/**
+ * Performance Counter Header
+ *
+ * This header file declares a small wrapper around perf_event_open() for
+ * the hardware and software events the memory tests report. Counters are
+ * optional: virtual machines and locked-down kernels often refuse them,
+ * and callers are expected to carry on without the extra numbers.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Maximum number of raw events summed into one counter */
+#define PERF_COUNTER_MAX_EVENTS 2
+
+/**
+ * Counter Kind:
+ * What a counter measures.
+ */
+typedef enum
+{
+    PERF_DTLB_MISSES, /* Data TLB misses, loads plus stores where supported */
+    PERF_MINOR_FAULTS, /* Minor page faults taken by user-space accesses */
+    PERF_CPU_CYCLES    /* Core clock cycles spent in user space */
+} PerfCounterKind;
+
+/**
+ * Performance Counter:
+ * One logical counter backed by one or more perf events.
+ */
+typedef struct
+{
+    int fds[PERF_COUNTER_MAX_EVENTS]; /* Open perf event descriptors */
+    int count;                        /* Number of open descriptors */
+} PerfCounter;
+
+/**
+ * Open a counter for the calling thread
+ *
+ * The counter starts running immediately and counts user-space events
+ * only. With inherit set it also counts threads created afterwards; their
+ * counts are included in perf_counter_read().
+ *
+ * Parameters:
+ *   counter - Counter to initialise
+ *   kind    - Event to count
+ *   inherit - Also count threads created after this call
+ *
+ * Returns:
+ *   true if the counter is available, false otherwise (counter is unusable)
+ */
+bool perf_counter_open(PerfCounter *counter, PerfCounterKind kind, bool inherit);
+
+/**
+ * Read a counter
+ *
+ * Parameters:
+ *   counter - Counter previously opened by perf_counter_open()
+ *
+ * Returns:
+ *   Events counted since the counter was opened, or 0 if it is not open
+ */
+uint64_t perf_counter_read(const PerfCounter *counter);
+
+/**
+ * Close a counter
+ *
+ * Parameters:
+ *   counter - Counter to close; safe to call on a counter that failed to open
+ */
+void perf_counter_close(PerfCounter *counter);
+
+#endif /* PERF_COUNTER_H */
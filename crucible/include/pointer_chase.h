@@ -0,0 +1,114 @@
+/**
+ * Pointer Chase Header
+ *
+ * This header file defines the dependent-load chains used by the memory
+ * latency tests. A chain is built in place inside a buffer: every node
+ * holds the address of the next node, so each load has to wait for the
+ * previous one and the measured time per load is the memory latency.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef POINTER_CHASE_H
+#define POINTER_CHASE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Chase Order:
+ * How nodes are linked together.
+ */
+typedef enum
+{
+    CHASE_SEQ,    /* Consecutive cache lines */
+    CHASE_RAND,   /* Random single-cycle permutation of cache lines */
+    CHASE_STRIDE  /* Fixed byte stride, wrapping at the end of the buffer */
+} ChaseOrder;
+
+/**
+ * Chase Pattern:
+ * Parsed form of the p: memory option.
+ */
+typedef struct
+{
+    ChaseOrder order; /* Link order */
+    size_t stride;    /* Distance between nodes in bytes */
+} ChasePattern;
+
+/**
+ * Parse a chase pattern
+ *
+ * Accepts "seq", "rand" or "stride:N" where N is a byte count with an
+ * optional k/m/g suffix and a multiple of the pointer size. An empty
+ * string selects "rand".
+ *
+ * Parameters:
+ *   str     - Pattern string from the configuration
+ *   pattern - Pointer to store the parsed pattern in
+ *
+ * Returns:
+ *   true if successful, false if the string is malformed
+ */
+bool chase_parse_pattern(const char *str, ChasePattern *pattern);
+
+/**
+ * Describe a chase pattern
+ *
+ * Parameters:
+ *   pattern - Pattern to describe
+ *   buffer  - Buffer to store the description in, e.g. "stride:256"
+ *   size    - Size of the buffer
+ */
+void chase_pattern_name(const ChasePattern *pattern, char *buffer, size_t size);
+
+/**
+ * Build a chain in a buffer
+ *
+ * For CHASE_RAND the tlb_friendly flag selects the variant: when true the
+ * lines of each page are visited in random order but pages are visited in
+ * address order, so a load rarely needs a new TLB entry; when false the
+ * permutation spans the whole buffer and nearly every load misses the TLB.
+ * The flag is ignored for the linear orders.
+ *
+ * Parameters:
+ *   base         - Start of the buffer (pointer-aligned)
+ *   bytes        - Length of the region to link
+ *   pattern      - Link order and node spacing
+ *   tlb_friendly - Keep random permutations within a page at a time
+ *   seed         - Random seed for CHASE_RAND
+ *   nodes        - Optional pointer to store the number of nodes linked
+ *
+ * Returns:
+ *   First node of the chain, or NULL if the region holds fewer than two nodes
+ */
+void **chase_build(void *base, size_t bytes, const ChasePattern *pattern,
+                   bool tlb_friendly, uint64_t seed, size_t *nodes);
+
+/**
+ * Follow a chain
+ *
+ * Parameters:
+ *   head  - Node to start from
+ *   loads - Number of dependent loads to perform (rounded up to 16)
+ *
+ * Returns:
+ *   The node reached, to be passed as head to continue the walk
+ */
+void **chase_walk(void **head, uint64_t loads);
+
+/**
+ * Measure the average load latency of a chain
+ *
+ * Parameters:
+ *   head  - Node to start from
+ *   loads - Number of dependent loads to time
+ *
+ * Returns:
+ *   Nanoseconds per load
+ */
+double chase_measure(void **head, uint64_t loads);
+
+#endif /* POINTER_CHASE_H */
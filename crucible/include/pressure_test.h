@@ -0,0 +1,45 @@
+/**
+ * Memory Pressure Generator Header
+ *
+ * This header file declares the memory pressure generator. It ramps the
+ * resident memory of the process up to a target share of MemTotal, holds
+ * it there while re-touching its pages at a steady rate, and logs the
+ * kernel's view of the resulting pressure: PSI stall time, reclaim and
+ * swap activity. It backs off before the machine runs out of memory so
+ * neighbouring services degrade without the test itself being killed.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef PRESSURE_TEST_H
+#define PRESSURE_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the memory pressure generator
+ *
+ * Options:
+ *   sz: target resident size, as a size or a percentage of MemTotal
+ *       (e.g. "90%"), default 80%
+ *   tr: memory re-touched per second to keep the pages hot, default 1g
+ *   hp: page backing (one type per run)
+ *
+ * The first quarter of the duration ramps up to the target and the rest
+ * holds it. Growth stops, and memory is handed back, whenever
+ * MemAvailable falls below a reserve of 2% of MemTotal (at least 256 MB).
+ * Every second one mem_pressure metric records the held and available
+ * memory, PSI some/full stall percentages and reclaim and swap rates.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a memory component)
+ *
+ * Returns:
+ *   true if the generator ran for the full duration, false on setup errors
+ */
+bool pressure_test_run(const ComponentConfig *comp);
+
+#endif /* PRESSURE_TEST_H */
@@ -0,0 +1,38 @@
+/**
+ * SMT Interference Test Header
+ *
+ * This header file declares the simultaneous multithreading interference
+ * benchmark. It measures how much each workload slows down when another
+ * workload runs on the other hardware thread of the same physical core.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef SMT_TEST_H
+#define SMT_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the SMT interference matrix
+ *
+ * Picks a core with at least two hardware threads (the first cr: core if
+ * it has a sibling) from thread_siblings_list. Each of the integer, FP,
+ * SIMD, memory-bound and branchy workloads is measured alone on one
+ * thread, then every pair is run on the two siblings at once. Each cell
+ * of the resulting matrix is the row workload's throughput next to the
+ * column workload, relative to running alone. The component duration is
+ * divided evenly between the runs; v:true enables result verification.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a CPU component)
+ *
+ * Returns:
+ *   true if the matrix was produced or SMT is unavailable, false on errors
+ */
+bool smt_test_run(const ComponentConfig *comp);
+
+#endif /* SMT_TEST_H */
@@ -0,0 +1,36 @@
+/**
+ * Thread and Process Creation Test Header
+ *
+ * This header file declares the task creation rate benchmark. It measures
+ * how quickly the system can create and reap threads and processes, and
+ * how fork-style creation slows down as the parent's resident set grows.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef SPAWN_TEST_H
+#define SPAWN_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the creation rate suite
+ *
+ * Measures pthread_create+join, fork+waitpid, vfork+exec, posix_spawn of a
+ * trivial binary, and raw clone(SIGCHLD) with the parent holding 0 MB up
+ * to several GB of touched anonymous memory. Each operation is repeated
+ * with 1, 2, 4, ... concurrent spawner threads up to the online CPU count.
+ * The component duration is divided evenly between the cases.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a CPU component)
+ *
+ * Returns:
+ *   true if every case completed, false otherwise
+ */
+bool spawn_test_run(const ComponentConfig *comp);
+
+#endif /* SPAWN_TEST_H */
@@ -1 +1,92 @@
-# Storage test declarations
+/**
+ * Storage Test Header
+ *
+ * This header file declares the entry point for storage component tests.
+ * The engine lays out a set of files in the target directory, then runs
+ * a random or sequential read/write mix over them from one or more
+ * threads, optionally with O_DIRECT, using blocking system calls or an
+ * io_uring ring per thread, either as fast as possible or open-loop at
+ * a target rate. Other storage workloads are chosen with the w:
+ * suboption and live in their own files.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef STORAGE_TEST_H
+#define STORAGE_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run a storage component test
+ *
+ * Options:
+ *   w:   workload: "io" (default, this engine), "wal" (write-ahead log
+ *        commits, see wal_test.h) or "meta" (create, stat, open, rename
+ *        and unlink of many small files, see meta_test.h)
+ *   dir: directory to create the test files in, default the current one
+ *   fc:  number of files, default 1
+ *   sz:  size of each file, default 256 MB
+ *   bs:  I/O size, default 4 KB
+ *   rr:  share of I/Os that are reads, 0-100, default 50
+ *   p:   access pattern, "rand" (default) or "seq"; sequential threads
+ *        each walk their own stripe of the files
+ *   th:  threads issuing I/O, default 1
+ *   dio: true opens the files with O_DIRECT; bs: and buffers are then
+ *        kept block aligned and the page cache is bypassed
+ *   e:   engine: "psync" (pread/pwrite, default), "sync" (lseek plus
+ *        read/write) or "uring" (io_uring with registered buffers and
+ *        files, batched submission and reaping)
+ *   qd:  I/Os in flight per uring thread, default 32
+ *   sqp: true lets a kernel thread poll each ring's submission queue
+ *   iop: true busy-polls for completions (needs dio:true and a device
+ *        with poll queues)
+ *   iops: open-loop target rate for the whole component, split evenly
+ *        across threads; 0 (default) runs closed-loop
+ *   arr: open-loop arrivals, "const" (default) or "poisson"
+ *   v:   true writes every block with a header (block, generation,
+ *        payload seed) and a CRC32C, checks every read and reads all
+ *        blocks back after the run; each thread keeps to its own stripe
+ *        of blocks
+ *   cmp: share of the written data that compresses away, 0-100,
+ *        default 0 (incompressible)
+ *   dup: share of written blocks that duplicate another block, 0-100,
+ *        default 0; not available with v:true
+ *   sd:  seed of the written data, default one picked per run
+ *   pc:  true preconditions the device before the measurement, SNIA
+ *        PTS style: a second sequential fill, then random writes in
+ *        rounds until steady state (at most 25 rounds)
+ *   pcr: preconditioning round length in seconds, default 60
+ *
+ * Files are written out in full before the measurement so reads hit real
+ * data, and are removed afterwards. Every second one storage_io metric
+ * records read and write IOPS, MB/s and latency (mean, p50, p90, p99,
+ * p99.9, p99.99 and max, from per-thread histograms), and storage_io_cpu
+ * the CPU cores the process used and IOPS per core. Open-loop runs
+ * measure latency from each I/O's intended start time and add
+ * storage_io_rate with the requested and achieved rate, the backlog of
+ * due but unstarted I/Os and the worst start lag. The _summary variants
+ * cover the whole run. The run's latency histograms are saved
+ * as storage.<order>.read.hist and storage.<order>.write.hist in the log
+ * directory. storage_data_summary records the data seed and the
+ * compressibility and duplicate share the measured run actually wrote.
+ * Preconditioning logs its fill rate and the write IOPS of every round
+ * as storage_precondition, and storage_steady_state whether the last
+ * five rounds stayed within 20% of their average with a best-fit slope
+ * under 10%. In verify mode each bad block is logged with its file and
+ * offset as a storage_verify_error metric, classified as torn (bad CRC),
+ * stale (an older generation) or misdirected (another block's data),
+ * and storage_verify_summary counts them; any bad block fails the test.
+ *
+ * Parameters:
+ *   comp - Component configuration (component_type 's')
+ *
+ * Returns:
+ *   true if the workload ran without I/O errors, false otherwise
+ */
+bool storage_test_run(const ComponentConfig *comp);
+
+#endif /* STORAGE_TEST_H */
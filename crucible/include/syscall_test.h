@@ -0,0 +1,36 @@
+/**
+ * Syscall Overhead Test Header
+ *
+ * This header file declares the system call and vDSO cost microbenchmark.
+ * It times a fixed set of cheap kernel entries so per-kernel baselines can
+ * expose regressions from kernel updates or mitigation changes.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef SYSCALL_TEST_H
+#define SYSCALL_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the syscall overhead suite
+ *
+ * Measures raw getpid, vDSO clock_gettime, 8-byte read from /dev/zero,
+ * futex wake without waiters, one-page mmap/munmap and sched_yield, first
+ * with the machine idle and then with every other online CPU loaded. The
+ * measuring thread is pinned to the first cr: core, or the first online
+ * CPU. The component duration is divided evenly between the cases.
+ *
+ * Parameters:
+ *   comp - Component configuration (must be a CPU component)
+ *
+ * Returns:
+ *   true if every case completed, false otherwise
+ */
+bool syscall_test_run(const ComponentConfig *comp);
+
+#endif /* SYSCALL_TEST_H */
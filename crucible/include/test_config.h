@@ -0,0 +1,143 @@
+/**
+ * Test Configuration Types Header
+ *
+ * This header file defines the per-component option structures produced by
+ * the command-line parser in main.c. Test modules include it so they can read
+ * the options for the component they are asked to run.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef TEST_CONFIG_H
+#define TEST_CONFIG_H
+
+#include <stdbool.h>
+
+typedef enum
+{
+    PTT_BASELINE, // Retrieve a baseline amount of data
+    PTT_STRESS,   // Progressively increases load beyond normal operating capacity
+    PTT_SPIKE,    // Suddenly applies a massive load increase, then drops back to normal levels
+    PTT_LOAD,     // Gradually increases load to a predetermined level and maintains it for a specified duration
+} PerfTestType;
+
+typedef enum
+{
+    ASYNC_IO,
+    SYNC_IO
+} IOType;
+
+typedef enum
+{
+    INTERFACE_USB3,
+    INTERFACE_PCIE
+} IOInterfaceType;
+
+typedef struct
+{
+    int *cores;
+    int core_count;
+    char freq_min[16];
+    char freq_max[16];
+    char workload_type[16];
+    int threads_per_core;
+    bool test_thermal;
+    bool verify; /* Check stress workload results for silent data corruption */
+} CPUOptions;
+
+typedef struct
+{
+    char size[16];
+    char pattern[64];   /* Access pattern, or comma-separated pattern or method list (p:) */
+    char alloc_size[128]; /* Allocation size or size histogram file (a:) */
+    int alignment;
+    bool numa_aware;
+    char workload[16]; /* Memory test to run (w: suboption) */
+    int threads;       /* Worker threads, 0 for one per online CPU (th:) */
+    int write_pct;     /* Share of load traffic that is writes, 0-100 (wr:) */
+    char delays[64];   /* Injected delay list for loaded latency (dl:) */
+    char pages[16];    /* Page backing: 4k, thp, 2m, 1g or all (hp:) */
+    unsigned long seed; /* Seed for random data patterns, 0 picks one (sd:) */
+    char touch_rate[16]; /* Memory re-touched per second under pressure (tr:) */
+} MemoryOptions;
+
+typedef struct
+{
+    char file_size[16];
+    int read_ratio;     /* Share of reads, 0-100, -1 when not given (rr:) */
+    char block_size[16];
+    bool direct_io;
+    char directory[256];
+    int file_count;
+    char pattern[16];   /* Access pattern: rand or seq (p:) */
+    int threads;        /* Threads issuing I/O (th:) */
+    char engine[16];    /* I/O engine: psync, sync or uring (e:) */
+    int queue_depth;    /* I/Os in flight per uring thread (qd:) */
+    bool sqpoll;        /* Kernel thread polls the submission queue (sqp:) */
+    bool iopoll;        /* Busy-poll for completions, needs O_DIRECT (iop:) */
+    int target_iops;    /* Open-loop rate in I/Os per second, 0 runs closed-loop (iops:) */
+    char arrival[16];   /* Open-loop arrivals: const or poisson (arr:) */
+    bool verify;        /* Checksummed blocks, checked on every read and after the run (v:) */
+    int compress_pct;   /* Share of written data that compresses away, 0-100 (cmp:) */
+    int dedupe_pct;     /* Share of written blocks that duplicate another, 0-100 (dup:) */
+    unsigned long seed; /* Seed for the written data, 0 picks one (sd:) */
+    bool precondition;  /* Sequential fill then random writes until steady state (pc:) */
+    int round_secs;     /* Preconditioning round length in seconds (pcr:) */
+    char workload[16];  /* Storage test to run: io (default), wal or meta (w:) */
+    char sync_method[16]; /* WAL sync: fsync, fdatasync, dsync or sfr (sm:) */
+    int group_commit;   /* Most WAL records one sync may cover (gc:) */
+    char prealloc[16];  /* WAL segment allocation: none, falloc or zero (pre:) */
+    int fanout;         /* Metadata test subdirectories per directory (fo:) */
+    int depth;          /* Metadata test directory levels, -1 when not given (dd:) */
+    bool cold_cache;    /* Metadata test stat and open again after drop_caches, needs root (cc:) */
+} StorageOptions;
+
+typedef struct
+{
+    char protocol[8];
+    char target_ip[64];
+    int port;
+    char packet_size[16];
+    int connection_count;
+    char bandwidth_limit[16];
+} NetworkOptions;
+
+typedef struct
+{
+    char device_path[256];
+    IOType io_type;     /* async (native AIO) or sync (pread/pwrite) (io:) */
+    char buffer_size[16];
+    int operation_count; /* Stop after this many I/Os, 0 runs for the duration (n:) */
+    IOInterfaceType interface_type;
+    int queue_depth;    /* I/Os in flight for async (qd:) */
+    int write_pct;      /* Share of writes, 0-100 (wr:) */
+    char file_size[16]; /* Size of a test file created for the run (sz:) */
+} IOOptions;
+
+typedef struct
+{
+    int order;
+    char component_type;
+    PerfTestType test_type;
+    int duration;
+    union
+    {
+        CPUOptions cpu;
+        MemoryOptions memory;
+        StorageOptions storage;
+        NetworkOptions network;
+        IOOptions io;
+    } options;
+} ComponentConfig;
+
+typedef struct
+{
+    ComponentConfig *components;
+    int component_count;
+    char log_directory[256];
+    char file_name_base[256];
+    char file_format[16];
+} TestConfig;
+
+#endif /* TEST_CONFIG_H */
@@ -0,0 +1,137 @@
+/**
+ * CPU Topology Header
+ *
+ * This header file defines the interface for discovering the logical CPU
+ * layout of the machine from sysfs: which CPUs are online, which physical
+ * core and package each belongs to, and which NUMA node it sits on.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * CPU Information:
+ * Placement of one online logical CPU.
+ */
+typedef struct
+{
+    int cpu;        /* Logical CPU number */
+    int core_id;    /* Physical core ID (unique within a package) */
+    int package_id; /* Physical package (socket) ID */
+    int node;       /* NUMA node, or -1 if unknown */
+} CpuInfo;
+
+/**
+ * CPU Topology:
+ * All online logical CPUs, in ascending CPU number order.
+ */
+typedef struct
+{
+    CpuInfo *cpus; /* Array of online CPUs */
+    int count;     /* Number of entries in cpus */
+} CpuTopology;
+
+/**
+ * Load the CPU topology from sysfs
+ *
+ * Parameters:
+ *   topo - Pointer to the topology structure to fill in
+ *
+ * Returns:
+ *   true if at least one online CPU was found, false otherwise
+ */
+bool topology_load(CpuTopology *topo);
+
+/**
+ * Release memory held by a topology
+ *
+ * Parameters:
+ *   topo - Topology previously filled in by topology_load()
+ */
+void topology_free(CpuTopology *topo);
+
+/**
+ * Parse a kernel CPU list string
+ *
+ * Understands the sysfs list format, e.g. "0-3,8,10-11".
+ *
+ * Parameters:
+ *   list - String to parse
+ *   cpus - Array to store the CPU numbers in
+ *   max  - Capacity of the cpus array
+ *
+ * Returns:
+ *   Number of CPUs stored, or -1 if the list is malformed
+ */
+int topology_parse_cpulist(const char *list, int *cpus, int max);
+
+/**
+ * Look up a logical CPU
+ *
+ * Returns:
+ *   Pointer to the CPU's entry, or NULL if it is not online
+ */
+const CpuInfo *topology_find(const CpuTopology *topo, int cpu);
+
+/**
+ * Read the SMT siblings of a CPU
+ *
+ * Parses /sys/devices/system/cpu/cpuN/topology/thread_siblings_list. The
+ * result includes the CPU itself.
+ *
+ * Parameters:
+ *   cpu      - Logical CPU number
+ *   siblings - Array to store the sibling CPU numbers in
+ *   max      - Capacity of the siblings array
+ *
+ * Returns:
+ *   Number of siblings stored, or -1 if the list cannot be read
+ */
+int topology_thread_siblings(int cpu, int *siblings, int max);
+
+/**
+ * Find an SMT sibling of a CPU
+ *
+ * Returns:
+ *   A different logical CPU on the same physical core, or -1 if none
+ */
+int topology_smt_sibling(const CpuTopology *topo, int cpu);
+
+/**
+ * Find a CPU on another core of the same package
+ *
+ * Returns:
+ *   A logical CPU on a different physical core of the same package, or -1
+ */
+int topology_same_package_cpu(const CpuTopology *topo, int cpu);
+
+/**
+ * Find a CPU on a different package
+ *
+ * Returns:
+ *   A logical CPU on a different physical package, or -1 if single-socket
+ */
+int topology_other_package_cpu(const CpuTopology *topo, int cpu);
+
+/**
+ * Read the size of a data cache level
+ *
+ * Looks through /sys/devices/system/cpu/cpuN/cache for a data or unified
+ * cache of the given level.
+ *
+ * Parameters:
+ *   cpu   - Logical CPU number
+ *   level - Cache level (1 for L1, 2 for L2, ...)
+ *
+ * Returns:
+ *   Cache size in bytes, or 0 if the level does not exist or is unknown
+ */
+size_t topology_cache_size(int cpu, int level);
+
+#endif /* TOPOLOGY_H */
@@ -0,0 +1,180 @@
+/**
+ * io_uring Wrapper Header
+ *
+ * This header file declares a minimal io_uring interface built directly on
+ * the system calls, so no liburing is needed at build or run time. It
+ * covers what the I/O engines use: ring setup (optionally with SQPOLL or
+ * IOPOLL), registered buffers and files, batched submission and batched
+ * completion reaping. Each ring is meant to be driven by a single thread.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef URING_H
+#define URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+
+/**
+ * Ring:
+ * One io_uring instance and its mapped submission and completion queues.
+ */
+typedef struct
+{
+    int fd;                    /* Ring descriptor, -1 when not set up */
+    unsigned flags;            /* IORING_SETUP_* the ring was created with */
+    unsigned features;         /* IORING_FEAT_* the kernel reported */
+
+    /* Submission queue */
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_flags;
+    unsigned *sq_array;
+    unsigned sq_entries;
+    unsigned sqe_tail;         /* SQEs handed out, published on submit */
+    struct io_uring_sqe *sqes;
+
+    /* Completion queue */
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    unsigned cq_entries;
+    struct io_uring_cqe *cqes;
+
+    /* Mappings to release */
+    void *sq_map;
+    size_t sq_map_size;
+    void *cq_map;
+    size_t cq_map_size;
+    size_t sqes_size;
+} Uring;
+
+/**
+ * Create a ring
+ *
+ * Parameters:
+ *   ring       - Ring to initialise
+ *   entries    - Submission queue size (rounded up to a power of two)
+ *   flags      - IORING_SETUP_* flags, e.g. IORING_SETUP_SQPOLL
+ *   sq_idle_ms - Idle time before the SQPOLL thread sleeps, ignored without SQPOLL
+ *
+ * Returns:
+ *   true if the ring is ready, false otherwise with errno set
+ */
+bool uring_init(Uring *ring, unsigned entries, unsigned flags, unsigned sq_idle_ms);
+
+/**
+ * Register fixed buffers
+ *
+ * Parameters:
+ *   ring  - Ring to register with
+ *   iovs  - Buffers; READ_FIXED/WRITE_FIXED refer to them by index
+ *   count - Number of buffers
+ *
+ * Returns:
+ *   true on success, false otherwise with errno set
+ */
+bool uring_register_buffers(Uring *ring, const struct iovec *iovs, unsigned count);
+
+/**
+ * Register fixed files
+ *
+ * Parameters:
+ *   ring  - Ring to register with
+ *   fds   - Descriptors; SQEs with IOSQE_FIXED_FILE refer to them by index
+ *   count - Number of descriptors
+ *
+ * Returns:
+ *   true on success, false otherwise with errno set
+ */
+bool uring_register_files(Uring *ring, const int *fds, unsigned count);
+
+/**
+ * Get a free submission queue entry
+ *
+ * The entry is zeroed. It is not visible to the kernel until
+ * uring_submit() is called.
+ *
+ * Parameters:
+ *   ring - Ring to take the entry from
+ *
+ * Returns:
+ *   Pointer to the entry, or NULL if the submission queue is full
+ */
+struct io_uring_sqe *uring_get_sqe(Uring *ring);
+
+/**
+ * Submit prepared entries and optionally wait for completions
+ *
+ * Every entry handed out and not yet consumed by the kernel is offered in
+ * one batch. The kernel may take fewer (short of resources, or an entry
+ * it rejects); the rest stay queued and are offered again by the next
+ * call, and no completions are waited for in that case. With SQPOLL the
+ * system call is skipped unless the poll thread needs a wakeup or
+ * completions are waited for, and every published entry counts as
+ * submitted; with IOPOLL the kernel is always entered so it can poll for
+ * completions.
+ *
+ * Parameters:
+ *   ring    - Ring to submit on
+ *   wait_nr - Completions to wait for, 0 to return immediately
+ *
+ * Returns:
+ *   Number of entries the kernel consumed, or a negative errno value
+ */
+int uring_submit(Uring *ring, unsigned wait_nr);
+
+/**
+ * Submit prepared entries and wait for completions, with a timeout
+ *
+ * Like uring_submit(), but gives up waiting after timeout_ns. Needs a
+ * kernel with IORING_FEAT_EXT_ARG (5.11 or later).
+ *
+ * Parameters:
+ *   ring       - Ring to submit on
+ *   wait_nr    - Completions to wait for
+ *   timeout_ns - Longest time to wait in nanoseconds
+ *
+ * Returns:
+ *   Number of entries the kernel consumed (also on timeout), -EOPNOTSUPP
+ *   if the kernel lacks the feature, or another negative errno value
+ */
+int uring_submit_timeout(Uring *ring, unsigned wait_nr, uint64_t timeout_ns);
+
+/**
+ * Peek at available completions
+ *
+ * Parameters:
+ *   ring - Ring to reap from
+ *   cqes - Array to fill with pointers into the completion queue
+ *   max  - Size of the array
+ *
+ * Returns:
+ *   Number of completions stored; release them with uring_cq_advance()
+ */
+unsigned uring_peek_batch(Uring *ring, struct io_uring_cqe **cqes, unsigned max);
+
+/**
+ * Mark completions as consumed
+ *
+ * Parameters:
+ *   ring  - Ring the completions came from
+ *   count - Number of completions returned by uring_peek_batch() to release
+ */
+void uring_cq_advance(Uring *ring, unsigned count);
+
+/**
+ * Tear down a ring
+ *
+ * Parameters:
+ *   ring - Ring to release; safe to call on a ring that failed to set up
+ */
+void uring_exit(Uring *ring);
+
+#endif /* URING_H */
@@ -0,0 +1,64 @@
+/**
+ * Write-Ahead Log Test Header
+ *
+ * This header file declares the write-ahead log workload of the storage
+ * component. Databases commit by appending a record to a log and making
+ * it durable before they answer, so their commit rate is bound by sync
+ * latency rather than bandwidth. The test emulates that log: committer
+ * threads append records to one shared log file, made durable with
+ * fsync, fdatasync, O_DSYNC or sync_file_range, either one record per
+ * sync or in group-commit batches.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#ifndef WAL_TEST_H
+#define WAL_TEST_H
+
+#include <stdbool.h>
+
+#include "test_config.h"
+
+/**
+ * Run the write-ahead log test
+ *
+ * Options (w:wal):
+ *   dir: directory to create the log in, default the current one
+ *   sz:  log segment size, default 64 MB; a full segment starts over at
+ *        its beginning
+ *   bs:  record size, default 4 KB
+ *   th:  committer threads, default 1
+ *   sm:  sync method: "fsync", "fdatasync" (default), "dsync" (the log is
+ *        opened O_DSYNC, every write is durable on return) or "sfr"
+ *        (sync_file_range; flushes data pages only, neither metadata nor
+ *        the device cache, so it is not a durable commit)
+ *   gc:  most records one sync may cover, default 1 (every commit syncs
+ *        its own record). Above 1 a committer that finds no sync running
+ *        becomes the leader and writes and syncs every waiting record in
+ *        one go, up to gc: of them
+ *   pre: segment allocation: "none" (default) extends the file with every
+ *        write and truncates it when the segment is full, "falloc"
+ *        reserves the segment with fallocate and "zero" also writes it out
+ *        with zeros first, so no write has to convert unwritten extents
+ *   dio: true opens the log with O_DIRECT; bs: must then be a multiple
+ *        of 512
+ *   cmp: share of the record data that compresses away, 0-100
+ *   sd:  seed of the record data
+ *
+ * Every second storage_wal records commits per second, MB/s, syncs per
+ * second, the mean batch and commit latency percentiles; commit latency
+ * runs from handing the record to the log to it being durable, waiting
+ * for other batches included. storage_wal_summary covers the whole run
+ * with sync latency next to commit latency, and the histograms are saved
+ * as storage.<order>.commit.hist and storage.<order>.sync.hist.
+ *
+ * Parameters:
+ *   comp - Component configuration (component_type 's')
+ *
+ * Returns:
+ *   true if the workload ran without I/O errors, false otherwise
+ */
+bool wal_test_run(const ComponentConfig *comp);
+
+#endif /* WAL_TEST_H */
@@ -0,0 +1,68 @@
+/**
+ * Bump Arena Allocator Implementation
+ *
+ * This file implements the bump-pointer arena on top of a MemBuffer so
+ * the region is a private mapping independent of the malloc heap.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Include our header file */
+#include "alloc_arena.h"
+
+/* Define constants */
+#define ARENA_ALIGN 16
+
+/**
+ * Create an arena
+ */
+bool arena_init(Arena *arena, size_t size)
+{
+    memset(arena, 0, sizeof(*arena));
+    if (!mem_buffer_alloc(&arena->buffer, size, 0))
+    {
+        return false;
+    }
+
+    arena->base = arena->buffer.data;
+    arena->size = size;
+    return true;
+}
+
+/**
+ * Allocate from an arena
+ */
+void *arena_alloc(Arena *arena, size_t size)
+{
+    size_t aligned = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    if (aligned > arena->size - arena->used)
+    {
+        return NULL;
+    }
+
+    void *ptr = arena->base + arena->used;
+    arena->used += aligned;
+    return ptr;
+}
+
+/**
+ * Release everything allocated from an arena
+ */
+void arena_reset(Arena *arena)
+{
+    arena->used = 0;
+}
+
+/**
+ * Destroy an arena
+ */
+void arena_destroy(Arena *arena)
+{
+    mem_buffer_free(&arena->buffer);
+    memset(arena, 0, sizeof(*arena));
+}
@@ -0,0 +1,251 @@
+/**
+ * Slab Allocator Implementation
+ *
+ * This file implements the per-thread slab allocator. Slabs are 64 KB,
+ * 64 KB aligned and carved from 2 MB chunks. The slab header at the start
+ * of each slab records the owning cache and object size, so a free finds
+ * both by masking the object address. Frees from the owning thread go on
+ * a local free list; frees from other threads are pushed onto the owner's
+ * remote list with a compare-and-swap and drained in one exchange when the
+ * owner runs out of local objects.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+/* Include our header files */
+#include "alloc_slab.h"
+#include "mem_buffer.h"
+
+/* Define constants */
+#define SLAB_SIZE (64 * 1024)
+#define SLAB_CHUNK_SLABS 32 /* 2 MB mapped at a time */
+#define SLAB_HEADER_SIZE 64
+#define SLAB_MIN_SHIFT 4    /* Smallest class is 16 bytes */
+#define SLAB_CLASSES 11     /* 16 B .. 16 KB */
+#define SLAB_LINE_SIZE 64
+
+/* Free object, linked through its first word */
+typedef struct SlabObject
+{
+    struct SlabObject *next;
+} SlabObject;
+
+/* Header at the start of every slab */
+typedef struct
+{
+    SlabCache *owner;
+    int size_class;
+} SlabHeader;
+
+/* Mapped chunk, kept so the cache can unmap it */
+typedef struct SlabChunk
+{
+    MemBuffer buffer;
+    struct SlabChunk *next;
+} SlabChunk;
+
+struct SlabCache
+{
+    SlabObject *free_list[SLAB_CLASSES];
+    char *next_slab;    /* Next unused slab in the current chunk */
+    int slabs_left;
+    SlabChunk *chunks;
+    size_t footprint;
+    /* Written by other threads, kept off the owner's hot line */
+    SlabObject *remote __attribute__((aligned(SLAB_LINE_SIZE)));
+};
+
+/* Private helper function prototypes */
+static int size_class(size_t size);
+static void drain_remote(SlabCache *cache);
+static bool refill(SlabCache *cache, int cls);
+
+/**
+ * Create a cache for the calling thread
+ */
+SlabCache *slab_cache_create(void)
+{
+    void *mem = NULL;
+    if (posix_memalign(&mem, SLAB_LINE_SIZE, sizeof(SlabCache)) != 0)
+    {
+        return NULL;
+    }
+
+    memset(mem, 0, sizeof(SlabCache));
+    return mem;
+}
+
+/**
+ * Allocate an object
+ */
+void *slab_alloc(SlabCache *cache, size_t size)
+{
+    if (size > SLAB_MAX_OBJECT)
+    {
+        return malloc(size);
+    }
+
+    int cls = size_class(size);
+    SlabObject *obj = cache->free_list[cls];
+    if (!obj)
+    {
+        drain_remote(cache);
+        obj = cache->free_list[cls];
+        if (!obj)
+        {
+            if (!refill(cache, cls))
+            {
+                return NULL;
+            }
+            obj = cache->free_list[cls];
+        }
+    }
+
+    cache->free_list[cls] = obj->next;
+    return obj;
+}
+
+/**
+ * Free an object
+ */
+void slab_free(SlabCache *cache, void *ptr, size_t size)
+{
+    if (!ptr)
+    {
+        return;
+    }
+    if (size > SLAB_MAX_OBJECT)
+    {
+        free(ptr);
+        return;
+    }
+
+    SlabHeader *header = (SlabHeader *)((uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+    SlabObject *obj = ptr;
+    SlabCache *owner = header->owner;
+
+    if (owner == cache)
+    {
+        obj->next = cache->free_list[header->size_class];
+        cache->free_list[header->size_class] = obj;
+        return;
+    }
+
+    /* Only the owner takes from the remote list, and it takes all of it, so no ABA */
+    SlabObject *head = __atomic_load_n(&owner->remote, __ATOMIC_RELAXED);
+    do
+    {
+        obj->next = head;
+    } while (!__atomic_compare_exchange_n(&owner->remote, &head, obj, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+/**
+ * Report the memory mapped by a cache
+ */
+size_t slab_cache_footprint(const SlabCache *cache)
+{
+    return __atomic_load_n(&cache->footprint, __ATOMIC_RELAXED);
+}
+
+/**
+ * Destroy a cache
+ */
+void slab_cache_destroy(SlabCache *cache)
+{
+    if (!cache)
+    {
+        return;
+    }
+
+    SlabChunk *chunk = cache->chunks;
+    while (chunk)
+    {
+        SlabChunk *next = chunk->next;
+        mem_buffer_free(&chunk->buffer);
+        free(chunk);
+        chunk = next;
+    }
+    free(cache);
+}
+
+/* Private helper function: smallest power-of-two class holding size bytes */
+static int size_class(size_t size)
+{
+    if (size <= (1U << SLAB_MIN_SHIFT))
+    {
+        return 0;
+    }
+    return 64 - __builtin_clzll((unsigned long long)(size - 1)) - SLAB_MIN_SHIFT;
+}
+
+/* Private helper function: move objects freed by other threads to the local lists */
+static void drain_remote(SlabCache *cache)
+{
+    if (!__atomic_load_n(&cache->remote, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+
+    SlabObject *obj = __atomic_exchange_n(&cache->remote, NULL, __ATOMIC_ACQUIRE);
+    while (obj)
+    {
+        SlabObject *next = obj->next;
+        SlabHeader *header = (SlabHeader *)((uintptr_t)obj & ~(uintptr_t)(SLAB_SIZE - 1));
+        obj->next = cache->free_list[header->size_class];
+        cache->free_list[header->size_class] = obj;
+        obj = next;
+    }
+}
+
+/* Private helper function: carve a new slab into objects of the given class */
+static bool refill(SlabCache *cache, int cls)
+{
+    if (cache->slabs_left == 0)
+    {
+        SlabChunk *chunk = calloc(1, sizeof(SlabChunk));
+        if (!chunk)
+        {
+            return false;
+        }
+        if (!mem_buffer_alloc(&chunk->buffer, (size_t)SLAB_SIZE * SLAB_CHUNK_SLABS, SLAB_SIZE))
+        {
+            free(chunk);
+            return false;
+        }
+
+        chunk->next = cache->chunks;
+        cache->chunks = chunk;
+        cache->next_slab = chunk->buffer.data;
+        cache->slabs_left = SLAB_CHUNK_SLABS;
+        __atomic_store_n(&cache->footprint, cache->footprint + chunk->buffer.size, __ATOMIC_RELAXED);
+    }
+
+    char *slab = cache->next_slab;
+    cache->next_slab += SLAB_SIZE;
+    cache->slabs_left--;
+
+    SlabHeader *header = (SlabHeader *)slab;
+    header->owner = cache;
+    header->size_class = cls;
+
+    /* Link the objects in address order so fresh slabs are handed out sequentially */
+    size_t object_size = (size_t)1 << (cls + SLAB_MIN_SHIFT);
+    size_t first = object_size > SLAB_HEADER_SIZE ? object_size : SLAB_HEADER_SIZE;
+    SlabObject *head = NULL;
+    for (size_t offset = SLAB_SIZE - object_size; offset >= first; offset -= object_size)
+    {
+        SlabObject *obj = (SlabObject *)(slab + offset);
+        obj->next = head;
+        head = obj;
+    }
+
+    cache->free_list[cls] = head;
+    return head != NULL;
+}
@@ -0,0 +1,970 @@
+/**
+ * Allocator Benchmark Implementation
+ *
+ * This file implements the allocator benchmark. Worker threads run one
+ * scenario against one allocator at a time:
+ *   fixed   - allocate a batch of one size, then free the batch
+ *   dist    - the same with sizes drawn from the size distribution
+ *   xthread - producers allocate and hand objects to consumers that free
+ *             them, so every free crosses threads
+ *   churn   - hold a large set of live objects and replace random ones,
+ *             which is what fragments long-running heaps
+ * Sizes come from a precomputed table so drawing them costs one load. One
+ * operation in ALLOC_SAMPLE_EVERY is timed individually for percentiles,
+ * while the main thread samples RSS and live bytes for the fragmentation
+ * picture over time.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Include our header files */
+#include "alloc_test.h"
+#include "alloc_arena.h"
+#include "alloc_slab.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "topology.h"
+
+/* Define constants */
+#define ALLOC_DEFAULT_SIZE 64
+#define ALLOC_DEFAULT_LIVE (256ULL << 20)
+#define ALLOC_MAX_THREADS 256
+#define ALLOC_MAX_BINS 64
+#define ALLOC_SIZE_TABLE 4096              /* Power of two */
+#define ALLOC_BATCH 64
+#define ALLOC_SAMPLE_EVERY 16              /* Power of two */
+#define ALLOC_MAX_SAMPLES (1 << 18)        /* Per thread and kind, kept as a ring */
+#define ALLOC_ARENA_SIZE (64ULL << 20)
+#define ALLOC_RING_SIZE 1024               /* Power of two */
+#define ALLOC_MIN_SLOTS 1024
+#define ALLOC_MAX_SLOTS (1 << 22)
+#define ALLOC_MIN_RUN_NS 250000000ULL
+#define ALLOC_MAX_RUN_NS 30000000000ULL
+#define ALLOC_RSS_SAMPLES 10
+#define ALLOC_LINE_SIZE 64
+#define ALLOC_SEED 0x9E3779B97F4A7C15ULL
+
+typedef enum
+{
+    ALLOCATOR_MALLOC,
+    ALLOCATOR_ARENA,
+    ALLOCATOR_SLAB,
+    ALLOCATOR_COUNT
+} AllocatorKind;
+
+typedef enum
+{
+    SCENARIO_FIXED,
+    SCENARIO_DIST,
+    SCENARIO_XTHREAD,
+    SCENARIO_CHURN,
+    SCENARIO_COUNT
+} AllocScenario;
+
+static const char *const allocator_names[ALLOCATOR_COUNT] = {"malloc", "arena", "slab"};
+static const char *const scenario_names[SCENARIO_COUNT] = {"fixed", "dist", "xthread", "churn"};
+
+/* Built-in distribution, weighted towards the small objects typical of real heaps */
+static const size_t default_sizes[] = {16, 32, 48, 64, 96, 128, 256, 512, 1024, 4096, 16384};
+static const unsigned long default_weights[] = {20, 20, 10, 12, 6, 8, 8, 6, 4, 4, 2};
+
+/* Allocation size distribution */
+typedef struct
+{
+    size_t sizes[ALLOC_MAX_BINS];
+    unsigned long weights[ALLOC_MAX_BINS];
+    int count;
+} SizeDist;
+
+/* Object in flight or held in a churn slot */
+typedef struct
+{
+    void *ptr;
+    size_t size;
+} AllocItem;
+
+/* Single-producer single-consumer ring for the cross-thread scenario */
+typedef struct
+{
+    AllocItem items[ALLOC_RING_SIZE];
+    uint64_t head __attribute__((aligned(ALLOC_LINE_SIZE))); /* Written by the consumer */
+    uint64_t tail __attribute__((aligned(ALLOC_LINE_SIZE))); /* Written by the producer */
+    int done;
+} AllocRing;
+
+/* State shared by the workers of one run */
+typedef struct
+{
+    AllocatorKind allocator;
+    AllocScenario scenario;
+    const size_t *sizes;   /* ALLOC_SIZE_TABLE entries */
+    size_t slots;          /* Live objects per thread for churn */
+    AllocRing *rings;      /* One per producer-consumer pair */
+    pthread_mutex_t gate;  /* Held while the threads are created */
+    int cancel;
+    int stop;
+} AllocRun;
+
+/* Per-thread state, one cache line apart */
+typedef struct
+{
+    pthread_t thread;
+    int index;
+    int cpu;
+    AllocRun *run;
+    Arena arena;
+    SlabCache *slab;
+    uint64_t ops;
+    uint64_t active_ns;
+    int64_t live_bytes;        /* Sampled by the main thread */
+    uint64_t *alloc_samples;
+    uint64_t alloc_seen;
+    uint64_t *free_samples;
+    uint64_t free_seen;
+    bool failed;
+} __attribute__((aligned(ALLOC_LINE_SIZE))) AllocWorker;
+
+/* Outcome of one allocator and scenario run */
+typedef struct
+{
+    double ops_per_sec;
+    LatencySummary alloc_lat;
+    LatencySummary free_lat;
+    double peak_rss_mb;
+    double rss_mb;
+    double live_mb;
+} AllocResult;
+
+/* Private helper function prototypes */
+static bool load_histogram(const char *path, SizeDist *dist);
+static void build_table(const SizeDist *dist, size_t *table);
+static size_t common_size(const SizeDist *dist);
+static double mean_size(const SizeDist *dist);
+static bool run_once(AllocRun *run, AllocWorker *workers, int count, uint64_t run_ns, AllocResult *result);
+static void *alloc_worker(void *arg);
+static void run_batches(AllocWorker *worker);
+static void run_producer(AllocWorker *worker);
+static void run_consumer(AllocWorker *worker);
+static void run_churn(AllocWorker *worker);
+static void *worker_alloc(AllocWorker *worker, size_t size);
+static void worker_free(AllocWorker *worker, void *ptr, size_t size);
+static void touch(void *ptr, size_t size);
+static void record(uint64_t *samples, uint64_t *seen, uint64_t value);
+static bool summarize(AllocWorker *workers, int count, bool use_alloc, LatencySummary *summary);
+static size_t read_rss(void);
+static uint64_t next_random(uint64_t *state);
+static void sleep_ns(uint64_t ns);
+
+/**
+ * Run the allocator benchmark
+ */
+bool alloc_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    SizeDist dist;
+    memset(&dist, 0, sizeof(dist));
+    size_t fixed_size = ALLOC_DEFAULT_SIZE;
+    if (opts->alloc_size[0] != '\0' && !bench_parse_size(opts->alloc_size, &fixed_size))
+    {
+        /* Not a size, so it names a histogram file */
+        if (!load_histogram(opts->alloc_size, &dist))
+        {
+            return false;
+        }
+        fixed_size = common_size(&dist);
+    }
+    if (dist.count == 0)
+    {
+        dist.count = (int)(sizeof(default_sizes) / sizeof(default_sizes[0]));
+        memcpy(dist.sizes, default_sizes, sizeof(default_sizes));
+        memcpy(dist.weights, default_weights, sizeof(default_weights));
+    }
+    if (fixed_size == 0)
+    {
+        logger_error("Alloc: invalid allocation size '%s'", opts->alloc_size);
+        return false;
+    }
+
+    size_t live_target = ALLOC_DEFAULT_LIVE;
+    if (opts->size[0] != '\0' && !bench_parse_size(opts->size, &live_target))
+    {
+        logger_error("Alloc: invalid size '%s'", opts->size);
+        return false;
+    }
+    size_t available = bench_mem_available() / 2;
+    if (available > 0 && live_target > available)
+    {
+        logger_warning("Alloc: %zu MB of live data requested, using %zu MB", live_target >> 20, available >> 20);
+        live_target = available;
+    }
+
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        logger_error("Alloc: cannot read CPU topology");
+        return false;
+    }
+
+    int thread_count = opts->threads > 0 ? opts->threads : topo.count;
+    if (thread_count > ALLOC_MAX_THREADS)
+    {
+        thread_count = ALLOC_MAX_THREADS;
+    }
+    /* The cross-thread scenario needs at least one pair */
+    int worker_count = thread_count < 2 ? 2 : thread_count;
+
+    size_t slots = (size_t)((double)live_target / (double)thread_count / mean_size(&dist));
+    if (slots < ALLOC_MIN_SLOTS)
+        slots = ALLOC_MIN_SLOTS;
+    if (slots > ALLOC_MAX_SLOTS)
+        slots = ALLOC_MAX_SLOTS;
+
+    size_t *fixed_table = malloc(ALLOC_SIZE_TABLE * sizeof(size_t));
+    size_t *dist_table = malloc(ALLOC_SIZE_TABLE * sizeof(size_t));
+    AllocWorker *workers = aligned_alloc(ALLOC_LINE_SIZE, (size_t)worker_count * sizeof(AllocWorker));
+    MemBuffer samples;
+    size_t sample_bytes = (size_t)worker_count * 2 * ALLOC_MAX_SAMPLES * sizeof(uint64_t);
+    if (!fixed_table || !dist_table || !workers || !mem_buffer_alloc(&samples, sample_bytes, 0))
+    {
+        logger_error("Alloc: setup failed");
+        free(fixed_table);
+        free(dist_table);
+        free(workers);
+        topology_free(&topo);
+        return false;
+    }
+
+    /* Fault the sample buffers in now so they do not show up as allocator RSS */
+    memset(samples.data, 0, sample_bytes);
+    memset(workers, 0, (size_t)worker_count * sizeof(AllocWorker));
+    for (int i = 0; i < worker_count; i++)
+    {
+        workers[i].index = i;
+        workers[i].cpu = topo.cpus[i % topo.count].cpu;
+        workers[i].alloc_samples = (uint64_t *)samples.data + (size_t)i * 2 * ALLOC_MAX_SAMPLES;
+        workers[i].free_samples = workers[i].alloc_samples + ALLOC_MAX_SAMPLES;
+    }
+    topology_free(&topo);
+
+    for (int i = 0; i < ALLOC_SIZE_TABLE; i++)
+    {
+        fixed_table[i] = fixed_size;
+    }
+    build_table(&dist, dist_table);
+
+    /* Spread the requested duration over every run that takes place */
+    int run_count = SCENARIO_COUNT * ALLOCATOR_COUNT - 2;
+    uint64_t run_ns = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)run_count;
+    if (run_ns < ALLOC_MIN_RUN_NS)
+        run_ns = ALLOC_MIN_RUN_NS;
+    if (run_ns > ALLOC_MAX_RUN_NS)
+        run_ns = ALLOC_MAX_RUN_NS;
+
+    logger_info("Alloc: %d threads, fixed size %zu bytes, %d size bins (mean %.0f bytes), "
+                "%zu churn objects per thread, %.2f s per run",
+                thread_count, fixed_size, dist.count, mean_size(&dist), slots, (double)run_ns / 1e9);
+
+    bool ok = true;
+    for (int s = 0; s < SCENARIO_COUNT && ok; s++)
+    {
+        for (int a = 0; a < ALLOCATOR_COUNT && ok; a++)
+        {
+            /* A bump arena cannot take back individual objects */
+            if (a == ALLOCATOR_ARENA && (s == SCENARIO_XTHREAD || s == SCENARIO_CHURN))
+            {
+                continue;
+            }
+
+            AllocRun run;
+            memset(&run, 0, sizeof(run));
+            run.allocator = (AllocatorKind)a;
+            run.scenario = (AllocScenario)s;
+            run.sizes = s == SCENARIO_FIXED ? fixed_table : dist_table;
+            run.slots = slots;
+            pthread_mutex_init(&run.gate, NULL);
+
+            int count = s == SCENARIO_XTHREAD ? worker_count - worker_count % 2 : thread_count;
+            AllocResult result;
+            ok = run_once(&run, workers, count, run_ns, &result);
+            pthread_mutex_destroy(&run.gate);
+            if (!ok)
+            {
+                logger_error("Alloc: %s %s run failed", allocator_names[a], scenario_names[s]);
+                break;
+            }
+
+            logger_info("Alloc: %-6s %-7s %8.2f Mops/s, alloc p50/p99 %lu/%lu ns, free p50/p99 %lu/%lu ns, "
+                        "peak RSS %.1f MB, live %.1f MB",
+                        allocator_names[a], scenario_names[s], result.ops_per_sec / 1e6,
+                        (unsigned long)result.alloc_lat.p50, (unsigned long)result.alloc_lat.p99,
+                        (unsigned long)result.free_lat.p50, (unsigned long)result.free_lat.p99,
+                        result.peak_rss_mb, result.live_mb);
+
+            char frag[32] = "";
+            if (s == SCENARIO_CHURN && result.live_mb > 0.0)
+            {
+                snprintf(frag, sizeof(frag), ",frag_ratio=%.3f", result.rss_mb / result.live_mb);
+            }
+            logger_metric("mem_alloc", "allocator=%s,scenario=%s,threads=%d,ops_per_sec=%.0f,"
+                          "alloc_p50_ns=%lu,alloc_p99_ns=%lu,free_p50_ns=%lu,free_p99_ns=%lu,"
+                          "peak_rss_mb=%.1f,live_mb=%.1f%s",
+                          allocator_names[a], scenario_names[s], count, result.ops_per_sec,
+                          (unsigned long)result.alloc_lat.p50, (unsigned long)result.alloc_lat.p99,
+                          (unsigned long)result.free_lat.p50, (unsigned long)result.free_lat.p99,
+                          result.peak_rss_mb, result.live_mb, frag);
+        }
+    }
+
+    mem_buffer_free(&samples);
+    free(workers);
+    free(dist_table);
+    free(fixed_table);
+    return ok;
+}
+
+/* Private helper function: read "size weight" lines into a distribution */
+static bool load_histogram(const char *path, SizeDist *dist)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        logger_error("Alloc: '%s' is neither a size nor a readable histogram file", path);
+        return false;
+    }
+
+    char line[256];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        line_no++;
+        char *comment = strchr(line, '#');
+        if (comment)
+        {
+            *comment = '\0';
+        }
+
+        char size_str[64];
+        unsigned long weight;
+        int fields = sscanf(line, "%63s %lu", size_str, &weight);
+        if (fields <= 0)
+        {
+            continue;
+        }
+
+        size_t size;
+        if (fields != 2 || !bench_parse_size(size_str, &size) || size == 0)
+        {
+            logger_error("Alloc: %s:%d: expected \"size weight\"", path, line_no);
+            ok = false;
+        }
+        else if (dist->count == ALLOC_MAX_BINS)
+        {
+            logger_error("Alloc: %s: more than %d size bins", path, ALLOC_MAX_BINS);
+            ok = false;
+        }
+        else if (weight > 0)
+        {
+            dist->sizes[dist->count] = size;
+            dist->weights[dist->count] = weight;
+            dist->count++;
+        }
+    }
+    fclose(file);
+
+    if (ok && dist->count == 0)
+    {
+        logger_error("Alloc: %s: no sizes with a non-zero weight", path);
+        ok = false;
+    }
+    return ok;
+}
+
+/* Private helper function: fill the size table by sampling the distribution */
+static void build_table(const SizeDist *dist, size_t *table)
+{
+    unsigned long total = 0;
+    for (int i = 0; i < dist->count; i++)
+    {
+        total += dist->weights[i];
+    }
+
+    uint64_t state = ALLOC_SEED;
+    for (int i = 0; i < ALLOC_SIZE_TABLE; i++)
+    {
+        unsigned long pick = (unsigned long)(next_random(&state) % total);
+        int bin = 0;
+        while (pick >= dist->weights[bin])
+        {
+            pick -= dist->weights[bin];
+            bin++;
+        }
+        table[i] = dist->sizes[bin];
+    }
+}
+
+/* Private helper function: most heavily weighted size */
+static size_t common_size(const SizeDist *dist)
+{
+    int best = 0;
+    for (int i = 1; i < dist->count; i++)
+    {
+        if (dist->weights[i] > dist->weights[best])
+        {
+            best = i;
+        }
+    }
+    return dist->sizes[best];
+}
+
+/* Private helper function: weighted mean allocation size */
+static double mean_size(const SizeDist *dist)
+{
+    double sum = 0.0, total = 0.0;
+    for (int i = 0; i < dist->count; i++)
+    {
+        sum += (double)dist->sizes[i] * (double)dist->weights[i];
+        total += (double)dist->weights[i];
+    }
+    return total > 0.0 ? sum / total : (double)ALLOC_DEFAULT_SIZE;
+}
+
+/* Private helper function: run one scenario against one allocator */
+static bool run_once(AllocRun *run, AllocWorker *workers, int count, uint64_t run_ns, AllocResult *result)
+{
+    memset(result, 0, sizeof(*result));
+
+    /* Allocator state is set up here and torn down after the join, when no
+     * thread can still free into it; the memory is first touched by the workers */
+    bool ok = true;
+    for (int i = 0; i < count; i++)
+    {
+        AllocWorker *worker = &workers[i];
+        worker->run = run;
+        worker->ops = 0;
+        worker->active_ns = 0;
+        worker->live_bytes = 0;
+        worker->alloc_seen = 0;
+        worker->free_seen = 0;
+        worker->failed = false;
+        worker->slab = NULL;
+        memset(&worker->arena, 0, sizeof(worker->arena));
+
+        if (run->allocator == ALLOCATOR_ARENA && !arena_init(&worker->arena, ALLOC_ARENA_SIZE))
+            ok = false;
+        if (run->allocator == ALLOCATOR_SLAB && !(worker->slab = slab_cache_create()))
+            ok = false;
+    }
+    if (ok && run->scenario == SCENARIO_XTHREAD)
+    {
+        size_t ring_bytes = (size_t)(count / 2) * sizeof(AllocRing);
+        run->rings = aligned_alloc(ALLOC_LINE_SIZE, ring_bytes);
+        if (run->rings)
+            memset(run->rings, 0, ring_bytes);
+        else
+            ok = false;
+    }
+
+    size_t baseline = read_rss();
+    int started = 0;
+    if (ok)
+    {
+        pthread_mutex_lock(&run->gate);
+        for (int i = 0; i < count; i++)
+        {
+            if (pthread_create(&workers[i].thread, NULL, alloc_worker, &workers[i]) != 0)
+            {
+                logger_error("Alloc: started only %d of %d threads", started, count);
+                run->cancel = 1;
+                ok = false;
+                break;
+            }
+            started++;
+        }
+        pthread_mutex_unlock(&run->gate);
+    }
+
+    if (ok)
+    {
+        uint64_t start = bench_now_ns();
+        for (int s = 1; s <= ALLOC_RSS_SAMPLES; s++)
+        {
+            uint64_t target = start + run_ns * (uint64_t)s / ALLOC_RSS_SAMPLES;
+            uint64_t now = bench_now_ns();
+            if (target > now)
+            {
+                sleep_ns(target - now);
+            }
+
+            size_t rss = read_rss();
+            int64_t live = 0;
+            for (int i = 0; i < count; i++)
+            {
+                live += __atomic_load_n(&workers[i].live_bytes, __ATOMIC_RELAXED);
+            }
+
+            result->rss_mb = rss > baseline ? (double)(rss - baseline) / 1048576.0 : 0.0;
+            result->live_mb = live > 0 ? (double)live / 1048576.0 : 0.0;
+            if (result->rss_mb > result->peak_rss_mb)
+            {
+                result->peak_rss_mb = result->rss_mb;
+            }
+            logger_metric("mem_alloc_rss", "allocator=%s,scenario=%s,t_ms=%lu,rss_mb=%.1f,live_mb=%.1f",
+                          allocator_names[run->allocator], scenario_names[run->scenario],
+                          (unsigned long)((bench_now_ns() - start) / 1000000ULL), result->rss_mb, result->live_mb);
+        }
+    }
+
+    __atomic_store_n(&run->stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    if (ok)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (workers[i].failed)
+            {
+                logger_error("Alloc: %s returned NULL in thread %d", allocator_names[run->allocator], i);
+                ok = false;
+            }
+            if (workers[i].active_ns > 0)
+            {
+                result->ops_per_sec += (double)workers[i].ops * 1e9 / (double)workers[i].active_ns;
+            }
+        }
+        summarize(workers, count, true, &result->alloc_lat);
+        summarize(workers, count, false, &result->free_lat);
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (run->allocator == ALLOCATOR_ARENA)
+            arena_destroy(&workers[i].arena);
+        slab_cache_destroy(workers[i].slab);
+    }
+    free(run->rings);
+    run->rings = NULL;
+
+    /* Give freed heap memory back so the next run starts from a clean baseline */
+    malloc_trim(0);
+    return ok;
+}
+
+/* Private helper function: worker thread, runs the scenario until told to stop */
+static void *alloc_worker(void *arg)
+{
+    AllocWorker *worker = arg;
+    AllocRun *run = worker->run;
+    bench_pin_cpu(worker->cpu);
+
+    /* Wait until every thread exists, then bail out if one could not be started */
+    pthread_mutex_lock(&run->gate);
+    pthread_mutex_unlock(&run->gate);
+    if (__atomic_load_n(&run->cancel, __ATOMIC_ACQUIRE))
+    {
+        return NULL;
+    }
+
+    switch (run->scenario)
+    {
+    case SCENARIO_FIXED:
+    case SCENARIO_DIST:
+        run_batches(worker);
+        break;
+    case SCENARIO_XTHREAD:
+        if (worker->index % 2 == 0)
+            run_producer(worker);
+        else
+            run_consumer(worker);
+        break;
+    case SCENARIO_CHURN:
+        run_churn(worker);
+        break;
+    default:
+        break;
+    }
+    return NULL;
+}
+
+/* Private helper function: allocate a batch, then free it in allocation order */
+static void run_batches(AllocWorker *worker)
+{
+    AllocRun *run = worker->run;
+    AllocItem batch[ALLOC_BATCH];
+    unsigned pos = (unsigned)worker->index * 977U;
+    unsigned tick = 0;
+    uint64_t start = bench_now_ns();
+
+    while (!__atomic_load_n(&run->stop, __ATOMIC_RELAXED))
+    {
+        int64_t live = 0;
+        for (int i = 0; i < ALLOC_BATCH; i++)
+        {
+            size_t size = run->sizes[pos++ & (ALLOC_SIZE_TABLE - 1)];
+            void *ptr;
+            if ((tick++ & (ALLOC_SAMPLE_EVERY - 1)) == 0)
+            {
+                uint64_t t0 = bench_now_ns();
+                ptr = worker_alloc(worker, size);
+                record(worker->alloc_samples, &worker->alloc_seen, bench_now_ns() - t0);
+            }
+            else
+            {
+                ptr = worker_alloc(worker, size);
+            }
+            if (!ptr && run->allocator == ALLOCATOR_ARENA && worker->arena.used > 0)
+            {
+                /* The objects of this batch are only "freed" below, so starting over is safe */
+                arena_reset(&worker->arena);
+                ptr = worker_alloc(worker, size);
+            }
+            if (!ptr)
+            {
+                worker->failed = true;
+                worker->active_ns = bench_now_ns() - start;
+                return;
+            }
+
+            touch(ptr, size);
+            batch[i].ptr = ptr;
+            batch[i].size = size;
+            live += (int64_t)size;
+        }
+        __atomic_store_n(&worker->live_bytes, live, __ATOMIC_RELAXED);
+
+        for (int i = 0; i < ALLOC_BATCH; i++)
+        {
+            if ((tick++ & (ALLOC_SAMPLE_EVERY - 1)) == 0)
+            {
+                uint64_t t0 = bench_now_ns();
+                worker_free(worker, batch[i].ptr, batch[i].size);
+                record(worker->free_samples, &worker->free_seen, bench_now_ns() - t0);
+            }
+            else
+            {
+                worker_free(worker, batch[i].ptr, batch[i].size);
+            }
+        }
+        if (run->allocator == ALLOCATOR_ARENA)
+        {
+            arena_reset(&worker->arena);
+        }
+        worker->ops += ALLOC_BATCH;
+    }
+
+    worker->active_ns = bench_now_ns() - start;
+    __atomic_store_n(&worker->live_bytes, 0, __ATOMIC_RELAXED);
+}
+
+/* Private helper function: allocate objects and pass them to the paired consumer */
+static void run_producer(AllocWorker *worker)
+{
+    AllocRun *run = worker->run;
+    AllocRing *ring = &run->rings[worker->index / 2];
+    unsigned pos = (unsigned)worker->index * 977U;
+    unsigned tick = 0;
+    uint64_t tail = 0;
+    uint64_t start = bench_now_ns();
+
+    while (!__atomic_load_n(&run->stop, __ATOMIC_RELAXED))
+    {
+        size_t size = run->sizes[pos++ & (ALLOC_SIZE_TABLE - 1)];
+        void *ptr;
+        if ((tick++ & (ALLOC_SAMPLE_EVERY - 1)) == 0)
+        {
+            uint64_t t0 = bench_now_ns();
+            ptr = worker_alloc(worker, size);
+            record(worker->alloc_samples, &worker->alloc_seen, bench_now_ns() - t0);
+        }
+        else
+        {
+            ptr = worker_alloc(worker, size);
+        }
+        if (!ptr)
+        {
+            worker->failed = true;
+            break;
+        }
+        touch(ptr, size);
+
+        while (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == ALLOC_RING_SIZE)
+        {
+            if (__atomic_load_n(&run->stop, __ATOMIC_RELAXED))
+            {
+                worker_free(worker, ptr, size);
+                ptr = NULL;
+                break;
+            }
+            sched_yield();
+        }
+        if (!ptr)
+        {
+            break;
+        }
+
+        ring->items[tail & (ALLOC_RING_SIZE - 1)].ptr = ptr;
+        ring->items[tail & (ALLOC_RING_SIZE - 1)].size = size;
+        __atomic_store_n(&ring->tail, ++tail, __ATOMIC_RELEASE);
+        __atomic_store_n(&worker->live_bytes, worker->live_bytes + (int64_t)size, __ATOMIC_RELAXED);
+        worker->ops++;
+    }
+
+    worker->active_ns = bench_now_ns() - start;
+    __atomic_store_n(&ring->done, 1, __ATOMIC_RELEASE);
+}
+
+/* Private helper function: free whatever the paired producer hands over */
+static void run_consumer(AllocWorker *worker)
+{
+    AllocRing *ring = &worker->run->rings[worker->index / 2];
+    unsigned tick = 0;
+    uint64_t head = 0;
+
+    for (;;)
+    {
+        uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+        if (head == tail)
+        {
+            /* Done is published after the last tail update, so recheck the tail */
+            if (__atomic_load_n(&ring->done, __ATOMIC_ACQUIRE) &&
+                __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head)
+            {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+
+        while (head != tail)
+        {
+            AllocItem item = ring->items[head & (ALLOC_RING_SIZE - 1)];
+            if ((tick++ & (ALLOC_SAMPLE_EVERY - 1)) == 0)
+            {
+                uint64_t t0 = bench_now_ns();
+                worker_free(worker, item.ptr, item.size);
+                record(worker->free_samples, &worker->free_seen, bench_now_ns() - t0);
+            }
+            else
+            {
+                worker_free(worker, item.ptr, item.size);
+            }
+            __atomic_store_n(&worker->live_bytes, worker->live_bytes - (int64_t)item.size, __ATOMIC_RELAXED);
+            __atomic_store_n(&ring->head, ++head, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+/* Private helper function: keep a large live set and replace random objects */
+static void run_churn(AllocWorker *worker)
+{
+    AllocRun *run = worker->run;
+    AllocItem *slots = calloc(run->slots, sizeof(AllocItem));
+    if (!slots)
+    {
+        worker->failed = true;
+        return;
+    }
+
+    unsigned pos = (unsigned)worker->index * 977U;
+    uint64_t state = ALLOC_SEED ^ ((uint64_t)worker->index << 32);
+    int64_t live = 0;
+    for (size_t i = 0; i < run->slots; i++)
+    {
+        size_t size = run->sizes[pos++ & (ALLOC_SIZE_TABLE - 1)];
+        void *ptr = worker_alloc(worker, size);
+        if (!ptr)
+        {
+            worker->failed = true;
+            break;
+        }
+        touch(ptr, size);
+        slots[i].ptr = ptr;
+        slots[i].size = size;
+        live += (int64_t)size;
+    }
+    __atomic_store_n(&worker->live_bytes, live, __ATOMIC_RELAXED);
+
+    unsigned tick = 0;
+    uint64_t start = bench_now_ns();
+    while (!worker->failed && !__atomic_load_n(&run->stop, __ATOMIC_RELAXED))
+    {
+        for (int n = 0; n < ALLOC_BATCH; n++)
+        {
+            AllocItem *slot = &slots[next_random(&state) % run->slots];
+            size_t size = run->sizes[pos++ & (ALLOC_SIZE_TABLE - 1)];
+            void *ptr;
+            if ((tick++ & (ALLOC_SAMPLE_EVERY - 1)) == 0)
+            {
+                uint64_t t0 = bench_now_ns();
+                worker_free(worker, slot->ptr, slot->size);
+                uint64_t t1 = bench_now_ns();
+                ptr = worker_alloc(worker, size);
+                uint64_t t2 = bench_now_ns();
+                record(worker->free_samples, &worker->free_seen, t1 - t0);
+                record(worker->alloc_samples, &worker->alloc_seen, t2 - t1);
+            }
+            else
+            {
+                worker_free(worker, slot->ptr, slot->size);
+                ptr = worker_alloc(worker, size);
+            }
+
+            live += (int64_t)size - (int64_t)slot->size;
+            slot->ptr = ptr;
+            slot->size = size;
+            if (!ptr)
+            {
+                worker->failed = true;
+                break;
+            }
+            touch(ptr, size);
+        }
+        worker->ops += ALLOC_BATCH;
+        __atomic_store_n(&worker->live_bytes, live, __ATOMIC_RELAXED);
+    }
+    worker->active_ns = bench_now_ns() - start;
+
+    for (size_t i = 0; i < run->slots; i++)
+    {
+        if (slots[i].ptr)
+        {
+            worker_free(worker, slots[i].ptr, slots[i].size);
+        }
+    }
+    free(slots);
+    __atomic_store_n(&worker->live_bytes, 0, __ATOMIC_RELAXED);
+}
+
+/* Private helper function: allocate from the allocator under test */
+static void *worker_alloc(AllocWorker *worker, size_t size)
+{
+    switch (worker->run->allocator)
+    {
+    case ALLOCATOR_ARENA:
+        return arena_alloc(&worker->arena, size);
+    case ALLOCATOR_SLAB:
+        return slab_alloc(worker->slab, size);
+    default:
+        return malloc(size);
+    }
+}
+
+/* Private helper function: free to the allocator under test (a no-op for the arena) */
+static void worker_free(AllocWorker *worker, void *ptr, size_t size)
+{
+    switch (worker->run->allocator)
+    {
+    case ALLOCATOR_ARENA:
+        break;
+    case ALLOCATOR_SLAB:
+        slab_free(worker->slab, ptr, size);
+        break;
+    default:
+        free(ptr);
+        break;
+    }
+}
+
+/* Private helper function: write one byte per page, as a user of the object would fault it in */
+static void touch(void *ptr, size_t size)
+{
+    for (size_t offset = 0; offset < size; offset += 4096)
+    {
+        ((volatile char *)ptr)[offset] = (char)size;
+    }
+}
+
+/* Private helper function: store a latency sample, overwriting the oldest once full */
+static void record(uint64_t *samples, uint64_t *seen, uint64_t value)
+{
+    samples[*seen % ALLOC_MAX_SAMPLES] = value;
+    (*seen)++;
+}
+
+/* Private helper function: merge every thread's samples of one kind and summarize them */
+static bool summarize(AllocWorker *workers, int count, bool use_alloc, LatencySummary *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+
+    size_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t seen = use_alloc ? workers[i].alloc_seen : workers[i].free_seen;
+        total += seen < ALLOC_MAX_SAMPLES ? (size_t)seen : ALLOC_MAX_SAMPLES;
+    }
+    if (total == 0)
+    {
+        return false;
+    }
+
+    uint64_t *merged = malloc(total * sizeof(uint64_t));
+    if (!merged)
+    {
+        return false;
+    }
+
+    size_t offset = 0;
+    for (int i = 0; i < count; i++)
+    {
+        uint64_t seen = use_alloc ? workers[i].alloc_seen : workers[i].free_seen;
+        size_t n = seen < ALLOC_MAX_SAMPLES ? (size_t)seen : ALLOC_MAX_SAMPLES;
+        memcpy(merged + offset, use_alloc ? workers[i].alloc_samples : workers[i].free_samples,
+               n * sizeof(uint64_t));
+        offset += n;
+    }
+
+    bench_summarize(merged, total, summary);
+    free(merged);
+    return true;
+}
+
+/* Private helper function: resident set size of the process in bytes */
+static size_t read_rss(void)
+{
+    FILE *file = fopen("/proc/self/statm", "r");
+    if (!file)
+    {
+        return 0;
+    }
+
+    unsigned long size_pages = 0, resident_pages = 0;
+    int fields = fscanf(file, "%lu %lu", &size_pages, &resident_pages);
+    fclose(file);
+    return fields == 2 ? (size_t)resident_pages * (size_t)sysconf(_SC_PAGESIZE) : 0;
+}
+
+/* Private helper function: xorshift64* generator */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/* Private helper function: sleep for a number of nanoseconds */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}
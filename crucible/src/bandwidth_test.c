@@ -0,0 +1,770 @@
+/**
+ * Memory Bandwidth Test Implementation
+ *
+ * This file implements a STREAM-style bandwidth engine. Three arrays of
+ * doubles are split into per-thread slices; a pool of pinned worker
+ * threads runs one kernel over its slice between two barriers, and the
+ * main thread times the whole pass. Byte counts follow STREAM: copy and
+ * scale move two arrays, add and triad three, read and write one.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/* Include our header files */
+#include "bandwidth_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "numa.h"
+#include "perf_counter.h"
+#include "topology.h"
+
+/* Define constants */
+#define BW_DEFAULT_SIZE (512ULL << 20)
+#define BW_REPS 5
+#define BW_MAX_THREADS 256
+#define BW_SLICE_ELEMS 8 /* Slices start on 64-byte boundaries relative to the array */
+#define BW_SCALAR 3.0
+
+/* Kernels, in STREAM order followed by the one-array kernels */
+typedef enum
+{
+    BW_COPY,
+    BW_SCALE,
+    BW_ADD,
+    BW_TRIAD,
+    BW_READ,
+    BW_WRITE,
+    BW_KERNEL_COUNT
+} BwKernel;
+
+/* Instruction set variants */
+typedef enum
+{
+    BW_ISA_SCALAR,
+    BW_ISA_AVX2,
+    BW_ISA_AVX512,
+    BW_ISA_COUNT
+} BwIsa;
+
+/* Kernel signature: dst = f(x, y, s); the read kernel returns its sum instead */
+typedef double (*BwFunc)(double *restrict dst, const double *restrict x,
+                         const double *restrict y, size_t n, double s);
+
+/* Worker pool shared by all measurements */
+typedef struct
+{
+    pthread_t threads[BW_MAX_THREADS];
+    int cpus[BW_MAX_THREADS];
+    int nodes[BW_MAX_THREADS]; /* Node to allocate from with numa:true, else -1 */
+    int thread_count;          /* Threads in the pool */
+    int active;                /* Threads taking part in the current pass */
+    BwFunc func;
+    double *dst;
+    const double *x;
+    const double *y;
+    size_t n;                  /* Elements per array */
+    bool quit;
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    pthread_mutex_t gate;      /* Held while the pool is being sized */
+    double sums[BW_MAX_THREADS];
+} BwPool;
+
+typedef struct
+{
+    BwPool *pool;
+    int index;
+} BwWorkerArg;
+
+static const char *const kernel_names[BW_KERNEL_COUNT] = {
+    "copy", "scale", "add", "triad", "read", "write"};
+static const int kernel_arrays[BW_KERNEL_COUNT] = {2, 2, 3, 3, 1, 1};
+static const char *const isa_names[BW_ISA_COUNT] = {"scalar", "avx2", "avx512"};
+
+/*
+ * Scalar kernels are kept scalar on purpose so they show what plain
+ * compiled code achieves next to the explicit SIMD variants.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define BW_SCALAR_FN __attribute__((optimize("no-tree-vectorize")))
+#else
+#define BW_SCALAR_FN
+#endif
+
+/* Private helper function prototypes */
+static BwFunc lookup_kernel(BwIsa isa, bool nt, BwKernel kernel);
+static bool isa_supported(BwIsa isa);
+static void *bw_worker(void *arg);
+static double run_pass(BwPool *pool, BwFunc func, double *dst, const double *x,
+                       const double *y, int threads);
+static void init_arrays(BwPool *pool, double *a, double *b, double *c);
+static void run_suite(BwPool *pool, double *pa, double *pb, double *pc, const int *levels, int level_count,
+                      const char *pages, const PerfCounter *tlb, double *summary);
+static int build_levels(int *levels, int max, int limit);
+
+/* ------------------------------------------------------------------------ */
+/* Scalar kernels                                                           */
+/* ------------------------------------------------------------------------ */
+
+BW_SCALAR_FN static double scalar_copy(double *restrict d, const double *restrict x,
+                                       const double *restrict y, size_t n, double s)
+{
+    (void)y;
+    (void)s;
+    for (size_t i = 0; i < n; i++)
+        d[i] = x[i];
+    return 0.0;
+}
+
+BW_SCALAR_FN static double scalar_scale(double *restrict d, const double *restrict x,
+                                        const double *restrict y, size_t n, double s)
+{
+    (void)y;
+    for (size_t i = 0; i < n; i++)
+        d[i] = s * x[i];
+    return 0.0;
+}
+
+BW_SCALAR_FN static double scalar_add(double *restrict d, const double *restrict x,
+                                      const double *restrict y, size_t n, double s)
+{
+    (void)s;
+    for (size_t i = 0; i < n; i++)
+        d[i] = x[i] + y[i];
+    return 0.0;
+}
+
+BW_SCALAR_FN static double scalar_triad(double *restrict d, const double *restrict x,
+                                        const double *restrict y, size_t n, double s)
+{
+    for (size_t i = 0; i < n; i++)
+        d[i] = x[i] + s * y[i];
+    return 0.0;
+}
+
+BW_SCALAR_FN static double scalar_read(double *restrict d, const double *restrict x,
+                                       const double *restrict y, size_t n, double s)
+{
+    (void)d;
+    (void)y;
+    (void)s;
+    double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        s0 += x[i];
+        s1 += x[i + 1];
+        s2 += x[i + 2];
+        s3 += x[i + 3];
+    }
+    for (; i < n; i++)
+        s0 += x[i];
+    return s0 + s1 + s2 + s3;
+}
+
+BW_SCALAR_FN static double scalar_write(double *restrict d, const double *restrict x,
+                                        const double *restrict y, size_t n, double s)
+{
+    (void)x;
+    (void)y;
+    for (size_t i = 0; i < n; i++)
+        d[i] = s;
+    return 0.0;
+}
+
+#if defined(__x86_64__)
+
+/* Scalar non-temporal stores go through MOVNTI on the raw bit pattern */
+static inline void stream_double(double *d, double v)
+{
+    long long bits;
+    memcpy(&bits, &v, sizeof(bits));
+    _mm_stream_si64((long long *)d, bits);
+}
+
+#define SCALAR_NT_KERNEL(NAME, EXPR)                                               \
+    BW_SCALAR_FN static double scalar_nt_##NAME(double *restrict d,                \
+                                                const double *restrict x,          \
+                                                const double *restrict y,          \
+                                                size_t n, double s)                \
+    {                                                                              \
+        (void)x;                                                                   \
+        (void)y;                                                                   \
+        (void)s;                                                                   \
+        for (size_t i = 0; i < n; i++)                                             \
+            stream_double(&d[i], (EXPR));                                          \
+        _mm_sfence();                                                              \
+        return 0.0;                                                                \
+    }
+
+SCALAR_NT_KERNEL(copy, x[i])
+SCALAR_NT_KERNEL(scale, s * x[i])
+SCALAR_NT_KERNEL(add, x[i] + y[i])
+SCALAR_NT_KERNEL(triad, x[i] + s * y[i])
+SCALAR_NT_KERNEL(write, s)
+
+/* ------------------------------------------------------------------------ */
+/* SIMD kernels                                                             */
+/* ------------------------------------------------------------------------ */
+
+/*
+ * Each vector kernel peels scalar elements until the destination is
+ * vector-aligned (required by the streaming stores), runs the vector
+ * loop, then finishes the tail with scalar code.
+ */
+#define VECTOR_KERNEL(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE, NAME, VEXPR, SEXPR) \
+    __attribute__((target(TARGET))) static double PREFIX##_##NAME(double *restrict d,              \
+                                                                  const double *restrict x,        \
+                                                                  const double *restrict y,        \
+                                                                  size_t n, double s)              \
+    {                                                                                              \
+        (void)x;                                                                                   \
+        (void)y;                                                                                   \
+        VT vs = SET1(s);                                                                           \
+        (void)vs;                                                                                  \
+        size_t i = 0;                                                                              \
+        for (; i < n && ((uintptr_t)(d + i) & (sizeof(VT) - 1)) != 0; i++)                         \
+            d[i] = (SEXPR);                                                                        \
+        for (; i + (W) <= n; i += (W))                                                             \
+            STORE(d + i, (VEXPR));                                                                 \
+        for (; i < n; i++)                                                                         \
+            d[i] = (SEXPR);                                                                        \
+        FENCE;                                                                                     \
+        return 0.0;                                                                                \
+    }
+
+#define VECTOR_KERNEL_SET(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE)                              \
+    VECTOR_KERNEL(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE, copy, LOADU(x + i), x[i])             \
+    VECTOR_KERNEL(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE, scale, MUL(vs, LOADU(x + i)),          \
+                  s * x[i])                                                                                         \
+    VECTOR_KERNEL(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE, add, ADD(LOADU(x + i), LOADU(y + i)),  \
+                  x[i] + y[i])                                                                                      \
+    VECTOR_KERNEL(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE, triad,                                 \
+                  ADD(LOADU(x + i), MUL(vs, LOADU(y + i))), x[i] + s * y[i])                                         \
+    VECTOR_KERNEL(PREFIX, TARGET, W, VT, LOADU, SET1, ADD, MUL, STORE, FENCE, write, vs, s)
+
+VECTOR_KERNEL_SET(avx2, "avx2", 4, __m256d, _mm256_loadu_pd, _mm256_set1_pd, _mm256_add_pd,
+                  _mm256_mul_pd, _mm256_store_pd, (void)0)
+VECTOR_KERNEL_SET(avx2_nt, "avx2", 4, __m256d, _mm256_loadu_pd, _mm256_set1_pd, _mm256_add_pd,
+                  _mm256_mul_pd, _mm256_stream_pd, _mm_sfence())
+VECTOR_KERNEL_SET(avx512, "avx512f", 8, __m512d, _mm512_loadu_pd, _mm512_set1_pd, _mm512_add_pd,
+                  _mm512_mul_pd, _mm512_store_pd, (void)0)
+VECTOR_KERNEL_SET(avx512_nt, "avx512f", 8, __m512d, _mm512_loadu_pd, _mm512_set1_pd, _mm512_add_pd,
+                  _mm512_mul_pd, _mm512_stream_pd, _mm_sfence())
+
+__attribute__((target("avx2"))) static double avx2_read(double *restrict d, const double *restrict x,
+                                                        const double *restrict y, size_t n, double s)
+{
+    (void)d;
+    (void)y;
+    (void)s;
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(x + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(x + i + 4));
+    }
+    double lanes[4];
+    _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; i++)
+        sum += x[i];
+    return sum;
+}
+
+__attribute__((target("avx512f"))) static double avx512_read(double *restrict d, const double *restrict x,
+                                                             const double *restrict y, size_t n, double s)
+{
+    (void)d;
+    (void)y;
+    (void)s;
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        acc0 = _mm512_add_pd(acc0, _mm512_loadu_pd(x + i));
+        acc1 = _mm512_add_pd(acc1, _mm512_loadu_pd(x + i + 8));
+    }
+    double sum = _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+    for (; i < n; i++)
+        sum += x[i];
+    return sum;
+}
+
+#endif /* __x86_64__ */
+
+/**
+ * Run the bandwidth engine
+ */
+bool bandwidth_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    size_t total = BW_DEFAULT_SIZE;
+    if (opts->size[0] != '\0' && !bench_parse_size(opts->size, &total))
+    {
+        logger_error("Bandwidth: invalid size '%s'", opts->size);
+        return false;
+    }
+    size_t limit = bench_mem_available() / 2;
+    if (limit > 0 && total > limit)
+    {
+        logger_warning("Bandwidth: %zu MB requested, only %zu MB available, shrinking",
+                       total >> 20, limit >> 20);
+        total = limit;
+    }
+
+    /* Doubles need at least 8-byte alignment */
+    size_t alignment = opts->alignment > 0 ? (size_t)opts->alignment : 0;
+    if (alignment != 0 && alignment < sizeof(double))
+    {
+        logger_warning("Bandwidth: alignment %zu too small for doubles, using 8", alignment);
+        alignment = sizeof(double);
+    }
+
+    size_t n = total / 3 / sizeof(double);
+    n -= n % BW_SLICE_ELEMS;
+    if (n < BW_SLICE_ELEMS)
+    {
+        logger_error("Bandwidth: working set of %zu bytes is too small", total);
+        return false;
+    }
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Bandwidth: invalid page type '%s' (expected 4k, thp, 2m, 1g or all)", opts->pages);
+        return false;
+    }
+
+    /* Opened before the pool exists so that the workers inherit it */
+    PerfCounter tlb;
+    bool have_tlb = perf_counter_open(&tlb, PERF_DTLB_MISSES, true);
+    if (!have_tlb)
+    {
+        logger_info("Bandwidth: dTLB miss counters unavailable, reporting bandwidth only");
+    }
+
+    /* Build and start the worker pool, one thread per online CPU */
+    static BwPool pool;
+    memset(&pool, 0, sizeof(pool));
+    CpuTopology topo;
+    if (topology_load(&topo))
+    {
+        for (int i = 0; i < topo.count && i < BW_MAX_THREADS; i++)
+        {
+            pool.cpus[pool.thread_count] = topo.cpus[i].cpu;
+            pool.nodes[pool.thread_count] = opts->numa_aware ? topo.cpus[i].node : -1;
+            pool.thread_count++;
+        }
+        topology_free(&topo);
+    }
+    else
+    {
+        pool.cpus[pool.thread_count] = -1;
+        pool.nodes[pool.thread_count] = -1;
+        pool.thread_count++;
+    }
+    pool.n = n;
+
+    /*
+     * Workers wait on the gate until the barriers exist, so the barriers can
+     * be sized for however many threads actually started.
+     */
+    BwWorkerArg args[BW_MAX_THREADS];
+    pthread_mutex_init(&pool.gate, NULL);
+    pthread_mutex_lock(&pool.gate);
+    int started = 0;
+    for (int i = 0; i < pool.thread_count; i++)
+    {
+        args[i] = (BwWorkerArg){&pool, i};
+        if (pthread_create(&pool.threads[i], NULL, bw_worker, &args[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started != pool.thread_count)
+    {
+        logger_warning("Bandwidth: only %d of %d worker threads started", started, pool.thread_count);
+        pool.thread_count = started;
+    }
+    pthread_barrier_init(&pool.start, NULL, (unsigned int)pool.thread_count + 1);
+    pthread_barrier_init(&pool.done, NULL, (unsigned int)pool.thread_count + 1);
+    pthread_mutex_unlock(&pool.gate);
+
+    if (pool.thread_count == 0)
+    {
+        logger_error("Bandwidth: failed to start worker threads");
+        pthread_barrier_destroy(&pool.start);
+        pthread_barrier_destroy(&pool.done);
+        pthread_mutex_destroy(&pool.gate);
+        if (have_tlb)
+        {
+            perf_counter_close(&tlb);
+        }
+        return false;
+    }
+
+    int levels[16];
+    int level_count = build_levels(levels, 16, pool.thread_count);
+
+    logger_info("Bandwidth: 3 arrays of %zu MB, alignment %zu, up to %d threads",
+                (n * sizeof(double)) >> 20, alignment ? alignment : (size_t)sysconf(_SC_PAGESIZE),
+                pool.thread_count);
+
+    /* Best result per kernel and page type at the largest thread count */
+    double summary[MEM_PAGE_TYPE_MAX][BW_KERNEL_COUNT] = {{0.0}};
+    bool measured[MEM_PAGE_TYPE_MAX] = {false};
+    int measured_count = 0;
+
+    for (int t = 0; t < type_count; t++)
+    {
+        const char *pages = mem_buffer_page_name(types[t]);
+        MemBuffer a, b, c;
+        if (!mem_buffer_alloc_pages(&a, n * sizeof(double), alignment, types[t]))
+        {
+            logger_warning("Bandwidth: cannot map arrays with %s pages, skipping", pages);
+            continue;
+        }
+        if (!mem_buffer_alloc_pages(&b, n * sizeof(double), alignment, types[t]))
+        {
+            mem_buffer_free(&a);
+            logger_warning("Bandwidth: cannot map arrays with %s pages, skipping", pages);
+            continue;
+        }
+        if (!mem_buffer_alloc_pages(&c, n * sizeof(double), alignment, types[t]))
+        {
+            mem_buffer_free(&a);
+            mem_buffer_free(&b);
+            logger_warning("Bandwidth: cannot map arrays with %s pages, skipping", pages);
+            continue;
+        }
+
+        init_arrays(&pool, a.data, b.data, c.data);
+        run_suite(&pool, a.data, b.data, c.data, levels, level_count, pages,
+                  have_tlb ? &tlb : NULL, summary[t]);
+
+        mem_buffer_free(&a);
+        mem_buffer_free(&b);
+        mem_buffer_free(&c);
+        measured[t] = true;
+        measured_count++;
+    }
+
+    pool.quit = true;
+    pthread_barrier_wait(&pool.start);
+    for (int i = 0; i < pool.thread_count; i++)
+    {
+        pthread_join(pool.threads[i], NULL);
+    }
+    pthread_barrier_destroy(&pool.start);
+    pthread_barrier_destroy(&pool.done);
+    pthread_mutex_destroy(&pool.gate);
+    if (have_tlb)
+    {
+        perf_counter_close(&tlb);
+    }
+
+    if (measured_count == 0)
+    {
+        logger_error("Bandwidth: no page type could be mapped");
+        return false;
+    }
+
+    /* Compare every page type against the first one measured */
+    int ref = 0;
+    while (!measured[ref])
+    {
+        ref++;
+    }
+    for (int t = ref + 1; t < type_count; t++)
+    {
+        if (!measured[t])
+        {
+            continue;
+        }
+        for (int k = 0; k < BW_KERNEL_COUNT; k++)
+        {
+            if (summary[ref][k] <= 0.0)
+            {
+                continue;
+            }
+            double delta = 100.0 * (summary[t][k] - summary[ref][k]) / summary[ref][k];
+            logger_info("Bandwidth: %-5s %s %.2f GB/s vs %s %.2f GB/s (%+.1f%%)",
+                        kernel_names[k], mem_buffer_page_name(types[t]), summary[t][k],
+                        mem_buffer_page_name(types[ref]), summary[ref][k], delta);
+            logger_metric("mem_bandwidth_pages", "kernel=%s,pages=%s,ref_pages=%s,threads=%d,best_gbps=%.3f,"
+                          "ref_best_gbps=%.3f,delta_pct=%.1f",
+                          kernel_names[k], mem_buffer_page_name(types[t]), mem_buffer_page_name(types[ref]),
+                          levels[level_count - 1], summary[t][k], summary[ref][k], delta);
+        }
+    }
+
+    return true;
+}
+
+/* Private helper function to run every kernel variant at every thread count over one set of arrays */
+static void run_suite(BwPool *pool, double *pa, double *pb, double *pc, const int *levels, int level_count,
+                      const char *pages, const PerfCounter *tlb, double *summary)
+{
+    size_t n = pool->n;
+
+    for (int isa = 0; isa < BW_ISA_COUNT; isa++)
+    {
+        if (!isa_supported((BwIsa)isa))
+        {
+            logger_info("Bandwidth: %s not supported on this CPU, skipping", isa_names[isa]);
+            continue;
+        }
+
+        for (int nt = 0; nt < 2; nt++)
+        {
+            for (int k = 0; k < BW_KERNEL_COUNT; k++)
+            {
+                BwFunc func = lookup_kernel((BwIsa)isa, nt == 1, (BwKernel)k);
+                if (!func)
+                {
+                    continue;
+                }
+
+                /* STREAM array roles: c=a, b=s*c, c=a+b, a=b+s*c */
+                double *dst = NULL;
+                const double *x = NULL, *y = NULL;
+                switch ((BwKernel)k)
+                {
+                case BW_COPY:
+                    dst = pc, x = pa;
+                    break;
+                case BW_SCALE:
+                    dst = pb, x = pc;
+                    break;
+                case BW_ADD:
+                    dst = pc, x = pa, y = pb;
+                    break;
+                case BW_TRIAD:
+                    dst = pa, x = pb, y = pc;
+                    break;
+                case BW_READ:
+                    x = pa;
+                    break;
+                case BW_WRITE:
+                    dst = pc;
+                    break;
+                default:
+                    break;
+                }
+
+                double bytes = (double)kernel_arrays[k] * (double)n * sizeof(double);
+                for (int l = 0; l < level_count; l++)
+                {
+                    double best = 0.0, sum = 0.0;
+
+                    /* First pass warms up page tables and caches and is not counted */
+                    run_pass(pool, func, dst, x, y, levels[l]);
+                    uint64_t misses_before = tlb ? perf_counter_read(tlb) : 0;
+                    for (int rep = 0; rep < BW_REPS; rep++)
+                    {
+                        double seconds = run_pass(pool, func, dst, x, y, levels[l]);
+                        double gbps = bytes / seconds / 1e9;
+                        sum += gbps;
+                        if (gbps > best)
+                            best = gbps;
+                    }
+
+                    if (l == level_count - 1 && best > summary[k])
+                    {
+                        summary[k] = best;
+                    }
+
+                    const char *store = k == BW_READ ? "none" : (nt ? "nt" : "regular");
+                    if (tlb)
+                    {
+                        /* Misses per KB of array traffic, comparable across kernels */
+                        double misses = (double)(perf_counter_read(tlb) - misses_before);
+                        double per_kb = misses / (bytes * BW_REPS / 1024.0);
+                        logger_info("Bandwidth: %-5s %-6s %-7s %-7s %3d threads: best %.2f GB/s, avg %.2f GB/s, "
+                                    "%.4f dTLB misses/KB",
+                                    kernel_names[k], isa_names[isa], store, pages, levels[l], best,
+                                    sum / BW_REPS, per_kb);
+                        logger_metric("mem_bandwidth",
+                                      "kernel=%s,isa=%s,store=%s,pages=%s,threads=%d,array_mb=%zu,best_gbps=%.3f,"
+                                      "avg_gbps=%.3f,dtlb_misses_per_kb=%.4f",
+                                      kernel_names[k], isa_names[isa], store, pages, levels[l],
+                                      (n * sizeof(double)) >> 20, best, sum / BW_REPS, per_kb);
+                    }
+                    else
+                    {
+                        logger_info("Bandwidth: %-5s %-6s %-7s %-7s %3d threads: best %.2f GB/s, avg %.2f GB/s",
+                                    kernel_names[k], isa_names[isa], store, pages, levels[l], best,
+                                    sum / BW_REPS);
+                        logger_metric("mem_bandwidth",
+                                      "kernel=%s,isa=%s,store=%s,pages=%s,threads=%d,array_mb=%zu,best_gbps=%.3f,"
+                                      "avg_gbps=%.3f",
+                                      kernel_names[k], isa_names[isa], store, pages, levels[l],
+                                      (n * sizeof(double)) >> 20, best, sum / BW_REPS);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Private helper function to find the implementation of a kernel variant */
+static BwFunc lookup_kernel(BwIsa isa, bool nt, BwKernel kernel)
+{
+    static const BwFunc scalar[BW_KERNEL_COUNT] = {
+        scalar_copy, scalar_scale, scalar_add, scalar_triad, scalar_read, scalar_write};
+
+    if (isa == BW_ISA_SCALAR && !nt)
+    {
+        return scalar[kernel];
+    }
+
+#if defined(__x86_64__)
+    static const BwFunc table[BW_ISA_COUNT][2][BW_KERNEL_COUNT] = {
+        [BW_ISA_SCALAR] = {
+            [1] = {scalar_nt_copy, scalar_nt_scale, scalar_nt_add, scalar_nt_triad, NULL, scalar_nt_write},
+        },
+        [BW_ISA_AVX2] = {
+            {avx2_copy, avx2_scale, avx2_add, avx2_triad, avx2_read, avx2_write},
+            {avx2_nt_copy, avx2_nt_scale, avx2_nt_add, avx2_nt_triad, NULL, avx2_nt_write},
+        },
+        [BW_ISA_AVX512] = {
+            {avx512_copy, avx512_scale, avx512_add, avx512_triad, avx512_read, avx512_write},
+            {avx512_nt_copy, avx512_nt_scale, avx512_nt_add, avx512_nt_triad, NULL, avx512_nt_write},
+        },
+    };
+    return table[isa][nt ? 1 : 0][kernel];
+#else
+    return NULL;
+#endif
+}
+
+/* Private helper function to check whether the CPU can run an ISA variant */
+static bool isa_supported(BwIsa isa)
+{
+    switch (isa)
+    {
+    case BW_ISA_SCALAR:
+        return true;
+#if defined(__x86_64__)
+    case BW_ISA_AVX2:
+        return __builtin_cpu_supports("avx2");
+    case BW_ISA_AVX512:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+/* Private helper function: pinned pool worker, runs its slice of every pass */
+static void *bw_worker(void *arg)
+{
+    BwWorkerArg *worker = arg;
+    BwPool *pool = worker->pool;
+    int index = worker->index;
+
+    if (pool->cpus[index] >= 0)
+    {
+        bench_pin_cpu(pool->cpus[index]);
+    }
+
+    /* Make the first-touch placement explicit rather than relying on the default policy */
+    if (pool->nodes[index] >= 0 && !numa_set_preferred(pool->nodes[index]))
+    {
+        logger_warning("Bandwidth: cannot prefer node %d for CPU %d", pool->nodes[index], pool->cpus[index]);
+    }
+
+    pthread_mutex_lock(&pool->gate);
+    pthread_mutex_unlock(&pool->gate);
+
+    for (;;)
+    {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit)
+        {
+            break;
+        }
+
+        if (index < pool->active)
+        {
+            /* Slice boundaries fall on whole cache lines */
+            size_t chunks = pool->n / BW_SLICE_ELEMS;
+            size_t first = chunks * (size_t)index / (size_t)pool->active * BW_SLICE_ELEMS;
+            size_t last = chunks * (size_t)(index + 1) / (size_t)pool->active * BW_SLICE_ELEMS;
+
+            pool->sums[index] = pool->func(pool->dst ? pool->dst + first : NULL,
+                                           pool->x ? pool->x + first : NULL,
+                                           pool->y ? pool->y + first : NULL,
+                                           last - first, BW_SCALAR);
+        }
+
+        pthread_barrier_wait(&pool->done);
+    }
+    return NULL;
+}
+
+/* Private helper function to run one timed pass; returns elapsed seconds */
+static double run_pass(BwPool *pool, BwFunc func, double *dst, const double *x,
+                       const double *y, int threads)
+{
+    pool->func = func;
+    pool->dst = dst;
+    pool->x = x;
+    pool->y = y;
+    pool->active = threads;
+
+    uint64_t t0 = bench_now_ns();
+    pthread_barrier_wait(&pool->start);
+    pthread_barrier_wait(&pool->done);
+    uint64_t t1 = bench_now_ns();
+
+    /* Keep the read kernel's result alive */
+    double sum = 0.0;
+    for (int i = 0; i < threads; i++)
+    {
+        sum += pool->sums[i];
+    }
+    __asm__ __volatile__("" : : "g"(&sum) : "memory");
+
+    return (double)(t1 - t0) / 1e9;
+}
+
+/* Private helper function: first-touch the arrays from the threads that will use them */
+static void init_arrays(BwPool *pool, double *a, double *b, double *c)
+{
+    run_pass(pool, scalar_write, a, NULL, NULL, pool->thread_count);
+    run_pass(pool, scalar_write, b, NULL, NULL, pool->thread_count);
+    run_pass(pool, scalar_write, c, NULL, NULL, pool->thread_count);
+}
+
+/* Private helper function to build 1, 2, 4, ... thread counts up to the pool size */
+static int build_levels(int *levels, int max, int limit)
+{
+    int count = 0;
+    for (int n = 1; n < limit && count < max - 1; n *= 2)
+    {
+        levels[count++] = n;
+    }
+    levels[count++] = limit;
+    return count;
+}
@@ -0,0 +1,779 @@
+/**
+ * Memory Copy Test Implementation
+ *
+ * This file implements the memcpy/memset shoot-out. Every method is a
+ * plain function over (dst, src, n) so they can be timed the same way:
+ * the number of calls per batch is calibrated to fill a slice of the
+ * measurement window, and the best of several batches is kept. The
+ * vector loops follow the usual library shape: one unaligned vector at
+ * each end, aligned (or streaming) stores in between, and overlapping
+ * narrower moves below one vector. Results are checked after a warm-up
+ * call, including the bytes just outside the destination.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#include <x86intrin.h>
+#endif
+
+/* Include our header files */
+#include "copy_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "perf_counter.h"
+
+/* Define constants */
+#define COPY_DEFAULT_MAX_SIZE (1ULL << 30)
+#define COPY_MIN_SIZE 8
+#define COPY_MAX_SIZES 128
+#define COPY_MAX_ALIGNMENTS 8
+#define COPY_MAX_OFFSET 4095
+#define COPY_DST_SKEW 2048 /* Keeps src and dst off the same 4 KB page offset */
+#define COPY_SLACK 8192    /* Room for the offsets, the skew and the guard bytes */
+#define COPY_MIN_BATCHES 3
+#define COPY_MAX_CALLS (1ULL << 30)
+#define COPY_MIN_WINDOW_NS 2000000ULL
+#define COPY_MAX_WINDOW_NS 500000000ULL
+#define COPY_FILL 0x5a
+#define COPY_GUARD 0xa5
+#define COPY_TIE_MARGIN 0.05 /* Within 5% of the fastest counts as a tie */
+
+typedef enum
+{
+    COPY_OP_MEMCPY,
+    COPY_OP_MEMSET,
+    COPY_OP_COUNT
+} CopyOp;
+
+typedef enum
+{
+    COPY_LIBC,
+    COPY_REP,
+    COPY_AVX2,
+    COPY_AVX2_NT,
+    COPY_AVX512,
+    COPY_AVX512_NT,
+    COPY_METHOD_COUNT
+} CopyMethod;
+
+/* Method signature; memset variants ignore src and write COPY_FILL */
+typedef void (*CopyFunc)(char *dst, const char *src, size_t n);
+
+/* Source and destination misalignment in bytes */
+typedef struct
+{
+    size_t src;
+    size_t dst;
+} CopyAlignment;
+
+/* Where cycles per byte come from */
+typedef enum
+{
+    CYCLES_PERF, /* Core cycles from a perf counter */
+    CYCLES_TSC,  /* Reference cycles from the time stamp counter */
+    CYCLES_NONE
+} CycleSource;
+
+/* Best batch of one measurement */
+typedef struct
+{
+    double ns_per_call;
+    double gbps;
+    double cycles_per_byte;
+} CopyResult;
+
+static const char *const op_names[COPY_OP_COUNT] = {"memcpy", "memset"};
+static const char *const method_names[COPY_METHOD_COUNT] = {"libc", "rep", "avx2", "avx2nt", "avx512", "avx512nt"};
+static const char *const cycle_source_names[] = {"perf", "tsc", "none"};
+
+/* Private helper function prototypes */
+static int parse_methods(const char *str, CopyMethod *methods);
+static bool method_supported(CopyMethod method);
+static CopyFunc lookup_method(CopyMethod method, CopyOp op);
+static int build_sizes(size_t *sizes, int max, size_t limit);
+static int build_alignments(CopyAlignment *alignments, int max, int offset);
+static bool check_result(CopyOp op, const char *dst, const char *src, size_t n);
+static void measure(CopyFunc func, char *dst, const char *src, size_t n, uint64_t window_ns,
+                    CycleSource source, const PerfCounter *cycles, CopyResult *result);
+static uint64_t read_cycles(CycleSource source, const PerfCounter *cycles);
+static void log_crossover(CopyOp op, const CopyAlignment *alignment, const size_t *sizes,
+                          const int *winners, int size_count);
+static void format_size(size_t bytes, char *buf, size_t len);
+
+/* ------------------------------------------------------------------------ */
+/* Methods                                                                  */
+/* ------------------------------------------------------------------------ */
+
+static void libc_memcpy(char *d, const char *s, size_t n)
+{
+    memcpy(d, s, n);
+}
+
+static void libc_memset(char *d, const char *s, size_t n)
+{
+    (void)s;
+    memset(d, COPY_FILL, n);
+}
+
+#if defined(__x86_64__)
+
+static void rep_memcpy(char *d, const char *s, size_t n)
+{
+    __asm__ volatile("rep movsb" : "+D"(d), "+S"(s), "+c"(n) : : "memory");
+}
+
+static void rep_memset(char *d, const char *s, size_t n)
+{
+    (void)s;
+    __asm__ volatile("rep stosb" : "+D"(d), "+c"(n) : "a"(COPY_FILL) : "memory");
+}
+
+/*
+ * Below one vector the vector methods fall back to two overlapping moves
+ * of the widest size that fits, as the library routines do, so no byte
+ * loop is ever involved.
+ */
+static inline __attribute__((always_inline)) void copy_below32(char *d, const char *s, size_t n)
+{
+    if (n >= 16)
+    {
+        __m128i head = _mm_loadu_si128((const __m128i *)s);
+        __m128i tail = _mm_loadu_si128((const __m128i *)(s + n - 16));
+        _mm_storeu_si128((__m128i *)d, head);
+        _mm_storeu_si128((__m128i *)(d + n - 16), tail);
+    }
+    else if (n >= 8)
+    {
+        uint64_t head, tail;
+        memcpy(&head, s, 8);
+        memcpy(&tail, s + n - 8, 8);
+        memcpy(d, &head, 8);
+        memcpy(d + n - 8, &tail, 8);
+    }
+    else if (n >= 4)
+    {
+        uint32_t head, tail;
+        memcpy(&head, s, 4);
+        memcpy(&tail, s + n - 4, 4);
+        memcpy(d, &head, 4);
+        memcpy(d + n - 4, &tail, 4);
+    }
+    else if (n > 0)
+    {
+        char first = s[0], middle = s[n / 2], last = s[n - 1];
+        d[0] = first;
+        d[n / 2] = middle;
+        d[n - 1] = last;
+    }
+}
+
+static inline __attribute__((always_inline)) void set_below32(char *d, size_t n)
+{
+    if (n >= 16)
+    {
+        __m128i v = _mm_set1_epi8((char)COPY_FILL);
+        _mm_storeu_si128((__m128i *)d, v);
+        _mm_storeu_si128((__m128i *)(d + n - 16), v);
+    }
+    else if (n >= 8)
+    {
+        uint64_t v = 0x0101010101010101ULL * COPY_FILL;
+        memcpy(d, &v, 8);
+        memcpy(d + n - 8, &v, 8);
+    }
+    else if (n >= 4)
+    {
+        uint32_t v = 0x01010101U * COPY_FILL;
+        memcpy(d, &v, 4);
+        memcpy(d + n - 4, &v, 4);
+    }
+    else if (n > 0)
+    {
+        d[0] = (char)COPY_FILL;
+        d[n / 2] = (char)COPY_FILL;
+        d[n - 1] = (char)COPY_FILL;
+    }
+}
+
+__attribute__((target("avx2"), always_inline)) static inline void copy_below64(char *d, const char *s, size_t n)
+{
+    if (n >= 32)
+    {
+        __m256i head = _mm256_loadu_si256((const __m256i *)s);
+        __m256i tail = _mm256_loadu_si256((const __m256i *)(s + n - 32));
+        _mm256_storeu_si256((__m256i *)d, head);
+        _mm256_storeu_si256((__m256i *)(d + n - 32), tail);
+    }
+    else
+    {
+        copy_below32(d, s, n);
+    }
+}
+
+__attribute__((target("avx2"), always_inline)) static inline void set_below64(char *d, size_t n)
+{
+    if (n >= 32)
+    {
+        __m256i v = _mm256_set1_epi8((char)COPY_FILL);
+        _mm256_storeu_si256((__m256i *)d, v);
+        _mm256_storeu_si256((__m256i *)(d + n - 32), v);
+    }
+    else
+    {
+        set_below32(d, n);
+    }
+}
+
+#define AVX2_LOADU(p) _mm256_loadu_si256((const __m256i *)(p))
+#define AVX2_STOREU(p, v) _mm256_storeu_si256((__m256i *)(p), (v))
+#define AVX2_STORE(p, v) _mm256_store_si256((__m256i *)(p), (v))
+#define AVX2_STREAM(p, v) _mm256_stream_si256((__m256i *)(p), (v))
+#define AVX2_SET1() _mm256_set1_epi8((char)COPY_FILL)
+#define AVX512_LOADU(p) _mm512_loadu_si512((const void *)(p))
+#define AVX512_STOREU(p, v) _mm512_storeu_si512((void *)(p), (v))
+#define AVX512_STORE(p, v) _mm512_store_si512((void *)(p), (v))
+#define AVX512_STREAM(p, v) _mm512_stream_si512((void *)(p), (v))
+#define AVX512_SET1() _mm512_set1_epi8((char)COPY_FILL)
+
+/*
+ * The first and last vector are stored unaligned up front and at the end;
+ * everything between runs from the first aligned destination address,
+ * four vectors per iteration. Streaming stores are fenced before the
+ * final unaligned store so the two never race for the same line.
+ */
+#define VECTOR_MEMCPY(NAME, TARGET, W, VT, LOADU, STOREU, STORE, FENCE, SMALL)                   \
+    __attribute__((target(TARGET))) static void NAME(char *d, const char *s, size_t n)          \
+    {                                                                                         \
+        if (n < (W))                                                                          \
+        {                                                                                     \
+            SMALL(d, s, n);                                                                   \
+            return;                                                                           \
+        }                                                                                     \
+        VT head = LOADU(s);                                                                   \
+        VT tail = LOADU(s + n - (W));                                                         \
+        STOREU(d, head);                                                                      \
+        size_t i = (W) - ((uintptr_t)d & ((W) - 1));                                          \
+        for (; i + 4 * (W) <= n; i += 4 * (W))                                                \
+        {                                                                                     \
+            VT v0 = LOADU(s + i);                                                             \
+            VT v1 = LOADU(s + i + (W));                                                       \
+            VT v2 = LOADU(s + i + 2 * (W));                                                   \
+            VT v3 = LOADU(s + i + 3 * (W));                                                   \
+            STORE(d + i, v0);                                                                 \
+            STORE(d + i + (W), v1);                                                           \
+            STORE(d + i + 2 * (W), v2);                                                       \
+            STORE(d + i + 3 * (W), v3);                                                       \
+        }                                                                                     \
+        for (; i + (W) <= n; i += (W))                                                        \
+            STORE(d + i, LOADU(s + i));                                                       \
+        FENCE;                                                                                \
+        STOREU(d + n - (W), tail);                                                            \
+    }
+
+#define VECTOR_MEMSET(NAME, TARGET, W, VT, SET1, STOREU, STORE, FENCE, SMALL)                    \
+    __attribute__((target(TARGET))) static void NAME(char *d, const char *s, size_t n)          \
+    {                                                                                         \
+        (void)s;                                                                              \
+        if (n < (W))                                                                          \
+        {                                                                                     \
+            SMALL(d, n);                                                                      \
+            return;                                                                           \
+        }                                                                                     \
+        VT v = SET1();                                                                        \
+        STOREU(d, v);                                                                         \
+        size_t i = (W) - ((uintptr_t)d & ((W) - 1));                                          \
+        for (; i + 4 * (W) <= n; i += 4 * (W))                                                \
+        {                                                                                     \
+            STORE(d + i, v);                                                                  \
+            STORE(d + i + (W), v);                                                            \
+            STORE(d + i + 2 * (W), v);                                                        \
+            STORE(d + i + 3 * (W), v);                                                        \
+        }                                                                                     \
+        for (; i + (W) <= n; i += (W))                                                        \
+            STORE(d + i, v);                                                                  \
+        FENCE;                                                                                \
+        STOREU(d + n - (W), v);                                                               \
+    }
+
+VECTOR_MEMCPY(avx2_memcpy, "avx2", 32, __m256i, AVX2_LOADU, AVX2_STOREU, AVX2_STORE, (void)0, copy_below32)
+VECTOR_MEMCPY(avx2nt_memcpy, "avx2", 32, __m256i, AVX2_LOADU, AVX2_STOREU, AVX2_STREAM, _mm_sfence(),
+              copy_below32)
+VECTOR_MEMCPY(avx512_memcpy, "avx512f", 64, __m512i, AVX512_LOADU, AVX512_STOREU, AVX512_STORE, (void)0,
+              copy_below64)
+VECTOR_MEMCPY(avx512nt_memcpy, "avx512f", 64, __m512i, AVX512_LOADU, AVX512_STOREU, AVX512_STREAM, _mm_sfence(),
+              copy_below64)
+VECTOR_MEMSET(avx2_memset, "avx2", 32, __m256i, AVX2_SET1, AVX2_STOREU, AVX2_STORE, (void)0, set_below32)
+VECTOR_MEMSET(avx2nt_memset, "avx2", 32, __m256i, AVX2_SET1, AVX2_STOREU, AVX2_STREAM, _mm_sfence(), set_below32)
+VECTOR_MEMSET(avx512_memset, "avx512f", 64, __m512i, AVX512_SET1, AVX512_STOREU, AVX512_STORE, (void)0,
+              set_below64)
+VECTOR_MEMSET(avx512nt_memset, "avx512f", 64, __m512i, AVX512_SET1, AVX512_STOREU, AVX512_STREAM, _mm_sfence(),
+              set_below64)
+
+#endif /* __x86_64__ */
+
+/**
+ * Run the memory copy test
+ */
+bool copy_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    size_t max_size = COPY_DEFAULT_MAX_SIZE;
+    if (opts->size[0] != '\0' && (!bench_parse_size(opts->size, &max_size) || max_size < COPY_MIN_SIZE))
+    {
+        logger_error("Copy: invalid size '%s'", opts->size);
+        return false;
+    }
+    size_t limit = bench_mem_available() / 4;
+    if (limit > 0 && max_size > limit)
+    {
+        logger_warning("Copy: %zu MB requested, only %zu MB available per buffer, shrinking",
+                       max_size >> 20, limit >> 20);
+        max_size = limit;
+    }
+
+    CopyMethod requested[COPY_METHOD_COUNT];
+    int requested_count = parse_methods(opts->pattern, requested);
+    if (requested_count == 0)
+    {
+        logger_error("Copy: invalid method list '%s'", opts->pattern);
+        return false;
+    }
+    CopyMethod methods[COPY_METHOD_COUNT];
+    int method_count = 0;
+    for (int i = 0; i < requested_count; i++)
+    {
+        if (method_supported(requested[i]))
+        {
+            methods[method_count++] = requested[i];
+        }
+        else
+        {
+            logger_info("Copy: %s not supported on this CPU, skipping", method_names[requested[i]]);
+        }
+    }
+    if (method_count == 0)
+    {
+        logger_error("Copy: none of the requested methods can run here");
+        return false;
+    }
+
+    if (opts->alignment < 0 || opts->alignment > COPY_MAX_OFFSET)
+    {
+        logger_error("Copy: misalignment %d out of range (0-%d)", opts->alignment, COPY_MAX_OFFSET);
+        return false;
+    }
+    CopyAlignment alignments[COPY_MAX_ALIGNMENTS];
+    int alignment_count = build_alignments(alignments, COPY_MAX_ALIGNMENTS, opts->alignment);
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Copy: invalid page type '%s'", opts->pages);
+        return false;
+    }
+    if (type_count > 1)
+    {
+        logger_warning("Copy: one page type per run, using %s", mem_buffer_page_name(types[0]));
+    }
+
+    size_t sizes[COPY_MAX_SIZES];
+    int size_count = build_sizes(sizes, COPY_MAX_SIZES, max_size);
+
+    MemBuffer src_buf, dst_buf;
+    if (!mem_buffer_alloc_pages(&src_buf, max_size + COPY_SLACK, 4096, types[0]))
+    {
+        logger_error("Copy: failed to allocate %zu MB source buffer", max_size >> 20);
+        return false;
+    }
+    if (!mem_buffer_alloc_pages(&dst_buf, max_size + COPY_SLACK, 4096, types[0]))
+    {
+        logger_error("Copy: failed to allocate %zu MB destination buffer", max_size >> 20);
+        mem_buffer_free(&src_buf);
+        return false;
+    }
+
+    /* Fault everything in up front; the source gets bytes no method writes */
+    char *src_base = src_buf.data;
+    for (size_t i = 0; i < src_buf.size; i++)
+    {
+        src_base[i] = (char)((i * 131 + 7) % 251);
+    }
+    memset(dst_buf.data, 0, dst_buf.size);
+
+    PerfCounter cycles;
+    CycleSource source = CYCLES_NONE;
+    if (perf_counter_open(&cycles, PERF_CPU_CYCLES, false))
+    {
+        source = CYCLES_PERF;
+    }
+    else
+    {
+#if defined(__x86_64__)
+        source = CYCLES_TSC;
+        logger_info("Copy: core cycle counter unavailable, cycles per byte use TSC reference cycles");
+#else
+        logger_info("Copy: no cycle counter available, reporting GB/s only");
+#endif
+    }
+
+    int runs = COPY_OP_COUNT * alignment_count * size_count * method_count;
+    uint64_t window = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)runs;
+    if (window < COPY_MIN_WINDOW_NS)
+        window = COPY_MIN_WINDOW_NS;
+    if (window > COPY_MAX_WINDOW_NS)
+        window = COPY_MAX_WINDOW_NS;
+
+    char max_name[16];
+    format_size(max_size, max_name, sizeof(max_name));
+    logger_info("Copy: %d methods, %d sizes from 8 B to %s, %d alignments, %s pages, %.1f ms per run",
+                method_count, size_count, max_name, alignment_count, mem_buffer_page_name(types[0]),
+                (double)window / 1e6);
+
+    bool ok = true;
+    for (int op = 0; op < COPY_OP_COUNT && ok; op++)
+    {
+        for (int a = 0; a < alignment_count && ok; a++)
+        {
+            const char *src = src_base + alignments[a].src;
+            char *dst = (char *)dst_buf.data + COPY_DST_SKEW + alignments[a].dst;
+            int winners[COPY_MAX_SIZES];
+
+            for (int s = 0; s < size_count && ok; s++)
+            {
+                size_t n = sizes[s];
+                char line[256];
+                int used = 0;
+                double gbps[COPY_METHOD_COUNT] = {0};
+
+                for (int m = 0; m < method_count; m++)
+                {
+                    CopyFunc func = lookup_method(methods[m], (CopyOp)op);
+
+                    /* Warm-up call doubles as the correctness check, guard bytes included */
+                    dst[-1] = (char)COPY_GUARD;
+                    dst[n] = (char)COPY_GUARD;
+                    func(dst, src, n);
+                    if (!check_result((CopyOp)op, dst, src, n) || dst[-1] != (char)COPY_GUARD ||
+                        dst[n] != (char)COPY_GUARD)
+                    {
+                        logger_error("Copy: %s %s produced wrong data at %zu bytes (src +%zu, dst +%zu)",
+                                     method_names[methods[m]], op_names[op], n, alignments[a].src,
+                                     alignments[a].dst);
+                        ok = false;
+                        break;
+                    }
+
+                    CopyResult result;
+                    measure(func, dst, src, n, window, source, &cycles, &result);
+                    gbps[methods[m]] = result.gbps;
+
+                    if (used < (int)sizeof(line))
+                    {
+                        used += snprintf(line + used, sizeof(line) - (size_t)used, "%s%s %.2f",
+                                         m > 0 ? ", " : "", method_names[methods[m]], result.gbps);
+                    }
+                    logger_metric("mem_copy", "op=%s,method=%s,bytes=%zu,src_offset=%zu,dst_offset=%zu,pages=%s,"
+                                  "ns_per_call=%.2f,gbps=%.3f,cycles_per_byte=%.4f,cycle_source=%s",
+                                  op_names[op], method_names[methods[m]], n, alignments[a].src, alignments[a].dst,
+                                  mem_buffer_page_name(types[0]), result.ns_per_call, result.gbps,
+                                  result.cycles_per_byte, cycle_source_names[source]);
+                }
+                if (ok)
+                {
+                    /* Near-ties keep the previous winner so the ranges do not flicker */
+                    winners[s] = methods[0];
+                    for (int m = 1; m < method_count; m++)
+                    {
+                        if (gbps[methods[m]] > gbps[winners[s]])
+                            winners[s] = methods[m];
+                    }
+                    if (s > 0 && gbps[winners[s - 1]] >= gbps[winners[s]] * (1.0 - COPY_TIE_MARGIN))
+                    {
+                        winners[s] = winners[s - 1];
+                    }
+
+                    char size_name[16];
+                    format_size(n, size_name, sizeof(size_name));
+                    logger_info("Copy: %s %9s src +%zu dst +%zu: %s GB/s", op_names[op], size_name,
+                                alignments[a].src, alignments[a].dst, line);
+                }
+            }
+
+            if (ok)
+            {
+                log_crossover((CopyOp)op, &alignments[a], sizes, winners, size_count);
+            }
+        }
+    }
+
+    if (source == CYCLES_PERF)
+    {
+        perf_counter_close(&cycles);
+    }
+    mem_buffer_free(&dst_buf);
+    mem_buffer_free(&src_buf);
+    return ok;
+}
+
+/* Private helper function: parse the p: method list, "all" or empty selects every method */
+static int parse_methods(const char *str, CopyMethod *methods)
+{
+    if (str[0] == '\0' || strcmp(str, "all") == 0)
+    {
+        for (int i = 0; i < COPY_METHOD_COUNT; i++)
+        {
+            methods[i] = (CopyMethod)i;
+        }
+        return COPY_METHOD_COUNT;
+    }
+
+    char list[64];
+    strncpy(list, str, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+
+    int count = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(list, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr))
+    {
+        int found = -1;
+        for (int i = 0; i < COPY_METHOD_COUNT; i++)
+        {
+            if (strcmp(token, method_names[i]) == 0)
+            {
+                found = i;
+            }
+        }
+        if (found < 0 || count == COPY_METHOD_COUNT)
+        {
+            return 0;
+        }
+        methods[count++] = (CopyMethod)found;
+    }
+    return count;
+}
+
+/* Private helper function: check whether the CPU can run a method */
+static bool method_supported(CopyMethod method)
+{
+    switch (method)
+    {
+    case COPY_LIBC:
+        return true;
+#if defined(__x86_64__)
+    case COPY_REP:
+        return true;
+    case COPY_AVX2:
+    case COPY_AVX2_NT:
+        return __builtin_cpu_supports("avx2");
+    case COPY_AVX512:
+    case COPY_AVX512_NT:
+        return __builtin_cpu_supports("avx512f");
+#endif
+    default:
+        return false;
+    }
+}
+
+/* Private helper function: find the implementation of a method */
+static CopyFunc lookup_method(CopyMethod method, CopyOp op)
+{
+    if (method == COPY_LIBC)
+    {
+        return op == COPY_OP_MEMCPY ? libc_memcpy : libc_memset;
+    }
+
+#if defined(__x86_64__)
+    static const CopyFunc table[COPY_METHOD_COUNT][COPY_OP_COUNT] = {
+        [COPY_REP] = {rep_memcpy, rep_memset},
+        [COPY_AVX2] = {avx2_memcpy, avx2_memset},
+        [COPY_AVX2_NT] = {avx2nt_memcpy, avx2nt_memset},
+        [COPY_AVX512] = {avx512_memcpy, avx512_memset},
+        [COPY_AVX512_NT] = {avx512nt_memcpy, avx512nt_memset},
+    };
+    return table[method][op];
+#else
+    return NULL;
+#endif
+}
+
+/* Private helper function: sizes from COPY_MIN_SIZE to limit, at each power of two and halfway past it */
+static int build_sizes(size_t *sizes, int max, size_t limit)
+{
+    int count = 0;
+    for (size_t size = COPY_MIN_SIZE; size <= limit && count < max; size *= 2)
+    {
+        sizes[count++] = size;
+        if (size + size / 2 <= limit && count < max)
+        {
+            sizes[count++] = size + size / 2;
+        }
+    }
+    if (count < max && sizes[count - 1] != limit)
+    {
+        sizes[count++] = limit;
+    }
+    return count;
+}
+
+/* Private helper function: the aligned case, then each offset on src, dst and both */
+static int build_alignments(CopyAlignment *alignments, int max, int offset)
+{
+    static const size_t default_offsets[] = {1, 32};
+    const size_t *offsets = default_offsets;
+    int offset_count = (int)(sizeof(default_offsets) / sizeof(default_offsets[0]));
+    size_t single = (size_t)offset;
+    if (offset > 0)
+    {
+        offsets = &single;
+        offset_count = 1;
+    }
+
+    int count = 0;
+    alignments[count++] = (CopyAlignment){0, 0};
+    for (int i = 0; i < offset_count && count + 3 <= max; i++)
+    {
+        alignments[count++] = (CopyAlignment){offsets[i], 0};
+        alignments[count++] = (CopyAlignment){0, offsets[i]};
+        alignments[count++] = (CopyAlignment){offsets[i], offsets[i]};
+    }
+    return count;
+}
+
+/* Private helper function: verify what a method wrote */
+static bool check_result(CopyOp op, const char *dst, const char *src, size_t n)
+{
+    if (op == COPY_OP_MEMCPY)
+    {
+        return memcmp(dst, src, n) == 0;
+    }
+
+    /* Every byte equals the fill iff the first does and each equals its neighbour */
+    return dst[0] == (char)COPY_FILL && memcmp(dst, dst + 1, n - 1) == 0;
+}
+
+/* Private helper function: calibrate a batch to a slice of the window, keep the best batch */
+static void measure(CopyFunc func, char *dst, const char *src, size_t n, uint64_t window_ns,
+                    CycleSource source, const PerfCounter *cycles, CopyResult *result)
+{
+    uint64_t batch_ns = window_ns / COPY_MIN_BATCHES;
+    uint64_t calls = 1;
+    for (;;)
+    {
+        uint64_t start = bench_now_ns();
+        for (uint64_t i = 0; i < calls; i++)
+        {
+            func(dst, src, n);
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        if (elapsed >= batch_ns / 2 || calls >= COPY_MAX_CALLS)
+        {
+            break;
+        }
+        calls = elapsed > 0 ? calls * batch_ns / elapsed + 1 : calls * 16;
+    }
+
+    double best_ns = 0.0;
+    uint64_t best_cycles = 0;
+    uint64_t window_start = bench_now_ns();
+    for (int batch = 0; batch < COPY_MIN_BATCHES || bench_now_ns() - window_start < window_ns; batch++)
+    {
+        uint64_t cycles_before = read_cycles(source, cycles);
+        uint64_t start = bench_now_ns();
+        for (uint64_t i = 0; i < calls; i++)
+        {
+            func(dst, src, n);
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        uint64_t spent = read_cycles(source, cycles) - cycles_before;
+
+        double per_call = (double)elapsed / (double)calls;
+        if (batch == 0 || per_call < best_ns)
+        {
+            best_ns = per_call;
+            best_cycles = spent;
+        }
+    }
+
+    result->ns_per_call = best_ns;
+    result->gbps = best_ns > 0.0 ? (double)n / best_ns : 0.0;
+    result->cycles_per_byte = (double)best_cycles / (double)calls / (double)n;
+}
+
+/* Private helper function: read the cycle counter in use */
+static uint64_t read_cycles(CycleSource source, const PerfCounter *cycles)
+{
+    switch (source)
+    {
+    case CYCLES_PERF:
+        return perf_counter_read(cycles);
+#if defined(__x86_64__)
+    case CYCLES_TSC:
+        return __rdtsc();
+#endif
+    default:
+        return 0;
+    }
+}
+
+/* Private helper function: log the fastest method per run of consecutive sizes */
+static void log_crossover(CopyOp op, const CopyAlignment *alignment, const size_t *sizes,
+                          const int *winners, int size_count)
+{
+    char line[512];
+    int used = 0;
+    int first = 0;
+    for (int s = 1; s <= size_count; s++)
+    {
+        if (s < size_count && winners[s] == winners[first])
+        {
+            continue;
+        }
+
+        char from[16], to[16];
+        format_size(sizes[first], from, sizeof(from));
+        format_size(sizes[s - 1], to, sizeof(to));
+        if (used < (int)sizeof(line))
+        {
+            used += snprintf(line + used, sizeof(line) - (size_t)used, "%s%s %s%s%s", first > 0 ? ", " : "",
+                             method_names[winners[first]], from, s - 1 > first ? "-" : "",
+                             s - 1 > first ? to : "");
+        }
+        logger_metric("mem_copy_crossover", "op=%s,src_offset=%zu,dst_offset=%zu,method=%s,from_bytes=%zu,to_bytes=%zu",
+                      op_names[op], alignment->src, alignment->dst, method_names[winners[first]], sizes[first],
+                      sizes[s - 1]);
+        first = s;
+    }
+    logger_info("Copy: fastest %s with src +%zu dst +%zu: %s", op_names[op], alignment->src, alignment->dst, line);
+}
+
+/* Private helper function: print a byte count with a binary unit */
+static void format_size(size_t bytes, char *buf, size_t len)
+{
+    static const char *const units[] = {"B", "KB", "MB", "GB", "TB"};
+    double value = (double)bytes;
+    int unit = 0;
+    while (value >= 1024.0 && unit < 4)
+    {
+        value /= 1024.0;
+        unit++;
+    }
+    if (value == (double)(uint64_t)value)
+    {
+        snprintf(buf, len, "%.0f %s", value, units[unit]);
+    }
+    else
+    {
+        snprintf(buf, len, "%.1f %s", value, units[unit]);
+    }
+}
@@ -0,0 +1,567 @@
+/**
+ * CPU Stress Generator Implementation
+ *
+ * This file implements the pinned worker threads and their deterministic
+ * kernels. Each kernel expands a small seed into its inputs, does a fixed
+ * amount of work and folds the output into a 64-bit checksum. In verify
+ * mode a worker compares every checksum with a table computed once before
+ * the workers start; the comparison is a single load and branch per
+ * kernel call, so verification costs well under 1% of throughput.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+/* Include our header files */
+#include "cpu_stress.h"
+#include "bench_util.h"
+#include "logger.h"
+
+/* Define constants */
+#define KERNEL_COUNT 6       /* Concrete kernels (everything before CPU_WORK_MIX) */
+#define REFERENCE_SEEDS 16   /* Distinct inputs cycled through by each worker */
+#define INT_ROUNDS 16384
+#define SIMD_ROUNDS 2048
+#define MEM_ROUNDS 4096
+#define MEM_TABLE_WORDS (4u << 20) /* 32 MB of uint64_t, shared read-only */
+#define BRANCH_ROUNDS 16384
+#define MATRIX_DIM 32
+#define FFT_SIZE 1024
+#define FFT_LOG2 10
+#define SCRATCH_BYTES (64 * 1024)
+#define MAX_LOGGED_MISMATCHES 10 /* Per worker, to keep a failing core from flooding the log */
+
+/* A kernel maps a seed to a checksum, using scratch for its buffers */
+typedef uint64_t (*KernelFunc)(uint64_t seed, void *scratch);
+
+/* Private helper function prototypes */
+static void *stress_worker(void *arg);
+static uint64_t kernel_int(uint64_t seed, void *scratch);
+static uint64_t kernel_fp(uint64_t seed, void *scratch);
+static uint64_t kernel_fft(uint64_t seed, void *scratch);
+static uint64_t kernel_simd(uint64_t seed, void *scratch);
+static uint64_t kernel_mem(uint64_t seed, void *scratch);
+static uint64_t kernel_branch(uint64_t seed, void *scratch);
+static void init_references(void);
+static bool compute_references(void);
+static void fft(double *re, double *im, bool inverse);
+static inline uint64_t splitmix64(uint64_t *state);
+static inline double unit_double(uint64_t bits);
+static inline uint64_t fold_doubles(uint64_t hash, const double *values, size_t count);
+
+static const KernelFunc kernels[KERNEL_COUNT] = {
+    kernel_int, kernel_fp, kernel_fft, kernel_simd, kernel_mem, kernel_branch};
+static const char *const workload_names[] = {"int", "fp", "fft", "avx", "mem", "branch", "mix"};
+
+/* Expected checksum for every kernel and seed, filled in once */
+static uint64_t references[KERNEL_COUNT][REFERENCE_SEEDS];
+static pthread_once_t references_once = PTHREAD_ONCE_INIT;
+static bool references_ready;
+
+/* FFT twiddle factors, part of the reference initialization */
+static double twiddle_re[FFT_SIZE / 2];
+static double twiddle_im[FFT_SIZE / 2];
+
+/* Random table walked by the memory kernel, part of the reference initialization */
+static uint64_t *mem_table = NULL;
+
+/**
+ * Parse a workload name
+ */
+CpuWorkload cpu_stress_parse_workload(const char *name)
+{
+    if (strcmp(name, "int") == 0)
+        return CPU_WORK_INT;
+    if (strcmp(name, "fp") == 0)
+        return CPU_WORK_FP;
+    if (strcmp(name, "fft") == 0)
+        return CPU_WORK_FFT;
+    if (strcmp(name, "avx") == 0 || strcmp(name, "simd") == 0)
+        return CPU_WORK_SIMD;
+    if (strcmp(name, "mem") == 0)
+        return CPU_WORK_MEM;
+    if (strcmp(name, "branch") == 0)
+        return CPU_WORK_BRANCH;
+    if (strcmp(name, "mix") == 0)
+        return CPU_WORK_MIX;
+    return CPU_WORK_INVALID;
+}
+
+/**
+ * Convert a workload to its name
+ */
+const char *cpu_stress_workload_name(CpuWorkload workload)
+{
+    if (workload < CPU_WORK_INT || workload >= CPU_WORK_INVALID)
+    {
+        return "unknown";
+    }
+    return workload_names[workload];
+}
+
+/**
+ * Start loading a set of CPUs
+ */
+bool cpu_stress_start(CpuStress *stress, const int *cpus, int count,
+                      CpuWorkload workload, bool verify)
+{
+    memset(stress, 0, sizeof(*stress));
+    if (count <= 0)
+    {
+        return true;
+    }
+    if (workload < CPU_WORK_INT || workload >= CPU_WORK_INVALID)
+    {
+        return false;
+    }
+
+    /* Twiddles and the memory table are needed even without verification */
+    pthread_once(&references_once, init_references);
+    if (!mem_table && (workload == CPU_WORK_MEM || workload == CPU_WORK_MIX))
+    {
+        return false;
+    }
+    if (verify && !references_ready)
+    {
+        /* Zero references would flag every iteration as a mismatch */
+        logger_error("CPU: cannot compute the verification references");
+        return false;
+    }
+
+    stress->workers = calloc((size_t)count, sizeof(CpuStressWorker));
+    if (!stress->workers)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        CpuStressWorker *worker = &stress->workers[i];
+        worker->cpu = cpus[i];
+        worker->workload = workload;
+        worker->verify = verify;
+        worker->stop = &stress->stop;
+
+        if (posix_memalign(&worker->scratch, 64, SCRATCH_BYTES) != 0)
+        {
+            worker->scratch = NULL;
+            cpu_stress_stop(stress);
+            cpu_stress_free(stress);
+            return false;
+        }
+
+        if (pthread_create(&worker->thread, NULL, stress_worker, worker) != 0)
+        {
+            free(worker->scratch);
+            worker->scratch = NULL;
+            cpu_stress_stop(stress);
+            cpu_stress_free(stress);
+            return false;
+        }
+        stress->count++;
+    }
+
+    return true;
+}
+
+/**
+ * Total iterations completed so far
+ */
+uint64_t cpu_stress_iterations(const CpuStress *stress)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < stress->count; i++)
+    {
+        total += __atomic_load_n(&stress->workers[i].iterations, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/**
+ * Stop a running generator
+ */
+uint64_t cpu_stress_stop(CpuStress *stress)
+{
+    uint64_t total = 0;
+
+    __atomic_store_n(&stress->stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < stress->count; i++)
+    {
+        pthread_join(stress->workers[i].thread, NULL);
+        total += stress->workers[i].iterations;
+    }
+    return total;
+}
+
+/**
+ * Release a stopped generator
+ */
+void cpu_stress_free(CpuStress *stress)
+{
+    if (stress->workers)
+    {
+        for (int i = 0; i < stress->count; i++)
+        {
+            free(stress->workers[i].scratch);
+        }
+        free(stress->workers);
+    }
+    stress->workers = NULL;
+    stress->count = 0;
+}
+
+/* Private helper function: pinned worker running one kernel in a loop */
+static void *stress_worker(void *arg)
+{
+    CpuStressWorker *worker = arg;
+    uint64_t sink = 0;
+    uint64_t iteration = 0;
+
+    bench_pin_cpu(worker->cpu);
+
+    while (!__atomic_load_n(worker->stop, __ATOMIC_ACQUIRE))
+    {
+        int kernel = (int)worker->workload;
+        uint64_t round = iteration;
+        if (worker->workload == CPU_WORK_MIX)
+        {
+            kernel = (int)(iteration % KERNEL_COUNT);
+            round = iteration / KERNEL_COUNT;
+        }
+        unsigned int slot = (unsigned int)(round % REFERENCE_SEEDS);
+
+        uint64_t result = kernels[kernel](slot + 1, worker->scratch);
+
+        if (worker->verify && result != references[kernel][slot])
+        {
+            worker->mismatches++;
+            if (worker->mismatches <= MAX_LOGGED_MISMATCHES)
+            {
+                logger_error("CPU: verification mismatch on core %d: workload %s, iteration %llu, "
+                             "seed %u, expected 0x%016llx, got 0x%016llx",
+                             worker->cpu, workload_names[kernel], (unsigned long long)iteration,
+                             slot + 1, (unsigned long long)references[kernel][slot],
+                             (unsigned long long)result);
+                logger_metric("cpu_sdc", "core=%d,workload=%s,iteration=%llu,unix_time=%lld,"
+                                         "expected=0x%016llx,actual=0x%016llx",
+                              worker->cpu, workload_names[kernel], (unsigned long long)iteration,
+                              (long long)time(NULL), (unsigned long long)references[kernel][slot],
+                              (unsigned long long)result);
+            }
+        }
+
+        sink ^= result;
+        iteration++;
+        __atomic_store_n(&worker->iterations, iteration, __ATOMIC_RELAXED);
+    }
+
+    /* Publish the results so the kernels have an observable effect */
+    __asm__ __volatile__("" : : "r"(sink));
+    return NULL;
+}
+
+/* Private helper function: pthread_once() entry point for compute_references() */
+static void init_references(void)
+{
+    references_ready = compute_references();
+}
+
+/* Private helper function to fill the reference table, false if it could not be */
+static bool compute_references(void)
+{
+    for (int i = 0; i < FFT_SIZE / 2; i++)
+    {
+        double angle = -2.0 * M_PI * (double)i / (double)FFT_SIZE;
+        twiddle_re[i] = cos(angle);
+        twiddle_im[i] = sin(angle);
+    }
+
+    uint64_t state = 0x243f6a8885a308d3ULL;
+    mem_table = malloc(sizeof(uint64_t) * MEM_TABLE_WORDS);
+    if (mem_table)
+    {
+        for (size_t i = 0; i < MEM_TABLE_WORDS; i++)
+        {
+            mem_table[i] = splitmix64(&state);
+        }
+    }
+
+    void *scratch = NULL;
+    if (posix_memalign(&scratch, 64, SCRATCH_BYTES) != 0)
+    {
+        return false;
+    }
+    for (int k = 0; k < KERNEL_COUNT; k++)
+    {
+        if (kernels[k] == kernel_mem && !mem_table)
+        {
+            continue;
+        }
+        for (unsigned int s = 0; s < REFERENCE_SEEDS; s++)
+        {
+            references[k][s] = kernels[k](s + 1, scratch);
+        }
+    }
+    free(scratch);
+    return true;
+}
+
+/* Private helper function: dependent xorshift/multiply hash chain */
+static uint64_t kernel_int(uint64_t seed, void *scratch)
+{
+    (void)scratch;
+    uint64_t x = splitmix64(&seed);
+
+    for (int i = 0; i < INT_ROUNDS; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        x *= 0x2545f4914f6cdd1dULL;
+    }
+    return x;
+}
+
+/* Private helper function: dense matrix product, checksum of the result bits */
+static uint64_t kernel_fp(uint64_t seed, void *scratch)
+{
+    double *a = scratch;
+    double *b = a + MATRIX_DIM * MATRIX_DIM;
+    double *c = b + MATRIX_DIM * MATRIX_DIM;
+    uint64_t state = seed;
+
+    for (int i = 0; i < MATRIX_DIM * MATRIX_DIM; i++)
+    {
+        a[i] = unit_double(splitmix64(&state));
+        b[i] = unit_double(splitmix64(&state));
+    }
+
+    for (int i = 0; i < MATRIX_DIM; i++)
+    {
+        for (int j = 0; j < MATRIX_DIM; j++)
+        {
+            double sum = 0.0;
+            for (int k = 0; k < MATRIX_DIM; k++)
+            {
+                sum += a[i * MATRIX_DIM + k] * b[k * MATRIX_DIM + j];
+            }
+            c[i * MATRIX_DIM + j] = sum;
+        }
+    }
+
+    return fold_doubles(seed, c, MATRIX_DIM * MATRIX_DIM);
+}
+
+/* Private helper function: FFT then inverse FFT, checksum of the round trip */
+static uint64_t kernel_fft(uint64_t seed, void *scratch)
+{
+    double *re = scratch;
+    double *im = re + FFT_SIZE;
+    uint64_t state = seed;
+
+    for (int i = 0; i < FFT_SIZE; i++)
+    {
+        re[i] = unit_double(splitmix64(&state));
+        im[i] = unit_double(splitmix64(&state));
+    }
+
+    fft(re, im, false);
+    fft(re, im, true);
+
+    uint64_t hash = fold_doubles(seed, re, FFT_SIZE);
+    return fold_doubles(hash, im, FFT_SIZE);
+}
+
+/*
+ * Private helper function: eight 32-bit xorshift/multiply lanes per vector.
+ * On x86-64 an AVX2 clone is selected at load time when the CPU supports it.
+ */
+typedef uint32_t v8u32 __attribute__((vector_size(32)));
+
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target_clones("avx2", "default")))
+#endif
+static uint64_t kernel_simd(uint64_t seed, void *scratch)
+{
+    (void)scratch;
+    v8u32 lanes[4];
+    uint64_t state = seed;
+
+    for (int v = 0; v < 4; v++)
+    {
+        for (int l = 0; l < 8; l++)
+        {
+            lanes[v][l] = (uint32_t)splitmix64(&state) | 1u;
+        }
+    }
+
+    for (int i = 0; i < SIMD_ROUNDS; i++)
+    {
+        for (int v = 0; v < 4; v++)
+        {
+            v8u32 x = lanes[v];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            x *= 0x9e3779b1u;
+            lanes[v] = x;
+        }
+    }
+
+    uint64_t hash = seed;
+    for (int v = 0; v < 4; v++)
+    {
+        for (int l = 0; l < 8; l++)
+        {
+            hash = (hash ^ lanes[v][l]) * 0x100000001b3ULL;
+        }
+    }
+    return hash;
+}
+
+/* Private helper function: chain of loads whose addresses depend on the previous value */
+static uint64_t kernel_mem(uint64_t seed, void *scratch)
+{
+    (void)scratch;
+    uint64_t x = splitmix64(&seed);
+
+    for (int i = 0; i < MEM_ROUNDS; i++)
+    {
+        x = (x ^ mem_table[x & (MEM_TABLE_WORDS - 1)]) * 0x9e3779b97f4a7c15ULL;
+        x ^= x >> 29;
+    }
+    return x;
+}
+
+/* Private helper function: random eight-way dispatch the predictor cannot learn */
+static uint64_t kernel_branch(uint64_t seed, void *scratch)
+{
+    (void)scratch;
+    uint64_t x = splitmix64(&seed);
+    uint64_t acc = seed;
+
+    for (int i = 0; i < BRANCH_ROUNDS; i++)
+    {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+
+        switch ((x >> 29) & 7)
+        {
+        case 0:
+            acc += x;
+            break;
+        case 1:
+            acc ^= x >> 3;
+            break;
+        case 2:
+            acc = (acc << 5) | (acc >> 59);
+            break;
+        case 3:
+            acc -= x;
+            break;
+        case 4:
+            acc *= 3;
+            break;
+        case 5:
+            acc ^= acc >> 11;
+            break;
+        case 6:
+            acc += 0x632be59bd9b4e019ULL;
+            break;
+        default:
+            if (x & 0x100)
+                acc = ~acc;
+            break;
+        }
+    }
+    return acc;
+}
+
+/* Private helper function: in-place iterative radix-2 FFT of FFT_SIZE points */
+static void fft(double *re, double *im, bool inverse)
+{
+    /* Bit-reversal permutation */
+    for (unsigned int i = 0; i < FFT_SIZE; i++)
+    {
+        unsigned int j = 0;
+        for (int b = 0; b < FFT_LOG2; b++)
+        {
+            j |= ((i >> b) & 1u) << (FFT_LOG2 - 1 - b);
+        }
+        if (j > i)
+        {
+            double t = re[i];
+            re[i] = re[j];
+            re[j] = t;
+            t = im[i];
+            im[i] = im[j];
+            im[j] = t;
+        }
+    }
+
+    double sign = inverse ? -1.0 : 1.0;
+    for (unsigned int len = 2; len <= FFT_SIZE; len <<= 1)
+    {
+        unsigned int half = len / 2;
+        unsigned int step = FFT_SIZE / len;
+        for (unsigned int start = 0; start < FFT_SIZE; start += len)
+        {
+            for (unsigned int k = 0; k < half; k++)
+            {
+                double wr = twiddle_re[k * step];
+                double wi = sign * twiddle_im[k * step];
+                unsigned int a = start + k;
+                unsigned int b = a + half;
+                double tr = re[b] * wr - im[b] * wi;
+                double ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    if (inverse)
+    {
+        for (int i = 0; i < FFT_SIZE; i++)
+        {
+            re[i] /= FFT_SIZE;
+            im[i] /= FFT_SIZE;
+        }
+    }
+}
+
+/* Private helper function: splitmix64 generator step */
+static inline uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/* Private helper function: map 64 random bits to a double in [-1, 1) */
+static inline double unit_double(uint64_t bits)
+{
+    return (double)(bits >> 11) * 0x1.0p-52 - 1.0;
+}
+
+/* Private helper function: fold the exact bit patterns of doubles into a hash */
+static inline uint64_t fold_doubles(uint64_t hash, const double *values, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        uint64_t bits;
+        memcpy(&bits, &values[i], sizeof(bits));
+        hash = (hash ^ bits) * 0x100000001b3ULL;
+    }
+    return hash;
+}
@@ -1 +1,178 @@
-# CPU testing functions
+/**
+ * CPU Test Implementation
+ *
+ * This file selects and runs the CPU test requested by the component
+ * configuration. Stress workloads run here directly on top of the stress
+ * generator; microbenchmarks live in their own source files.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Include our header files */
+#include "cpu_test.h"
+#include "bench_util.h"
+#include "cpu_stress.h"
+#include "ipc_test.h"
+#include "logger.h"
+#include "smt_test.h"
+#include "spawn_test.h"
+#include "syscall_test.h"
+#include "topology.h"
+
+/* Define constants */
+#define DEFAULT_STRESS_SECONDS 60
+
+/* Private helper function prototypes */
+static bool run_stress_workload(const ComponentConfig *comp, CpuWorkload workload);
+
+/**
+ * Run a CPU component test
+ */
+bool cpu_test_run(const ComponentConfig *comp)
+{
+    const char *workload = comp->options.cpu.workload_type;
+
+    if (strcmp(workload, "ipc") == 0)
+    {
+        return ipc_test_run(comp);
+    }
+    if (strcmp(workload, "syscall") == 0)
+    {
+        return syscall_test_run(comp);
+    }
+    if (strcmp(workload, "spawn") == 0)
+    {
+        return spawn_test_run(comp);
+    }
+    if (strcmp(workload, "smt") == 0)
+    {
+        return smt_test_run(comp);
+    }
+
+    CpuWorkload stress_workload = cpu_stress_parse_workload(workload);
+    if (stress_workload != CPU_WORK_INVALID)
+    {
+        return run_stress_workload(comp, stress_workload);
+    }
+
+    logger_error("CPU: unsupported workload '%s'", workload[0] ? workload : "(none)");
+    return false;
+}
+
+/* Private helper function to load the selected CPUs and report throughput each second */
+static bool run_stress_workload(const ComponentConfig *comp, CpuWorkload workload)
+{
+    const CPUOptions *opts = &comp->options.cpu;
+    int threads_per_core = opts->threads_per_core > 0 ? opts->threads_per_core : 1;
+    int duration = comp->duration > 0 ? comp->duration : DEFAULT_STRESS_SECONDS;
+
+    /* Use the cr: list if given, otherwise every online CPU */
+    int *cpus = NULL;
+    int cpu_count = 0;
+    if (opts->core_count > 0)
+    {
+        cpus = malloc(sizeof(int) * (size_t)opts->core_count * (size_t)threads_per_core);
+        if (!cpus)
+        {
+            return false;
+        }
+        for (int i = 0; i < opts->core_count; i++)
+        {
+            for (int t = 0; t < threads_per_core; t++)
+            {
+                cpus[cpu_count++] = opts->cores[i];
+            }
+        }
+    }
+    else
+    {
+        CpuTopology topo;
+        if (!topology_load(&topo))
+        {
+            logger_error("CPU: unable to read CPU topology");
+            return false;
+        }
+        cpus = malloc(sizeof(int) * (size_t)topo.count * (size_t)threads_per_core);
+        if (!cpus)
+        {
+            topology_free(&topo);
+            return false;
+        }
+        for (int i = 0; i < topo.count; i++)
+        {
+            for (int t = 0; t < threads_per_core; t++)
+            {
+                cpus[cpu_count++] = topo.cpus[i].cpu;
+            }
+        }
+        topology_free(&topo);
+    }
+
+    CpuStress stress;
+    if (!cpu_stress_start(&stress, cpus, cpu_count, workload, opts->verify))
+    {
+        logger_error("CPU: failed to start %d %s workers", cpu_count,
+                     cpu_stress_workload_name(workload));
+        free(cpus);
+        return false;
+    }
+
+    logger_info("CPU: running %s workload on %d threads for %d seconds (verification %s)",
+                cpu_stress_workload_name(workload), cpu_count, duration,
+                opts->verify ? "enabled" : "disabled");
+
+    uint64_t start = bench_now_ns();
+    uint64_t last_time = start;
+    uint64_t last_iterations = 0;
+    for (int second = 0; second < duration; second++)
+    {
+        sleep(1);
+
+        uint64_t now = bench_now_ns();
+        uint64_t iterations = cpu_stress_iterations(&stress);
+        double rate = (double)(iterations - last_iterations) * 1e9 / (double)(now - last_time);
+        logger_metric("cpu_stress", "workload=%s,threads=%d,iterations_per_sec=%.1f",
+                      cpu_stress_workload_name(workload), cpu_count, rate);
+        last_time = now;
+        last_iterations = iterations;
+    }
+
+    uint64_t total = cpu_stress_stop(&stress);
+    double elapsed = (double)(bench_now_ns() - start) / 1e9;
+
+    uint64_t mismatches = 0;
+    for (int i = 0; i < stress.count; i++)
+    {
+        if (stress.workers[i].mismatches > 0)
+        {
+            logger_error("CPU: core %d reported %llu verification mismatches",
+                         stress.workers[i].cpu, (unsigned long long)stress.workers[i].mismatches);
+        }
+        mismatches += stress.workers[i].mismatches;
+    }
+    cpu_stress_free(&stress);
+    free(cpus);
+
+    logger_info("CPU: %s workload finished: %llu iterations, %.1f per second",
+                cpu_stress_workload_name(workload), (unsigned long long)total,
+                (double)total / elapsed);
+    logger_metric("cpu_stress_summary", "workload=%s,threads=%d,iterations=%llu,"
+                                        "iterations_per_sec=%.1f,verify=%s,mismatches=%llu",
+                  cpu_stress_workload_name(workload), cpu_count, (unsigned long long)total,
+                  (double)total / elapsed, opts->verify ? "true" : "false",
+                  (unsigned long long)mismatches);
+
+    if (mismatches > 0)
+    {
+        logger_error("CPU: %llu verification mismatches detected, failing the run",
+                     (unsigned long long)mismatches);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,195 @@
+/**
+ * Write Data Generator Implementation
+ *
+ * This file implements the write data generator. A block's bytes are a
+ * pure function of the profile and a 64-bit seed: eight xoshiro256+
+ * lanes, seeded from it with splitmix64, fill the block 64 bytes per
+ * step, then the tail of every segment is cleared to zeros. The lanes
+ * are GCC vector types, and on x86-64 an AVX2 clone of the fill loop is
+ * selected at load time when the CPU supports it. Each generator picks
+ * block seeds from its own splitmix64 stream; duplicate blocks use one
+ * of DATA_DUP_POOL seeds derived from the run seed instead.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <string.h>
+
+/* Include our header files */
+#include "data_gen.h"
+
+typedef uint64_t v4u64 __attribute__((vector_size(32)));
+
+/* Private helper function prototypes */
+static void fill_random(unsigned char *buf, size_t size, uint64_t seed);
+static size_t zeros_per_block(const DataProfile *profile, size_t size);
+static inline uint64_t splitmix64(uint64_t *state);
+
+/**
+ * Set up a profile
+ */
+void data_profile_init(DataProfile *profile, int compress_pct, int dedupe_pct, uint64_t seed)
+{
+    memset(profile, 0, sizeof(*profile));
+    profile->compress_pct = compress_pct;
+    profile->dedupe_pct = dedupe_pct;
+    profile->seed = seed;
+}
+
+/**
+ * Set up one thread's generator
+ */
+void data_gen_init(DataGen *gen, DataProfile *profile, uint64_t stream)
+{
+    memset(gen, 0, sizeof(*gen));
+    gen->profile = profile;
+    gen->state = profile->seed ^ ((stream + 1) * 0x9E3779B97F4A7C15ULL);
+    splitmix64(&gen->state);
+}
+
+/**
+ * Generate the next block
+ */
+void data_gen_block(DataGen *gen, void *buf, size_t size)
+{
+    DataProfile *profile = gen->profile;
+    uint64_t seed = splitmix64(&gen->state);
+
+    if (profile->dedupe_pct > 0 && (int)(splitmix64(&gen->state) % 100) < profile->dedupe_pct)
+    {
+        uint64_t index = seed % DATA_DUP_POOL;
+        uint64_t bit = 1ULL << (index % 64);
+        seed = profile->seed ^ ((index + 1) * 0xD1B54A32D192ED03ULL);
+
+        /* Only the first write of a pool block touches the shared line */
+        if (!(__atomic_load_n(&profile->pool_used[index / 64], __ATOMIC_RELAXED) & bit))
+        {
+            __atomic_fetch_or(&profile->pool_used[index / 64], bit, __ATOMIC_RELAXED);
+        }
+        gen->duplicates++;
+    }
+
+    data_gen_block_seed(gen, buf, size, seed);
+}
+
+/**
+ * Generate a block from a chosen seed
+ */
+void data_gen_block_seed(DataGen *gen, void *buf, size_t size, uint64_t seed)
+{
+    data_gen_fill(gen->profile, buf, size, seed);
+    gen->blocks++;
+    gen->bytes += size;
+    gen->zero_bytes += zeros_per_block(gen->profile, size);
+}
+
+/**
+ * Fill a buffer with the data of one seed
+ */
+void data_gen_fill(const DataProfile *profile, void *buf, size_t size, uint64_t seed)
+{
+    fill_random(buf, size, seed);
+    if (profile->compress_pct <= 0)
+    {
+        return;
+    }
+
+    size_t keep = DATA_SEGMENT - DATA_SEGMENT * (size_t)profile->compress_pct / 100;
+    for (size_t off = 0; off < size; off += DATA_SEGMENT)
+    {
+        size_t segment = size - off < DATA_SEGMENT ? size - off : DATA_SEGMENT;
+        if (segment > keep)
+        {
+            memset((unsigned char *)buf + off + keep, 0, segment - keep);
+        }
+    }
+}
+
+/**
+ * Count the duplicate-pool blocks written so far
+ */
+uint64_t data_profile_pool_used(const DataProfile *profile)
+{
+    uint64_t used = 0;
+    for (int i = 0; i < DATA_DUP_POOL / 64; i++)
+    {
+        used += (uint64_t)__builtin_popcountll(__atomic_load_n(&profile->pool_used[i], __ATOMIC_RELAXED));
+    }
+    return used;
+}
+
+/* Private helper function: one xoshiro256+ step on four lanes */
+#define XOSHIRO_STEP(out, s0, s1, s2, s3)         \
+    do                                            \
+    {                                             \
+        v4u64 t_ = (s1) << 17;                    \
+        (out) = (s0) + (s3);                      \
+        (s2) ^= (s0);                             \
+        (s3) ^= (s1);                             \
+        (s1) ^= (s2);                             \
+        (s0) ^= (s3);                             \
+        (s2) ^= t_;                               \
+        (s3) = ((s3) << 45) | ((s3) >> 19);       \
+    } while (0)
+
+/*
+ * Private helper function: eight xoshiro256+ lanes, two vectors of four,
+ * 64 bytes per step. The state lives in named vectors so it stays in
+ * registers across the loop.
+ */
+#if defined(__x86_64__) && defined(__GNUC__)
+__attribute__((target_clones("avx2", "default")))
+#endif
+static void fill_random(unsigned char *buf, size_t size, uint64_t seed)
+{
+    v4u64 init[8];
+    for (int v = 0; v < 8; v++)
+    {
+        for (int l = 0; l < 4; l++)
+        {
+            init[v][l] = splitmix64(&seed);
+        }
+    }
+    v4u64 a0 = init[0], a1 = init[1], a2 = init[2], a3 = init[3];
+    v4u64 b0 = init[4], b1 = init[5], b2 = init[6], b3 = init[7];
+
+    v4u64 out[2];
+    size_t off = 0;
+    for (; off + sizeof(out) <= size; off += sizeof(out))
+    {
+        XOSHIRO_STEP(out[0], a0, a1, a2, a3);
+        XOSHIRO_STEP(out[1], b0, b1, b2, b3);
+        memcpy(buf + off, out, sizeof(out));
+    }
+    if (off < size)
+    {
+        XOSHIRO_STEP(out[0], a0, a1, a2, a3);
+        XOSHIRO_STEP(out[1], b0, b1, b2, b3);
+        memcpy(buf + off, out, size - off);
+    }
+}
+
+/* Private helper function: zero bytes data_gen_fill() leaves in a block of a given size */
+static size_t zeros_per_block(const DataProfile *profile, size_t size)
+{
+    if (profile->compress_pct <= 0)
+    {
+        return 0;
+    }
+    size_t keep = DATA_SEGMENT - DATA_SEGMENT * (size_t)profile->compress_pct / 100;
+    size_t zeros = size / DATA_SEGMENT * (DATA_SEGMENT - keep);
+    size_t tail = size % DATA_SEGMENT;
+    return zeros + (tail > keep ? tail - keep : 0);
+}
+
+/* Private helper function: splitmix64 generator, seeds the lanes and picks block seeds */
+static inline uint64_t splitmix64(uint64_t *state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
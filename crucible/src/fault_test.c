@@ -0,0 +1,603 @@
+/**
+ * Page Fault Test Implementation
+ *
+ * This file implements the page fault cost test. A pool of pinned worker
+ * threads shares one address space and is driven by the main thread in
+ * four barrier-separated phases per iteration: prepare (map, and touch if
+ * the method needs resident memory), advise (MADV_DONTNEED or MADV_FREE),
+ * measure (the faulting step under test) and unmap. Keeping the measure
+ * phase in its own round makes every thread fault at the same time, so
+ * the concurrent numbers include mmap_lock and page allocator contention.
+ * Each thread counts its own minor faults with a software perf event,
+ * which shows fault-around, THP and lazy-free reuse directly. MAP_POPULATE
+ * and mlock() fault through get_user_pages(), which raises no perf event,
+ * so those two read the thread's minor fault count from getrusage()
+ * instead.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+/* Include our header files */
+#include "fault_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "perf_counter.h"
+#include "topology.h"
+
+/* Define constants */
+#define FAULT_DEFAULT_REGION (256ULL << 20)
+#define FAULT_REGION_ALIGN (2ULL << 20)
+#define FAULT_BASE_PAGE 4096
+#define FAULT_MAX_THREADS 256
+#define FAULT_MIN_ITERATIONS 3
+#define FAULT_MIN_WINDOW_NS 200000000ULL
+#define FAULT_MAX_WINDOW_NS 10000000000ULL
+#define FAULT_LINE_SIZE 64
+
+typedef enum
+{
+    FAULT_TOUCH,
+    FAULT_POPULATE,
+    FAULT_MLOCK,
+    FAULT_DONTNEED,
+    FAULT_FREE,
+    FAULT_METHOD_COUNT
+} FaultMethod;
+
+typedef enum
+{
+    PHASE_PREPARE,
+    PHASE_ADVISE,
+    PHASE_MEASURE,
+    PHASE_UNMAP
+} FaultPhase;
+
+static const char *const method_names[FAULT_METHOD_COUNT] = {"touch", "populate", "mlock", "dontneed", "free"};
+
+/* Per-thread state, one cache line apart */
+typedef struct
+{
+    pthread_t thread;
+    int cpu;
+    MemBuffer region;     /* Mapping for every method except populate */
+    void *populated;      /* MAP_POPULATE mapping */
+    PerfCounter faults;
+    bool counting;        /* Fault counter opened */
+    uint64_t fault_ns;    /* Time spent in the measure phase */
+    uint64_t advise_ns;
+    uint64_t unmap_ns;
+    uint64_t fault_count;
+    int error;            /* errno of the first failure, 0 if none */
+} __attribute__((aligned(FAULT_LINE_SIZE))) FaultWorker;
+
+/* Worker pool driven by the main thread */
+typedef struct
+{
+    FaultWorker *workers;
+    int thread_count;
+    int active;               /* Threads taking part in the current method */
+    FaultMethod method;
+    FaultPhase phase;
+    size_t region_size;
+    MemPageType pages;
+    bool quit;
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    pthread_mutex_t gate;     /* Held while the pool is being sized */
+} FaultPool;
+
+typedef struct
+{
+    FaultPool *pool;
+    int index;
+} FaultWorkerArg;
+
+/* Outcome of one method */
+typedef struct
+{
+    int iterations;
+    double pages_per_sec;
+    double ns_per_page;
+    double advise_ns_per_page;
+    double unmap_ns_per_page;
+    bool counted;         /* faults holds a real count */
+    uint64_t faults;
+    double faults_per_sec;
+    double ns_per_fault;
+} FaultResult;
+
+/* Private helper function prototypes */
+static int parse_methods(const char *str, FaultMethod *methods);
+static void *fault_worker(void *arg);
+static void run_phase(FaultWorker *worker, const FaultPool *pool);
+static void touch_pages(char *data, size_t size);
+static bool gup_method(FaultMethod method);
+static uint64_t thread_minor_faults(void);
+static void run_round(FaultPool *pool, FaultPhase phase);
+static int first_error(const FaultPool *pool);
+static bool measure_method(FaultPool *pool, FaultMethod method, int threads, uint64_t window_ns,
+                           FaultResult *result);
+
+/**
+ * Run the page fault test
+ */
+bool fault_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    FaultMethod methods[FAULT_METHOD_COUNT];
+    int method_count = parse_methods(opts->pattern, methods);
+    if (method_count == 0)
+    {
+        logger_error("Fault: invalid method list '%s'", opts->pattern);
+        return false;
+    }
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Fault: invalid page type '%s'", opts->pages);
+        return false;
+    }
+
+    size_t region = FAULT_DEFAULT_REGION;
+    if (opts->size[0] != '\0' && !bench_parse_size(opts->size, &region))
+    {
+        logger_error("Fault: invalid size '%s'", opts->size);
+        return false;
+    }
+
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        logger_error("Fault: cannot read CPU topology");
+        return false;
+    }
+
+    int thread_count = opts->threads > 0 ? opts->threads : topo.count;
+    if (thread_count > FAULT_MAX_THREADS)
+    {
+        thread_count = FAULT_MAX_THREADS;
+    }
+
+    /* All threads hold their regions at once in the concurrent pass */
+    size_t available = bench_mem_available() / 2;
+    if (available > 0 && region * (size_t)thread_count > available)
+    {
+        size_t shrunk = available / (size_t)thread_count;
+        logger_warning("Fault: %zu MB per thread requested, using %zu MB", region >> 20, shrunk >> 20);
+        region = shrunk;
+    }
+    region -= region % FAULT_REGION_ALIGN;
+    if (region == 0)
+    {
+        logger_error("Fault: region too small");
+        topology_free(&topo);
+        return false;
+    }
+
+    FaultPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.workers = aligned_alloc(FAULT_LINE_SIZE, (size_t)thread_count * sizeof(FaultWorker));
+    FaultWorkerArg *args = calloc((size_t)thread_count, sizeof(FaultWorkerArg));
+    if (!pool.workers || !args)
+    {
+        logger_error("Fault: setup failed");
+        free(pool.workers);
+        free(args);
+        topology_free(&topo);
+        return false;
+    }
+    memset(pool.workers, 0, (size_t)thread_count * sizeof(FaultWorker));
+    pool.region_size = region;
+
+    /*
+     * Workers wait on the gate until the barriers exist, so the barriers can
+     * be sized for however many threads actually started.
+     */
+    pthread_mutex_init(&pool.gate, NULL);
+    pthread_mutex_lock(&pool.gate);
+    int started = 0;
+    for (int i = 0; i < thread_count; i++)
+    {
+        pool.workers[i].cpu = topo.cpus[i % topo.count].cpu;
+        args[i].pool = &pool;
+        args[i].index = i;
+        if (pthread_create(&pool.workers[i].thread, NULL, fault_worker, &args[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started != thread_count)
+    {
+        logger_warning("Fault: only %d of %d worker threads started", started, thread_count);
+    }
+    pool.thread_count = started;
+    pthread_barrier_init(&pool.start, NULL, (unsigned int)started + 1);
+    pthread_barrier_init(&pool.done, NULL, (unsigned int)started + 1);
+    pthread_mutex_unlock(&pool.gate);
+    topology_free(&topo);
+
+    /* One pass on a single thread, then one with every thread unless that is the same */
+    int modes[2] = {1, started};
+    int mode_count = started > 1 ? 2 : 1;
+    int run_count = type_count * method_count * mode_count;
+    uint64_t window = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)run_count;
+    if (window < FAULT_MIN_WINDOW_NS)
+        window = FAULT_MIN_WINDOW_NS;
+    if (window > FAULT_MAX_WINDOW_NS)
+        window = FAULT_MAX_WINDOW_NS;
+
+    /* An empty round makes sure every worker has opened its counter */
+    pool.active = 0;
+    run_round(&pool, PHASE_UNMAP);
+    bool counting = started > 0 && pool.workers[0].counting;
+    logger_info("Fault: %zu MB per thread, up to %d threads, fault counter %s",
+                region >> 20, started, counting ? "available" : "unavailable (populate and mlock only)");
+
+    bool ok = started > 0;
+    for (int t = 0; t < type_count && ok; t++)
+    {
+        if (types[t] == MEM_PAGES_2M || types[t] == MEM_PAGES_1G)
+        {
+            logger_info("Fault: %s pages come from the hugetlbfs reserve, skipped", mem_buffer_page_name(types[t]));
+            continue;
+        }
+        pool.pages = types[t];
+
+        for (int m = 0; m < mode_count && ok; m++)
+        {
+            for (int i = 0; i < method_count && ok; i++)
+            {
+                FaultMethod method = methods[i];
+                if (method == FAULT_POPULATE && pool.pages != MEM_PAGES_DEFAULT)
+                {
+                    /* MAP_POPULATE faults before any madvise() could pick the page size */
+                    if (m == 0)
+                        logger_info("Fault: populate only runs with the default page policy, skipped for %s",
+                                    mem_buffer_page_name(pool.pages));
+                    continue;
+                }
+
+                FaultResult result;
+                if (!measure_method(&pool, method, modes[m], window, &result))
+                {
+                    int error = first_error(&pool);
+                    if (method == FAULT_MLOCK && (error == EPERM || error == ENOMEM || error == EAGAIN))
+                    {
+                        logger_warning("Fault: mlock refused (%s), raise RLIMIT_MEMLOCK to measure it",
+                                       strerror(error));
+                        continue;
+                    }
+                    logger_error("Fault: %s failed on %s pages: %s", method_names[method],
+                                 mem_buffer_page_name(pool.pages), strerror(error));
+                    ok = false;
+                    break;
+                }
+
+                logger_info("Fault: %-8s %-7s %3d threads: %8.1f ns/page, %7.3f M pages/s, unmap %6.1f ns/page",
+                            method_names[method], mem_buffer_page_name(pool.pages), modes[m], result.ns_per_page,
+                            result.pages_per_sec / 1e6, result.unmap_ns_per_page);
+
+                char extra[160] = "";
+                int len = 0;
+                if (method == FAULT_DONTNEED || method == FAULT_FREE)
+                {
+                    len += snprintf(extra + len, sizeof(extra) - (size_t)len, ",advise_ns_per_page=%.2f",
+                                    result.advise_ns_per_page);
+                }
+                if (result.counted)
+                {
+                    double pages = result.pages_per_sec > 0.0 ? result.faults_per_sec / result.pages_per_sec : 0.0;
+                    len += snprintf(extra + len, sizeof(extra) - (size_t)len,
+                                    ",faults_per_sec=%.0f,faults_per_page=%.4f", result.faults_per_sec, pages);
+                    if (result.faults > 0)
+                    {
+                        snprintf(extra + len, sizeof(extra) - (size_t)len, ",ns_per_fault=%.1f", result.ns_per_fault);
+                    }
+                }
+                logger_metric("mem_fault", "method=%s,pages=%s,threads=%d,region_mb=%zu,iterations=%d,"
+                              "pages_per_sec=%.0f,ns_per_page=%.2f,unmap_ns_per_page=%.2f%s",
+                              method_names[method], mem_buffer_page_name(pool.pages), modes[m], region >> 20,
+                              result.iterations, result.pages_per_sec, result.ns_per_page,
+                              result.unmap_ns_per_page, extra);
+            }
+        }
+    }
+
+    pool.quit = true;
+    pthread_barrier_wait(&pool.start);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(pool.workers[i].thread, NULL);
+    }
+
+    pthread_barrier_destroy(&pool.start);
+    pthread_barrier_destroy(&pool.done);
+    pthread_mutex_destroy(&pool.gate);
+    free(args);
+    free(pool.workers);
+    return ok;
+}
+
+/* Private helper function: parse a comma-separated method list, returns the count */
+static int parse_methods(const char *str, FaultMethod *methods)
+{
+    if (str[0] == '\0' || strcmp(str, "all") == 0)
+    {
+        for (int i = 0; i < FAULT_METHOD_COUNT; i++)
+        {
+            methods[i] = (FaultMethod)i;
+        }
+        return FAULT_METHOD_COUNT;
+    }
+
+    char list[64];
+    strncpy(list, str, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+
+    int count = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(list, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr))
+    {
+        int found = -1;
+        for (int i = 0; i < FAULT_METHOD_COUNT; i++)
+        {
+            if (strcmp(token, method_names[i]) == 0)
+            {
+                found = i;
+            }
+        }
+        if (found < 0 || count == FAULT_METHOD_COUNT)
+        {
+            return 0;
+        }
+        methods[count++] = (FaultMethod)found;
+    }
+    return count;
+}
+
+/* Private helper function: worker thread, runs one phase per round */
+static void *fault_worker(void *arg)
+{
+    FaultWorkerArg *worker_arg = arg;
+    FaultPool *pool = worker_arg->pool;
+    int index = worker_arg->index;
+    FaultWorker *worker = &pool->workers[index];
+    bench_pin_cpu(worker->cpu);
+
+    /* Count this thread only, so every worker sees its own faults */
+    worker->counting = perf_counter_open(&worker->faults, PERF_MINOR_FAULTS, false);
+
+    pthread_mutex_lock(&pool->gate);
+    pthread_mutex_unlock(&pool->gate);
+
+    for (;;)
+    {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit)
+        {
+            break;
+        }
+
+        if (index < pool->active)
+        {
+            run_phase(worker, pool);
+        }
+
+        pthread_barrier_wait(&pool->done);
+    }
+
+    perf_counter_close(&worker->faults);
+    return NULL;
+}
+
+/* Private helper function: one phase of the current method on one thread */
+static void run_phase(FaultWorker *worker, const FaultPool *pool)
+{
+    size_t size = pool->region_size;
+    FaultMethod method = pool->method;
+    bool resident = (method == FAULT_DONTNEED || method == FAULT_FREE);
+
+    /* Unmapping always runs so a failed iteration leaves nothing behind */
+    if (worker->error && pool->phase != PHASE_UNMAP)
+    {
+        return;
+    }
+
+    switch (pool->phase)
+    {
+    case PHASE_PREPARE:
+        if (method != FAULT_POPULATE)
+        {
+            errno = 0;
+            if (!mem_buffer_alloc_pages(&worker->region, size, 0, pool->pages))
+            {
+                worker->error = errno ? errno : ENOMEM;
+                return;
+            }
+            if (resident)
+            {
+                touch_pages(worker->region.data, size);
+            }
+        }
+        break;
+
+    case PHASE_ADVISE:
+        if (resident)
+        {
+            uint64_t t0 = bench_now_ns();
+            if (madvise(worker->region.data, size, method == FAULT_FREE ? MADV_FREE : MADV_DONTNEED) != 0)
+            {
+                worker->error = errno;
+            }
+            worker->advise_ns += bench_now_ns() - t0;
+        }
+        break;
+
+    case PHASE_MEASURE:
+    {
+        bool gup = gup_method(method);
+        uint64_t f0 = gup ? thread_minor_faults() : worker->counting ? perf_counter_read(&worker->faults) : 0;
+        uint64_t t0 = bench_now_ns();
+        if (method == FAULT_POPULATE)
+        {
+            void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+            if (map == MAP_FAILED)
+                worker->error = errno;
+            else
+                worker->populated = map;
+        }
+        else if (method == FAULT_MLOCK)
+        {
+            if (mlock(worker->region.data, size) != 0)
+                worker->error = errno;
+        }
+        else
+        {
+            touch_pages(worker->region.data, size);
+        }
+        worker->fault_ns += bench_now_ns() - t0;
+        if (gup)
+        {
+            worker->fault_count += thread_minor_faults() - f0;
+        }
+        else if (worker->counting)
+        {
+            worker->fault_count += perf_counter_read(&worker->faults) - f0;
+        }
+        break;
+    }
+
+    case PHASE_UNMAP:
+    {
+        uint64_t t0 = bench_now_ns();
+        if (worker->populated)
+        {
+            munmap(worker->populated, size);
+            worker->populated = NULL;
+        }
+        mem_buffer_free(&worker->region);
+        worker->unmap_ns += bench_now_ns() - t0;
+        break;
+    }
+    }
+}
+
+/* Private helper function: write one byte in every base page */
+static void touch_pages(char *data, size_t size)
+{
+    for (size_t offset = 0; offset < size; offset += FAULT_BASE_PAGE)
+    {
+        ((volatile char *)data)[offset] = 1;
+    }
+}
+
+/* Private helper function: whether a method faults through get_user_pages() rather than user accesses */
+static bool gup_method(FaultMethod method)
+{
+    return method == FAULT_POPULATE || method == FAULT_MLOCK;
+}
+
+/* Private helper function: minor faults of the calling thread, counted for get_user_pages() too */
+static uint64_t thread_minor_faults(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) != 0)
+    {
+        return 0;
+    }
+    return (uint64_t)usage.ru_minflt;
+}
+
+/* Private helper function: run one phase on every active worker and wait for it */
+static void run_round(FaultPool *pool, FaultPhase phase)
+{
+    pool->phase = phase;
+    pthread_barrier_wait(&pool->start);
+    pthread_barrier_wait(&pool->done);
+}
+
+/* Private helper function: first errno recorded by any worker, 0 if none */
+static int first_error(const FaultPool *pool)
+{
+    for (int i = 0; i < pool->active; i++)
+    {
+        if (pool->workers[i].error)
+        {
+            return pool->workers[i].error;
+        }
+    }
+    return 0;
+}
+
+/* Private helper function: repeat one method until the window is used up */
+static bool measure_method(FaultPool *pool, FaultMethod method, int threads, uint64_t window_ns,
+                           FaultResult *result)
+{
+    memset(result, 0, sizeof(*result));
+    pool->method = method;
+    pool->active = threads;
+    for (int i = 0; i < threads; i++)
+    {
+        FaultWorker *worker = &pool->workers[i];
+        worker->fault_ns = 0;
+        worker->advise_ns = 0;
+        worker->unmap_ns = 0;
+        worker->fault_count = 0;
+        worker->error = 0;
+    }
+
+    uint64_t wall_ns = 0;
+    uint64_t start = bench_now_ns();
+    int iterations = 0;
+    while (iterations < FAULT_MIN_ITERATIONS || bench_now_ns() - start < window_ns)
+    {
+        run_round(pool, PHASE_PREPARE);
+        run_round(pool, PHASE_ADVISE);
+        uint64_t t0 = bench_now_ns();
+        run_round(pool, PHASE_MEASURE);
+        wall_ns += bench_now_ns() - t0;
+        run_round(pool, PHASE_UNMAP);
+
+        if (first_error(pool))
+        {
+            return false;
+        }
+        iterations++;
+    }
+
+    double pages = (double)(pool->region_size / FAULT_BASE_PAGE) * iterations;
+    uint64_t fault_ns = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        const FaultWorker *worker = &pool->workers[i];
+        result->ns_per_page += (double)worker->fault_ns / pages / threads;
+        result->advise_ns_per_page += (double)worker->advise_ns / pages / threads;
+        result->unmap_ns_per_page += (double)worker->unmap_ns / pages / threads;
+        result->faults += worker->fault_count;
+        fault_ns += worker->fault_ns;
+    }
+
+    result->iterations = iterations;
+    result->counted = gup_method(method) || pool->workers[0].counting;
+    result->pages_per_sec = pages * threads / ((double)wall_ns / 1e9);
+    result->faults_per_sec = (double)result->faults / ((double)wall_ns / 1e9);
+    result->ns_per_fault = result->faults > 0 ? (double)fault_ns / (double)result->faults : 0.0;
+    return true;
+}
@@ -0,0 +1,329 @@
+/**
+ * Latency Histogram Implementation
+ *
+ * This file implements the log-linear histogram. A value's bucket comes
+ * from its highest set bit (the power of two) and the next seven bits
+ * (the linear step within it). The recording thread publishes every
+ * field with relaxed atomic stores and a collecting thread reads them
+ * with relaxed atomic loads, so neither side ever sees a torn counter;
+ * each bucket count is monotonic, which is all the interval difference
+ * needs. The bucket counts alone are stored with release and loaded with
+ * acquire ordering, so a value the collector counts always comes with
+ * its min and max.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* Include our header files */
+#include "histogram.h"
+#include "logger.h"
+
+/* Define constants */
+#define HIST_SUB_COUNT (1 << HIST_SUB_BITS)
+#define HIST_HALF_COUNT (1 << (HIST_SUB_BITS - 1))
+#define HIST_MAX_VALUE ((1ULL << HIST_MAX_BITS) - 1)
+
+/* Private helper function prototypes */
+static unsigned bucket_index(uint64_t value);
+static uint64_t bucket_low(unsigned index);
+static uint64_t bucket_high(unsigned index);
+
+/**
+ * Reset a histogram to empty
+ */
+void hist_init(Histogram *hist)
+{
+    memset(hist, 0, sizeof(*hist));
+    hist->min = UINT64_MAX;
+}
+
+/**
+ * Record one value
+ */
+void hist_record(Histogram *hist, uint64_t value)
+{
+    unsigned index = bucket_index(value);
+
+    /*
+     * hist_collect() swaps these out, so they are loaded atomically too.
+     * They go first: the release below then covers them, and an interval
+     * that counts this value also sees it in its min and max.
+     */
+    if (value > __atomic_load_n(&hist->max, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&hist->max, value, __ATOMIC_RELAXED);
+    }
+    if (value < __atomic_load_n(&hist->min, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&hist->min, value, __ATOMIC_RELAXED);
+    }
+
+    /* Single writer: plain read-modify-write, published with atomic stores */
+    __atomic_store_n(&hist->counts[index], hist->counts[index] + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&hist->count, hist->count + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&hist->sum, hist->sum + value, __ATOMIC_RELAXED);
+}
+
+/**
+ * Take what a live histogram recorded since the last collection
+ */
+void hist_collect(Histogram *live, Histogram *seen, Histogram *interval)
+{
+    interval->count = 0;
+    for (unsigned i = 0; i < HIST_BUCKETS; i++)
+    {
+        uint64_t now = __atomic_load_n(&live->counts[i], __ATOMIC_ACQUIRE);
+        interval->counts[i] = now - seen->counts[i];
+        interval->count += interval->counts[i];
+        seen->counts[i] = now;
+    }
+
+    uint64_t sum = __atomic_load_n(&live->sum, __ATOMIC_RELAXED);
+    interval->sum = sum - seen->sum;
+    seen->sum = sum;
+    seen->count += interval->count;
+
+    /* After the counts, so every value counted above is already in these */
+    interval->max = __atomic_exchange_n(&live->max, 0, __ATOMIC_RELAXED);
+    interval->min = __atomic_exchange_n(&live->min, UINT64_MAX, __ATOMIC_RELAXED);
+}
+
+/**
+ * Add one histogram into another
+ */
+void hist_merge(Histogram *dest, const Histogram *src)
+{
+    for (unsigned i = 0; i < HIST_BUCKETS; i++)
+    {
+        dest->counts[i] += src->counts[i];
+    }
+    dest->count += src->count;
+    dest->sum += src->sum;
+    if (src->max > dest->max)
+    {
+        dest->max = src->max;
+    }
+    if (src->min < dest->min)
+    {
+        dest->min = src->min;
+    }
+}
+
+/**
+ * Look up a percentile
+ */
+uint64_t hist_percentile(const Histogram *hist, double pct)
+{
+    if (hist->count == 0)
+    {
+        return 0;
+    }
+
+    /*
+     * Nearest rank: the smallest value with at least pct% of the count at
+     * or below it. The allowance keeps a product such as 99.9 * 1000 that
+     * lands a hair above a whole number from taking the next rank.
+     */
+    uint64_t rank = (uint64_t)ceil(pct * (double)hist->count / 100.0 - 1e-9);
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+    if (rank > hist->count)
+    {
+        rank = hist->count;
+    }
+
+    uint64_t seen = 0;
+    unsigned index = 0;
+    for (; index < HIST_BUCKETS; index++)
+    {
+        seen += hist->counts[index];
+        if (seen >= rank)
+        {
+            break;
+        }
+    }
+    if (index == HIST_BUCKETS)
+    {
+        index = HIST_BUCKETS - 1;
+    }
+
+    uint64_t value = bucket_high(index);
+    if (hist->max > 0 && value > hist->max)
+    {
+        value = hist->max;
+    }
+    if (hist->min != UINT64_MAX && value < hist->min)
+    {
+        value = hist->min;
+    }
+    return value;
+}
+
+/**
+ * Summarize a histogram
+ */
+void hist_summarize(const Histogram *hist, LatencySummary *summary)
+{
+    memset(summary, 0, sizeof(*summary));
+    if (hist->count == 0)
+    {
+        return;
+    }
+
+    summary->count = hist->count;
+    summary->min = hist->min != UINT64_MAX ? hist->min : 0;
+    summary->max = hist->max;
+    summary->p50 = hist_percentile(hist, 50.0);
+    summary->p90 = hist_percentile(hist, 90.0);
+    summary->p99 = hist_percentile(hist, 99.0);
+    summary->p999 = hist_percentile(hist, 99.9);
+    summary->p9999 = hist_percentile(hist, 99.99);
+    summary->mean = (double)hist->sum / (double)hist->count;
+}
+
+/**
+ * Save a histogram into the log directory
+ */
+bool hist_save(const Histogram *hist, const char *name)
+{
+    const char *dir = logger_get_directory();
+    char path[1024];
+    snprintf(path, sizeof(path), "%s/%s.hist", dir ? dir : ".", name);
+
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        return false;
+    }
+
+    fprintf(file, "# crucible latency histogram: index lowest_value_ns count\n");
+    fprintf(file, "layout sub_bits=%d max_bits=%d buckets=%d\n", HIST_SUB_BITS, HIST_MAX_BITS, HIST_BUCKETS);
+    fprintf(file, "total count=%llu sum=%llu min=%llu max=%llu\n", (unsigned long long)hist->count,
+            (unsigned long long)hist->sum, (unsigned long long)(hist->count > 0 ? hist->min : 0),
+            (unsigned long long)hist->max);
+    for (unsigned i = 0; i < HIST_BUCKETS; i++)
+    {
+        if (hist->counts[i] > 0)
+        {
+            fprintf(file, "%u %llu %llu\n", i, (unsigned long long)bucket_low(i), (unsigned long long)hist->counts[i]);
+        }
+    }
+
+    bool ok = !ferror(file);
+    if (fclose(file) != 0)
+    {
+        ok = false;
+    }
+    return ok;
+}
+
+/**
+ * Add a saved histogram into another
+ */
+bool hist_load(Histogram *hist, const char *path)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    Histogram *loaded = malloc(sizeof(Histogram));
+    if (!loaded)
+    {
+        fclose(file);
+        return false;
+    }
+    hist_init(loaded);
+
+    bool layout = false, total = false, ok = true;
+    char line[256];
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        int sub_bits, max_bits, buckets;
+        unsigned long long count, sum, min, max, low;
+        unsigned index;
+        if (line[0] == '#' || line[0] == '\n')
+        {
+            continue;
+        }
+        if (sscanf(line, "layout sub_bits=%d max_bits=%d buckets=%d", &sub_bits, &max_bits, &buckets) == 3)
+        {
+            layout = sub_bits == HIST_SUB_BITS && max_bits == HIST_MAX_BITS && buckets == HIST_BUCKETS;
+            ok = layout;
+        }
+        else if (sscanf(line, "total count=%llu sum=%llu min=%llu max=%llu", &count, &sum, &min, &max) == 4)
+        {
+            loaded->count = count;
+            loaded->sum = sum;
+            loaded->min = count > 0 ? min : UINT64_MAX;
+            loaded->max = max;
+            total = true;
+        }
+        else if (layout && sscanf(line, "%u %llu %llu", &index, &low, &count) == 3 && index < HIST_BUCKETS)
+        {
+            loaded->counts[index] = count;
+        }
+        else
+        {
+            ok = false;
+        }
+    }
+    fclose(file);
+
+    ok = ok && layout && total;
+    if (ok)
+    {
+        hist_merge(hist, loaded);
+    }
+    free(loaded);
+    return ok;
+}
+
+/* Private helper function: bucket of a value, clamping values beyond the range */
+static unsigned bucket_index(uint64_t value)
+{
+    if (value > HIST_MAX_VALUE)
+    {
+        value = HIST_MAX_VALUE;
+    }
+    if (value < HIST_SUB_COUNT)
+    {
+        return (unsigned)value;
+    }
+    unsigned shift = (unsigned)(63 - __builtin_clzll(value)) - (HIST_SUB_BITS - 1);
+    return HIST_SUB_COUNT + (shift - 1) * HIST_HALF_COUNT + (unsigned)(value >> shift) - HIST_HALF_COUNT;
+}
+
+/* Private helper function: smallest value that lands in a bucket */
+static uint64_t bucket_low(unsigned index)
+{
+    if (index < HIST_SUB_COUNT)
+    {
+        return index;
+    }
+    unsigned offset = index - HIST_SUB_COUNT;
+    unsigned shift = offset / HIST_HALF_COUNT + 1;
+    return (uint64_t)(offset % HIST_HALF_COUNT + HIST_HALF_COUNT) << shift;
+}
+
+/* Private helper function: largest value that lands in a bucket */
+static uint64_t bucket_high(unsigned index)
+{
+    if (index < HIST_SUB_COUNT)
+    {
+        return index;
+    }
+    unsigned shift = (index - HIST_SUB_COUNT) / HIST_HALF_COUNT + 1;
+    return bucket_low(index) + (1ULL << shift) - 1;
+}
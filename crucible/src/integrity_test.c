@@ -0,0 +1,657 @@
+/**
+ * Memory Integrity Test Implementation
+ *
+ * This file implements a memtest86-style pattern test. Every worker thread
+ * is pinned to one CPU and owns a chunk of memory that it maps, locks and
+ * first-touches itself, so chunks are local to the node that tests them.
+ * The main thread steps all workers through the same pattern at the same
+ * time with start/done barriers, which keeps the whole memory system
+ * loaded while one pattern runs:
+ *   walk1 - a single one bit walking through every byte lane
+ *   walk0 - a single zero bit walking through every byte lane
+ *   inv   - moving inversions: fill with zeros, then check and invert
+ *           bottom-up, then check and invert back top-down
+ *   rand  - seeded pseudo-random data, checked, inverted and checked again
+ *   addr  - every word holds its own address
+ * Memory is processed in 512-byte blocks. A block is first checked by
+ * OR-ing the differences of all its words, which vectorises; only a block
+ * with a difference is scanned word by word to record the failures.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/* Include our header files */
+#include "integrity_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "topology.h"
+
+/* Define constants */
+#define INT_DEFAULT_PERCENT 70
+#define INT_MAX_THREADS 1024
+#define INT_CHUNK_ALIGN (2ULL << 20)
+#define INT_BLOCK_WORDS 64              /* 512 bytes per check block */
+#define INT_MAX_RECORDED 8              /* Errors kept per thread and pattern */
+#define INT_LANE_ONES 0x0101010101010101ULL
+#define INT_LINE_SIZE 64
+
+typedef enum
+{
+    INT_WALK_ONES,
+    INT_WALK_ZEROS,
+    INT_MOVING_INV,
+    INT_RANDOM,
+    INT_ADDRESS,
+    INT_PATTERN_COUNT,
+    INT_SETUP = INT_PATTERN_COUNT /* Pseudo pattern: map and lock the chunks */
+} IntegrityPattern;
+
+static const char *const pattern_names[INT_PATTERN_COUNT] = {"walk1", "walk0", "inv", "rand", "addr"};
+
+/* How the expected value of a word is derived */
+typedef enum
+{
+    VALUE_CONST,   /* The parameter itself */
+    VALUE_ADDRESS, /* The word's own address */
+    VALUE_RANDOM   /* A hash of the address, seeded by the parameter */
+} ValueKind;
+
+/* One miscompare */
+typedef struct
+{
+    const uint64_t *addr;
+    uint64_t expected;
+    uint64_t actual;
+    uint64_t reread; /* Second read, tells a stuck bit from a transient one */
+} IntegrityError;
+
+/* Per-thread state, one cache line apart */
+typedef struct
+{
+    pthread_t thread;
+    int cpu;
+    int node;
+    MemBuffer chunk;
+    bool mapped;
+    bool locked;
+    bool bound;
+    uint64_t bytes;      /* Bytes read and written during the current pattern */
+    uint64_t errors;     /* Miscompares during the current pattern */
+    IntegrityError recorded[INT_MAX_RECORDED];
+    int recorded_count;
+} __attribute__((aligned(INT_LINE_SIZE))) IntegrityWorker;
+
+/* Worker pool driven by the main thread */
+typedef struct
+{
+    IntegrityWorker *workers;
+    int thread_count;
+    size_t chunk_size;
+    MemPageType pages;
+    bool bind;
+    IntegrityPattern pattern; /* Pattern of the current round */
+    uint64_t seed;            /* Seed of the current round */
+    bool quit;
+    pthread_barrier_t start;
+    pthread_barrier_t done;
+    pthread_mutex_t gate;     /* Held while the pool is being sized */
+} IntegrityPool;
+
+typedef struct
+{
+    IntegrityPool *pool;
+    int index;
+} IntegrityWorkerArg;
+
+/* Private helper function prototypes */
+static int parse_patterns(const char *str, IntegrityPattern *patterns);
+static bool parse_test_size(const char *str, size_t *bytes);
+static void *integrity_worker(void *arg);
+static void setup_chunk(IntegrityPool *pool, IntegrityWorker *worker);
+static void run_pattern(IntegrityWorker *worker, IntegrityPattern pattern, uint64_t seed);
+static void record_block(IntegrityWorker *worker, const uint64_t *block, ValueKind kind, uint64_t param,
+                         uint64_t flip);
+static void run_round(IntegrityPool *pool, IntegrityPattern pattern, uint64_t seed);
+static uint64_t report_errors(IntegrityPool *pool, IntegrityPattern pattern, int cycle);
+static bool physical_address(const void *addr, uint64_t *phys);
+
+/* Private helper function: hash an address into a pseudo-random word */
+static inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    return x;
+}
+
+/* Private helper function: expected value of the word at addr */
+static inline uint64_t value_at(ValueKind kind, uint64_t param, const uint64_t *addr)
+{
+    switch (kind)
+    {
+    case VALUE_ADDRESS:
+        return (uint64_t)(uintptr_t)addr;
+    case VALUE_RANDOM:
+        return mix64((uint64_t)(uintptr_t)addr ^ param);
+    default:
+        return param;
+    }
+}
+
+/*
+ * Private helper function: one pass over the chunk. With check set every
+ * word is compared against its value XOR check_flip; with write set it is
+ * then overwritten with its value XOR write_flip. Forced inline so each
+ * call site is specialised for its constant arguments.
+ */
+static inline __attribute__((always_inline)) void sweep(IntegrityWorker *worker, ValueKind kind, uint64_t param,
+                                                        bool check, uint64_t check_flip, bool write,
+                                                        uint64_t write_flip, bool descending)
+{
+    uint64_t *words = worker->chunk.data;
+    size_t blocks = worker->chunk.size / (INT_BLOCK_WORDS * sizeof(uint64_t));
+
+    for (size_t b = 0; b < blocks; b++)
+    {
+        uint64_t *block = words + (descending ? blocks - 1 - b : b) * INT_BLOCK_WORDS;
+        if (check)
+        {
+            uint64_t diff = 0;
+            for (int i = 0; i < INT_BLOCK_WORDS; i++)
+            {
+                diff |= block[i] ^ value_at(kind, param, &block[i]) ^ check_flip;
+            }
+            if (diff)
+            {
+                record_block(worker, block, kind, param, check_flip);
+            }
+        }
+        if (write)
+        {
+            for (int i = 0; i < INT_BLOCK_WORDS; i++)
+            {
+                block[i] = value_at(kind, param, &block[i]) ^ write_flip;
+            }
+        }
+    }
+
+    worker->bytes += worker->chunk.size * ((check ? 1 : 0) + (write ? 1 : 0));
+}
+
+/**
+ * Run the memory integrity test
+ */
+bool integrity_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    IntegrityPattern patterns[INT_PATTERN_COUNT];
+    int pattern_count = parse_patterns(opts->pattern, patterns);
+    if (pattern_count == 0)
+    {
+        logger_error("Integrity: invalid pattern list '%s'", opts->pattern);
+        return false;
+    }
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Integrity: invalid page type '%s'", opts->pages);
+        return false;
+    }
+    if (type_count > 1)
+    {
+        logger_warning("Integrity: one page type per run, using %s", mem_buffer_page_name(types[0]));
+    }
+
+    size_t total;
+    if (!parse_test_size(opts->size, &total))
+    {
+        logger_error("Integrity: invalid size '%s'", opts->size);
+        return false;
+    }
+    size_t available = bench_mem_available();
+    if (available > 0 && total > available)
+    {
+        logger_warning("Integrity: %zu MB requested but only %zu MB available, expect swapping or OOM",
+                       total >> 20, available >> 20);
+    }
+
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        logger_error("Integrity: cannot read CPU topology");
+        return false;
+    }
+
+    int thread_count = opts->threads > 0 ? opts->threads : topo.count;
+    if (thread_count > INT_MAX_THREADS)
+    {
+        thread_count = INT_MAX_THREADS;
+    }
+
+    size_t chunk_size = total / (size_t)thread_count;
+    chunk_size -= chunk_size % INT_CHUNK_ALIGN;
+    if (chunk_size == 0)
+    {
+        logger_error("Integrity: %zu MB is too little for %d threads", total >> 20, thread_count);
+        topology_free(&topo);
+        return false;
+    }
+
+    uint64_t seed = opts->seed != 0 ? opts->seed : bench_now_ns() ^ ((uint64_t)getpid() << 32);
+
+    IntegrityPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.workers = aligned_alloc(INT_LINE_SIZE, (size_t)thread_count * sizeof(IntegrityWorker));
+    IntegrityWorkerArg *args = calloc((size_t)thread_count, sizeof(IntegrityWorkerArg));
+    if (!pool.workers || !args)
+    {
+        logger_error("Integrity: setup failed");
+        free(pool.workers);
+        free(args);
+        topology_free(&topo);
+        return false;
+    }
+    memset(pool.workers, 0, (size_t)thread_count * sizeof(IntegrityWorker));
+    pool.chunk_size = chunk_size;
+    pool.pages = types[0];
+    pool.bind = opts->numa_aware;
+
+    /*
+     * Workers wait on the gate until the barriers exist, so the barriers can
+     * be sized for however many threads actually started.
+     */
+    pthread_mutex_init(&pool.gate, NULL);
+    pthread_mutex_lock(&pool.gate);
+    int started = 0;
+    for (int i = 0; i < thread_count; i++)
+    {
+        pool.workers[i].cpu = topo.cpus[i % topo.count].cpu;
+        pool.workers[i].node = topo.cpus[i % topo.count].node;
+        args[i].pool = &pool;
+        args[i].index = i;
+        if (pthread_create(&pool.workers[i].thread, NULL, integrity_worker, &args[i]) != 0)
+        {
+            break;
+        }
+        started++;
+    }
+    if (started != thread_count)
+    {
+        logger_warning("Integrity: only %d of %d worker threads started, testing %zu MB less",
+                       started, thread_count, (size_t)(thread_count - started) * (chunk_size >> 20));
+    }
+    pool.thread_count = started;
+    pthread_barrier_init(&pool.start, NULL, (unsigned int)started + 1);
+    pthread_barrier_init(&pool.done, NULL, (unsigned int)started + 1);
+    pthread_mutex_unlock(&pool.gate);
+    topology_free(&topo);
+
+    /* Map, bind and lock every chunk before the first pattern */
+    run_round(&pool, INT_SETUP, seed);
+    int mapped = 0, locked = 0, unbound = 0;
+    for (int i = 0; i < started; i++)
+    {
+        mapped += pool.workers[i].mapped ? 1 : 0;
+        locked += pool.workers[i].locked ? 1 : 0;
+        unbound += (pool.bind && pool.workers[i].mapped && !pool.workers[i].bound) ? 1 : 0;
+    }
+
+    bool ok = started > 0 && mapped == started;
+    uint64_t total_errors = 0;
+    int cycle = 0;
+    if (!ok)
+    {
+        logger_error("Integrity: only %d of %d chunks of %zu MB could be mapped", mapped, started, chunk_size >> 20);
+    }
+    else
+    {
+        if (locked < started)
+        {
+            logger_warning("Integrity: only %d of %d chunks locked in memory, the rest may be swapped", locked, started);
+        }
+        if (unbound > 0)
+        {
+            logger_warning("Integrity: %d chunks could not be bound to their node, using first touch", unbound);
+        }
+
+        double tested_gb = (double)chunk_size * started / 1e9;
+        logger_info("Integrity: %d threads, %zu MB per thread, %.2f GB total, %s pages, seed 0x%llx",
+                    started, chunk_size >> 20, tested_gb, mem_buffer_page_name(pool.pages),
+                    (unsigned long long)seed);
+
+        /* Repeat whole cycles until the duration is used up, but finish at least one */
+        uint64_t deadline = bench_now_ns() + (uint64_t)comp->duration * 1000000000ULL;
+        do
+        {
+            cycle++;
+            for (int p = 0; p < pattern_count; p++)
+            {
+                uint64_t t0 = bench_now_ns();
+                run_round(&pool, patterns[p], seed + (uint64_t)cycle);
+                double secs = (double)(bench_now_ns() - t0) / 1e9;
+
+                uint64_t bytes = 0;
+                for (int i = 0; i < started; i++)
+                {
+                    bytes += pool.workers[i].bytes;
+                }
+                uint64_t errors = report_errors(&pool, patterns[p], cycle);
+                total_errors += errors;
+
+                logger_info("Integrity: cycle %d %-5s %8.2f s, %8.2f GB/s, %llu errors",
+                            cycle, pattern_names[patterns[p]], secs, (double)bytes / secs / 1e9,
+                            (unsigned long long)errors);
+                logger_metric("mem_integrity", "cycle=%d,pattern=%s,threads=%d,tested_gb=%.2f,seconds=%.3f,"
+                              "gbps=%.3f,errors=%llu",
+                              cycle, pattern_names[patterns[p]], started, tested_gb, secs,
+                              (double)bytes / secs / 1e9, (unsigned long long)errors);
+            }
+        } while (bench_now_ns() < deadline);
+
+        logger_metric("mem_integrity_summary", "cycles=%d,threads=%d,tested_gb=%.2f,seed=0x%llx,errors=%llu",
+                      cycle, started, tested_gb, (unsigned long long)seed, (unsigned long long)total_errors);
+        if (total_errors > 0)
+        {
+            logger_error("Integrity: %llu errors in %d cycles", (unsigned long long)total_errors, cycle);
+            ok = false;
+        }
+        else
+        {
+            logger_info("Integrity: %d cycles over %.2f GB, no errors", cycle, tested_gb);
+        }
+    }
+
+    pool.quit = true;
+    pthread_barrier_wait(&pool.start);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(pool.workers[i].thread, NULL);
+        mem_buffer_free(&pool.workers[i].chunk);
+    }
+
+    pthread_barrier_destroy(&pool.start);
+    pthread_barrier_destroy(&pool.done);
+    pthread_mutex_destroy(&pool.gate);
+    free(args);
+    free(pool.workers);
+    return ok;
+}
+
+/* Private helper function: parse a comma-separated pattern list, returns the count */
+static int parse_patterns(const char *str, IntegrityPattern *patterns)
+{
+    if (str[0] == '\0' || strcmp(str, "all") == 0)
+    {
+        for (int i = 0; i < INT_PATTERN_COUNT; i++)
+        {
+            patterns[i] = (IntegrityPattern)i;
+        }
+        return INT_PATTERN_COUNT;
+    }
+
+    char list[64];
+    strncpy(list, str, sizeof(list) - 1);
+    list[sizeof(list) - 1] = '\0';
+
+    int count = 0;
+    char *saveptr = NULL;
+    for (char *token = strtok_r(list, ",", &saveptr); token; token = strtok_r(NULL, ",", &saveptr))
+    {
+        int found = -1;
+        for (int i = 0; i < INT_PATTERN_COUNT; i++)
+        {
+            if (strcmp(token, pattern_names[i]) == 0)
+            {
+                found = i;
+            }
+        }
+        if (found < 0 || count == INT_PATTERN_COUNT)
+        {
+            return 0;
+        }
+        patterns[count++] = (IntegrityPattern)found;
+    }
+    return count;
+}
+
+/* Private helper function: parse sz: as a size or a percentage of available memory */
+static bool parse_test_size(const char *str, size_t *bytes)
+{
+    size_t len = strlen(str);
+    if (len > 0 && str[len - 1] != '%')
+    {
+        return bench_parse_size(str, bytes);
+    }
+
+    int percent = len > 0 ? atoi(str) : INT_DEFAULT_PERCENT;
+    size_t available = bench_mem_available();
+    if (percent <= 0 || percent > 100 || available == 0)
+    {
+        return false;
+    }
+
+    *bytes = available / 100 * (size_t)percent;
+    return true;
+}
+
+/* Private helper function: worker thread, runs one pattern per round on its own chunk */
+static void *integrity_worker(void *arg)
+{
+    IntegrityWorkerArg *worker_arg = arg;
+    IntegrityPool *pool = worker_arg->pool;
+    IntegrityWorker *worker = &pool->workers[worker_arg->index];
+    bench_pin_cpu(worker->cpu);
+
+    pthread_mutex_lock(&pool->gate);
+    pthread_mutex_unlock(&pool->gate);
+
+    for (;;)
+    {
+        pthread_barrier_wait(&pool->start);
+        if (pool->quit)
+        {
+            break;
+        }
+
+        worker->bytes = 0;
+        worker->errors = 0;
+        worker->recorded_count = 0;
+        if (pool->pattern == INT_SETUP)
+        {
+            setup_chunk(pool, worker);
+        }
+        else if (worker->mapped)
+        {
+            run_pattern(worker, pool->pattern, pool->seed);
+        }
+
+        pthread_barrier_wait(&pool->done);
+    }
+    return NULL;
+}
+
+/* Private helper function: map the worker's chunk from its own CPU, bind it and lock it */
+static void setup_chunk(IntegrityPool *pool, IntegrityWorker *worker)
+{
+    if (!mem_buffer_alloc_pages(&worker->chunk, pool->chunk_size, 0, pool->pages))
+    {
+        return;
+    }
+    worker->mapped = true;
+
+    if (pool->bind && worker->node >= 0)
+    {
+        worker->bound = mem_buffer_bind(&worker->chunk, worker->node);
+    }
+
+    /* Locking also faults every page in, from this CPU */
+    worker->locked = mlock(worker->chunk.data, worker->chunk.size) == 0;
+}
+
+/* Private helper function: run one pattern over the worker's chunk */
+static void run_pattern(IntegrityWorker *worker, IntegrityPattern pattern, uint64_t seed)
+{
+    switch (pattern)
+    {
+    case INT_WALK_ONES:
+        for (int bit = 0; bit < 8; bit++)
+        {
+            sweep(worker, VALUE_CONST, INT_LANE_ONES << bit, false, 0, true, 0, false);
+            sweep(worker, VALUE_CONST, INT_LANE_ONES << bit, true, 0, false, 0, false);
+        }
+        break;
+    case INT_WALK_ZEROS:
+        for (int bit = 0; bit < 8; bit++)
+        {
+            sweep(worker, VALUE_CONST, ~(INT_LANE_ONES << bit), false, 0, true, 0, false);
+            sweep(worker, VALUE_CONST, ~(INT_LANE_ONES << bit), true, 0, false, 0, false);
+        }
+        break;
+    case INT_MOVING_INV:
+        sweep(worker, VALUE_CONST, 0, false, 0, true, 0, false);
+        sweep(worker, VALUE_CONST, 0, true, 0, true, ~0ULL, false);
+        sweep(worker, VALUE_CONST, 0, true, ~0ULL, true, 0, true);
+        break;
+    case INT_RANDOM:
+        sweep(worker, VALUE_RANDOM, seed, false, 0, true, 0, false);
+        sweep(worker, VALUE_RANDOM, seed, true, 0, true, ~0ULL, false);
+        sweep(worker, VALUE_RANDOM, seed, true, ~0ULL, false, 0, false);
+        break;
+    case INT_ADDRESS:
+        sweep(worker, VALUE_ADDRESS, 0, false, 0, true, 0, false);
+        sweep(worker, VALUE_ADDRESS, 0, true, 0, false, 0, false);
+        break;
+    default:
+        break;
+    }
+}
+
+/* Private helper function: record the mismatching words of a block that failed its check */
+static void record_block(IntegrityWorker *worker, const uint64_t *block, ValueKind kind, uint64_t param,
+                         uint64_t flip)
+{
+    for (int i = 0; i < INT_BLOCK_WORDS; i++)
+    {
+        const volatile uint64_t *word = &block[i];
+        uint64_t expected = value_at(kind, param, &block[i]) ^ flip;
+        uint64_t actual = *word;
+        if (actual == expected)
+        {
+            continue;
+        }
+
+        if (worker->recorded_count < INT_MAX_RECORDED)
+        {
+            IntegrityError *error = &worker->recorded[worker->recorded_count++];
+            error->addr = &block[i];
+            error->expected = expected;
+            error->actual = actual;
+            error->reread = *word;
+        }
+        worker->errors++;
+    }
+}
+
+/* Private helper function: run one round on every worker and wait for it */
+static void run_round(IntegrityPool *pool, IntegrityPattern pattern, uint64_t seed)
+{
+    pool->pattern = pattern;
+    pool->seed = seed;
+    pthread_barrier_wait(&pool->start);
+    pthread_barrier_wait(&pool->done);
+}
+
+/* Private helper function: log the recorded miscompares of a round, returns the error count */
+static uint64_t report_errors(IntegrityPool *pool, IntegrityPattern pattern, int cycle)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < pool->thread_count; i++)
+    {
+        IntegrityWorker *worker = &pool->workers[i];
+        total += worker->errors;
+
+        for (int e = 0; e < worker->recorded_count; e++)
+        {
+            const IntegrityError *error = &worker->recorded[e];
+            uint64_t diff = error->expected ^ error->actual;
+
+            /* Failing bit positions, separated by '/' to stay inside one metric field */
+            char bits[64 * 3 + 1] = "";
+            int len = 0;
+            for (int bit = 0; bit < 64; bit++)
+            {
+                if (diff & (1ULL << bit))
+                {
+                    len += snprintf(bits + len, sizeof(bits) - (size_t)len, "%s%d", len ? "/" : "", bit);
+                }
+            }
+
+            char phys[32] = "unknown";
+            uint64_t paddr;
+            if (physical_address(error->addr, &paddr))
+            {
+                snprintf(phys, sizeof(phys), "0x%llx", (unsigned long long)paddr);
+            }
+
+            logger_error("Integrity: %s mismatch at %p (phys %s) on CPU %d: expected 0x%016llx, "
+                         "read 0x%016llx, bits %s, %s",
+                         pattern_names[pattern], (const void *)error->addr, phys, worker->cpu,
+                         (unsigned long long)error->expected, (unsigned long long)error->actual, bits,
+                         error->reread == error->expected ? "correct on reread" : "persistent");
+            logger_metric("mem_integrity_error", "cycle=%d,pattern=%s,cpu=%d,node=%d,vaddr=%p,paddr=%s,"
+                          "expected=0x%016llx,actual=0x%016llx,reread=0x%016llx,bits=%s",
+                          cycle, pattern_names[pattern], worker->cpu, worker->node, (const void *)error->addr,
+                          phys, (unsigned long long)error->expected, (unsigned long long)error->actual,
+                          (unsigned long long)error->reread, bits);
+        }
+        if (worker->errors > (uint64_t)worker->recorded_count)
+        {
+            logger_error("Integrity: %llu more %s mismatches on CPU %d not shown",
+                         (unsigned long long)(worker->errors - (uint64_t)worker->recorded_count),
+                         pattern_names[pattern], worker->cpu);
+        }
+    }
+    return total;
+}
+
+/* Private helper function: translate a virtual address through /proc/self/pagemap (needs CAP_SYS_ADMIN) */
+static bool physical_address(const void *addr, uint64_t *phys)
+{
+    int fd = open("/proc/self/pagemap", O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    long page = sysconf(_SC_PAGESIZE);
+    uint64_t entry = 0;
+    off_t offset = (off_t)((uintptr_t)addr / (uintptr_t)page * sizeof(entry));
+    ssize_t got = pread(fd, &entry, sizeof(entry), offset);
+    close(fd);
+
+    /* Bit 63: present; bits 0-54: page frame number, reported as 0 without privilege */
+    uint64_t pfn = entry & ((1ULL << 55) - 1);
+    if (got != (ssize_t)sizeof(entry) || !(entry & (1ULL << 63)) || pfn == 0)
+    {
+        return false;
+    }
+
+    *phys = pfn * (uint64_t)page + (uintptr_t)addr % (uintptr_t)page;
+    return true;
+}
@@ -0,0 +1,697 @@
+/**
+ * I/O Test Implementation
+ *
+ * This file implements the I/O component test. The target is opened with
+ * O_DIRECT and driven from the calling thread. The async mode talks to the
+ * kernel's native AIO interface through syscall(): io_setup() creates a
+ * context sized to the queue depth, every pass submits all free slots as
+ * one io_submit() batch and io_getevents() reaps whatever has completed.
+ * The sync mode issues one pread() or pwrite() at a time. Native AIO only
+ * stays asynchronous for O_DIRECT I/O the block layer can queue, so the
+ * time spent inside io_submit() is reported next to the I/O latency; when
+ * it approaches the latency the submissions are effectively synchronous.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/aio_abi.h>
+#include <linux/fs.h>
+
+/* Include our header files */
+#include "io_test.h"
+#include "bench_util.h"
+#include "histogram.h"
+#include "logger.h"
+#include "mem_buffer.h"
+
+/* Define constants */
+#define IO_DEFAULT_FILE_SIZE (256ULL << 20)
+#define IO_DEFAULT_BLOCK_SIZE 4096
+#define IO_DEFAULT_DEPTH 32
+#define IO_MAX_DEPTH 1024
+#define IO_DIRECT_ALIGN 4096          /* Buffer alignment that satisfies any logical block size */
+#define IO_LAYOUT_CHUNK (1ULL << 20)
+#define IO_INTERVAL_NS 1000000000ULL  /* 1 s */
+
+typedef enum
+{
+    IO_READ,
+    IO_WRITE,
+    IO_DIR_COUNT
+} IoDir;
+
+/* State of one run */
+typedef struct
+{
+    int fd;
+    bool async;
+    unsigned queue_depth;
+    size_t block_size;
+    uint64_t blocks;
+    int write_pct;
+    uint64_t op_limit;       /* 0 runs until the deadline */
+    uint64_t issued;
+    uint64_t rng;
+    MemBuffer buffer;        /* One block per queue slot */
+    Histogram *interval;     /* Latency per direction since the last report */
+    Histogram *totals;       /* Latency per direction for the whole run */
+    uint64_t worst_p99[IO_DIR_COUNT];
+    uint64_t submit_calls;   /* io_submit() calls this interval */
+    uint64_t submit_ns;
+    uint64_t submit_max_ns;
+    uint64_t submit_calls_total;
+    uint64_t submit_ns_total;
+    uint64_t start;
+    uint64_t deadline;
+    uint64_t last_report;
+    double last_cpu;
+} IoJob;
+
+static const char *const dir_names[IO_DIR_COUNT] = {"read", "write"};
+
+/* Private helper function prototypes */
+static bool open_target(const char *path, size_t block_size, size_t file_size, bool writes, IoJob *job,
+                        bool *created);
+static bool run_job(IoJob *job, const ComponentConfig *comp, const char *path);
+static bool create_file(const char *path, size_t size);
+static int run_sync(IoJob *job);
+static int run_async(IoJob *job);
+static uint64_t next_io(IoJob *job, IoDir *dir);
+static void maybe_report(IoJob *job, uint64_t now, bool force);
+static void report_interval(IoJob *job, double t_s, double secs, double cpu_s);
+static double cpu_seconds(void);
+static uint64_t next_random(uint64_t *state);
+
+/**
+ * Run an I/O component test
+ */
+bool io_test_run(const ComponentConfig *comp)
+{
+    const IOOptions *opts = &comp->options.io;
+
+    size_t block_size = IO_DEFAULT_BLOCK_SIZE;
+    if (opts->buffer_size[0] != '\0' && (!bench_parse_size(opts->buffer_size, &block_size) || block_size == 0))
+    {
+        logger_error("IO: invalid buffer size '%s'", opts->buffer_size);
+        return false;
+    }
+    size_t file_size = IO_DEFAULT_FILE_SIZE;
+    if (opts->file_size[0] != '\0' && !bench_parse_size(opts->file_size, &file_size))
+    {
+        logger_error("IO: invalid file size '%s'", opts->file_size);
+        return false;
+    }
+    if (opts->write_pct < 0 || opts->write_pct > 100)
+    {
+        logger_error("IO: write share %d out of range (0-100)", opts->write_pct);
+        return false;
+    }
+    if (opts->operation_count < 0)
+    {
+        logger_error("IO: invalid operation count %d", opts->operation_count);
+        return false;
+    }
+
+    IoJob job;
+    memset(&job, 0, sizeof(job));
+    job.fd = -1;
+    job.async = opts->io_type == ASYNC_IO;
+    job.queue_depth = 1;
+    if (job.async)
+    {
+        job.queue_depth = opts->queue_depth > 0 ? (unsigned)opts->queue_depth : IO_DEFAULT_DEPTH;
+        if (job.queue_depth > IO_MAX_DEPTH)
+        {
+            logger_error("IO: queue depth %u above the maximum of %d", job.queue_depth, IO_MAX_DEPTH);
+            return false;
+        }
+    }
+    else if (opts->queue_depth > 1)
+    {
+        logger_warning("IO: qd: only applies to async I/O, ignoring it");
+    }
+    job.block_size = block_size;
+    job.write_pct = opts->write_pct;
+    job.op_limit = (uint64_t)opts->operation_count;
+    job.rng = bench_now_ns() | 1;
+
+    char path[512];
+    if (opts->device_path[0] != '\0')
+    {
+        snprintf(path, sizeof(path), "%s", opts->device_path);
+    }
+    else
+    {
+        snprintf(path, sizeof(path), "./crucible.io.%d", (int)getpid());
+    }
+    bool created = false;
+    bool ok = open_target(path, block_size, file_size, opts->write_pct > 0, &job, &created);
+
+    job.interval = malloc(sizeof(Histogram) * IO_DIR_COUNT);
+    job.totals = malloc(sizeof(Histogram) * IO_DIR_COUNT);
+    for (int d = 0; job.interval && job.totals && d < IO_DIR_COUNT; d++)
+    {
+        hist_init(&job.interval[d]);
+        hist_init(&job.totals[d]);
+    }
+    if (ok && (!job.interval || !job.totals ||
+               !mem_buffer_alloc(&job.buffer, block_size * job.queue_depth, IO_DIRECT_ALIGN)))
+    {
+        logger_error("IO: setup failed");
+        ok = false;
+    }
+    if (ok)
+    {
+        ok = run_job(&job, comp, path);
+    }
+
+    mem_buffer_free(&job.buffer);
+    free(job.interval);
+    free(job.totals);
+    if (job.fd >= 0)
+    {
+        close(job.fd);
+    }
+    if (created)
+    {
+        unlink(path);
+    }
+    return ok;
+}
+
+/* Private helper function: run the configured mode, then log the run summary */
+static bool run_job(IoJob *job, const ComponentConfig *comp, const char *path)
+{
+    int duration = comp->duration;
+    /* Incompressible data for writes */
+    uint64_t seed = job->rng;
+    for (size_t off = 0; off + sizeof(uint64_t) <= job->buffer.size; off += sizeof(uint64_t))
+    {
+        uint64_t value = next_random(&seed);
+        memcpy((char *)job->buffer.data + off, &value, sizeof(value));
+    }
+
+    const char *mode = job->async ? "async" : "sync";
+    logger_info("IO: %s (%s, %llu MB), %zu KB random I/O, %d%% writes, %s, qd %u", path,
+                comp->options.io.interface_type == INTERFACE_PCIE ? "pcie" : "usb3",
+                (unsigned long long)((job->blocks * job->block_size) >> 20), job->block_size >> 10, job->write_pct,
+                job->async ? "native AIO" : "pread/pwrite", job->queue_depth);
+    if (job->op_limit > 0)
+    {
+        logger_info("IO: stopping after %llu operations or %d s", (unsigned long long)job->op_limit, duration);
+    }
+
+    job->start = bench_now_ns();
+    job->deadline = job->start + (uint64_t)duration * 1000000000ULL;
+    job->last_report = job->start;
+    job->last_cpu = cpu_seconds();
+    double cpu_start = job->last_cpu;
+
+    int error = job->async ? run_async(job) : run_sync(job);
+    maybe_report(job, bench_now_ns(), true);
+    if (error != 0)
+    {
+        logger_error("IO: %s failed: %s%s", job->async ? "native AIO" : "I/O", strerror(error),
+                     error == EAGAIN && job->async ? " (fs.aio-max-nr exhausted?)" : "");
+    }
+
+    double secs = (double)(bench_now_ns() - job->start) / 1e9;
+    double cores = secs > 0.0 ? (cpu_seconds() - cpu_start) / secs : 0.0;
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        LatencySummary summary;
+        hist_summarize(&job->totals[d], &summary);
+        logger_metric("io_test_summary", "mode=%s,qd=%u,dir=%s,ops=%llu,iops=%.0f,mbps=%.2f,lat_mean_us=%.1f,"
+                      "lat_p50_us=%.1f,lat_p90_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,lat_p9999_us=%.1f,"
+                      "lat_max_us=%.1f,worst_interval_p99_us=%.1f",
+                      mode, job->queue_depth, dir_names[d], (unsigned long long)summary.count,
+                      secs > 0.0 ? (double)summary.count / secs : 0.0,
+                      secs > 0.0 ? (double)summary.count * (double)job->block_size / 1048576.0 / secs : 0.0,
+                      summary.mean / 1e3, (double)summary.p50 / 1e3, (double)summary.p90 / 1e3,
+                      (double)summary.p99 / 1e3, (double)summary.p999 / 1e3, (double)summary.p9999 / 1e3,
+                      (double)summary.max / 1e3, (double)job->worst_p99[d] / 1e3);
+
+        char name[64];
+        snprintf(name, sizeof(name), "io.%d.%s", comp->order, dir_names[d]);
+        if (summary.count > 0 && !hist_save(&job->totals[d], name))
+        {
+            logger_warning("IO: could not save the %s latency histogram", dir_names[d]);
+        }
+    }
+
+    uint64_t ops = job->totals[IO_READ].count + job->totals[IO_WRITE].count;
+    double iops = secs > 0.0 ? (double)ops / secs : 0.0;
+    double submit_us = job->submit_calls_total > 0
+                           ? (double)job->submit_ns_total / (double)job->submit_calls_total / 1e3
+                           : 0.0;
+    logger_metric("io_test_cpu_summary", "mode=%s,iops=%.0f,cpu_cores=%.3f,iops_per_core=%.0f,submit_calls=%llu,"
+                  "submit_mean_us=%.1f,ios_per_submit=%.1f",
+                  mode, iops, cores, cores > 0.0 ? iops / cores : 0.0, (unsigned long long)job->submit_calls_total,
+                  submit_us, job->submit_calls_total > 0 ? (double)ops / (double)job->submit_calls_total : 0.0);
+    logger_info("IO: %llu I/Os in %.1f s, %.0f IOPS, %.2f cores, %.0f IOPS per core", (unsigned long long)ops, secs,
+                iops, cores, cores > 0.0 ? iops / cores : 0.0);
+    if (job->async)
+    {
+        logger_info("IO: io_submit() blocked for %.1f us per call on average", submit_us);
+    }
+    return error == 0;
+}
+
+/*
+ * Private helper function: open the target with O_DIRECT and size it.
+ * Block devices report their size and logical block size through ioctl()
+ * and are never written to; a missing path is created as a test file. On
+ * failure the caller closes job->fd and removes a created file.
+ */
+static bool open_target(const char *path, size_t block_size, size_t file_size, bool writes, IoJob *job,
+                        bool *created)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+    {
+        /* A mistyped device name must not turn into a test file on devtmpfs */
+        if (errno != ENOENT ||
+            (strncmp(path, "/dev/", 5) == 0 && strncmp(path, "/dev/shm/", 9) != 0))
+        {
+            logger_error("IO: cannot access %s: %s", path, strerror(errno));
+            return false;
+        }
+        if (file_size < block_size)
+        {
+            logger_error("IO: file size %zu is smaller than the buffer size %zu", file_size, block_size);
+            return false;
+        }
+        file_size -= file_size % block_size;
+        if (!create_file(path, file_size))
+        {
+            return false;
+        }
+        *created = true;
+        if (stat(path, &st) != 0)
+        {
+            logger_error("IO: cannot access %s: %s", path, strerror(errno));
+            return false;
+        }
+    }
+
+    bool device = S_ISBLK(st.st_mode);
+    if (!device && !S_ISREG(st.st_mode))
+    {
+        logger_error("IO: %s is neither a block device nor a regular file", path);
+        return false;
+    }
+    if (device && writes)
+    {
+        logger_error("IO: refusing to write to block device %s; point dev: at a file for write tests", path);
+        return false;
+    }
+
+    int flags = writes ? O_RDWR : O_RDONLY;
+    job->fd = open(path, flags | O_DIRECT);
+    if (job->fd < 0 && errno == EINVAL)
+    {
+        /* Without O_DIRECT native AIO goes through the page cache and blocks in io_submit() */
+        logger_warning("IO: %s does not support O_DIRECT, using buffered I/O%s", path,
+                       job->async ? "; native AIO will submit synchronously" : "");
+        job->fd = open(path, flags);
+    }
+    if (job->fd < 0)
+    {
+        logger_error("IO: cannot open %s: %s", path, strerror(errno));
+        return false;
+    }
+
+    uint64_t size = (uint64_t)st.st_size;
+    size_t sector = 512;
+    if (device)
+    {
+        int logical = 0;
+        if (ioctl(job->fd, BLKGETSIZE64, &size) != 0 || ioctl(job->fd, BLKSSZGET, &logical) != 0)
+        {
+            logger_error("IO: cannot query the size of %s: %s", path, strerror(errno));
+            return false;
+        }
+        sector = logical > 0 ? (size_t)logical : 512;
+    }
+    if (block_size % sector != 0)
+    {
+        logger_error("IO: buffer size %zu is not a multiple of the %zu byte logical block size", block_size, sector);
+        return false;
+    }
+    job->blocks = size / block_size;
+    if (job->blocks == 0)
+    {
+        logger_error("IO: %s is smaller than one %zu byte buffer", path, block_size);
+        return false;
+    }
+    return true;
+}
+
+/* Private helper function: write a test file out in full, sync it and drop it from the page cache */
+static bool create_file(const char *path, size_t size)
+{
+    char *chunk = malloc(IO_LAYOUT_CHUNK);
+    if (!chunk)
+    {
+        logger_error("IO: setup failed");
+        return false;
+    }
+    uint64_t seed = bench_now_ns() | 1;
+    for (size_t off = 0; off + sizeof(uint64_t) <= IO_LAYOUT_CHUNK; off += sizeof(uint64_t))
+    {
+        uint64_t value = next_random(&seed);
+        memcpy(chunk + off, &value, sizeof(value));
+    }
+
+    int fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        logger_error("IO: cannot create %s: %s", path, strerror(errno));
+        free(chunk);
+        return false;
+    }
+    for (size_t done = 0; done < size;)
+    {
+        size_t len = size - done < IO_LAYOUT_CHUNK ? size - done : IO_LAYOUT_CHUNK;
+        ssize_t written = write(fd, chunk, len);
+        if (written <= 0)
+        {
+            logger_error("IO: writing %s failed: %s", path, written < 0 ? strerror(errno) : "short write");
+            close(fd);
+            unlink(path);
+            free(chunk);
+            return false;
+        }
+        done += (size_t)written;
+    }
+    fsync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+    free(chunk);
+    return true;
+}
+
+/* Private helper function: one blocking pread/pwrite at a time, returns errno of a failure or 0 */
+static int run_sync(IoJob *job)
+{
+    int error = 0;
+    uint64_t now = bench_now_ns();
+    while (now < job->deadline && (job->op_limit == 0 || job->issued < job->op_limit))
+    {
+        IoDir dir;
+        off_t offset = (off_t)(next_io(job, &dir) * job->block_size);
+        job->issued++;
+
+        uint64_t t0 = bench_now_ns();
+        ssize_t done = dir == IO_READ ? pread(job->fd, job->buffer.data, job->block_size, offset)
+                                      : pwrite(job->fd, job->buffer.data, job->block_size, offset);
+        now = bench_now_ns();
+        if (done != (ssize_t)job->block_size)
+        {
+            error = done < 0 ? errno : EIO;
+            break;
+        }
+        hist_record(&job->interval[dir], now - t0);
+        maybe_report(job, now, false);
+    }
+    return error;
+}
+
+/*
+ * Private helper function: keep queue_depth I/Os in flight through native
+ * AIO. Each pass fills every free slot, submits them as one batch, then
+ * waits for at least one completion and reaps up to a queue's worth. A
+ * partial or refused submission returns the unsubmitted slots to the free
+ * list. After a failure, the deadline or the operation count no new I/O is
+ * queued, but the loop runs on until the context is drained so no buffer
+ * is released while the kernel still owns it. Returns errno of the first
+ * failure or 0.
+ */
+static int run_async(IoJob *job)
+{
+    aio_context_t ctx = 0;
+    if (syscall(__NR_io_setup, job->queue_depth, &ctx) != 0)
+    {
+        return errno;
+    }
+
+    struct iocb *iocbs = calloc(job->queue_depth, sizeof(struct iocb));
+    struct iocb **batch = calloc(job->queue_depth, sizeof(struct iocb *));
+    struct io_event *events = calloc(job->queue_depth, sizeof(struct io_event));
+    uint64_t *slot_start = calloc(job->queue_depth, sizeof(uint64_t));
+    unsigned char *slot_dir = calloc(job->queue_depth, 1);
+    unsigned *free_slots = calloc(job->queue_depth, sizeof(unsigned));
+    if (!iocbs || !batch || !events || !slot_start || !slot_dir || !free_slots)
+    {
+        syscall(__NR_io_destroy, ctx);
+        free(iocbs);
+        free(batch);
+        free(events);
+        free(slot_start);
+        free(slot_dir);
+        free(free_slots);
+        return ENOMEM;
+    }
+
+    unsigned free_count = job->queue_depth;
+    for (unsigned slot = 0; slot < job->queue_depth; slot++)
+    {
+        free_slots[slot] = slot;
+    }
+    unsigned inflight = 0;
+    int error = 0;
+
+    for (;;)
+    {
+        uint64_t now = bench_now_ns();
+        bool stopping = error != 0 || now >= job->deadline;
+        unsigned count = 0;
+        while (!stopping && free_count > 0 && (job->op_limit == 0 || job->issued < job->op_limit))
+        {
+            unsigned slot = free_slots[--free_count];
+            IoDir dir;
+            uint64_t block = next_io(job, &dir);
+
+            struct iocb *cb = &iocbs[slot];
+            memset(cb, 0, sizeof(*cb));
+            cb->aio_data = slot;
+            cb->aio_lio_opcode = dir == IO_READ ? IOCB_CMD_PREAD : IOCB_CMD_PWRITE;
+            cb->aio_fildes = (uint32_t)job->fd;
+            cb->aio_buf = (uint64_t)(uintptr_t)((char *)job->buffer.data + slot * job->block_size);
+            cb->aio_nbytes = job->block_size;
+            cb->aio_offset = (int64_t)(block * job->block_size);
+            slot_dir[slot] = (unsigned char)dir;
+            batch[count++] = cb;
+            job->issued++;
+        }
+
+        unsigned submitted = 0;
+        while (submitted < count)
+        {
+            uint64_t t0 = bench_now_ns();
+            long ret = syscall(__NR_io_submit, ctx, (long)(count - submitted), batch + submitted);
+            uint64_t t1 = bench_now_ns();
+            if (ret < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            job->submit_calls++;
+            job->submit_ns += t1 - t0;
+            if (t1 - t0 > job->submit_max_ns)
+            {
+                job->submit_max_ns = t1 - t0;
+            }
+            if (ret <= 0)
+            {
+                /* EAGAIN with I/O in flight only means the queue is full; retry after reaping */
+                if (ret < 0 && (errno != EAGAIN || inflight + submitted == 0))
+                {
+                    error = errno;
+                }
+                break;
+            }
+            for (long i = 0; i < ret; i++)
+            {
+                slot_start[batch[submitted + i]->aio_data] = t0;
+            }
+            submitted += (unsigned)ret;
+        }
+        for (unsigned i = submitted; i < count; i++)
+        {
+            free_slots[free_count++] = (unsigned)batch[i]->aio_data;
+            job->issued--;
+        }
+        inflight += submitted;
+        if (inflight == 0)
+        {
+            break;
+        }
+
+        /* Wake up by the next interval boundary even if nothing completes */
+        now = bench_now_ns();
+        uint64_t wait = job->last_report + IO_INTERVAL_NS > now ? job->last_report + IO_INTERVAL_NS - now : 0;
+        struct timespec timeout = {(time_t)(wait / 1000000000ULL), (long)(wait % 1000000000ULL)};
+        long reaped = syscall(__NR_io_getevents, ctx, 1L, (long)job->queue_depth, events, &timeout);
+        if (reaped < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            if (error == 0)
+            {
+                error = errno;
+            }
+            /* io_destroy() below waits for what is still in flight */
+            break;
+        }
+
+        now = bench_now_ns();
+        for (long i = 0; i < reaped; i++)
+        {
+            unsigned slot = (unsigned)events[i].data;
+            int64_t res = events[i].res;
+            if (res == (int64_t)job->block_size)
+            {
+                hist_record(&job->interval[slot_dir[slot]], now - slot_start[slot]);
+            }
+            else if (error == 0)
+            {
+                error = res < 0 ? (int)-res : EIO;
+            }
+            free_slots[free_count++] = slot;
+        }
+        inflight -= (unsigned)reaped;
+        maybe_report(job, now, false);
+    }
+
+    syscall(__NR_io_destroy, ctx);
+    free(iocbs);
+    free(batch);
+    free(events);
+    free(slot_start);
+    free(slot_dir);
+    free(free_slots);
+    return error;
+}
+
+/* Private helper function: pick a random block and the direction by the write share */
+static uint64_t next_io(IoJob *job, IoDir *dir)
+{
+    *dir = (int)(next_random(&job->rng) % 100) < job->write_pct ? IO_WRITE : IO_READ;
+    return next_random(&job->rng) % job->blocks;
+}
+
+/*
+ * Private helper function: log an interval once one has elapsed. At the
+ * end of the run (force) what is left is logged too, unless it is only
+ * the drain of the last I/Os in flight, which is folded into the totals.
+ */
+static void maybe_report(IoJob *job, uint64_t now, bool force)
+{
+    uint64_t elapsed = now - job->last_report;
+    if (elapsed < IO_INTERVAL_NS && !force)
+    {
+        return;
+    }
+    if (elapsed < IO_INTERVAL_NS / 10)
+    {
+        for (int d = 0; d < IO_DIR_COUNT; d++)
+        {
+            hist_merge(&job->totals[d], &job->interval[d]);
+            hist_init(&job->interval[d]);
+        }
+        job->submit_calls_total += job->submit_calls;
+        job->submit_ns_total += job->submit_ns;
+        job->submit_calls = job->submit_ns = job->submit_max_ns = 0;
+        return;
+    }
+    double cpu = cpu_seconds();
+    report_interval(job, (double)(now - job->start) / 1e9, (double)elapsed / 1e9, cpu - job->last_cpu);
+    job->last_report = now;
+    job->last_cpu = cpu;
+}
+
+/* Private helper function: log one interval and fold its histograms into the run totals */
+static void report_interval(IoJob *job, double t_s, double secs, double cpu_s)
+{
+    double iops[IO_DIR_COUNT], mbps[IO_DIR_COUNT];
+    LatencySummary summary[IO_DIR_COUNT];
+
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        hist_summarize(&job->interval[d], &summary[d]);
+        iops[d] = secs > 0.0 ? (double)summary[d].count / secs : 0.0;
+        mbps[d] = secs > 0.0 ? (double)summary[d].count * (double)job->block_size / 1048576.0 / secs : 0.0;
+        if (summary[d].p99 > job->worst_p99[d])
+        {
+            job->worst_p99[d] = summary[d].p99;
+        }
+        hist_merge(&job->totals[d], &job->interval[d]);
+        hist_init(&job->interval[d]);
+    }
+
+    double cores = secs > 0.0 ? cpu_s / secs : 0.0;
+    double submit_us = job->submit_calls > 0 ? (double)job->submit_ns / (double)job->submit_calls / 1e3 : 0.0;
+
+    logger_info("IO: %5.0fs read %8.0f IOPS %8.1f MB/s avg %7.1f us p99 %7.1f us | "
+                "write %8.0f IOPS %8.1f MB/s avg %7.1f us p99 %7.1f us | %.2f cores",
+                t_s, iops[IO_READ], mbps[IO_READ], summary[IO_READ].mean / 1e3, (double)summary[IO_READ].p99 / 1e3,
+                iops[IO_WRITE], mbps[IO_WRITE], summary[IO_WRITE].mean / 1e3, (double)summary[IO_WRITE].p99 / 1e3,
+                cores);
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        logger_metric("io_test", "t_s=%.1f,mode=%s,dir=%s,iops=%.0f,mbps=%.2f,lat_mean_us=%.1f,lat_p50_us=%.1f,"
+                      "lat_p90_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,lat_p9999_us=%.1f,lat_max_us=%.1f",
+                      t_s, job->async ? "async" : "sync", dir_names[d], iops[d], mbps[d], summary[d].mean / 1e3,
+                      (double)summary[d].p50 / 1e3, (double)summary[d].p90 / 1e3, (double)summary[d].p99 / 1e3,
+                      (double)summary[d].p999 / 1e3, (double)summary[d].p9999 / 1e3, (double)summary[d].max / 1e3);
+    }
+    double iops_all = iops[IO_READ] + iops[IO_WRITE];
+    logger_metric("io_test_cpu", "t_s=%.1f,mode=%s,cpu_cores=%.3f,iops_per_core=%.0f,submit_calls=%llu,"
+                  "submit_mean_us=%.1f,submit_max_us=%.1f",
+                  t_s, job->async ? "async" : "sync", cores, cores > 0.0 ? iops_all / cores : 0.0,
+                  (unsigned long long)job->submit_calls, submit_us, (double)job->submit_max_ns / 1e3);
+
+    job->submit_calls_total += job->submit_calls;
+    job->submit_ns_total += job->submit_ns;
+    job->submit_calls = job->submit_ns = job->submit_max_ns = 0;
+}
+
+/* Private helper function: user plus system CPU time of the process */
+static double cpu_seconds(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0.0;
+    }
+    return (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1e6 +
+           (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1e6;
+}
+
+/* Private helper function: xorshift64* generator */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
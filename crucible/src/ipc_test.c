@@ -0,0 +1,656 @@
+/**
+ * IPC Latency Test Implementation
+ *
+ * This file implements a ping-pong benchmark between two pinned endpoints.
+ * The initiator sends a sequence number, the responder echoes it back, and
+ * the initiator records the round-trip time. Each mechanism is exercised in
+ * thread mode (two pthreads in one process) and process mode (parent thread
+ * and forked child), so both private and shared futex paths are covered.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <linux/futex.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+/* Include our header files */
+#include "ipc_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "topology.h"
+
+/* Define constants */
+#define IPC_STOP_TOKEN UINT64_C(0xfffffffffffffffe) /* Largest value eventfd accepts */
+#define IPC_MAX_SAMPLES (1u << 20)
+#define IPC_WARMUP_ROUNDS 1000
+#define IPC_RING_SLOTS 64
+#define IPC_SPIN_LIMIT 2000
+#define IPC_DEFAULT_CASE_NS 500000000ULL /* 0.5 s per case without a duration */
+#define IPC_MIN_CASE_NS 100000000ULL     /* Never run a case for less than 0.1 s */
+#define CACHE_LINE 64
+
+/* IPC mechanisms under test */
+typedef enum
+{
+    IPC_PIPE,
+    IPC_EVENTFD,
+    IPC_FUTEX,
+    IPC_UDS,
+    IPC_SHM_SPIN,
+    IPC_SHM_FUTEX,
+    IPC_MECHANISM_COUNT
+} IpcMechanism;
+
+/* One-slot mailbox signalled with a raw futex */
+typedef struct
+{
+    uint32_t seq; /* Futex word, bumped once per message */
+    uint64_t value;
+} __attribute__((aligned(CACHE_LINE))) FutexSlot;
+
+/* Single-producer single-consumer ring; head and tail live on separate lines */
+typedef struct
+{
+    uint32_t head __attribute__((aligned(CACHE_LINE))); /* Written by producer, futex word */
+    uint32_t sleeping;                                  /* Consumer is (about to be) in FUTEX_WAIT */
+    uint32_t tail __attribute__((aligned(CACHE_LINE))); /* Written by consumer */
+    uint64_t slots[IPC_RING_SLOTS] __attribute__((aligned(CACHE_LINE)));
+} SpscRing;
+
+/* Shared-memory area, mapped MAP_SHARED so it survives fork() */
+typedef struct
+{
+    FutexSlot mailbox[2]; /* One per direction */
+    SpscRing ring[2];     /* One per direction */
+} IpcShared;
+
+/*
+ * Channel between the two endpoints. Direction 0 carries initiator to
+ * responder traffic, direction 1 carries the replies.
+ */
+typedef struct
+{
+    IpcMechanism mechanism;
+    bool cross_process;  /* Use shared (non-private) futex operations */
+    int fds[2][2];       /* Per direction: [0] read end, [1] write end */
+    int owned_fds[4];    /* Descriptors to close on teardown */
+    int owned_count;
+    IpcShared *shared;   /* MAP_SHARED area for futex and ring mechanisms */
+    uint32_t last_seq[2]; /* Last mailbox sequence seen per direction */
+} IpcChannel;
+
+/* Arguments for an endpoint thread */
+typedef struct
+{
+    IpcChannel *channel;
+    int cpu;
+    uint64_t budget_ns;
+    uint64_t *samples;
+    size_t sample_count;
+    uint64_t round_trips;
+    uint64_t elapsed_ns;
+    bool ok;
+} IpcEndpoint;
+
+/* A pair of CPUs to place the endpoints on */
+typedef struct
+{
+    const char *name;
+    int cpu_a;
+    int cpu_b;
+} IpcPlacement;
+
+static const char *const mechanism_names[IPC_MECHANISM_COUNT] = {
+    "pipe", "eventfd", "futex", "uds", "shm_spin", "shm_futex"};
+
+/* Private helper function prototypes */
+static bool channel_open(IpcChannel *ch, IpcMechanism mechanism, bool cross_process);
+static void channel_close(IpcChannel *ch);
+static bool ipc_send(IpcChannel *ch, int dir, uint64_t value);
+static bool ipc_recv(IpcChannel *ch, int dir, uint64_t *value);
+static long futex_op(uint32_t *addr, int op, uint32_t val, bool cross_process);
+static void *initiator_main(void *arg);
+static void *responder_main(void *arg);
+static bool run_case(IpcMechanism mechanism, bool cross_process,
+                     const IpcPlacement *placement, uint64_t budget_ns, uint64_t *samples);
+static int build_placements(IpcPlacement *placements, int anchor);
+static inline void cpu_relax(void);
+
+/**
+ * Run the IPC ping-pong suite
+ */
+bool ipc_test_run(const ComponentConfig *comp)
+{
+    int anchor = -1;
+    if (comp->options.cpu.core_count > 0)
+    {
+        anchor = comp->options.cpu.cores[0];
+    }
+
+    IpcPlacement placements[4];
+    int placement_count = build_placements(placements, anchor);
+    if (placement_count == 0)
+    {
+        logger_error("IPC: unable to determine CPU placements");
+        return false;
+    }
+
+    int case_count = placement_count * IPC_MECHANISM_COUNT * 2;
+    uint64_t budget_ns = IPC_DEFAULT_CASE_NS;
+    if (comp->duration > 0)
+    {
+        budget_ns = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)case_count;
+        if (budget_ns < IPC_MIN_CASE_NS)
+        {
+            budget_ns = IPC_MIN_CASE_NS;
+        }
+    }
+
+    uint64_t *samples = malloc(sizeof(uint64_t) * IPC_MAX_SAMPLES);
+    if (!samples)
+    {
+        logger_error("IPC: failed to allocate sample buffer");
+        return false;
+    }
+
+    logger_info("IPC: running %d cases, %.2f s each", case_count, (double)budget_ns / 1e9);
+
+    bool all_ok = true;
+    for (int p = 0; p < placement_count; p++)
+    {
+        for (int mode = 0; mode < 2; mode++)
+        {
+            for (int m = 0; m < IPC_MECHANISM_COUNT; m++)
+            {
+                if (!run_case((IpcMechanism)m, mode == 1, &placements[p], budget_ns, samples))
+                {
+                    all_ok = false;
+                }
+            }
+        }
+    }
+
+    free(samples);
+    return all_ok;
+}
+
+/* Private helper function to pick the CPU pairs supported by this machine */
+static int build_placements(IpcPlacement *placements, int anchor)
+{
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        return 0;
+    }
+
+    if (anchor < 0 || !topology_find(&topo, anchor))
+    {
+        anchor = topo.cpus[0].cpu;
+    }
+
+    int count = 0;
+    placements[count++] = (IpcPlacement){"same_core", anchor, anchor};
+
+    int sibling = topology_smt_sibling(&topo, anchor);
+    int same_socket = topology_same_package_cpu(&topo, anchor);
+    int cross_socket = topology_other_package_cpu(&topo, anchor);
+
+    if (sibling >= 0)
+        placements[count++] = (IpcPlacement){"smt_sibling", anchor, sibling};
+    else
+        logger_info("IPC: no SMT sibling for CPU %d, skipping smt_sibling placement", anchor);
+
+    if (same_socket >= 0)
+        placements[count++] = (IpcPlacement){"same_socket", anchor, same_socket};
+    else
+        logger_info("IPC: no other core in the package of CPU %d, skipping same_socket placement", anchor);
+
+    if (cross_socket >= 0)
+        placements[count++] = (IpcPlacement){"cross_socket", anchor, cross_socket};
+    else
+        logger_info("IPC: single package system, skipping cross_socket placement");
+
+    topology_free(&topo);
+    return count;
+}
+
+/* Private helper function to run one mechanism/mode/placement combination */
+static bool run_case(IpcMechanism mechanism, bool cross_process,
+                     const IpcPlacement *placement, uint64_t budget_ns, uint64_t *samples)
+{
+    const char *mode = cross_process ? "process" : "thread";
+    IpcChannel channel;
+
+    if (!channel_open(&channel, mechanism, cross_process))
+    {
+        logger_error("IPC: failed to set up %s channel: %s",
+                     mechanism_names[mechanism], strerror(errno));
+        return false;
+    }
+
+    IpcEndpoint initiator = {&channel, placement->cpu_a, budget_ns, samples, 0, 0, 0, false};
+    IpcEndpoint responder = {&channel, placement->cpu_b, 0, NULL, 0, 0, 0, false};
+    pthread_t initiator_thread;
+    pthread_t responder_thread;
+    pid_t child = -1;
+    bool ok = true;
+
+    if (cross_process)
+    {
+        /* Fork before any extra threads exist in this process */
+        child = fork();
+        if (child < 0)
+        {
+            logger_error("IPC: fork failed: %s", strerror(errno));
+            channel_close(&channel);
+            return false;
+        }
+        if (child == 0)
+        {
+            responder_main(&responder);
+            _exit(responder.ok ? 0 : 1);
+        }
+    }
+    else if (pthread_create(&responder_thread, NULL, responder_main, &responder) != 0)
+    {
+        logger_error("IPC: failed to create responder thread");
+        channel_close(&channel);
+        return false;
+    }
+
+    if (pthread_create(&initiator_thread, NULL, initiator_main, &initiator) != 0)
+    {
+        logger_error("IPC: failed to create initiator thread");
+        /* Unblock the responder so it can be reaped */
+        ipc_send(&channel, 0, IPC_STOP_TOKEN);
+        initiator.ok = false;
+    }
+    else
+    {
+        pthread_join(initiator_thread, NULL);
+    }
+    ok = initiator.ok;
+
+    if (cross_process)
+    {
+        int status = 0;
+        if (waitpid(child, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        {
+            ok = false;
+        }
+    }
+    else
+    {
+        pthread_join(responder_thread, NULL);
+        ok = ok && responder.ok;
+    }
+
+    channel_close(&channel);
+
+    if (!ok)
+    {
+        logger_error("IPC: %s/%s/%s (cpu %d <-> %d) failed",
+                     mechanism_names[mechanism], mode, placement->name,
+                     placement->cpu_a, placement->cpu_b);
+        return false;
+    }
+
+    LatencySummary summary;
+    bench_summarize(samples, initiator.sample_count, &summary);
+    double rate = initiator.elapsed_ns > 0
+                      ? (double)initiator.round_trips * 1e9 / (double)initiator.elapsed_ns
+                      : 0.0;
+
+    logger_info("IPC: %-9s %-7s %-12s cpu %d <-> %d: %.0f round trips/s, avg %.0f ns, p50 %llu ns, p99 %llu ns",
+                mechanism_names[mechanism], mode, placement->name,
+                placement->cpu_a, placement->cpu_b, rate, summary.mean,
+                (unsigned long long)summary.p50, (unsigned long long)summary.p99);
+
+    logger_metric("ipc_latency",
+                  "mechanism=%s,mode=%s,placement=%s,cpu_a=%d,cpu_b=%d,round_trips=%llu,"
+                  "round_trips_per_sec=%.0f,avg_ns=%.1f,min_ns=%llu,p50_ns=%llu,p90_ns=%llu,"
+                  "p99_ns=%llu,p999_ns=%llu,max_ns=%llu",
+                  mechanism_names[mechanism], mode, placement->name,
+                  placement->cpu_a, placement->cpu_b,
+                  (unsigned long long)initiator.round_trips, rate, summary.mean,
+                  (unsigned long long)summary.min, (unsigned long long)summary.p50,
+                  (unsigned long long)summary.p90, (unsigned long long)summary.p99,
+                  (unsigned long long)summary.p999, (unsigned long long)summary.max);
+    return true;
+}
+
+/* Private helper function: initiator endpoint, measures round trips */
+static void *initiator_main(void *arg)
+{
+    IpcEndpoint *ep = arg;
+    IpcChannel *ch = ep->channel;
+    uint64_t reply = 0;
+
+    bench_pin_cpu(ep->cpu);
+    ep->ok = true;
+
+    /* Warm caches, branch predictors and wake-up paths */
+    for (uint64_t seq = 1; seq <= IPC_WARMUP_ROUNDS; seq++)
+    {
+        if (!ipc_send(ch, 0, seq) || !ipc_recv(ch, 1, &reply) || reply != seq)
+        {
+            ep->ok = false;
+            break;
+        }
+    }
+
+    uint64_t start = bench_now_ns();
+    uint64_t deadline = start + ep->budget_ns;
+    uint64_t now = start;
+    uint64_t seq = IPC_WARMUP_ROUNDS + 1;
+
+    while (ep->ok && now < deadline)
+    {
+        uint64_t t0 = bench_now_ns();
+        if (!ipc_send(ch, 0, seq) || !ipc_recv(ch, 1, &reply) || reply != seq)
+        {
+            logger_error("IPC: %s round trip %llu returned %llu",
+                         mechanism_names[ch->mechanism],
+                         (unsigned long long)seq, (unsigned long long)reply);
+            ep->ok = false;
+            break;
+        }
+        now = bench_now_ns();
+
+        if (ep->sample_count < IPC_MAX_SAMPLES)
+        {
+            ep->samples[ep->sample_count++] = now - t0;
+        }
+        ep->round_trips++;
+        seq++;
+    }
+    ep->elapsed_ns = now - start;
+
+    /* Tell the responder to finish and wait for its acknowledgement */
+    if (ipc_send(ch, 0, IPC_STOP_TOKEN))
+    {
+        ipc_recv(ch, 1, &reply);
+    }
+    return NULL;
+}
+
+/* Private helper function: responder endpoint, echoes every message */
+static void *responder_main(void *arg)
+{
+    IpcEndpoint *ep = arg;
+    IpcChannel *ch = ep->channel;
+    uint64_t value = 0;
+
+    bench_pin_cpu(ep->cpu);
+    ep->ok = false;
+
+    for (;;)
+    {
+        if (!ipc_recv(ch, 0, &value) || !ipc_send(ch, 1, value))
+        {
+            return NULL;
+        }
+        if (value == IPC_STOP_TOKEN)
+        {
+            break;
+        }
+    }
+
+    ep->ok = true;
+    return NULL;
+}
+
+/* Private helper function to create the kernel objects for a mechanism */
+static bool channel_open(IpcChannel *ch, IpcMechanism mechanism, bool cross_process)
+{
+    memset(ch, 0, sizeof(*ch));
+    ch->mechanism = mechanism;
+    ch->cross_process = cross_process;
+
+    switch (mechanism)
+    {
+    case IPC_PIPE:
+        for (int dir = 0; dir < 2; dir++)
+        {
+            if (pipe(ch->fds[dir]) != 0)
+            {
+                channel_close(ch);
+                return false;
+            }
+            ch->owned_fds[ch->owned_count++] = ch->fds[dir][0];
+            ch->owned_fds[ch->owned_count++] = ch->fds[dir][1];
+        }
+        return true;
+
+    case IPC_EVENTFD:
+        for (int dir = 0; dir < 2; dir++)
+        {
+            int fd = eventfd(0, 0);
+            if (fd < 0)
+            {
+                channel_close(ch);
+                return false;
+            }
+            ch->fds[dir][0] = fd;
+            ch->fds[dir][1] = fd;
+            ch->owned_fds[ch->owned_count++] = fd;
+        }
+        return true;
+
+    case IPC_UDS:
+    {
+        int sv[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0)
+        {
+            return false;
+        }
+        /* Initiator owns sv[0], responder owns sv[1] */
+        ch->fds[0][0] = sv[1];
+        ch->fds[0][1] = sv[0];
+        ch->fds[1][0] = sv[0];
+        ch->fds[1][1] = sv[1];
+        ch->owned_fds[ch->owned_count++] = sv[0];
+        ch->owned_fds[ch->owned_count++] = sv[1];
+        return true;
+    }
+
+    case IPC_FUTEX:
+    case IPC_SHM_SPIN:
+    case IPC_SHM_FUTEX:
+    {
+        void *area = mmap(NULL, sizeof(IpcShared), PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+        if (area == MAP_FAILED)
+        {
+            return false;
+        }
+        memset(area, 0, sizeof(IpcShared));
+        ch->shared = area;
+        return true;
+    }
+
+    default:
+        errno = EINVAL;
+        return false;
+    }
+}
+
+/* Private helper function to release the kernel objects of a channel */
+static void channel_close(IpcChannel *ch)
+{
+    for (int i = 0; i < ch->owned_count; i++)
+    {
+        close(ch->owned_fds[i]);
+    }
+    ch->owned_count = 0;
+
+    if (ch->shared)
+    {
+        munmap(ch->shared, sizeof(IpcShared));
+        ch->shared = NULL;
+    }
+}
+
+/* Private helper function to send one 8-byte message in a direction */
+static bool ipc_send(IpcChannel *ch, int dir, uint64_t value)
+{
+    switch (ch->mechanism)
+    {
+    case IPC_PIPE:
+    case IPC_EVENTFD:
+    case IPC_UDS:
+        return write(ch->fds[dir][1], &value, sizeof(value)) == (ssize_t)sizeof(value);
+
+    case IPC_FUTEX:
+    {
+        FutexSlot *slot = &ch->shared->mailbox[dir];
+        slot->value = value;
+        __atomic_fetch_add(&slot->seq, 1, __ATOMIC_SEQ_CST);
+        futex_op(&slot->seq, FUTEX_WAKE, 1, ch->cross_process);
+        return true;
+    }
+
+    case IPC_SHM_SPIN:
+    case IPC_SHM_FUTEX:
+    {
+        SpscRing *ring = &ch->shared->ring[dir];
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+
+        while (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) >= IPC_RING_SLOTS)
+        {
+            cpu_relax();
+        }
+        ring->slots[head % IPC_RING_SLOTS] = value;
+
+        /* Sequentially consistent store/load pair pairs with the consumer's sleep check */
+        __atomic_store_n(&ring->head, head + 1, __ATOMIC_SEQ_CST);
+        if (ch->mechanism == IPC_SHM_FUTEX && __atomic_load_n(&ring->sleeping, __ATOMIC_SEQ_CST))
+        {
+            futex_op(&ring->head, FUTEX_WAKE, 1, ch->cross_process);
+        }
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+/* Private helper function to receive one 8-byte message from a direction */
+static bool ipc_recv(IpcChannel *ch, int dir, uint64_t *value)
+{
+    switch (ch->mechanism)
+    {
+    case IPC_PIPE:
+    case IPC_EVENTFD:
+    case IPC_UDS:
+    {
+        /* Stream sockets and pipes may deliver a message in pieces */
+        char *dst = (char *)value;
+        size_t got = 0;
+        while (got < sizeof(*value))
+        {
+            ssize_t n = read(ch->fds[dir][0], dst + got, sizeof(*value) - got);
+            if (n <= 0)
+            {
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            got += (size_t)n;
+        }
+        return true;
+    }
+
+    case IPC_FUTEX:
+    {
+        FutexSlot *slot = &ch->shared->mailbox[dir];
+        uint32_t last = ch->last_seq[dir];
+        uint32_t seq;
+
+        while ((seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE)) == last)
+        {
+            futex_op(&slot->seq, FUTEX_WAIT, last, ch->cross_process);
+        }
+        ch->last_seq[dir] = seq;
+        *value = slot->value;
+        return true;
+    }
+
+    case IPC_SHM_SPIN:
+    case IPC_SHM_FUTEX:
+    {
+        SpscRing *ring = &ch->shared->ring[dir];
+        uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        unsigned int spins = 0;
+
+        while (__atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == tail)
+        {
+            if (++spins < IPC_SPIN_LIMIT)
+            {
+                cpu_relax();
+                continue;
+            }
+            spins = 0;
+
+            if (ch->mechanism == IPC_SHM_SPIN)
+            {
+                /* Lets a same-core peer run instead of burning the whole slice */
+                sched_yield();
+                continue;
+            }
+
+            __atomic_store_n(&ring->sleeping, 1, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&ring->head, __ATOMIC_SEQ_CST) == tail)
+            {
+                futex_op(&ring->head, FUTEX_WAIT, tail, ch->cross_process);
+            }
+            __atomic_store_n(&ring->sleeping, 0, __ATOMIC_RELAXED);
+        }
+
+        *value = ring->slots[tail % IPC_RING_SLOTS];
+        __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+/* Private helper function wrapping the raw futex system call */
+static long futex_op(uint32_t *addr, int op, uint32_t val, bool cross_process)
+{
+    if (!cross_process)
+    {
+        op |= FUTEX_PRIVATE_FLAG;
+    }
+    return syscall(SYS_futex, addr, op, val, NULL, NULL, 0);
+}
+
+/* Private helper function to ease off the core while spinning */
+static inline void cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
@@ -0,0 +1,465 @@
+/**
+ * Memory Latency Test Implementation
+ *
+ * This file implements the pointer-chasing latency sweep. For each working
+ * set size a chain is built over the start of one large buffer, walked
+ * once to warm the caches, and then timed. The resulting latency curve is
+ * split into plateaus, which are labelled against the cache sizes the
+ * kernel reports.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sched.h>
+
+/* Include our header files */
+#include "latency_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "numa.h"
+#include "perf_counter.h"
+#include "pointer_chase.h"
+#include "topology.h"
+
+/* Define constants */
+#define LAT_MIN_SIZE (4ULL << 10)
+#define LAT_DEFAULT_MAX_SIZE (4ULL << 30)
+#define LAT_MAX_POINTS 64
+#define LAT_CALIBRATE_LOADS (1ULL << 16)
+#define LAT_TARGET_NS 20000000.0   /* Time per timed repetition */
+#define LAT_MAX_LOADS (1ULL << 28)
+#define LAT_WARMUP_MAX_LOADS (1ULL << 24)
+#define LAT_REPS 3
+#define LAT_STEP_RATIO 1.10        /* Largest step still counted as flat */
+#define LAT_PLATEAU_SPREAD 1.25    /* Largest rise across a single plateau */
+#define LAT_MAX_CACHE_LEVEL 4
+#define LAT_SEED 0x5DEECE66DULL
+
+/* One measured point of the sweep */
+typedef struct
+{
+    size_t size;
+    double ns;
+    double tlb_misses; /* dTLB misses per load, negative if not counted */
+} LatencyPoint;
+
+/* Private helper function prototypes */
+static int build_sizes(size_t *sizes, int max, size_t limit);
+static double measure_size(void *base, size_t size, const ChasePattern *pattern, bool tlb_friendly,
+                           const PerfCounter *tlb, double *tlb_misses);
+static void report_plateaus(const LatencyPoint *points, int count, const char *pattern_name,
+                            const char *variant, size_t llc_size, int cache_levels);
+static void compare_pages(const LatencyPoint *ref, int ref_count, const LatencyPoint *points, int count,
+                          const char *pattern_name, const char *variant, const char *ref_pages,
+                          const char *pages);
+
+/**
+ * Run the latency sweep
+ */
+bool latency_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    ChasePattern pattern;
+    if (!chase_parse_pattern(opts->pattern, &pattern))
+    {
+        logger_error("Latency: invalid pattern '%s' (expected seq, rand or stride:N)", opts->pattern);
+        return false;
+    }
+    char pattern_name[32];
+    chase_pattern_name(&pattern, pattern_name, sizeof(pattern_name));
+
+    size_t max_size = LAT_DEFAULT_MAX_SIZE;
+    if (opts->size[0] != '\0' && !bench_parse_size(opts->size, &max_size))
+    {
+        logger_error("Latency: invalid size '%s'", opts->size);
+        return false;
+    }
+    size_t limit = bench_mem_available() / 2;
+    if (limit > 0 && max_size > limit)
+    {
+        logger_warning("Latency: %zu MB requested, only %zu MB available, shrinking",
+                       max_size >> 20, limit >> 20);
+        max_size = limit;
+    }
+
+    size_t sizes[LAT_MAX_POINTS];
+    int size_count = build_sizes(sizes, LAT_MAX_POINTS, max_size);
+    if (size_count == 0 || max_size < 2 * pattern.stride)
+    {
+        logger_error("Latency: working set of %zu bytes is too small", max_size);
+        return false;
+    }
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Latency: invalid page type '%s' (expected 4k, thp, 2m, 1g or all)", opts->pages);
+        return false;
+    }
+
+    /* Stay on one CPU so the private caches being measured stay the same; later components get the mask back */
+    bool saved_affinity = false;
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) == 0)
+    {
+        saved_affinity = true;
+    }
+    int cpu = sched_getcpu();
+    if (cpu >= 0)
+    {
+        bench_pin_cpu(cpu);
+    }
+
+    /* With numa:true buffers are bound to the measuring CPU's node before first touch */
+    int node = -1;
+    if (opts->numa_aware)
+    {
+        CpuTopology topo;
+        if (cpu >= 0 && topology_load(&topo))
+        {
+            const CpuInfo *info = topology_find(&topo, cpu);
+            node = info && info->node >= 0 ? info->node : 0;
+            topology_free(&topo);
+        }
+    }
+
+    size_t llc_size = 0;
+    int cache_levels = 0;
+    for (int level = 1; level <= LAT_MAX_CACHE_LEVEL; level++)
+    {
+        size_t cache = topology_cache_size(cpu >= 0 ? cpu : 0, level);
+        if (cache > 0)
+        {
+            logger_info("Latency: L%d cache %zu KB", level, cache >> 10);
+            llc_size = cache;
+            cache_levels = level;
+        }
+    }
+
+    PerfCounter tlb;
+    bool have_tlb = perf_counter_open(&tlb, PERF_DTLB_MISSES, false);
+    if (!have_tlb)
+    {
+        logger_info("Latency: dTLB miss counters unavailable, reporting latency only");
+    }
+
+    logger_info("Latency: pattern %s, %zu KB to %zu MB on CPU %d",
+                pattern_name, sizes[0] >> 10, sizes[size_count - 1] >> 20, cpu);
+
+    /* Random chains get both TLB variants, linear chains only one */
+    int variants = pattern.order == CHASE_RAND ? 2 : 1;
+    static LatencyPoint results[MEM_PAGE_TYPE_MAX][2][LAT_MAX_POINTS];
+    int result_counts[MEM_PAGE_TYPE_MAX][2] = {{0}};
+    bool measured[MEM_PAGE_TYPE_MAX] = {false};
+    int measured_count = 0;
+
+    for (int t = 0; t < type_count; t++)
+    {
+        const char *pages = mem_buffer_page_name(types[t]);
+        MemBuffer buffer;
+        if (!mem_buffer_alloc_pages(&buffer, sizes[size_count - 1], 0, types[t]))
+        {
+            logger_warning("Latency: cannot map %zu MB with %s pages, skipping", sizes[size_count - 1] >> 20, pages);
+            continue;
+        }
+        if (node >= 0 && !mem_buffer_bind(&buffer, node))
+        {
+            logger_warning("Latency: cannot bind buffer to the local node, using default placement");
+        }
+
+        for (int v = 0; v < variants; v++)
+        {
+            bool tlb_friendly = (pattern.order == CHASE_RAND && v == 0);
+            const char *variant = pattern.order != CHASE_RAND ? "linear" : (tlb_friendly ? "friendly" : "hostile");
+            LatencyPoint *points = results[t][v];
+            int point_count = 0;
+
+            for (int i = 0; i < size_count; i++)
+            {
+                double misses = -1.0;
+                double ns = measure_size(buffer.data, sizes[i], &pattern, tlb_friendly,
+                                         have_tlb ? &tlb : NULL, &misses);
+                if (ns <= 0.0)
+                {
+                    continue;
+                }
+                points[point_count++] = (LatencyPoint){sizes[i], ns, misses};
+
+                if (misses >= 0.0)
+                {
+                    logger_info("Latency: %-10s %-8s %-7s %10zu KB: %7.2f ns/load, %.3f dTLB misses/load",
+                                pattern_name, variant, pages, sizes[i] >> 10, ns, misses);
+                    logger_metric("mem_latency", "pattern=%s,tlb=%s,pages=%s,size_kb=%zu,ns_per_load=%.3f,"
+                                  "dtlb_misses_per_load=%.4f",
+                                  pattern_name, variant, pages, sizes[i] >> 10, ns, misses);
+                }
+                else
+                {
+                    logger_info("Latency: %-10s %-8s %-7s %10zu KB: %7.2f ns/load",
+                                pattern_name, variant, pages, sizes[i] >> 10, ns);
+                    logger_metric("mem_latency", "pattern=%s,tlb=%s,pages=%s,size_kb=%zu,ns_per_load=%.3f",
+                                  pattern_name, variant, pages, sizes[i] >> 10, ns);
+                }
+            }
+            result_counts[t][v] = point_count;
+
+            report_plateaus(points, point_count, pattern_name, variant, llc_size, cache_levels);
+        }
+
+        if (node >= 0)
+        {
+            double placed = numa_placement(buffer.data, buffer.size, node);
+            logger_info("Latency: %.0f%% of sampled pages on node %d", placed * 100.0, node);
+        }
+
+        mem_buffer_free(&buffer);
+        measured[t] = true;
+        measured_count++;
+    }
+
+    if (have_tlb)
+    {
+        perf_counter_close(&tlb);
+    }
+    if (saved_affinity)
+    {
+        sched_setaffinity(0, sizeof(original), &original);
+    }
+    if (measured_count == 0)
+    {
+        logger_error("Latency: no page type could be mapped");
+        return false;
+    }
+
+    /* Compare every page type against the first one measured */
+    int ref = 0;
+    while (!measured[ref])
+    {
+        ref++;
+    }
+    for (int t = ref + 1; t < type_count; t++)
+    {
+        if (!measured[t])
+        {
+            continue;
+        }
+        for (int v = 0; v < variants; v++)
+        {
+            const char *variant = pattern.order != CHASE_RAND ? "linear" : (v == 0 ? "friendly" : "hostile");
+            compare_pages(results[ref][v], result_counts[ref][v], results[t][v], result_counts[t][v],
+                          pattern_name, variant, mem_buffer_page_name(types[ref]), mem_buffer_page_name(types[t]));
+        }
+    }
+
+    return true;
+}
+
+/* Private helper function to list working set sizes: powers of two and the midpoints between them */
+static int build_sizes(size_t *sizes, int max, size_t limit)
+{
+    int count = 0;
+    for (size_t size = LAT_MIN_SIZE; size <= limit && count < max; size *= 2)
+    {
+        sizes[count++] = size;
+        size_t mid = size + size / 2;
+        if (mid <= limit && count < max)
+        {
+            sizes[count++] = mid;
+        }
+    }
+    return count;
+}
+
+/* Private helper function to time one working set size; returns the best ns per load */
+static double measure_size(void *base, size_t size, const ChasePattern *pattern, bool tlb_friendly,
+                           const PerfCounter *tlb, double *tlb_misses)
+{
+    size_t nodes;
+    void **head = chase_build(base, size, pattern, tlb_friendly, LAT_SEED, &nodes);
+    if (!head)
+    {
+        return 0.0;
+    }
+
+    /* Warm up: one lap brings the chain into whatever level holds it */
+    head = chase_walk(head, nodes < LAT_WARMUP_MAX_LOADS ? nodes : LAT_WARMUP_MAX_LOADS);
+
+    /* Size the timed runs from a short calibration walk */
+    double estimate = chase_measure(head, LAT_CALIBRATE_LOADS);
+    uint64_t loads = LAT_CALIBRATE_LOADS;
+    if (estimate > 0.0)
+    {
+        double wanted = LAT_TARGET_NS / estimate;
+        loads = wanted > (double)LAT_MAX_LOADS ? LAT_MAX_LOADS : (uint64_t)wanted;
+        if (loads < LAT_CALIBRATE_LOADS)
+        {
+            loads = LAT_CALIBRATE_LOADS;
+        }
+    }
+
+    uint64_t misses_before = tlb ? perf_counter_read(tlb) : 0;
+    double best = 0.0;
+    for (int rep = 0; rep < LAT_REPS; rep++)
+    {
+        double ns = chase_measure(head, loads);
+        if (rep == 0 || ns < best)
+        {
+            best = ns;
+        }
+    }
+    if (tlb)
+    {
+        uint64_t misses = perf_counter_read(tlb) - misses_before;
+        *tlb_misses = (double)misses / (double)(loads * LAT_REPS);
+    }
+    return best;
+}
+
+/* Private helper function to find flat runs in the curve and label them */
+static void report_plateaus(const LatencyPoint *points, int count, const char *pattern_name,
+                            const char *variant, size_t llc_size, int cache_levels)
+{
+    int starts[LAT_MAX_POINTS], ends[LAT_MAX_POINTS];
+    double values[LAT_MAX_POINTS];
+    int plateau_count = 0;
+
+    int start = 0;
+    while (start < count)
+    {
+        /* Grow the run while each step is flat and the whole run stays tight */
+        double low = points[start].ns;
+        int end = start;
+        while (end + 1 < count &&
+               points[end + 1].ns <= points[end].ns * LAT_STEP_RATIO &&
+               points[end + 1].ns <= low * LAT_PLATEAU_SPREAD)
+        {
+            end++;
+            if (points[end].ns < low)
+            {
+                low = points[end].ns;
+            }
+        }
+
+        /* A plateau needs at least two points; single points are transitions */
+        if (end > start)
+        {
+            double total = 0.0;
+            for (int i = start; i <= end; i++)
+            {
+                total += points[i].ns;
+            }
+            double ns = total / (double)(end - start + 1);
+
+            /* A noisy point can split one level in two; join them back up */
+            if (plateau_count > 0 && ns <= values[plateau_count - 1] * LAT_PLATEAU_SPREAD)
+            {
+                int last = plateau_count - 1;
+                int before = ends[last] - starts[last] + 1;
+                int added = end - start + 1;
+                values[last] = (values[last] * before + ns * added) / (double)(before + added);
+                ends[last] = end;
+            }
+            else
+            {
+                starts[plateau_count] = start;
+                ends[plateau_count] = end;
+                values[plateau_count] = ns;
+                plateau_count++;
+            }
+        }
+
+        start = end + 1;
+    }
+
+    if (plateau_count == 0)
+    {
+        logger_warning("Latency: no plateaus found for %s %s, curve too noisy", pattern_name, variant);
+        return;
+    }
+
+    int level = 0;
+    bool in_dram = false;
+    for (int p = 0; p < plateau_count; p++)
+    {
+        /*
+         * Anything past the last cache level is memory: either the run
+         * starts beyond the largest cache or every level is already named.
+         * Virtual machines often report cache sizes that do not match the
+         * host, so the level count is the more reliable of the two.
+         */
+        bool beyond_cache;
+        if (cache_levels > 0)
+        {
+            beyond_cache = points[starts[p]].size > llc_size || level >= cache_levels;
+        }
+        else
+        {
+            beyond_cache = (p == plateau_count - 1 && level > 0);
+        }
+
+        char label[16];
+        if (in_dram || beyond_cache)
+        {
+            /* Later memory plateaus are TLB reach steps, keep them apart */
+            in_dram = true;
+            snprintf(label, sizeof(label), "DRAM");
+        }
+        else
+        {
+            snprintf(label, sizeof(label), "L%d", ++level);
+        }
+
+        logger_info("Latency: %s %s plateau %s: %zu KB to %zu KB at %.2f ns/load",
+                    pattern_name, variant, label, points[starts[p]].size >> 10,
+                    points[ends[p]].size >> 10, values[p]);
+        logger_metric("mem_latency_plateau", "pattern=%s,tlb=%s,level=%s,from_kb=%zu,to_kb=%zu,ns_per_load=%.3f",
+                      pattern_name, variant, label, points[starts[p]].size >> 10,
+                      points[ends[p]].size >> 10, values[p]);
+    }
+}
+
+/* Private helper function to report a page type's latency against the reference type */
+static void compare_pages(const LatencyPoint *ref, int ref_count, const LatencyPoint *points, int count,
+                          const char *pattern_name, const char *variant, const char *ref_pages,
+                          const char *pages)
+{
+    const LatencyPoint *last = NULL;
+    const LatencyPoint *last_ref = NULL;
+
+    for (int i = 0; i < count; i++)
+    {
+        for (int j = 0; j < ref_count; j++)
+        {
+            if (ref[j].size != points[i].size || ref[j].ns <= 0.0)
+            {
+                continue;
+            }
+
+            double delta = 100.0 * (points[i].ns - ref[j].ns) / ref[j].ns;
+            logger_metric("mem_latency_pages", "pattern=%s,tlb=%s,pages=%s,ref_pages=%s,size_kb=%zu,"
+                          "ns_per_load=%.3f,ref_ns_per_load=%.3f,delta_pct=%.1f",
+                          pattern_name, variant, pages, ref_pages, points[i].size >> 10,
+                          points[i].ns, ref[j].ns, delta);
+            last = &points[i];
+            last_ref = &ref[j];
+            break;
+        }
+    }
+
+    /* The largest working set is where page size matters most */
+    if (last)
+    {
+        logger_info("Latency: %s %s at %zu KB: %s %.2f ns vs %s %.2f ns (%+.1f%%)",
+                    pattern_name, variant, last->size >> 10, pages, last->ns, ref_pages, last_ref->ns,
+                    100.0 * (last->ns - last_ref->ns) / last_ref->ns);
+    }
+}
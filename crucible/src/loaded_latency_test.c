@@ -0,0 +1,507 @@
+/**
+ * Loaded Latency Test Implementation
+ *
+ * This file implements an MLC-style loaded-latency test. Load threads
+ * stream through private buffers one cache line at a time. They read or
+ * write according to the configured mix and spin for the configured delay
+ * after every 4 KB. The calling thread walks a random pointer chain over a
+ * buffer larger than the last-level cache and times its loads while the
+ * load threads' byte counters give the bandwidth for the same window.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+/* Include our header files */
+#include "loaded_latency_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "pointer_chase.h"
+#include "topology.h"
+
+/* Define constants */
+#define LL_DEFAULT_LOAD_SIZE (1ULL << 30)
+#define LL_MIN_CHASE_SIZE (256ULL << 20)
+#define LL_MAX_THREADS 256
+#define LL_MAX_DELAYS 32
+#define LL_LINE_SIZE 64
+#define LL_CHUNK_LINES 64          /* 4 KB of traffic between delays */
+#define LL_SETTLE_NS 50000000ULL   /* Let traffic stabilise after a delay change */
+#define LL_MIN_WINDOW_NS 200000000ULL
+#define LL_MAX_WINDOW_NS 5000000000ULL
+#define LL_SLICE_LOADS (1ULL << 16)
+#define LL_KNEE_FACTOR 2.0
+#define LL_SEED 0x2545F4914F6CDD1DULL
+
+static const unsigned long default_delays[] = {50000, 10000, 5000, 2000, 1000, 500, 200, 100, 50, 0};
+
+/* Per-thread load generator state, one cache line each to keep counters apart */
+typedef struct
+{
+    pthread_t thread;
+    int cpu;
+    char *buffer;
+    size_t size;
+    uint64_t bytes;            /* Traffic generated so far */
+    const int *write_lines;    /* Lines per chunk that are written */
+    const unsigned long *delay;
+    const int *active;
+    const int *stop;
+    int *ready;                /* Counts threads done touching their buffer */
+    uint64_t sink;
+} __attribute__((aligned(LL_LINE_SIZE))) LoadWorker;
+
+/* One point of the curve */
+typedef struct
+{
+    unsigned long delay;
+    double gbps;
+    double ns;
+} LoadedPoint;
+
+/* Private helper function prototypes */
+static void *load_worker(void *arg);
+static int parse_delays(const char *str, unsigned long *delays, int max);
+static int compare_delay_desc(const void *a, const void *b);
+static uint64_t total_bytes(const LoadWorker *workers, int count);
+static LoadedPoint measure_point(void **chain, LoadWorker *workers, int count, uint64_t window_ns);
+static void sleep_ns(uint64_t ns);
+static void report_knee(const LoadedPoint *points, int count, double unloaded_ns, int threads, int write_pct);
+
+/**
+ * Run the loaded-latency test
+ */
+bool loaded_latency_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    ChasePattern pattern;
+    if (!chase_parse_pattern(opts->pattern, &pattern))
+    {
+        logger_error("Loaded latency: invalid pattern '%s'", opts->pattern);
+        return false;
+    }
+    if (opts->write_pct < 0 || opts->write_pct > 100)
+    {
+        logger_error("Loaded latency: write percentage %d out of range", opts->write_pct);
+        return false;
+    }
+
+    unsigned long delays[LL_MAX_DELAYS];
+    int delay_count;
+    if (opts->delays[0] != '\0')
+    {
+        delay_count = parse_delays(opts->delays, delays, LL_MAX_DELAYS);
+        if (delay_count <= 0)
+        {
+            logger_error("Loaded latency: invalid delay list '%s'", opts->delays);
+            return false;
+        }
+    }
+    else
+    {
+        delay_count = (int)(sizeof(default_delays) / sizeof(default_delays[0]));
+        memcpy(delays, default_delays, sizeof(default_delays));
+    }
+    /* Largest delay first, so bandwidth rises along the curve */
+    qsort(delays, (size_t)delay_count, sizeof(delays[0]), compare_delay_desc);
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Loaded latency: invalid page type '%s'", opts->pages);
+        return false;
+    }
+    if (type_count > 1)
+    {
+        logger_warning("Loaded latency: one page type per run, using %s", mem_buffer_page_name(types[0]));
+    }
+
+    size_t load_size = LL_DEFAULT_LOAD_SIZE;
+    if (opts->size[0] != '\0' && !bench_parse_size(opts->size, &load_size))
+    {
+        logger_error("Loaded latency: invalid size '%s'", opts->size);
+        return false;
+    }
+
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        logger_error("Loaded latency: cannot read CPU topology");
+        return false;
+    }
+
+    /* Latency thread on the first CPU, load threads on the rest */
+    int latency_cpu = topo.cpus[0].cpu;
+    int thread_count = opts->threads > 0 ? opts->threads : topo.count - 1;
+    if (thread_count > LL_MAX_THREADS)
+    {
+        thread_count = LL_MAX_THREADS;
+    }
+    if (topo.count < 2)
+    {
+        logger_warning("Loaded latency: only one CPU, load threads share it with the latency thread");
+        if (thread_count < 1)
+        {
+            thread_count = 1;
+        }
+    }
+
+    /* The chain must be well beyond the last-level cache */
+    size_t chase_size = LL_MIN_CHASE_SIZE;
+    for (int level = 1; level <= 4; level++)
+    {
+        size_t cache = topology_cache_size(latency_cpu, level);
+        if (cache * 2 > chase_size)
+        {
+            chase_size = cache * 2;
+        }
+    }
+
+    size_t available = bench_mem_available() / 2;
+    if (available > 0 && chase_size + load_size > available)
+    {
+        size_t shrunk = available > chase_size * 2 ? available - chase_size : available / 2;
+        logger_warning("Loaded latency: %zu MB of load buffers requested, using %zu MB",
+                       load_size >> 20, shrunk >> 20);
+        load_size = shrunk;
+        if (chase_size > available / 2)
+        {
+            chase_size = available / 2;
+        }
+    }
+
+    size_t per_thread = load_size / (size_t)thread_count;
+    per_thread -= per_thread % (LL_LINE_SIZE * LL_CHUNK_LINES);
+    if (per_thread == 0)
+    {
+        logger_error("Loaded latency: load buffer too small for %d threads", thread_count);
+        topology_free(&topo);
+        return false;
+    }
+
+    MemBuffer chase_buffer, load_buffer;
+    if (!mem_buffer_alloc_pages(&chase_buffer, chase_size, 0, types[0]))
+    {
+        logger_error("Loaded latency: failed to map %zu MB chase buffer", chase_size >> 20);
+        topology_free(&topo);
+        return false;
+    }
+    if (!mem_buffer_alloc_pages(&load_buffer, per_thread * (size_t)thread_count, 0, types[0]))
+    {
+        logger_error("Loaded latency: failed to map %zu MB of load buffers", load_size >> 20);
+        mem_buffer_free(&chase_buffer);
+        topology_free(&topo);
+        return false;
+    }
+
+    /* Pin for the measurement only; the caller's affinity is restored at the end */
+    bool saved_affinity = false;
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) == 0)
+    {
+        saved_affinity = true;
+    }
+
+    bench_pin_cpu(latency_cpu);
+    void **chain = chase_build(chase_buffer.data, chase_size, &pattern, false, LL_SEED, NULL);
+
+    int write_lines = (LL_CHUNK_LINES * opts->write_pct + 50) / 100;
+    unsigned long delay = delays[0];
+    int active = 0;
+    int stop = 0;
+    int ready = 0;
+
+    LoadWorker *workers = calloc((size_t)thread_count, sizeof(LoadWorker));
+    if (!workers || !chain)
+    {
+        logger_error("Loaded latency: setup failed");
+        if (saved_affinity)
+        {
+            sched_setaffinity(0, sizeof(original), &original);
+        }
+        free(workers);
+        mem_buffer_free(&load_buffer);
+        mem_buffer_free(&chase_buffer);
+        topology_free(&topo);
+        return false;
+    }
+
+    int started = 0;
+    for (int i = 0; i < thread_count; i++)
+    {
+        LoadWorker *worker = &workers[i];
+        worker->cpu = topo.count > 1 ? topo.cpus[1 + i % (topo.count - 1)].cpu : latency_cpu;
+        worker->buffer = (char *)load_buffer.data + (size_t)i * per_thread;
+        worker->size = per_thread;
+        worker->write_lines = &write_lines;
+        worker->delay = &delay;
+        worker->active = &active;
+        worker->stop = &stop;
+        worker->ready = &ready;
+        if (pthread_create(&worker->thread, NULL, load_worker, worker) != 0)
+        {
+            logger_warning("Loaded latency: started only %d of %d load threads", started, thread_count);
+            break;
+        }
+        started++;
+    }
+    topology_free(&topo);
+
+    bool ok = started > 0;
+    if (ok)
+    {
+        /* Spread the requested duration over the unloaded point and every delay */
+        uint64_t window = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)(delay_count + 1);
+        if (window < LL_MIN_WINDOW_NS)
+            window = LL_MIN_WINDOW_NS;
+        if (window > LL_MAX_WINDOW_NS)
+            window = LL_MAX_WINDOW_NS;
+
+        logger_info("Loaded latency: latency thread on CPU %d, %d load threads, %d%% writes, "
+                    "%zu MB chain, %zu MB per load thread, %s pages",
+                    latency_cpu, started, opts->write_pct, chase_size >> 20, per_thread >> 20,
+                    mem_buffer_page_name(types[0]));
+
+        /* The load threads fault in their buffers first; none of that may overlap the unloaded reference */
+        while (__atomic_load_n(&ready, __ATOMIC_ACQUIRE) < started)
+        {
+            sleep_ns(1000000);
+        }
+
+        /* Warm the chain once, then take the unloaded reference */
+        chase_walk(chain, chase_size / pattern.stride);
+        LoadedPoint unloaded = measure_point(chain, workers, started, window);
+        logger_info("Loaded latency: unloaded %.2f ns", unloaded.ns);
+        logger_metric("mem_loaded_latency", "delay=idle,threads=%d,write_pct=%d,bw_gbps=%.3f,latency_ns=%.3f",
+                      started, opts->write_pct, unloaded.gbps, unloaded.ns);
+
+        LoadedPoint points[LL_MAX_DELAYS];
+        __atomic_store_n(&active, 1, __ATOMIC_RELEASE);
+        for (int i = 0; i < delay_count; i++)
+        {
+            __atomic_store_n(&delay, delays[i], __ATOMIC_RELAXED);
+            sleep_ns(LL_SETTLE_NS);
+
+            points[i] = measure_point(chain, workers, started, window);
+            points[i].delay = delays[i];
+
+            logger_info("Loaded latency: delay %6lu: %8.2f GB/s, %8.2f ns", delays[i], points[i].gbps, points[i].ns);
+            logger_metric("mem_loaded_latency", "delay=%lu,threads=%d,write_pct=%d,bw_gbps=%.3f,latency_ns=%.3f",
+                          delays[i], started, opts->write_pct, points[i].gbps, points[i].ns);
+        }
+
+        report_knee(points, delay_count, unloaded.ns, started, opts->write_pct);
+    }
+
+    __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+    }
+
+    if (saved_affinity)
+    {
+        sched_setaffinity(0, sizeof(original), &original);
+    }
+
+    free(workers);
+    mem_buffer_free(&load_buffer);
+    mem_buffer_free(&chase_buffer);
+    return ok;
+}
+
+/* Private helper function: load thread, streams lines with the configured mix and delay */
+static void *load_worker(void *arg)
+{
+    LoadWorker *worker = arg;
+    bench_pin_cpu(worker->cpu);
+
+    /* Touch the buffer once so page faults stay out of the measurement */
+    memset(worker->buffer, 1, worker->size);
+    __atomic_add_fetch(worker->ready, 1, __ATOMIC_RELEASE);
+
+    uint64_t sum = 0;
+    size_t offset = 0;
+    while (!__atomic_load_n(worker->stop, __ATOMIC_ACQUIRE))
+    {
+        if (!__atomic_load_n(worker->active, __ATOMIC_ACQUIRE))
+        {
+            sleep_ns(1000000);
+            continue;
+        }
+
+        int writes = __atomic_load_n(worker->write_lines, __ATOMIC_RELAXED);
+        unsigned long delay = __atomic_load_n(worker->delay, __ATOMIC_RELAXED);
+        volatile uint64_t *line = (volatile uint64_t *)(worker->buffer + offset);
+
+        /* One word per line is enough to move the whole line */
+        int reads = LL_CHUNK_LINES - writes;
+        for (int i = 0; i < reads; i++)
+        {
+            sum += line[i * (LL_LINE_SIZE / sizeof(uint64_t))];
+        }
+        for (int i = reads; i < LL_CHUNK_LINES; i++)
+        {
+            line[i * (LL_LINE_SIZE / sizeof(uint64_t))] = sum + (uint64_t)i;
+        }
+
+        for (unsigned long i = 0; i < delay; i++)
+        {
+            __asm__ __volatile__("" ::: "memory");
+        }
+
+        __atomic_store_n(&worker->bytes, worker->bytes + LL_CHUNK_LINES * LL_LINE_SIZE, __ATOMIC_RELAXED);
+        offset += LL_CHUNK_LINES * LL_LINE_SIZE;
+        if (offset >= worker->size)
+        {
+            offset = 0;
+        }
+    }
+
+    worker->sink = sum;
+    return NULL;
+}
+
+/* Private helper function to parse "0,100,1000" into a delay list */
+static int parse_delays(const char *str, unsigned long *delays, int max)
+{
+    int count = 0;
+    const char *p = str;
+    while (*p)
+    {
+        char *end;
+        if (*p < '0' || *p > '9' || count == max)
+        {
+            return -1;
+        }
+        delays[count++] = strtoul(p, &end, 10);
+        if (*end == ',')
+        {
+            end++;
+        }
+        else if (*end != '\0')
+        {
+            return -1;
+        }
+        p = end;
+    }
+    return count;
+}
+
+/* Private helper function to order delays from largest to smallest for qsort() */
+static int compare_delay_desc(const void *a, const void *b)
+{
+    unsigned long x = *(const unsigned long *)a;
+    unsigned long y = *(const unsigned long *)b;
+    return (x < y) - (x > y);
+}
+
+/* Private helper function to sum the traffic counters of all load threads */
+static uint64_t total_bytes(const LoadWorker *workers, int count)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < count; i++)
+    {
+        total += __atomic_load_n(&workers[i].bytes, __ATOMIC_RELAXED);
+    }
+    return total;
+}
+
+/* Private helper function to time the chain for one window and read the bandwidth over it */
+static LoadedPoint measure_point(void **chain, LoadWorker *workers, int count, uint64_t window_ns)
+{
+    LoadedPoint point = {0, 0.0, 0.0};
+    uint64_t loads = 0;
+    void **p = chain;
+
+    uint64_t bytes_before = total_bytes(workers, count);
+    uint64_t start = bench_now_ns();
+    uint64_t now = start;
+    while (now - start < window_ns)
+    {
+        p = chase_walk(p, LL_SLICE_LOADS);
+        loads += LL_SLICE_LOADS;
+        now = bench_now_ns();
+    }
+    uint64_t bytes_after = total_bytes(workers, count);
+    __asm__ __volatile__("" : : "r"(p) : "memory");
+
+    double elapsed = (double)(now - start);
+    point.ns = elapsed / (double)loads;
+    point.gbps = (double)(bytes_after - bytes_before) / elapsed;
+    return point;
+}
+
+/* Private helper function to sleep for a number of nanoseconds */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}
+
+/* Private helper function to find where latency reaches LL_KNEE_FACTOR times the unloaded value */
+static void report_knee(const LoadedPoint *points, int count, double unloaded_ns, int threads, int write_pct)
+{
+    double threshold = unloaded_ns * LL_KNEE_FACTOR;
+    int peak = 0;
+    for (int i = 1; i < count; i++)
+    {
+        if (points[i].gbps > points[peak].gbps)
+        {
+            peak = i;
+        }
+    }
+
+    /* Interpolate between the last point below the threshold and the first at or above it */
+    double knee_gbps = -1.0;
+    for (int i = 0; i < count; i++)
+    {
+        if (points[i].ns >= threshold)
+        {
+            if (i == 0)
+            {
+                knee_gbps = points[0].gbps;
+            }
+            else
+            {
+                const LoadedPoint *lo = &points[i - 1];
+                const LoadedPoint *hi = &points[i];
+                double span = hi->ns - lo->ns;
+                double t = span > 0.0 ? (threshold - lo->ns) / span : 1.0;
+                knee_gbps = lo->gbps + t * (hi->gbps - lo->gbps);
+            }
+            break;
+        }
+    }
+
+    if (knee_gbps < 0.0)
+    {
+        logger_info("Loaded latency: no knee, latency stayed below %.2f ns up to %.2f GB/s",
+                    threshold, points[peak].gbps);
+        logger_metric("mem_loaded_latency_knee",
+                      "threads=%d,write_pct=%d,unloaded_ns=%.3f,knee_found=false,peak_gbps=%.3f,peak_latency_ns=%.3f",
+                      threads, write_pct, unloaded_ns, points[peak].gbps, points[peak].ns);
+        return;
+    }
+
+    double pct = points[peak].gbps > 0.0 ? 100.0 * knee_gbps / points[peak].gbps : 0.0;
+    logger_info("Loaded latency: knee at %.2f GB/s (%.0f%% of peak %.2f GB/s), latency %.1fx unloaded",
+                knee_gbps, pct, points[peak].gbps, LL_KNEE_FACTOR);
+    logger_metric("mem_loaded_latency_knee",
+                  "threads=%d,write_pct=%d,unloaded_ns=%.3f,knee_found=true,knee_gbps=%.3f,knee_pct_of_peak=%.1f,"
+                  "peak_gbps=%.3f,peak_latency_ns=%.3f",
+                  threads, write_pct, unloaded_ns, knee_gbps, pct, points[peak].gbps, points[peak].ns);
+}
@@ -4,107 +4,23 @@
 #include <stdbool.h>
 #include <ctype.h>
 
-enum PerfTestType
-{
-    PTT_BASELINE, // Retrieve a baseline amount of data
-    PTT_STRESS,   // Progressively increases load beyond normal operating capacity
-    PTT_SPIKE,    // Suddenly applies a massive load increase, then drops back to normal levels
-    PTT_LOAD,     // Gradually increases load to a predetermined level and maintains it for a specified duration
-};
-
-enum IOType
-{
-    ASYNC_IO,
-    SYNC_IO
-};
-
-enum IOInterfaceType
-{
-    INTERFACE_USB3,
-    INTERFACE_PCIE
-};
-
-// typedef struct
-// {
-//     int *cores;
-//     int core_count;
-//     char freq_min[16];
-//     char freq_max[16];
-//     char workload_type[16];
-//     int threads_per_core;
-//     bool test_thermal;
-// } CPUOptions;
-
-typedef struct
-{
-    char size[16];
-    char pattern[16];
-    char alloc_size[16];
-    int alignment;
-    bool numa_aware;
-} MemoryOptions;
-
-typedef struct
-{
-    char file_size[16];
-    int read_ratio;
-    char block_size[16];
-    bool direct_io;
-    char directory[256];
-    int file_count;
-} StorageOptions;
-
-typedef struct
-{
-    char protocol[8];
-    char target_ip[64];
-    int port;
-    char packet_size[16];
-    int connection_count;
-    char bandwidth_limit[16];
-} NetworkOptions;
-
-typedef struct
-{
-    char device_path[256];
-    IOType io_type;
-    char buffer_size[16];
-    int operation_count;
-    IOInterfaceType interface_type;
-} IOOptions;
-
-typedef struct
-{
-    int order;
-    char component_type;
-    PerfTestType test_type;
-    int duration;
-    union
-    {
-        CPUOptions cpu;
-        MemoryOptions memory;
-        StorageOptions storage;
-        NetworkOptions network;
-        IOOptions io;
-    } options;
-} ComponentConfig;
-
-typedef struct
-{
-    ComponentConfig *components;
-    int component_count;
-    char log_directory[256];
-    char file_name_base[256];
-    char file_format[16];
-} TestConfig;
+#include "test_config.h"
+#include "logger.h"
+#include "cpu_test.h"
+#include "memory_test.h"
+#include "storage_test.h"
+#include "io_test.h"
 
 // Function prototypes
 bool parse_command_line(const char *cmd_line, TestConfig *config);
 bool parse_component(const char *component_str, ComponentConfig *comp);
 bool parse_options(const char *options_str, ComponentConfig *comp);
 bool parse_global_option(const char *option_str, TestConfig *config);
+bool parse_suboptions(char *suboptions, ComponentConfig *comp);
 void free_config(TestConfig *config);
 void print_config(const TestConfig *config);
+bool run_tests(const TestConfig *config);
+bool run_component(const ComponentConfig *comp);
 
 int main(int argc, char *argv[])
 {
@@ -127,10 +43,19 @@ int main(int argc, char *argv[])
     printf("Successfully parsed configuration:\n");
     print_config(&config);
 
-    // TODO: Execute tests here
+    if (!logger_init(config.log_directory, LOG_INFO, 0, true))
+    {
+        fprintf(stderr, "Failed to initialize logger in %s\n", config.log_directory);
+        free_config(&config);
+        return 1;
+    }
+
+    // A non-zero exit code fails the Jenkins stage
+    bool passed = run_tests(&config);
 
+    logger_cleanup();
     free_config(&config);
-    return 0;
+    return passed ? 0 : 1;
 }
 
 bool parse_command_line(const char *cmd_line, TestConfig *config)
@@ -233,13 +158,20 @@ bool parse_component(const char *component_str, ComponentConfig *comp)
         return false;
     comp->order = atoi(component_str);
 
-    char *type_pos = component_str;
+    const char *type_pos = component_str;
     while (*type_pos && isdigit(*type_pos))
         type_pos++;
     if (!*type_pos)
         return false;
     comp->component_type = *type_pos;
 
+    // rr:0 is a valid write-only mix and dd:0 a flat directory, so mark them as not given
+    if (comp->component_type == 's')
+    {
+        comp->options.storage.read_ratio = -1;
+        comp->options.storage.depth = -1;
+    }
+
     // Find the options section
     char *bracket_start = strchr(component_str, '[');
     if (!bracket_start)
@@ -266,7 +198,31 @@ bool parse_options(const char *options_str, ComponentConfig *comp)
     if (!options_copy)
         return false;
 
-    char *token = strtok(options_copy, "-");
+    // Cut the {...} block out first: it uses '-' as its own separator
+    char suboptions[256] = "";
+    char *brace = strchr(options_copy, '{');
+    if (brace)
+    {
+        char *end_brace = strchr(brace, '}');
+        if (!end_brace)
+        {
+            free(options_copy);
+            return false;
+        }
+
+        int len = end_brace - brace - 1;
+        if (len >= sizeof(suboptions))
+        {
+            free(options_copy);
+            return false;
+        }
+        strncpy(suboptions, brace + 1, len);
+        suboptions[len] = '\0';
+        memmove(brace, end_brace + 1, strlen(end_brace + 1) + 1);
+    }
+
+    char *saveptr = NULL;
+    char *token = strtok_r(options_copy, "-", &saveptr);
 
     while (token)
     {
@@ -291,117 +247,301 @@ bool parse_options(const char *options_str, ComponentConfig *comp)
         {
             comp->duration = atoi(token + 1);
         }
-        else if (strncmp(token, "{", 1) == 0)
+
+        token = strtok_r(NULL, "-", &saveptr);
+    }
+
+    free(options_copy);
+    return parse_suboptions(suboptions, comp);
+}
+
+bool parse_suboptions(char *suboptions, ComponentConfig *comp)
+{
+    // Parse component-specific suboptions
+    char *saveptr = NULL;
+    char *subtoken = strtok_r(suboptions, "-", &saveptr);
+    while (subtoken)
+    {
+        switch (comp->component_type)
         {
-            // Parse component-specific options
-            char *end_brace = strchr(token, '}');
-            if (!end_brace)
+        case 'c': // CPU
+            if (strncmp(subtoken, "cr:", 3) == 0)
             {
-                free(options_copy);
-                return false;
-            }
+                // Parse core list
+                int core_count = 1;
+                for (char *c = subtoken + 3; *c; c++)
+                {
+                    if (*c == ',')
+                        core_count++;
+                }
 
-            char suboptions[256];
-            int len = end_brace - token - 1;
-            if (len >= sizeof(suboptions))
-            {
-                free(options_copy);
-                return false;
-            }
-            strncpy(suboptions, token + 1, len);
-            suboptions[len] = '\0';
+                free(comp->options.cpu.cores);
+                comp->options.cpu.cores = malloc(sizeof(int) * core_count);
+                if (!comp->options.cpu.cores)
+                    return false;
+                comp->options.cpu.core_count = 0;
 
-            // Parse component-specific suboptions
-            char *subtoken = strtok(suboptions, "-");
-            while (subtoken)
+                char *core_save = NULL;
+                char *core_token = strtok_r(subtoken + 3, ",", &core_save);
+                while (core_token && comp->options.cpu.core_count < core_count)
+                {
+                    comp->options.cpu.cores[comp->options.cpu.core_count++] = atoi(core_token);
+                    core_token = strtok_r(NULL, ",", &core_save);
+                }
+            }
+            else if (strncmp(subtoken, "f:", 2) == 0)
             {
-                switch (comp->component_type)
+                char *freq_range = subtoken + 2;
+                char *comma = strchr(freq_range, ',');
+                if (comma)
                 {
-                case 'c': // CPU
-                    if (strncmp(subtoken, "cr:", 3) == 0)
-                    {
-                        // Parse core list
-                        char *core_list = subtoken + 3;
-                        char *core_token = strtok(core_list, ",");
-                        int core_count = 0;
-
-                        // Count cores first
-                        char *temp_list = strdup(core_list);
-                        char *temp_token = strtok(temp_list, ",");
-                        while (temp_token)
-                        {
-                            core_count++;
-                            temp_token = strtok(NULL, ",");
-                        }
-                        free(temp_list);
-
-                        comp->options.cpu.cores = malloc(sizeof(int) * core_count);
-                        comp->options.cpu.core_count = core_count;
-
-                        // Now parse the actual cores
-                        core_list = strdup(subtoken + 3);
-                        core_token = strtok(core_list, ",");
-                        int i = 0;
-                        while (core_token && i < core_count)
-                        {
-                            comp->options.cpu.cores[i++] = atoi(core_token);
-                            core_token = strtok(NULL, ",");
-                        }
-                        free(core_list);
-                    }
-                    else if (strncmp(subtoken, "f:", 2) == 0)
-                    {
-                        char *freq_range = subtoken + 2;
-                        char *comma = strchr(freq_range, ',');
-                        if (comma)
-                        {
-                            strncpy(comp->options.cpu.freq_min, freq_range, comma - freq_range);
-                            comp->options.cpu.freq_min[comma - freq_range] = '\0';
-                            strcpy(comp->options.cpu.freq_max, comma + 1);
-                        }
-                    }
-                    else if (strncmp(subtoken, "w:", 2) == 0)
-                    {
-                        strcpy(comp->options.cpu.workload_type, subtoken + 2);
-                    }
-                    else if (strncmp(subtoken, "th:", 3) == 0)
-                    {
-                        comp->options.cpu.threads_per_core = atoi(subtoken + 3);
-                    }
-                    else if (strncmp(subtoken, "tt:", 3) == 0)
-                    {
-                        comp->options.cpu.test_thermal = (strcmp(subtoken + 3, "true") == 0);
-                    }
-                    break;
+                    strncpy(comp->options.cpu.freq_min, freq_range, comma - freq_range);
+                    comp->options.cpu.freq_min[comma - freq_range] = '\0';
+                    strcpy(comp->options.cpu.freq_max, comma + 1);
+                }
+            }
+            else if (strncmp(subtoken, "w:", 2) == 0)
+            {
+                strcpy(comp->options.cpu.workload_type, subtoken + 2);
+            }
+            else if (strncmp(subtoken, "th:", 3) == 0)
+            {
+                comp->options.cpu.threads_per_core = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "tt:", 3) == 0)
+            {
+                comp->options.cpu.test_thermal = (strcmp(subtoken + 3, "true") == 0);
+            }
+            else if (strncmp(subtoken, "v:", 2) == 0)
+            {
+                comp->options.cpu.verify = (strcmp(subtoken + 2, "true") == 0);
+            }
+            break;
 
-                case 'm': // Memory
-                    if (strncmp(subtoken, "sz:", 3) == 0)
-                    {
-                        strcpy(comp->options.memory.size, subtoken + 3);
-                    }
-                    else if (strncmp(subtoken, "p:", 2) == 0)
-                    {
-                        strcpy(comp->options.memory.pattern, subtoken + 2);
-                    }
-                    else if (strncmp(subtoken, "a:", 2) == 0)
-                    {
-                        strcpy(comp->options.memory.alloc_size, subtoken + 2);
-                    }
-                    break;
+        case 'm': // Memory
+            if (strncmp(subtoken, "sz:", 3) == 0)
+            {
+                strcpy(comp->options.memory.size, subtoken + 3);
+            }
+            else if (strncmp(subtoken, "p:", 2) == 0)
+            {
+                strncpy(comp->options.memory.pattern, subtoken + 2,
+                        sizeof(comp->options.memory.pattern) - 1);
+            }
+            else if (strncmp(subtoken, "a:", 2) == 0)
+            {
+                strncpy(comp->options.memory.alloc_size, subtoken + 2,
+                        sizeof(comp->options.memory.alloc_size) - 1);
+            }
+            else if (strncmp(subtoken, "al:", 3) == 0)
+            {
+                comp->options.memory.alignment = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "w:", 2) == 0)
+            {
+                strncpy(comp->options.memory.workload, subtoken + 2,
+                        sizeof(comp->options.memory.workload) - 1);
+            }
+            else if (strncmp(subtoken, "numa:", 5) == 0)
+            {
+                comp->options.memory.numa_aware = (strcmp(subtoken + 5, "true") == 0);
+            }
+            else if (strncmp(subtoken, "th:", 3) == 0)
+            {
+                comp->options.memory.threads = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "wr:", 3) == 0)
+            {
+                comp->options.memory.write_pct = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "dl:", 3) == 0)
+            {
+                strncpy(comp->options.memory.delays, subtoken + 3,
+                        sizeof(comp->options.memory.delays) - 1);
+            }
+            else if (strncmp(subtoken, "hp:", 3) == 0)
+            {
+                strncpy(comp->options.memory.pages, subtoken + 3,
+                        sizeof(comp->options.memory.pages) - 1);
+            }
+            else if (strncmp(subtoken, "sd:", 3) == 0)
+            {
+                comp->options.memory.seed = strtoul(subtoken + 3, NULL, 0);
+            }
+            else if (strncmp(subtoken, "tr:", 3) == 0)
+            {
+                strncpy(comp->options.memory.touch_rate, subtoken + 3,
+                        sizeof(comp->options.memory.touch_rate) - 1);
+            }
+            break;
 
-                // Add cases for other component types...
-                default:
-                    break;
-                }
+        case 's': // Storage
+            if (strncmp(subtoken, "sz:", 3) == 0)
+            {
+                strncpy(comp->options.storage.file_size, subtoken + 3,
+                        sizeof(comp->options.storage.file_size) - 1);
+            }
+            else if (strncmp(subtoken, "rr:", 3) == 0)
+            {
+                comp->options.storage.read_ratio = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "bs:", 3) == 0)
+            {
+                strncpy(comp->options.storage.block_size, subtoken + 3,
+                        sizeof(comp->options.storage.block_size) - 1);
+            }
+            else if (strncmp(subtoken, "dio:", 4) == 0)
+            {
+                comp->options.storage.direct_io = (strcmp(subtoken + 4, "true") == 0);
+            }
+            else if (strncmp(subtoken, "dir:", 4) == 0)
+            {
+                strncpy(comp->options.storage.directory, subtoken + 4,
+                        sizeof(comp->options.storage.directory) - 1);
+            }
+            else if (strncmp(subtoken, "fc:", 3) == 0)
+            {
+                comp->options.storage.file_count = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "p:", 2) == 0)
+            {
+                strncpy(comp->options.storage.pattern, subtoken + 2,
+                        sizeof(comp->options.storage.pattern) - 1);
+            }
+            else if (strncmp(subtoken, "th:", 3) == 0)
+            {
+                comp->options.storage.threads = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "e:", 2) == 0)
+            {
+                strncpy(comp->options.storage.engine, subtoken + 2,
+                        sizeof(comp->options.storage.engine) - 1);
+            }
+            else if (strncmp(subtoken, "qd:", 3) == 0)
+            {
+                comp->options.storage.queue_depth = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "sqp:", 4) == 0)
+            {
+                comp->options.storage.sqpoll = (strcmp(subtoken + 4, "true") == 0);
+            }
+            else if (strncmp(subtoken, "iop:", 4) == 0)
+            {
+                comp->options.storage.iopoll = (strcmp(subtoken + 4, "true") == 0);
+            }
+            else if (strncmp(subtoken, "iops:", 5) == 0)
+            {
+                comp->options.storage.target_iops = atoi(subtoken + 5);
+            }
+            else if (strncmp(subtoken, "arr:", 4) == 0)
+            {
+                strncpy(comp->options.storage.arrival, subtoken + 4,
+                        sizeof(comp->options.storage.arrival) - 1);
+            }
+            else if (strncmp(subtoken, "v:", 2) == 0)
+            {
+                comp->options.storage.verify = (strcmp(subtoken + 2, "true") == 0);
+            }
+            else if (strncmp(subtoken, "cmp:", 4) == 0)
+            {
+                comp->options.storage.compress_pct = atoi(subtoken + 4);
+            }
+            else if (strncmp(subtoken, "dup:", 4) == 0)
+            {
+                comp->options.storage.dedupe_pct = atoi(subtoken + 4);
+            }
+            else if (strncmp(subtoken, "sd:", 3) == 0)
+            {
+                comp->options.storage.seed = strtoul(subtoken + 3, NULL, 0);
+            }
+            else if (strncmp(subtoken, "pc:", 3) == 0)
+            {
+                comp->options.storage.precondition = (strcmp(subtoken + 3, "true") == 0);
+            }
+            else if (strncmp(subtoken, "pcr:", 4) == 0)
+            {
+                comp->options.storage.round_secs = atoi(subtoken + 4);
+            }
+            else if (strncmp(subtoken, "w:", 2) == 0)
+            {
+                strncpy(comp->options.storage.workload, subtoken + 2,
+                        sizeof(comp->options.storage.workload) - 1);
+            }
+            else if (strncmp(subtoken, "sm:", 3) == 0)
+            {
+                strncpy(comp->options.storage.sync_method, subtoken + 3,
+                        sizeof(comp->options.storage.sync_method) - 1);
+            }
+            else if (strncmp(subtoken, "gc:", 3) == 0)
+            {
+                comp->options.storage.group_commit = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "pre:", 4) == 0)
+            {
+                strncpy(comp->options.storage.prealloc, subtoken + 4,
+                        sizeof(comp->options.storage.prealloc) - 1);
+            }
+            else if (strncmp(subtoken, "fo:", 3) == 0)
+            {
+                comp->options.storage.fanout = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "dd:", 3) == 0)
+            {
+                comp->options.storage.depth = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "cc:", 3) == 0)
+            {
+                comp->options.storage.cold_cache = (strcmp(subtoken + 3, "true") == 0);
+            }
+            break;
 
-                subtoken = strtok(NULL, "-");
+        case 'i': // I/O
+            if (strncmp(subtoken, "dev:", 4) == 0)
+            {
+                strncpy(comp->options.io.device_path, subtoken + 4,
+                        sizeof(comp->options.io.device_path) - 1);
+            }
+            else if (strncmp(subtoken, "io:", 3) == 0)
+            {
+                comp->options.io.io_type = (strcmp(subtoken + 3, "sync") == 0) ? SYNC_IO : ASYNC_IO;
+            }
+            else if (strncmp(subtoken, "bs:", 3) == 0)
+            {
+                strncpy(comp->options.io.buffer_size, subtoken + 3,
+                        sizeof(comp->options.io.buffer_size) - 1);
+            }
+            else if (strncmp(subtoken, "n:", 2) == 0)
+            {
+                comp->options.io.operation_count = atoi(subtoken + 2);
+            }
+            else if (strncmp(subtoken, "if:", 3) == 0)
+            {
+                comp->options.io.interface_type =
+                    (strcmp(subtoken + 3, "pcie") == 0) ? INTERFACE_PCIE : INTERFACE_USB3;
+            }
+            else if (strncmp(subtoken, "qd:", 3) == 0)
+            {
+                comp->options.io.queue_depth = atoi(subtoken + 3);
+            }
+            else if (strncmp(subtoken, "wr:", 3) == 0)
+            {
+                comp->options.io.write_pct = atoi(subtoken + 3);
             }
+            else if (strncmp(subtoken, "sz:", 3) == 0)
+            {
+                strncpy(comp->options.io.file_size, subtoken + 3,
+                        sizeof(comp->options.io.file_size) - 1);
+            }
+            break;
+
+        // Add cases for other component types...
+        default:
+            break;
         }
 
-        token = strtok(NULL, "-");
+        subtoken = strtok_r(NULL, "-", &saveptr);
     }
 
-    free(options_copy);
     return true;
 }
 
@@ -506,13 +646,114 @@ void print_config(const TestConfig *config)
                 if (j < comp->options.cpu.core_count - 1)
                     printf(",");
             }
-            printf(", freq=%s-%s, workload=%s\n",
+            printf(", freq=%s-%s, workload=%s, verify=%s\n",
                    comp->options.cpu.freq_min, comp->options.cpu.freq_max,
-                   comp->options.cpu.workload_type);
+                   comp->options.cpu.workload_type,
+                   comp->options.cpu.verify ? "true" : "false");
+        }
+        else if (comp->component_type == 'm')
+        {
+            printf("      Memory Options: size=%s, pattern=%s, alloc_size=%s, alignment=%d, workload=%s, "
+                   "threads=%d, write_pct=%d, delays=%s, numa=%s, pages=%s, seed=%lu, "
+                   "touch_rate=%s\n",
+                   comp->options.memory.size, comp->options.memory.pattern,
+                   comp->options.memory.alloc_size, comp->options.memory.alignment,
+                   comp->options.memory.workload, comp->options.memory.threads,
+                   comp->options.memory.write_pct, comp->options.memory.delays,
+                   comp->options.memory.numa_aware ? "true" : "false", comp->options.memory.pages,
+                   comp->options.memory.seed, comp->options.memory.touch_rate);
+        }
+        else if (comp->component_type == 's')
+        {
+            printf("      Storage Options: dir=%s, files=%d, file_size=%s, block_size=%s, read_ratio=%d, "
+                   "pattern=%s, threads=%d, direct_io=%s, engine=%s, queue_depth=%d, sqpoll=%s, iopoll=%s, "
+                   "target_iops=%d, arrival=%s, verify=%s, compress=%d%%, dedupe=%d%%, seed=%lu, "
+                   "precondition=%s, round_secs=%d, workload=%s, sync_method=%s, group_commit=%d, "
+                   "prealloc=%s, fanout=%d, depth=%d, cold_cache=%s\n",
+                   comp->options.storage.directory, comp->options.storage.file_count,
+                   comp->options.storage.file_size, comp->options.storage.block_size,
+                   comp->options.storage.read_ratio, comp->options.storage.pattern,
+                   comp->options.storage.threads, comp->options.storage.direct_io ? "true" : "false",
+                   comp->options.storage.engine, comp->options.storage.queue_depth,
+                   comp->options.storage.sqpoll ? "true" : "false",
+                   comp->options.storage.iopoll ? "true" : "false",
+                   comp->options.storage.target_iops, comp->options.storage.arrival,
+                   comp->options.storage.verify ? "true" : "false", comp->options.storage.compress_pct,
+                   comp->options.storage.dedupe_pct, comp->options.storage.seed,
+                   comp->options.storage.precondition ? "true" : "false", comp->options.storage.round_secs,
+                   comp->options.storage.workload, comp->options.storage.sync_method,
+                   comp->options.storage.group_commit, comp->options.storage.prealloc,
+                   comp->options.storage.fanout, comp->options.storage.depth,
+                   comp->options.storage.cold_cache ? "true" : "false");
+        }
+        else if (comp->component_type == 'i')
+        {
+            printf("      I/O Options: device=%s, io=%s, buffer_size=%s, operations=%d, interface=%s, "
+                   "queue_depth=%d, write_pct=%d, file_size=%s\n",
+                   comp->options.io.device_path, comp->options.io.io_type == SYNC_IO ? "sync" : "async",
+                   comp->options.io.buffer_size, comp->options.io.operation_count,
+                   comp->options.io.interface_type == INTERFACE_PCIE ? "pcie" : "usb3",
+                   comp->options.io.queue_depth, comp->options.io.write_pct, comp->options.io.file_size);
         }
         // Add printing for other component types...
     }
 }
 
+static int compare_component_order(const void *a, const void *b)
+{
+    const ComponentConfig *x = *(const ComponentConfig *const *)a;
+    const ComponentConfig *y = *(const ComponentConfig *const *)b;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+bool run_tests(const TestConfig *config)
+{
+    if (config->component_count == 0)
+        return true;
+
+    // Components run in ascending order of their *N prefix
+    const ComponentConfig **ordered = malloc(sizeof(*ordered) * config->component_count);
+    if (!ordered)
+        return false;
+    for (int i = 0; i < config->component_count; i++)
+        ordered[i] = &config->components[i];
+    qsort(ordered, config->component_count, sizeof(*ordered), compare_component_order);
+
+    bool all_passed = true;
+    for (int i = 0; i < config->component_count; i++)
+    {
+        const ComponentConfig *comp = ordered[i];
+        logger_info("Running component %d (%c), duration %d seconds",
+                    comp->order, comp->component_type, comp->duration);
+
+        if (!run_component(comp))
+        {
+            logger_error("Component %d (%c) failed", comp->order, comp->component_type);
+            all_passed = false;
+        }
+    }
+
+    free(ordered);
+    return all_passed;
+}
+
+bool run_component(const ComponentConfig *comp)
+{
+    switch (comp->component_type)
+    {
+    case 'c':
+        return cpu_test_run(comp);
+    case 'm':
+        return memory_test_run(comp);
+    case 's':
+        return storage_test_run(comp);
+    case 'i':
+        return io_test_run(comp);
+    default:
+        logger_error("No tests implemented for component type '%c'", comp->component_type);
+        return false;
+    }
+}
+
 // gcc -o crucible crucible.c
 // ./crucible '*1c[t:stress-d600-{cr:1,2,3-f:min,max-w:avx}]*2m[t:baseline-d300-{sz:2g-p:seq-a:4k}]*D[/path/to/dir]*N[results]*F[JSON]'
\ No newline at end of file
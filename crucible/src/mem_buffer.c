@@ -0,0 +1,187 @@
+/**
+ * Memory Test Buffer Implementation
+ *
+ * This file maps anonymous memory for the memory tests and positions the
+ * usable region at the requested alignment. Buffers can be backed by base
+ * pages, transparent huge pages or hugetlbfs pages.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+/* Include our header file */
+#include "mem_buffer.h"
+#include "numa.h"
+
+/* Define constants */
+#define MEM_HUGE_2M (2ULL << 20)
+#define MEM_HUGE_1G (1ULL << 30)
+
+/* Older headers lack the hugetlb size flags */
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+/* Indexed by MemPageType */
+static const char *const page_names[] = {"default", "4k", "thp", "2m", "1g"};
+
+/**
+ * Parse a page type option
+ */
+int mem_buffer_parse_pages(const char *str, MemPageType *types)
+{
+    if (str == NULL || str[0] == '\0')
+    {
+        types[0] = MEM_PAGES_DEFAULT;
+        return 1;
+    }
+    if (strcmp(str, "all") == 0)
+    {
+        types[0] = MEM_PAGES_4K;
+        types[1] = MEM_PAGES_THP;
+        types[2] = MEM_PAGES_2M;
+        types[3] = MEM_PAGES_1G;
+        return 4;
+    }
+
+    for (int i = 0; i < (int)(sizeof(page_names) / sizeof(page_names[0])); i++)
+    {
+        if (strcmp(str, page_names[i]) == 0)
+        {
+            types[0] = (MemPageType)i;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Name a page type
+ */
+const char *mem_buffer_page_name(MemPageType pages)
+{
+    if ((int)pages < 0 || (int)pages >= (int)(sizeof(page_names) / sizeof(page_names[0])))
+    {
+        return "unknown";
+    }
+    return page_names[pages];
+}
+
+/**
+ * Allocate a test buffer
+ */
+bool mem_buffer_alloc(MemBuffer *buf, size_t size, size_t alignment)
+{
+    return mem_buffer_alloc_pages(buf, size, alignment, MEM_PAGES_DEFAULT);
+}
+
+/**
+ * Allocate a test buffer backed by a specific page type
+ */
+bool mem_buffer_alloc_pages(MemBuffer *buf, size_t size, size_t alignment, MemPageType pages)
+{
+    memset(buf, 0, sizeof(*buf));
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    if (alignment == 0)
+    {
+        alignment = page;
+    }
+    if ((alignment & (alignment - 1)) != 0 || size == 0)
+    {
+        return false;
+    }
+
+    /*
+     * unit is the granularity of the mapping itself, start_align the
+     * boundary the usable region is placed on before any sub-page offset.
+     * THP can only back 2 MB-aligned ranges, so those start on one.
+     */
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    size_t unit = page;
+    size_t start_align = alignment > page ? alignment : page;
+    switch (pages)
+    {
+    case MEM_PAGES_THP:
+        if (start_align < MEM_HUGE_2M)
+        {
+            start_align = MEM_HUGE_2M;
+        }
+        break;
+    case MEM_PAGES_2M:
+        flags |= MAP_HUGETLB | MAP_HUGE_2MB;
+        unit = MEM_HUGE_2M;
+        break;
+    case MEM_PAGES_1G:
+        flags |= MAP_HUGETLB | MAP_HUGE_1GB;
+        unit = MEM_HUGE_1G;
+        break;
+    default:
+        break;
+    }
+
+    /* Sub-page alignments start that many bytes into the first page */
+    size_t offset = alignment < page ? alignment : 0;
+    size_t slack = start_align > unit ? start_align - unit : 0;
+    size_t map_size = (offset + size + slack + unit - 1) & ~(unit - 1);
+
+    void *map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, flags, -1, 0);
+    if (map == MAP_FAILED)
+    {
+        return false;
+    }
+
+    if (pages == MEM_PAGES_THP && madvise(map, map_size, MADV_HUGEPAGE) != 0)
+    {
+        munmap(map, map_size);
+        return false;
+    }
+    if (pages == MEM_PAGES_4K)
+    {
+        /* Kernels without THP already use base pages, so failure is fine */
+        madvise(map, map_size, MADV_NOHUGEPAGE);
+    }
+
+    uintptr_t start = ((uintptr_t)map + start_align - 1) & ~(uintptr_t)(start_align - 1);
+
+    buf->map = map;
+    buf->map_size = map_size;
+    buf->data = (void *)(start + offset);
+    buf->size = size;
+    buf->pages = pages;
+    return true;
+}
+
+/**
+ * Bind a test buffer to a NUMA node
+ */
+bool mem_buffer_bind(MemBuffer *buf, int node)
+{
+    /* Bind the whole mapping so the alignment slack follows the data */
+    return buf->map && numa_bind_range(buf->map, buf->map_size, node);
+}
+
+/**
+ * Release a test buffer
+ */
+void mem_buffer_free(MemBuffer *buf)
+{
+    if (buf->map)
+    {
+        munmap(buf->map, buf->map_size);
+    }
+    memset(buf, 0, sizeof(*buf));
+}
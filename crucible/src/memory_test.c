@@ -1 +1,78 @@
-# Memory testing functions
+/**
+ * Memory Test Implementation
+ *
+ * This file selects and runs the memory test requested by the component
+ * configuration. Individual benchmarks live in their own source files.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+/* Include our header files */
+#include "memory_test.h"
+#include "bandwidth_test.h"
+#include "latency_test.h"
+#include "loaded_latency_test.h"
+#include "numa_test.h"
+#include "alloc_test.h"
+#include "integrity_test.h"
+#include "fault_test.h"
+#include "pressure_test.h"
+#include "copy_test.h"
+#include "logger.h"
+
+/**
+ * Run a memory component test
+ */
+bool memory_test_run(const ComponentConfig *comp)
+{
+    const char *workload = comp->options.memory.workload;
+
+    /* A load test without an explicit workload holds memory pressure */
+    if (workload[0] == '\0' && comp->test_type == PTT_LOAD)
+    {
+        return pressure_test_run(comp);
+    }
+    if (workload[0] == '\0' || strcmp(workload, "bw") == 0)
+    {
+        return bandwidth_test_run(comp);
+    }
+    if (strcmp(workload, "lat") == 0)
+    {
+        return latency_test_run(comp);
+    }
+    if (strcmp(workload, "loaded") == 0)
+    {
+        return loaded_latency_test_run(comp);
+    }
+    if (strcmp(workload, "numa") == 0)
+    {
+        return numa_test_run(comp);
+    }
+    if (strcmp(workload, "alloc") == 0)
+    {
+        return alloc_test_run(comp);
+    }
+    if (strcmp(workload, "integrity") == 0)
+    {
+        return integrity_test_run(comp);
+    }
+    if (strcmp(workload, "fault") == 0)
+    {
+        return fault_test_run(comp);
+    }
+    if (strcmp(workload, "pressure") == 0)
+    {
+        return pressure_test_run(comp);
+    }
+    if (strcmp(workload, "copy") == 0)
+    {
+        return copy_test_run(comp);
+    }
+
+    logger_error("Memory: unsupported workload '%s'", workload);
+    return false;
+}
@@ -0,0 +1,541 @@
+/**
+ * Filesystem Metadata Test Implementation
+ *
+ * This file implements the metadata workload. The directory tree is
+ * built first, fo: subdirectories per level and dd: levels deep, and
+ * file n lives in leaf directory n % leaves, so neighbouring files land
+ * in different directories and threads meet in every directory. Each
+ * phase starts one thread per th:, every thread doing its share of the
+ * files with one system call sequence per file, timed into its own
+ * histogram; the main thread wakes once per interval and logs what the
+ * threads recorded since the last interval. Paths are built in full for
+ * every operation, as the programs this imitates do, so the lookup of
+ * each path component is part of the measured cost.
+ *
+ * The cold phases sync and write 3 to /proc/sys/vm/drop_caches first, so
+ * their lookups have to read directories and inodes back from the
+ * device.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+
+/* Include our header files */
+#include "meta_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "data_gen.h"
+#include "histogram.h"
+
+/* Define constants */
+#define META_DEFAULT_FILES 100000
+#define META_DEFAULT_FANOUT 16
+#define META_DEFAULT_DEPTH 2
+#define META_MAX_FANOUT 256
+#define META_MAX_LEAVES 65536
+#define META_MAX_THREADS 256
+#define META_INTERVAL_NS 1000000000ULL  /* 1 s */
+#define META_POLL_NS 10000000ULL        /* How often the main thread checks for the end of a phase */
+#define META_PATH_SIZE 512
+#define META_LINE_SIZE 64
+
+typedef enum
+{
+    META_CREATE,
+    META_STAT,
+    META_OPEN,
+    META_STAT_COLD,
+    META_OPEN_COLD,
+    META_RENAME,
+    META_UNLINK,
+    META_PHASE_COUNT
+} MetaPhase;
+
+struct MetaJob;
+
+/* Per-thread state, one cache line apart */
+typedef struct
+{
+    pthread_t thread;
+    struct MetaJob *job;
+    int index;
+    Histogram *live;   /* Latency of the running phase, recorded only by this thread */
+    Histogram *seen;   /* What the main thread has already collected from live */
+    uint64_t failed;   /* File whose operation failed */
+    int error;         /* errno of the failed operation, 0 if none */
+} __attribute__((aligned(META_LINE_SIZE))) MetaWorker;
+
+/* Shared job description */
+typedef struct MetaJob
+{
+    char root[META_PATH_SIZE];
+    uint64_t file_count;
+    size_t file_size;
+    unsigned char *content; /* Written to every file on create */
+    int fanout;
+    int depth;
+    unsigned leaves;        /* Leaf directories, fanout^depth */
+    MetaPhase phase;
+    int finished;           /* Threads done with the running phase */
+    MetaWorker *workers;
+    int thread_count;
+    Histogram *interval;    /* Scratch for one worker's interval, main thread only */
+    Histogram *merged;      /* All workers' interval, main thread only */
+    Histogram *totals;      /* The running phase, main thread only */
+} MetaJob;
+
+static const char *const phase_names[META_PHASE_COUNT] = {"create",    "stat",      "open",  "stat_cold",
+                                                          "open_cold", "rename",    "unlink"};
+
+/* Private helper function prototypes */
+static bool build_tree(MetaJob *job);
+static void remove_tree(MetaJob *job, bool files);
+static int tree_path(const MetaJob *job, unsigned index, int levels, char *buf, size_t size);
+static void file_path(const MetaJob *job, uint64_t file, bool renamed, char *buf, size_t size);
+static bool drop_caches(void);
+static bool run_phase(MetaJob *job, MetaPhase phase, int order);
+static void *meta_worker(void *arg);
+static int do_op(const MetaJob *job, MetaPhase phase, uint64_t file, char *path, char *renamed);
+static void report_interval(MetaJob *job, double t_s, double secs);
+static void sleep_ns(uint64_t ns);
+
+/**
+ * Run the metadata test
+ */
+bool meta_test_run(const ComponentConfig *comp)
+{
+    const StorageOptions *opts = &comp->options.storage;
+
+    uint64_t file_count = opts->file_count > 0 ? (uint64_t)opts->file_count : META_DEFAULT_FILES;
+    size_t file_size = 0;
+    if (opts->file_size[0] != '\0' && !bench_parse_size(opts->file_size, &file_size))
+    {
+        logger_error("Meta: invalid file size '%s'", opts->file_size);
+        return false;
+    }
+    int fanout = opts->fanout > 0 ? opts->fanout : META_DEFAULT_FANOUT;
+    int depth = opts->depth >= 0 ? opts->depth : META_DEFAULT_DEPTH;
+    if (fanout > META_MAX_FANOUT)
+    {
+        logger_error("Meta: at most %d subdirectories per directory supported, %d requested", META_MAX_FANOUT,
+                     fanout);
+        return false;
+    }
+    uint64_t leaves = 1;
+    for (int level = 0; level < depth && leaves <= META_MAX_LEAVES; level++)
+    {
+        leaves *= (uint64_t)fanout;
+    }
+    if (leaves > META_MAX_LEAVES)
+    {
+        logger_error("Meta: %d levels of %d directories exceed %d leaf directories", depth, fanout, META_MAX_LEAVES);
+        return false;
+    }
+    int thread_count = opts->threads > 0 ? opts->threads : 1;
+    if (thread_count > META_MAX_THREADS)
+    {
+        logger_warning("Meta: limiting %d threads to %d", thread_count, META_MAX_THREADS);
+        thread_count = META_MAX_THREADS;
+    }
+
+    const char *dir = opts->directory[0] != '\0' ? opts->directory : ".";
+    struct statvfs fs;
+    if (statvfs(dir, &fs) != 0)
+    {
+        logger_error("Meta: cannot access directory '%s': %s", dir, strerror(errno));
+        return false;
+    }
+    /* Filesystems that allocate inodes on demand report no inode count at all */
+    uint64_t inodes = file_count + leaves * 2;
+    if (fs.f_files > 0 && (uint64_t)fs.f_favail < inodes)
+    {
+        logger_error("Meta: %llu inodes needed in '%s', only %llu free", (unsigned long long)inodes, dir,
+                     (unsigned long long)fs.f_favail);
+        return false;
+    }
+    if ((uint64_t)fs.f_bavail * fs.f_frsize < file_count * (uint64_t)file_size)
+    {
+        logger_error("Meta: %llu MB needed in '%s', only %llu MB free",
+                     (unsigned long long)((file_count * (uint64_t)file_size) >> 20), dir,
+                     (unsigned long long)(((uint64_t)fs.f_bavail * fs.f_frsize) >> 20));
+        return false;
+    }
+
+    MetaJob job;
+    memset(&job, 0, sizeof(job));
+    snprintf(job.root, sizeof(job.root), "%s/crucible.%d.meta", dir, (int)getpid());
+    job.file_count = file_count;
+    job.file_size = file_size;
+    job.fanout = fanout;
+    job.depth = depth;
+    job.leaves = (unsigned)leaves;
+    job.thread_count = thread_count;
+    job.workers = aligned_alloc(META_LINE_SIZE, sizeof(MetaWorker) * (size_t)thread_count);
+    job.interval = malloc(sizeof(Histogram));
+    job.merged = malloc(sizeof(Histogram));
+    job.totals = malloc(sizeof(Histogram));
+    job.content = malloc(file_size > 0 ? file_size : 1);
+    bool ok = job.workers && job.interval && job.merged && job.totals && job.content;
+    if (job.workers)
+    {
+        memset(job.workers, 0, sizeof(MetaWorker) * (size_t)thread_count);
+    }
+    for (int i = 0; ok && i < thread_count; i++)
+    {
+        job.workers[i].job = &job;
+        job.workers[i].index = i;
+        job.workers[i].live = malloc(sizeof(Histogram));
+        job.workers[i].seen = malloc(sizeof(Histogram));
+        ok = job.workers[i].live && job.workers[i].seen;
+    }
+    if (ok)
+    {
+        DataProfile profile;
+        data_profile_init(&profile, 0, 0, opts->seed != 0 ? (uint64_t)opts->seed : bench_now_ns() | 1);
+        data_gen_fill(&profile, job.content, file_size, profile.seed);
+    }
+
+    logger_info("Meta: %llu files of %zu bytes in %u leaf directories (%d levels of %d) under %s, %d threads",
+                (unsigned long long)file_count, file_size, job.leaves, depth, fanout, job.root, thread_count);
+
+    uint64_t tree_start = bench_now_ns();
+    if (!ok || !build_tree(&job))
+    {
+        if (!ok)
+        {
+            logger_error("Meta: setup failed");
+        }
+        ok = false;
+    }
+    else
+    {
+        logger_info("Meta: built the directory tree in %.3f s", (double)(bench_now_ns() - tree_start) / 1e9);
+    }
+
+    bool created = false;
+    for (int phase = 0; ok && phase < META_PHASE_COUNT; phase++)
+    {
+        if ((phase == META_STAT_COLD || phase == META_OPEN_COLD) && !opts->cold_cache)
+        {
+            continue;
+        }
+        /* Each cold phase starts from empty caches; the stat phase just filled them again */
+        if ((phase == META_STAT_COLD || phase == META_OPEN_COLD) && !drop_caches())
+        {
+            logger_warning("Meta: cannot drop caches (%s; needs root), skipping the cold phases", strerror(errno));
+            phase = META_OPEN_COLD;
+            continue;
+        }
+        created = true;
+        ok = run_phase(&job, (MetaPhase)phase, comp->order);
+    }
+
+    /* A failed run leaves files behind under either name */
+    if (job.workers && job.root[0] != '\0')
+    {
+        remove_tree(&job, !ok && created);
+    }
+
+    for (int i = 0; job.workers && i < thread_count; i++)
+    {
+        free(job.workers[i].live);
+        free(job.workers[i].seen);
+    }
+    free(job.workers);
+    free(job.interval);
+    free(job.merged);
+    free(job.totals);
+    free(job.content);
+    return ok;
+}
+
+/* Private helper function: create the root and every level of subdirectories */
+static bool build_tree(MetaJob *job)
+{
+    if (mkdir(job->root, 0755) != 0)
+    {
+        logger_error("Meta: cannot create %s: %s", job->root, strerror(errno));
+        job->root[0] = '\0';
+        return false;
+    }
+    char path[META_PATH_SIZE];
+    unsigned count = 1;
+    for (int level = 1; level <= job->depth; level++)
+    {
+        count *= (unsigned)job->fanout;
+        for (unsigned i = 0; i < count; i++)
+        {
+            tree_path(job, i, level, path, sizeof(path));
+            if (mkdir(path, 0755) != 0)
+            {
+                logger_error("Meta: cannot create %s: %s", path, strerror(errno));
+                remove_tree(job, false);
+                job->root[0] = '\0';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Private helper function: remove the directory tree, and with files set whatever files are left in it */
+static void remove_tree(MetaJob *job, bool files)
+{
+    char path[META_PATH_SIZE];
+    for (uint64_t file = 0; files && file < job->file_count; file++)
+    {
+        file_path(job, file, false, path, sizeof(path));
+        unlink(path);
+        file_path(job, file, true, path, sizeof(path));
+        unlink(path);
+    }
+
+    unsigned count = job->leaves;
+    for (int level = job->depth; level >= 1; level--)
+    {
+        for (unsigned i = 0; i < count; i++)
+        {
+            tree_path(job, i, level, path, sizeof(path));
+            rmdir(path);
+        }
+        count /= (unsigned)job->fanout;
+    }
+    rmdir(job->root);
+}
+
+/* Private helper function: path of directory index at a level of the tree, one hex component per level */
+static int tree_path(const MetaJob *job, unsigned index, int levels, char *buf, size_t size)
+{
+    int len = snprintf(buf, size, "%s", job->root);
+    unsigned scale = 1;
+    for (int level = 1; level < levels; level++)
+    {
+        scale *= (unsigned)job->fanout;
+    }
+    for (int level = 0; level < levels && len < (int)size; level++)
+    {
+        len += snprintf(buf + len, size - (size_t)len, "/%02x", (index / scale) % (unsigned)job->fanout);
+        scale /= (unsigned)job->fanout;
+    }
+    return len;
+}
+
+/* Private helper function: path of a file, under its original or its renamed name */
+static void file_path(const MetaJob *job, uint64_t file, bool renamed, char *buf, size_t size)
+{
+    int len = tree_path(job, (unsigned)(file % job->leaves), job->depth, buf, size);
+    if (len < (int)size)
+    {
+        snprintf(buf + len, size - (size_t)len, "/f%llu%s", (unsigned long long)file, renamed ? ".r" : "");
+    }
+}
+
+/* Private helper function: write back dirty data, then drop the page, dentry and inode caches */
+static bool drop_caches(void)
+{
+    sync();
+    int fd = open("/proc/sys/vm/drop_caches", O_WRONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    bool ok = write(fd, "3\n", 2) == 2;
+    int saved = errno;
+    close(fd);
+    errno = saved;
+    return ok;
+}
+
+/*
+ * Private helper function: run one phase over every file on all threads,
+ * logging each interval and the phase summary. Returns false if any
+ * operation failed.
+ */
+static bool run_phase(MetaJob *job, MetaPhase phase, int order)
+{
+    job->phase = phase;
+    job->finished = 0;
+    hist_init(job->totals);
+    for (int i = 0; i < job->thread_count; i++)
+    {
+        hist_init(job->workers[i].live);
+        hist_init(job->workers[i].seen);
+        job->workers[i].error = 0;
+    }
+
+    bool ok = true;
+    int started = 0;
+    uint64_t start = bench_now_ns();
+    for (int i = 0; i < job->thread_count; i++)
+    {
+        if (pthread_create(&job->workers[i].thread, NULL, meta_worker, &job->workers[i]) != 0)
+        {
+            logger_error("Meta: failed to start thread %d", i);
+            ok = false;
+            break;
+        }
+        started++;
+    }
+
+    uint64_t last = start;
+    while (__atomic_load_n(&job->finished, __ATOMIC_ACQUIRE) < started)
+    {
+        sleep_ns(META_POLL_NS);
+        uint64_t now = bench_now_ns();
+        if (now - last >= META_INTERVAL_NS)
+        {
+            report_interval(job, (double)(now - start) / 1e9, (double)(now - last) / 1e9);
+            last = now;
+        }
+    }
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(job->workers[i].thread, NULL);
+    }
+    uint64_t end = bench_now_ns();
+    report_interval(job, (double)(end - start) / 1e9, (double)(end - last) / 1e9);
+
+    for (int i = 0; i < started; i++)
+    {
+        if (job->workers[i].error != 0)
+        {
+            char path[META_PATH_SIZE];
+            file_path(job, job->workers[i].failed, phase == META_UNLINK, path, sizeof(path));
+            logger_error("Meta: %s of %s failed: %s", phase_names[phase], path, strerror(job->workers[i].error));
+            ok = false;
+        }
+    }
+
+    double secs = (double)(end - start) / 1e9;
+    LatencySummary summary;
+    hist_summarize(job->totals, &summary);
+    logger_metric("storage_meta_summary", "phase=%s,ops=%llu,secs=%.3f,ops_per_s=%.0f,lat_mean_us=%.1f,"
+                  "lat_p50_us=%.1f,lat_p90_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,lat_p9999_us=%.1f,"
+                  "lat_max_us=%.1f",
+                  phase_names[phase], (unsigned long long)summary.count, secs,
+                  secs > 0.0 ? (double)summary.count / secs : 0.0, summary.mean / 1e3, (double)summary.p50 / 1e3,
+                  (double)summary.p90 / 1e3, (double)summary.p99 / 1e3, (double)summary.p999 / 1e3,
+                  (double)summary.p9999 / 1e3, (double)summary.max / 1e3);
+    logger_info("Meta: %-9s %10.0f ops/s over %.1f s, avg %.1f us p99 %.1f us max %.1f us", phase_names[phase],
+                secs > 0.0 ? (double)summary.count / secs : 0.0, secs, summary.mean / 1e3,
+                (double)summary.p99 / 1e3, (double)summary.max / 1e3);
+
+    char name[64];
+    snprintf(name, sizeof(name), "storage.%d.%s", order, phase_names[phase]);
+    if (summary.count > 0 && !hist_save(job->totals, name))
+    {
+        logger_warning("Meta: could not save the %s latency histogram", phase_names[phase]);
+    }
+    return ok;
+}
+
+/* Private helper function: worker thread, does every thread_count-th file of the phase until done or failed */
+static void *meta_worker(void *arg)
+{
+    MetaWorker *worker = arg;
+    MetaJob *job = worker->job;
+    char path[META_PATH_SIZE], renamed[META_PATH_SIZE];
+
+    for (uint64_t file = (uint64_t)worker->index; file < job->file_count; file += (uint64_t)job->thread_count)
+    {
+        uint64_t t0 = bench_now_ns();
+        int error = do_op(job, job->phase, file, path, renamed);
+        if (error != 0)
+        {
+            worker->failed = file;
+            worker->error = error;
+            break;
+        }
+        hist_record(worker->live, bench_now_ns() - t0);
+    }
+    __atomic_add_fetch(&job->finished, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/* Private helper function: one operation of a phase on one file, returning an errno or 0 */
+static int do_op(const MetaJob *job, MetaPhase phase, uint64_t file, char *path, char *renamed)
+{
+    struct stat st;
+    int fd;
+
+    file_path(job, file, phase == META_UNLINK, path, META_PATH_SIZE);
+    switch (phase)
+    {
+    case META_CREATE:
+        fd = open(path, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd < 0)
+        {
+            return errno;
+        }
+        if (job->file_size > 0 && write(fd, job->content, job->file_size) != (ssize_t)job->file_size)
+        {
+            int error = errno != 0 ? errno : EIO;
+            close(fd);
+            return error;
+        }
+        return close(fd) == 0 ? 0 : errno;
+    case META_STAT:
+    case META_STAT_COLD:
+        return stat(path, &st) == 0 ? 0 : errno;
+    case META_OPEN:
+    case META_OPEN_COLD:
+        fd = open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return errno;
+        }
+        return close(fd) == 0 ? 0 : errno;
+    case META_RENAME:
+        file_path(job, file, true, renamed, META_PATH_SIZE);
+        return rename(path, renamed) == 0 ? 0 : errno;
+    case META_UNLINK:
+        return unlink(path) == 0 ? 0 : errno;
+    default:
+        return EINVAL;
+    }
+}
+
+/* Private helper function: collect every worker's histogram without stopping them, log one interval */
+static void report_interval(MetaJob *job, double t_s, double secs)
+{
+    hist_init(job->merged);
+    for (int i = 0; i < job->thread_count; i++)
+    {
+        hist_collect(job->workers[i].live, job->workers[i].seen, job->interval);
+        hist_merge(job->merged, job->interval);
+    }
+    hist_merge(job->totals, job->merged);
+
+    LatencySummary summary;
+    hist_summarize(job->merged, &summary);
+    if (summary.count == 0)
+    {
+        return;
+    }
+    double ops = secs > 0.0 ? (double)summary.count / secs : 0.0;
+    logger_metric("storage_meta", "t_s=%.1f,phase=%s,ops_per_s=%.0f,lat_mean_us=%.1f,lat_p50_us=%.1f,"
+                  "lat_p99_us=%.1f,lat_p999_us=%.1f,lat_max_us=%.1f",
+                  t_s, phase_names[job->phase], ops, summary.mean / 1e3, (double)summary.p50 / 1e3,
+                  (double)summary.p99 / 1e3, (double)summary.p999 / 1e3, (double)summary.max / 1e3);
+}
+
+/* Private helper function: sleep for a relative time */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}
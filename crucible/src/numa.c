@@ -0,0 +1,156 @@
+/**
+ * NUMA Placement Implementation
+ *
+ * This file calls the memory policy system calls through syscall(). The
+ * node masks passed to the kernel are plain unsigned long bitmaps; the
+ * kernel reads maxnode - 1 bits of them, hence the + 1 below.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+/* Include our header files */
+#include "numa.h"
+#include "topology.h"
+
+/* Define constants */
+#define NUMA_ONLINE_PATH "/sys/devices/system/node/online"
+#define NUMA_MAX_NODES 1024
+#define NUMA_MASK_LONGS (NUMA_MAX_NODES / (8 * sizeof(unsigned long)))
+#define NUMA_MAX_SAMPLES 4096
+
+/* Private helper function prototypes */
+static bool build_mask(unsigned long *mask, int node);
+
+/**
+ * List the online NUMA nodes
+ */
+int numa_online_nodes(int *nodes, int max)
+{
+    char list[1024];
+    FILE *file = fopen(NUMA_ONLINE_PATH, "r");
+    if (file == NULL)
+    {
+        nodes[0] = 0;
+        return 1;
+    }
+
+    bool ok = fgets(list, sizeof(list), file) != NULL;
+    fclose(file);
+
+    /* Node lists use the same format as CPU lists */
+    int count = ok ? topology_parse_cpulist(list, nodes, max) : -1;
+    if (count <= 0)
+    {
+        nodes[0] = 0;
+        return 1;
+    }
+    return count;
+}
+
+/**
+ * Bind a memory range to one node
+ */
+bool numa_bind_range(void *addr, size_t len, int node)
+{
+    unsigned long mask[NUMA_MASK_LONGS];
+    if (!build_mask(mask, node))
+    {
+        return false;
+    }
+
+    long rc = syscall(SYS_mbind, addr, len, MPOL_BIND, mask, (unsigned long)NUMA_MAX_NODES + 1,
+                      MPOL_MF_STRICT | MPOL_MF_MOVE);
+    return rc == 0;
+}
+
+/**
+ * Set the calling thread's default allocation node
+ */
+bool numa_set_preferred(int node)
+{
+    if (node < 0)
+    {
+        return syscall(SYS_set_mempolicy, MPOL_DEFAULT, NULL, 0UL) == 0;
+    }
+
+    unsigned long mask[NUMA_MASK_LONGS];
+    if (!build_mask(mask, node))
+    {
+        return false;
+    }
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, (unsigned long)NUMA_MAX_NODES + 1) == 0;
+}
+
+/**
+ * Check where the pages of a range live
+ */
+double numa_placement(const void *addr, size_t len, int node)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    uintptr_t first = (uintptr_t)addr & ~(uintptr_t)(page - 1);
+    size_t pages = ((uintptr_t)addr + len - first + page - 1) / page;
+    if (pages == 0)
+    {
+        return -1.0;
+    }
+
+    size_t samples = pages < NUMA_MAX_SAMPLES ? pages : NUMA_MAX_SAMPLES;
+    void **addrs = malloc(samples * sizeof(void *));
+    int *status = malloc(samples * sizeof(int));
+    if (!addrs || !status)
+    {
+        free(addrs);
+        free(status);
+        return -1.0;
+    }
+
+    for (size_t i = 0; i < samples; i++)
+    {
+        addrs[i] = (void *)(first + (i * pages / samples) * page);
+    }
+
+    /* With a NULL node list move_pages() only reports the current node */
+    double fraction = -1.0;
+    if (syscall(SYS_move_pages, 0, (unsigned long)samples, addrs, NULL, status, 0) == 0)
+    {
+        size_t matched = 0;
+        for (size_t i = 0; i < samples; i++)
+        {
+            if (status[i] == node)
+            {
+                matched++;
+            }
+        }
+        fraction = (double)matched / (double)samples;
+    }
+
+    free(addrs);
+    free(status);
+    return fraction;
+}
+
+/* Private helper function to build a single-node mask */
+static bool build_mask(unsigned long *mask, int node)
+{
+    if (node < 0 || node >= NUMA_MAX_NODES)
+    {
+        errno = EINVAL;
+        return false;
+    }
+
+    memset(mask, 0, NUMA_MASK_LONGS * sizeof(unsigned long));
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+    return true;
+}
@@ -0,0 +1,460 @@
+/**
+ * NUMA Matrix Test Implementation
+ *
+ * This file measures memory latency and bandwidth for every combination of
+ * CPU node and memory node. Each cell maps a fresh buffer, binds it to the
+ * memory node before first touch, checks the placement, then runs a
+ * pointer chase from one CPU of the CPU node and a read stream from all of
+ * its CPUs.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* Include our header files */
+#include "numa_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+#include "numa.h"
+#include "pointer_chase.h"
+#include "topology.h"
+
+/* Define constants */
+#define NUMA_DEFAULT_SIZE (512ULL << 20)
+#define NUMA_MAX_NODES 64
+#define NUMA_MAX_READERS 256
+#define NUMA_READ_REPS 3
+#define NUMA_CHASE_REPS 3
+#define NUMA_CALIBRATE_LOADS (1ULL << 16)
+#define NUMA_TARGET_NS 50000000.0
+#define NUMA_MIN_PLACEMENT 0.99
+#define NUMA_SEED 0x853C49E6748FEA9BULL
+
+/* One read bandwidth thread */
+typedef struct
+{
+    pthread_t thread;
+    int cpu;
+    const uint64_t *data;
+    size_t count;
+    pthread_barrier_t *barrier;
+    pthread_mutex_t *gate;     /* Held by the creator until all readers exist */
+    const bool *cancel;        /* Set if not all readers could be started */
+    uint64_t start[NUMA_READ_REPS];
+    uint64_t end[NUMA_READ_REPS];
+    uint64_t sum;
+} NumaReader;
+
+/* Results of one matrix cell */
+typedef struct
+{
+    bool measured;
+    double latency_ns;
+    double read_gbps;
+    double placement;
+} NumaCell;
+
+/* Private helper function prototypes */
+static int node_cpus(const CpuTopology *topo, int node, bool single_node, int *cpus, int max);
+static bool measure_cell(int cpu_node, int mem_node, const int *cpus, int cpu_count, size_t size,
+                         MemPageType pages, const ChasePattern *pattern, bool bind, NumaCell *cell);
+static double measure_chain(void **head, size_t nodes);
+static double measure_read(const MemBuffer *buffer, const int *cpus, int cpu_count);
+static void *reader_thread(void *arg);
+
+/**
+ * Run the NUMA matrix test
+ */
+bool numa_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    ChasePattern pattern;
+    if (!chase_parse_pattern(opts->pattern, &pattern))
+    {
+        logger_error("NUMA: invalid pattern '%s'", opts->pattern);
+        return false;
+    }
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("NUMA: invalid page type '%s'", opts->pages);
+        return false;
+    }
+    if (type_count > 1)
+    {
+        logger_warning("NUMA: one page type per run, using %s", mem_buffer_page_name(types[0]));
+    }
+
+    size_t size = NUMA_DEFAULT_SIZE;
+    if (opts->size[0] != '\0' && !bench_parse_size(opts->size, &size))
+    {
+        logger_error("NUMA: invalid size '%s'", opts->size);
+        return false;
+    }
+    size_t limit = bench_mem_available() / 2;
+    if (limit > 0 && size > limit)
+    {
+        logger_warning("NUMA: %zu MB requested, only %zu MB available, shrinking", size >> 20, limit >> 20);
+        size = limit;
+    }
+
+    int nodes[NUMA_MAX_NODES];
+    int node_count = numa_online_nodes(nodes, NUMA_MAX_NODES);
+    bool single_node = (node_count == 1);
+
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        logger_error("NUMA: cannot read CPU topology");
+        return false;
+    }
+
+    /* Probe once whether the kernel accepts memory policies at all */
+    bool bind = true;
+    MemBuffer probe;
+    if (mem_buffer_alloc(&probe, (size_t)4096, 0))
+    {
+        if (!mem_buffer_bind(&probe, nodes[0]))
+        {
+            logger_warning("NUMA: mbind unavailable (%s), measuring without placement control",
+                           strerror(errno));
+            bind = false;
+        }
+        mem_buffer_free(&probe);
+    }
+
+    if (single_node)
+    {
+        logger_warning("NUMA: single node machine, only the local cell is measured");
+    }
+    logger_info("NUMA: %d node(s), %zu MB per cell, %s pages", node_count, size >> 20,
+                mem_buffer_page_name(types[0]));
+
+    NumaCell *cells = calloc((size_t)(node_count * node_count), sizeof(NumaCell));
+    int *cpus = malloc(sizeof(int) * (size_t)topo.count);
+    if (!cells || !cpus)
+    {
+        free(cells);
+        free(cpus);
+        topology_free(&topo);
+        return false;
+    }
+
+    /* The cells pin this thread to each CPU node in turn; the caller's affinity is restored after them */
+    bool saved_affinity = false;
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) == 0)
+    {
+        saved_affinity = true;
+    }
+
+    for (int i = 0; i < node_count; i++)
+    {
+        int cpu_count = node_cpus(&topo, nodes[i], single_node, cpus, topo.count);
+        if (cpu_count == 0)
+        {
+            logger_info("NUMA: node %d has no CPUs, skipping as CPU node", nodes[i]);
+            continue;
+        }
+
+        for (int j = 0; j < node_count; j++)
+        {
+            NumaCell *cell = &cells[i * node_count + j];
+            if (!measure_cell(nodes[i], nodes[j], cpus, cpu_count, size, types[0], &pattern, bind, cell))
+            {
+                /* Memoryless nodes refuse the binding; that is not a failure */
+                logger_info("NUMA: cpu node %d, memory node %d not measurable", nodes[i], nodes[j]);
+                continue;
+            }
+
+            logger_info("NUMA: cpu node %d -> mem node %d: %.2f ns, %.2f GB/s read, %.0f%% of pages placed",
+                        nodes[i], nodes[j], cell->latency_ns, cell->read_gbps, cell->placement * 100.0);
+            logger_metric("numa_matrix", "cpu_node=%d,mem_node=%d,latency_ns=%.3f,read_gbps=%.3f,placed_pct=%.1f",
+                          nodes[i], nodes[j], cell->latency_ns, cell->read_gbps, cell->placement * 100.0);
+            if (bind && cell->placement >= 0.0 && cell->placement < NUMA_MIN_PLACEMENT)
+            {
+                logger_warning("NUMA: only %.0f%% of pages landed on node %d", cell->placement * 100.0, nodes[j]);
+            }
+        }
+    }
+
+    if (saved_affinity)
+    {
+        sched_setaffinity(0, sizeof(original), &original);
+    }
+
+    /* Print the matrices and the remote penalty relative to the local cell */
+    char row[1024];
+    for (int table = 0; table < 2; table++)
+    {
+        int len = snprintf(row, sizeof(row), "NUMA: %s  cpu\\mem", table == 0 ? "latency ns" : "read GB/s ");
+        for (int j = 0; j < node_count && len < (int)sizeof(row); j++)
+        {
+            len += snprintf(row + len, sizeof(row) - (size_t)len, " %9d", nodes[j]);
+        }
+        logger_info("%s", row);
+
+        for (int i = 0; i < node_count; i++)
+        {
+            len = snprintf(row, sizeof(row), "NUMA: %18d", nodes[i]);
+            for (int j = 0; j < node_count && len < (int)sizeof(row); j++)
+            {
+                const NumaCell *cell = &cells[i * node_count + j];
+                if (!cell->measured)
+                    len += snprintf(row + len, sizeof(row) - (size_t)len, " %9s", "-");
+                else
+                    len += snprintf(row + len, sizeof(row) - (size_t)len, " %9.2f",
+                                    table == 0 ? cell->latency_ns : cell->read_gbps);
+            }
+            logger_info("%s", row);
+        }
+    }
+
+    for (int i = 0; i < node_count; i++)
+    {
+        const NumaCell *local = &cells[i * node_count + i];
+        for (int j = 0; j < node_count; j++)
+        {
+            const NumaCell *remote = &cells[i * node_count + j];
+            if (j == i || !local->measured || !remote->measured || remote->read_gbps <= 0.0)
+            {
+                continue;
+            }
+            logger_metric("numa_remote_penalty", "cpu_node=%d,mem_node=%d,latency_ratio=%.3f,bandwidth_ratio=%.3f",
+                          nodes[i], nodes[j], remote->latency_ns / local->latency_ns,
+                          local->read_gbps / remote->read_gbps);
+        }
+    }
+
+    free(cells);
+    free(cpus);
+    topology_free(&topo);
+    return true;
+}
+
+/* Private helper function to list the online CPUs of a node */
+static int node_cpus(const CpuTopology *topo, int node, bool single_node, int *cpus, int max)
+{
+    int count = 0;
+    for (int i = 0; i < topo->count && count < max; i++)
+    {
+        /* Kernels without NUMA leave the node unknown; that is node 0 */
+        int cpu_node = topo->cpus[i].node;
+        if (cpu_node == node || (single_node && cpu_node < 0))
+        {
+            cpus[count++] = topo->cpus[i].cpu;
+        }
+    }
+    return count;
+}
+
+/* Private helper function to measure one cell of the matrix */
+static bool measure_cell(int cpu_node, int mem_node, const int *cpus, int cpu_count, size_t size,
+                         MemPageType pages, const ChasePattern *pattern, bool bind, NumaCell *cell)
+{
+    (void)cpu_node;
+
+    MemBuffer buffer;
+    if (!mem_buffer_alloc_pages(&buffer, size, 0, pages))
+    {
+        return false;
+    }
+    if (bind && !mem_buffer_bind(&buffer, mem_node))
+    {
+        mem_buffer_free(&buffer);
+        return false;
+    }
+
+    /* Build the chain from the CPU node; the binding decides where it lands */
+    bench_pin_cpu(cpus[0]);
+    size_t nodes;
+    void **head = chase_build(buffer.data, buffer.size, pattern, false, NUMA_SEED, &nodes);
+    if (!head)
+    {
+        mem_buffer_free(&buffer);
+        return false;
+    }
+
+    cell->placement = numa_placement(buffer.data, buffer.size, mem_node);
+    cell->latency_ns = measure_chain(head, nodes);
+
+    /* The read stream goes over the chain; only its bytes matter */
+    cell->read_gbps = measure_read(&buffer, cpus, cpu_count);
+    cell->measured = true;
+
+    mem_buffer_free(&buffer);
+    return true;
+}
+
+/* Private helper function to time a chain; returns the best ns per load */
+static double measure_chain(void **head, size_t nodes)
+{
+    head = chase_walk(head, nodes);
+
+    double estimate = chase_measure(head, NUMA_CALIBRATE_LOADS);
+    uint64_t loads = NUMA_CALIBRATE_LOADS;
+    if (estimate > 0.0 && NUMA_TARGET_NS / estimate > (double)loads)
+    {
+        loads = (uint64_t)(NUMA_TARGET_NS / estimate);
+    }
+
+    double best = 0.0;
+    for (int rep = 0; rep < NUMA_CHASE_REPS; rep++)
+    {
+        double ns = chase_measure(head, loads);
+        if (rep == 0 || ns < best)
+        {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+/* Private helper function to read the buffer from every CPU of a node; returns the best GB/s */
+static double measure_read(const MemBuffer *buffer, const int *cpus, int cpu_count)
+{
+    if (cpu_count > NUMA_MAX_READERS)
+    {
+        cpu_count = NUMA_MAX_READERS;
+    }
+
+    NumaReader *readers = calloc((size_t)cpu_count, sizeof(NumaReader));
+    if (!readers)
+    {
+        return 0.0;
+    }
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned int)cpu_count);
+
+    size_t total = buffer->size / sizeof(uint64_t);
+    for (int i = 0; i < cpu_count; i++)
+    {
+        size_t first = total * (size_t)i / (size_t)cpu_count;
+        size_t last = total * (size_t)(i + 1) / (size_t)cpu_count;
+        readers[i].cpu = cpus[i];
+        readers[i].data = (const uint64_t *)buffer->data + first;
+        readers[i].count = last - first;
+        readers[i].barrier = &barrier;
+    }
+
+    /*
+     * Readers wait on the gate until every thread exists, so a failed
+     * creation can call the run off before anyone reaches the barrier.
+     */
+    pthread_mutex_t gate = PTHREAD_MUTEX_INITIALIZER;
+    bool cancel = false;
+    pthread_mutex_lock(&gate);
+    int started = 1;
+    for (int i = 1; i < cpu_count; i++)
+    {
+        readers[i].gate = &gate;
+        readers[i].cancel = &cancel;
+        if (pthread_create(&readers[i].thread, NULL, reader_thread, &readers[i]) != 0)
+        {
+            logger_error("NUMA: failed to start reader on CPU %d", cpus[i]);
+            cancel = true;
+            break;
+        }
+        started++;
+    }
+    pthread_mutex_unlock(&gate);
+
+    if (!cancel)
+    {
+        reader_thread(&readers[0]);
+    }
+    for (int i = 1; i < started; i++)
+    {
+        pthread_join(readers[i].thread, NULL);
+    }
+    if (cancel)
+    {
+        pthread_barrier_destroy(&barrier);
+        free(readers);
+        return 0.0;
+    }
+    bench_pin_cpu(cpus[0]);
+
+    double best = 0.0;
+    for (int rep = 0; rep < NUMA_READ_REPS; rep++)
+    {
+        uint64_t start = readers[0].start[rep];
+        uint64_t end = readers[0].end[rep];
+        for (int i = 1; i < cpu_count; i++)
+        {
+            if (readers[i].start[rep] < start)
+                start = readers[i].start[rep];
+            if (readers[i].end[rep] > end)
+                end = readers[i].end[rep];
+        }
+        double gbps = end > start ? (double)buffer->size / (double)(end - start) : 0.0;
+        if (gbps > best)
+        {
+            best = gbps;
+        }
+    }
+
+    pthread_barrier_destroy(&barrier);
+    free(readers);
+    return best;
+}
+
+/* Private helper function: pinned reader summing its slice once per repetition */
+static void *reader_thread(void *arg)
+{
+    NumaReader *reader = arg;
+    bench_pin_cpu(reader->cpu);
+
+    if (reader->gate)
+    {
+        pthread_mutex_lock(reader->gate);
+        pthread_mutex_unlock(reader->gate);
+        if (*reader->cancel)
+        {
+            return NULL;
+        }
+    }
+
+    uint64_t sum = 0;
+    for (int rep = 0; rep < NUMA_READ_REPS; rep++)
+    {
+        pthread_barrier_wait(reader->barrier);
+        reader->start[rep] = bench_now_ns();
+
+        const uint64_t *p = reader->data;
+        uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= reader->count; i += 4)
+        {
+            s0 += p[i];
+            s1 += p[i + 1];
+            s2 += p[i + 2];
+            s3 += p[i + 3];
+        }
+        for (; i < reader->count; i++)
+        {
+            s0 += p[i];
+        }
+        sum += s0 + s1 + s2 + s3;
+
+        reader->end[rep] = bench_now_ns();
+    }
+
+    reader->sum = sum;
+    return NULL;
+}
@@ -0,0 +1,136 @@
+/**
+ * Performance Counter Implementation
+ *
+ * This file opens perf events through syscall() since glibc has no
+ * wrapper for perf_event_open(). Multiplexed counters are scaled by
+ * time_enabled / time_running so the totals stay comparable.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/* Include our header file */
+#include "perf_counter.h"
+
+/* Private helper function prototypes */
+static int open_event(uint32_t type, uint64_t config, bool inherit);
+
+/**
+ * Open a counter for the calling thread
+ */
+bool perf_counter_open(PerfCounter *counter, PerfCounterKind kind, bool inherit)
+{
+    memset(counter, 0, sizeof(*counter));
+
+    switch (kind)
+    {
+    case PERF_DTLB_MISSES:
+    {
+        uint64_t load = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                        (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        uint64_t store = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_WRITE << 8) |
+                         (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+        int fd = open_event(PERF_TYPE_HW_CACHE, load, inherit);
+        if (fd < 0)
+        {
+            return false;
+        }
+        counter->fds[counter->count++] = fd;
+
+        /* Some CPUs have no store-miss event; load misses alone still count */
+        fd = open_event(PERF_TYPE_HW_CACHE, store, inherit);
+        if (fd >= 0)
+        {
+            counter->fds[counter->count++] = fd;
+        }
+        return true;
+    }
+    case PERF_MINOR_FAULTS:
+    {
+        /* Faults are accounted to the user context that took them, so exclude_kernel keeps them */
+        int fd = open_event(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS_MIN, inherit);
+        if (fd < 0)
+        {
+            return false;
+        }
+        counter->fds[counter->count++] = fd;
+        return true;
+    }
+    case PERF_CPU_CYCLES:
+    {
+        int fd = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, inherit);
+        if (fd < 0)
+        {
+            return false;
+        }
+        counter->fds[counter->count++] = fd;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+/**
+ * Read a counter
+ */
+uint64_t perf_counter_read(const PerfCounter *counter)
+{
+    uint64_t total = 0;
+    for (int i = 0; i < counter->count; i++)
+    {
+        /* value, time_enabled, time_running */
+        uint64_t data[3];
+        if (read(counter->fds[i], data, sizeof(data)) != (ssize_t)sizeof(data))
+        {
+            continue;
+        }
+        if (data[2] > 0 && data[2] < data[1])
+        {
+            total += (uint64_t)((double)data[0] * (double)data[1] / (double)data[2]);
+        }
+        else
+        {
+            total += data[0];
+        }
+    }
+    return total;
+}
+
+/**
+ * Close a counter
+ */
+void perf_counter_close(PerfCounter *counter)
+{
+    for (int i = 0; i < counter->count; i++)
+    {
+        close(counter->fds[i]);
+    }
+    counter->count = 0;
+}
+
+/* Private helper function to open one user-space event on the calling thread */
+static int open_event(uint32_t type, uint64_t config, bool inherit)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = inherit ? 1 : 0;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
@@ -0,0 +1,250 @@
+/**
+ * Pointer Chase Implementation
+ *
+ * This file builds and walks dependent-load chains. Random chains use
+ * Sattolo's algorithm, which produces a permutation with a single cycle,
+ * so a walk of any length visits every node before repeating. The
+ * permutation is built in place using the nodes themselves as storage.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Include our header files */
+#include "pointer_chase.h"
+#include "bench_util.h"
+
+/* Define constants */
+#define CHASE_LINE_SIZE 64
+#define CHASE_MAX_PAGE_NODES 4096
+
+/* Private helper function prototypes */
+static uint64_t next_random(uint64_t *state);
+static void **build_linear(char *base, size_t count, size_t stride);
+static void **build_random(char *base, size_t count, size_t stride, uint64_t *state);
+static void **build_paged(char *base, size_t count, size_t stride, uint64_t *state);
+
+/**
+ * Parse a chase pattern
+ */
+bool chase_parse_pattern(const char *str, ChasePattern *pattern)
+{
+    pattern->order = CHASE_RAND;
+    pattern->stride = CHASE_LINE_SIZE;
+
+    if (str == NULL || str[0] == '\0' || strcmp(str, "rand") == 0)
+    {
+        return true;
+    }
+    if (strcmp(str, "seq") == 0)
+    {
+        pattern->order = CHASE_SEQ;
+        return true;
+    }
+    if (strncmp(str, "stride:", 7) == 0)
+    {
+        size_t stride;
+        if (!bench_parse_size(str + 7, &stride) || stride == 0 || stride % sizeof(void *) != 0)
+        {
+            return false;
+        }
+        pattern->order = CHASE_STRIDE;
+        pattern->stride = stride;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Describe a chase pattern
+ */
+void chase_pattern_name(const ChasePattern *pattern, char *buffer, size_t size)
+{
+    switch (pattern->order)
+    {
+    case CHASE_SEQ:
+        snprintf(buffer, size, "seq");
+        break;
+    case CHASE_STRIDE:
+        snprintf(buffer, size, "stride:%zu", pattern->stride);
+        break;
+    default:
+        snprintf(buffer, size, "rand");
+        break;
+    }
+}
+
+/**
+ * Build a chain in a buffer
+ */
+void **chase_build(void *base, size_t bytes, const ChasePattern *pattern,
+                   bool tlb_friendly, uint64_t seed, size_t *nodes)
+{
+    size_t count = bytes / pattern->stride;
+    if (nodes)
+    {
+        *nodes = count;
+    }
+    if (count < 2)
+    {
+        return NULL;
+    }
+
+    uint64_t state = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    if (pattern->order != CHASE_RAND)
+    {
+        return build_linear(base, count, pattern->stride);
+    }
+    if (tlb_friendly)
+    {
+        return build_paged(base, count, pattern->stride, &state);
+    }
+    return build_random(base, count, pattern->stride, &state);
+}
+
+/**
+ * Follow a chain
+ */
+void **chase_walk(void **head, uint64_t loads)
+{
+    void **p = head;
+
+#define CHASE_STEP p = (void **)*p;
+    for (uint64_t i = 0; i < (loads + 15) / 16; i++)
+    {
+        CHASE_STEP CHASE_STEP CHASE_STEP CHASE_STEP
+        CHASE_STEP CHASE_STEP CHASE_STEP CHASE_STEP
+        CHASE_STEP CHASE_STEP CHASE_STEP CHASE_STEP
+        CHASE_STEP CHASE_STEP CHASE_STEP CHASE_STEP
+    }
+#undef CHASE_STEP
+
+    return p;
+}
+
+/**
+ * Measure the average load latency of a chain
+ */
+double chase_measure(void **head, uint64_t loads)
+{
+    loads = (loads + 15) / 16 * 16;
+    if (loads == 0)
+    {
+        return 0.0;
+    }
+
+    uint64_t start = bench_now_ns();
+    void **end = chase_walk(head, loads);
+    uint64_t elapsed = bench_now_ns() - start;
+
+    /* Make the final node observable so the walk cannot be dropped */
+    __asm__ __volatile__("" : : "r"(end) : "memory");
+
+    return (double)elapsed / (double)loads;
+}
+
+/* Private helper function: xorshift64* generator */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/* Private helper function to link nodes in address order */
+static void **build_linear(char *base, size_t count, size_t stride)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t next = (i + 1 == count) ? 0 : i + 1;
+        *(void **)(base + i * stride) = base + next * stride;
+    }
+    return (void **)base;
+}
+
+/* Private helper function to link nodes in one random cycle over the whole region */
+static void **build_random(char *base, size_t count, size_t stride, uint64_t *state)
+{
+    /* Each node first stores its successor's index; identity to start */
+    for (size_t i = 0; i < count; i++)
+    {
+        *(size_t *)(base + i * stride) = i;
+    }
+
+    /* Sattolo: swapping only with strictly earlier slots yields one cycle */
+    for (size_t i = count - 1; i > 0; i--)
+    {
+        size_t j = (size_t)(next_random(state) % i);
+        size_t *a = (size_t *)(base + i * stride);
+        size_t *b = (size_t *)(base + j * stride);
+        size_t tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+
+    /* Turn successor indices into addresses */
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t next = *(size_t *)(base + i * stride);
+        *(void **)(base + i * stride) = base + next * stride;
+    }
+    return (void **)base;
+}
+
+/* Private helper function to shuffle nodes within each page and chain the pages in order */
+static void **build_paged(char *base, size_t count, size_t stride, uint64_t *state)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t per_page = stride < page ? page / stride : 1;
+    if (per_page > CHASE_MAX_PAGE_NODES)
+    {
+        per_page = CHASE_MAX_PAGE_NODES;
+    }
+
+    size_t order[CHASE_MAX_PAGE_NODES];
+    void **head = NULL;
+    void **prev = NULL;
+
+    for (size_t first = 0; first < count; first += per_page)
+    {
+        size_t n = count - first < per_page ? count - first : per_page;
+
+        /* Fisher-Yates over the nodes of this page */
+        for (size_t i = 0; i < n; i++)
+        {
+            order[i] = first + i;
+        }
+        for (size_t i = n - 1; i > 0; i--)
+        {
+            size_t j = (size_t)(next_random(state) % (i + 1));
+            size_t tmp = order[i];
+            order[i] = order[j];
+            order[j] = tmp;
+        }
+
+        for (size_t i = 0; i < n; i++)
+        {
+            void **node = (void **)(base + order[i] * stride);
+            if (prev)
+            {
+                *prev = node;
+            }
+            else
+            {
+                head = node;
+            }
+            prev = node;
+        }
+    }
+
+    *prev = head;
+    return head;
+}
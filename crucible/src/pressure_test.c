@@ -0,0 +1,432 @@
+/**
+ * Memory Pressure Generator Implementation
+ *
+ * This file implements the memory pressure generator. Memory is held in
+ * fixed-size chunks so it can grow and shrink in steps. The main loop runs
+ * in short ticks: each tick grows or shrinks the held set towards the
+ * current goal, then writes one byte into as many pages as the touch rate
+ * allows, cycling through the whole set so every page stays referenced.
+ * Once per interval it samples /proc/pressure/memory, /proc/meminfo and
+ * /proc/vmstat and logs the deltas as rates.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+/* Include our header files */
+#include "pressure_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "mem_buffer.h"
+
+/* Define constants */
+#define PRESSURE_DEFAULT_PERCENT 80
+#define PRESSURE_DEFAULT_TOUCH_RATE (1ULL << 30)
+#define PRESSURE_CHUNK (64ULL << 20)
+#define PRESSURE_PAGE 4096
+#define PRESSURE_TICK_NS 10000000ULL       /* 10 ms */
+#define PRESSURE_INTERVAL_NS 1000000000ULL /* 1 s */
+#define PRESSURE_RAMP_DIVISOR 4            /* Ramp over the first quarter */
+#define PRESSURE_RESERVE_MIN (256ULL << 20)
+#define PRESSURE_RESERVE_DIVISOR 50        /* 2% of MemTotal */
+
+/* One reading of the kernel counters */
+typedef struct
+{
+    uint64_t time_ns;
+    bool psi;                  /* /proc/pressure/memory was readable */
+    double some_avg10;
+    double full_avg10;
+    uint64_t some_total_us;
+    uint64_t full_total_us;
+    size_t mem_available;
+    size_t swap_used;
+    uint64_t pgscan_kswapd;
+    uint64_t pgscan_direct;
+    uint64_t pgsteal;
+    uint64_t pswpin;
+    uint64_t pswpout;
+} PressureSample;
+
+/* Held memory */
+typedef struct
+{
+    MemBuffer *chunks;
+    size_t count;
+    size_t capacity;
+    MemPageType pages;
+    size_t touch_chunk;  /* Where the next touch continues */
+    size_t touch_offset;
+} PressureSet;
+
+/* Private helper function prototypes */
+static bool parse_target(const char *str, size_t mem_total, size_t *bytes);
+static bool grow(PressureSet *set);
+static void shrink(PressureSet *set);
+static uint64_t touch(PressureSet *set, uint64_t pages);
+static void take_sample(PressureSample *sample);
+static bool read_psi(PressureSample *sample);
+static void read_vmstat(PressureSample *sample);
+static void sleep_ns(uint64_t ns);
+
+/**
+ * Run the memory pressure generator
+ */
+bool pressure_test_run(const ComponentConfig *comp)
+{
+    const MemoryOptions *opts = &comp->options.memory;
+
+    size_t mem_total = bench_meminfo("MemTotal");
+    if (mem_total == 0)
+    {
+        logger_error("Pressure: cannot read MemTotal");
+        return false;
+    }
+
+    size_t target;
+    if (!parse_target(opts->size, mem_total, &target))
+    {
+        logger_error("Pressure: invalid size '%s'", opts->size);
+        return false;
+    }
+
+    size_t touch_rate = PRESSURE_DEFAULT_TOUCH_RATE;
+    if (opts->touch_rate[0] != '\0' && !bench_parse_size(opts->touch_rate, &touch_rate))
+    {
+        logger_error("Pressure: invalid touch rate '%s'", opts->touch_rate);
+        return false;
+    }
+
+    MemPageType types[MEM_PAGE_TYPE_MAX];
+    int type_count = mem_buffer_parse_pages(opts->pages, types);
+    if (type_count == 0)
+    {
+        logger_error("Pressure: invalid page type '%s'", opts->pages);
+        return false;
+    }
+    if (type_count > 1)
+    {
+        logger_warning("Pressure: one page type per run, using %s", mem_buffer_page_name(types[0]));
+    }
+
+    size_t reserve = mem_total / PRESSURE_RESERVE_DIVISOR;
+    if (reserve < PRESSURE_RESERVE_MIN)
+    {
+        reserve = PRESSURE_RESERVE_MIN;
+    }
+
+    PressureSet set;
+    memset(&set, 0, sizeof(set));
+    set.pages = types[0];
+    set.capacity = target / PRESSURE_CHUNK + 1;
+    set.chunks = calloc(set.capacity, sizeof(MemBuffer));
+    if (!set.chunks)
+    {
+        logger_error("Pressure: setup failed");
+        return false;
+    }
+
+    PressureSample last;
+    take_sample(&last);
+    if (!last.psi)
+    {
+        logger_warning("Pressure: /proc/pressure/memory unavailable (kernel without PSI?), stall time not reported");
+    }
+
+    logger_info("Pressure: target %zu MB of %zu MB total, reserve %zu MB, touching %zu MB/s, %s pages",
+                target >> 20, mem_total >> 20, reserve >> 20, touch_rate >> 20, mem_buffer_page_name(set.pages));
+
+    uint64_t duration = (uint64_t)comp->duration * 1000000000ULL;
+    if (duration < PRESSURE_INTERVAL_NS)
+    {
+        duration = PRESSURE_INTERVAL_NS;
+    }
+    uint64_t start = last.time_ns;
+    uint64_t ramp_ns = duration / PRESSURE_RAMP_DIVISOR;
+    uint64_t next_interval = start + PRESSURE_INTERVAL_NS;
+    uint64_t touched = 0, backoffs = 0, interval_backoffs = 0;
+    double touch_carry = 0.0;
+    size_t peak_held = 0;
+    double max_some = 0.0, max_full = 0.0;
+    uint64_t first_pswpout = last.pswpout;
+    bool ok = true;
+
+    for (uint64_t now = start; now - start < duration; now = bench_now_ns())
+    {
+        /* Linear ramp to the target, then hold */
+        size_t goal = now - start >= ramp_ns
+                          ? target
+                          : (size_t)((double)target * (double)(now - start) / (double)ramp_ns);
+
+        /* Grow in as many chunks as fit in one tick, unless the reserve is reached */
+        size_t available = bench_mem_available();
+        if (available < reserve && set.count > 0)
+        {
+            shrink(&set);
+            backoffs++;
+            interval_backoffs++;
+        }
+        else
+        {
+            while ((set.count + 1) * PRESSURE_CHUNK <= goal && available >= reserve + PRESSURE_CHUNK &&
+                   bench_now_ns() - now < PRESSURE_TICK_NS)
+            {
+                if (!grow(&set))
+                {
+                    logger_error("Pressure: cannot map another %llu MB chunk", PRESSURE_CHUNK >> 20);
+                    ok = false;
+                    break;
+                }
+                available = bench_mem_available();
+            }
+            if (!ok)
+            {
+                break;
+            }
+        }
+        if (set.count * PRESSURE_CHUNK > peak_held)
+        {
+            peak_held = set.count * PRESSURE_CHUNK;
+        }
+
+        /* Keep the touch rate steady, carrying fractions of a page between ticks */
+        touch_carry += (double)touch_rate / PRESSURE_PAGE * (double)PRESSURE_TICK_NS / 1e9;
+        uint64_t pages = (uint64_t)touch_carry;
+        touch_carry -= (double)pages;
+        touched += touch(&set, pages);
+
+        if (bench_now_ns() >= next_interval)
+        {
+            PressureSample sample;
+            take_sample(&sample);
+            double secs = (double)(sample.time_ns - last.time_ns) / 1e9;
+            double some_pct = (double)(sample.some_total_us - last.some_total_us) / 1e4 / secs;
+            double full_pct = (double)(sample.full_total_us - last.full_total_us) / 1e4 / secs;
+            double scan = (double)(sample.pgscan_kswapd - last.pgscan_kswapd) / secs;
+            double direct = (double)(sample.pgscan_direct - last.pgscan_direct) / secs;
+            double steal = (double)(sample.pgsteal - last.pgsteal) / secs;
+            double swapin = (double)(sample.pswpin - last.pswpin) / secs;
+            double swapout = (double)(sample.pswpout - last.pswpout) / secs;
+            double touch_mbps = (double)touched * PRESSURE_PAGE / 1048576.0 / secs;
+            size_t held = set.count * PRESSURE_CHUNK;
+
+            if (some_pct > max_some)
+                max_some = some_pct;
+            if (full_pct > max_full)
+                max_full = full_pct;
+
+            logger_info("Pressure: %5.0fs held %7zu MB, available %7zu MB, swap used %6zu MB, "
+                        "PSI some %5.1f%% full %5.1f%%, scan %.0f/s (direct %.0f/s), swap in/out %.0f/%.0f pages/s",
+                        (double)(sample.time_ns - start) / 1e9, held >> 20, sample.mem_available >> 20,
+                        sample.swap_used >> 20, some_pct, full_pct, scan + direct, direct, swapin, swapout);
+            if (interval_backoffs > 0)
+            {
+                logger_warning("Pressure: MemAvailable below %zu MB, released %llu chunks",
+                               reserve >> 20, (unsigned long long)interval_backoffs);
+            }
+            logger_metric("mem_pressure", "t_s=%.1f,target_mb=%zu,held_mb=%zu,available_mb=%zu,swap_used_mb=%zu,"
+                          "psi_some_pct=%.2f,psi_full_pct=%.2f,psi_some_avg10=%.2f,psi_full_avg10=%.2f,"
+                          "pgscan_kswapd_per_sec=%.0f,pgscan_direct_per_sec=%.0f,pgsteal_per_sec=%.0f,"
+                          "pswpin_per_sec=%.0f,pswpout_per_sec=%.0f,touch_mbps=%.1f",
+                          (double)(sample.time_ns - start) / 1e9, target >> 20, held >> 20,
+                          sample.mem_available >> 20, sample.swap_used >> 20, some_pct, full_pct,
+                          sample.some_avg10, sample.full_avg10, scan, direct, steal, swapin, swapout, touch_mbps);
+
+            last = sample;
+            touched = 0;
+            interval_backoffs = 0;
+            next_interval += PRESSURE_INTERVAL_NS;
+        }
+
+        uint64_t elapsed = bench_now_ns() - now;
+        if (elapsed < PRESSURE_TICK_NS)
+        {
+            sleep_ns(PRESSURE_TICK_NS - elapsed);
+        }
+    }
+
+    if (ok && peak_held + PRESSURE_CHUNK <= target)
+    {
+        logger_warning("Pressure: reached %zu of %zu MB, held back by the %zu MB reserve",
+                       peak_held >> 20, target >> 20, reserve >> 20);
+    }
+    logger_metric("mem_pressure_summary", "target_mb=%zu,peak_held_mb=%zu,backoffs=%llu,max_psi_some_pct=%.2f,"
+                  "max_psi_full_pct=%.2f,pswpout_total=%llu",
+                  target >> 20, peak_held >> 20, (unsigned long long)backoffs, max_some, max_full,
+                  (unsigned long long)(last.pswpout - first_pswpout));
+
+    while (set.count > 0)
+    {
+        shrink(&set);
+    }
+    free(set.chunks);
+    return ok;
+}
+
+/* Private helper function: parse sz: as a size or a percentage of MemTotal */
+static bool parse_target(const char *str, size_t mem_total, size_t *bytes)
+{
+    size_t len = strlen(str);
+    if (len > 0 && str[len - 1] != '%')
+    {
+        return bench_parse_size(str, bytes) && *bytes > 0;
+    }
+
+    int percent = len > 0 ? atoi(str) : PRESSURE_DEFAULT_PERCENT;
+    if (percent <= 0 || percent > 100)
+    {
+        return false;
+    }
+
+    *bytes = mem_total / 100 * (size_t)percent;
+    return true;
+}
+
+/* Private helper function: map one more chunk and fault it in */
+static bool grow(PressureSet *set)
+{
+    if (set->count == set->capacity)
+    {
+        return true;
+    }
+
+    MemBuffer *chunk = &set->chunks[set->count];
+    if (!mem_buffer_alloc_pages(chunk, PRESSURE_CHUNK, 0, set->pages))
+    {
+        return false;
+    }
+
+    /* Write every page so the chunk is resident and dirty, not zero-page backed */
+    for (size_t offset = 0; offset < chunk->size; offset += PRESSURE_PAGE)
+    {
+        ((volatile char *)chunk->data)[offset] = 1;
+    }
+    set->count++;
+    return true;
+}
+
+/* Private helper function: hand the most recent chunk back to the kernel */
+static void shrink(PressureSet *set)
+{
+    set->count--;
+    mem_buffer_free(&set->chunks[set->count]);
+    if (set->touch_chunk >= set->count)
+    {
+        set->touch_chunk = 0;
+        set->touch_offset = 0;
+    }
+}
+
+/* Private helper function: write one byte into the next pages of the held set */
+static uint64_t touch(PressureSet *set, uint64_t pages)
+{
+    if (set->count == 0)
+    {
+        return 0;
+    }
+
+    uint64_t done = 0;
+    while (done < pages)
+    {
+        volatile char *data = set->chunks[set->touch_chunk].data;
+        data[set->touch_offset]++;
+        done++;
+
+        set->touch_offset += PRESSURE_PAGE;
+        if (set->touch_offset >= PRESSURE_CHUNK)
+        {
+            set->touch_offset = 0;
+            set->touch_chunk = (set->touch_chunk + 1) % set->count;
+        }
+    }
+    return done;
+}
+
+/* Private helper function: read PSI, meminfo and vmstat at one point in time */
+static void take_sample(PressureSample *sample)
+{
+    memset(sample, 0, sizeof(*sample));
+    sample->time_ns = bench_now_ns();
+    sample->psi = read_psi(sample);
+    sample->mem_available = bench_mem_available();
+
+    size_t swap_total = bench_meminfo("SwapTotal");
+    size_t swap_free = bench_meminfo("SwapFree");
+    sample->swap_used = swap_total > swap_free ? swap_total - swap_free : 0;
+
+    read_vmstat(sample);
+}
+
+/* Private helper function: parse the some and full lines of /proc/pressure/memory */
+static bool read_psi(PressureSample *sample)
+{
+    FILE *file = fopen("/proc/pressure/memory", "r");
+    if (!file)
+    {
+        return false;
+    }
+
+    char line[256];
+    int found = 0;
+    while (fgets(line, sizeof(line), file))
+    {
+        double avg10, avg60, avg300;
+        unsigned long long total;
+        if (sscanf(line, "some avg10=%lf avg60=%lf avg300=%lf total=%llu", &avg10, &avg60, &avg300, &total) == 4)
+        {
+            sample->some_avg10 = avg10;
+            sample->some_total_us = total;
+            found++;
+        }
+        else if (sscanf(line, "full avg10=%lf avg60=%lf avg300=%lf total=%llu", &avg10, &avg60, &avg300, &total) == 4)
+        {
+            sample->full_avg10 = avg10;
+            sample->full_total_us = total;
+            found++;
+        }
+    }
+    fclose(file);
+    return found > 0;
+}
+
+/* Private helper function: pick the reclaim and swap counters out of /proc/vmstat */
+static void read_vmstat(PressureSample *sample)
+{
+    FILE *file = fopen("/proc/vmstat", "r");
+    if (!file)
+    {
+        return;
+    }
+
+    char name[64];
+    unsigned long long value;
+    while (fscanf(file, "%63s %llu", name, &value) == 2)
+    {
+        if (strcmp(name, "pgscan_kswapd") == 0)
+            sample->pgscan_kswapd = value;
+        else if (strcmp(name, "pgscan_direct") == 0)
+            sample->pgscan_direct = value;
+        else if (strcmp(name, "pgsteal_kswapd") == 0 || strcmp(name, "pgsteal_direct") == 0)
+            sample->pgsteal += value;
+        else if (strcmp(name, "pswpin") == 0)
+            sample->pswpin = value;
+        else if (strcmp(name, "pswpout") == 0)
+            sample->pswpout = value;
+    }
+    fclose(file);
+}
+
+/* Private helper function: sleep for a number of nanoseconds */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}
@@ -0,0 +1,238 @@
+/**
+ * SMT Interference Test Implementation
+ *
+ * This file runs the stress generator's kernels alone and in pairs on two
+ * SMT siblings and turns the throughput ratios into an interference
+ * matrix. A value of 1.00 means the co-runner costs nothing; 0.50 means
+ * the workload ran at half its solo speed.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Include our header files */
+#include "smt_test.h"
+#include "bench_util.h"
+#include "cpu_stress.h"
+#include "logger.h"
+#include "topology.h"
+
+/* Define constants */
+#define SMT_WORKLOAD_COUNT 5
+#define SMT_DEFAULT_RUN_NS 1000000000ULL /* 1 s per run without a duration */
+#define SMT_MIN_RUN_NS 500000000ULL
+#define SMT_WARMUP_NS 100000000ULL
+
+static const CpuWorkload smt_workloads[SMT_WORKLOAD_COUNT] = {
+    CPU_WORK_INT, CPU_WORK_FP, CPU_WORK_SIMD, CPU_WORK_MEM, CPU_WORK_BRANCH};
+
+/* Private helper function prototypes */
+static bool measure(const int *cpus, const CpuWorkload *workloads, int count,
+                    bool verify, uint64_t run_ns, double *rates);
+static void sleep_ns(uint64_t ns);
+static bool pick_core(const ComponentConfig *comp, int *cpu_a, int *cpu_b);
+
+/**
+ * Run the SMT interference matrix
+ */
+bool smt_test_run(const ComponentConfig *comp)
+{
+    int cpus[2];
+    if (!pick_core(comp, &cpus[0], &cpus[1]))
+    {
+        logger_warning("SMT: no core with two online hardware threads, skipping interference test");
+        logger_metric("smt_interference", "status=skipped,reason=no_smt_siblings");
+        return true;
+    }
+
+    /* Solo runs plus every unordered pair, including a workload against itself */
+    int run_count = SMT_WORKLOAD_COUNT + SMT_WORKLOAD_COUNT * (SMT_WORKLOAD_COUNT + 1) / 2;
+    uint64_t run_ns = SMT_DEFAULT_RUN_NS;
+    if (comp->duration > 0)
+    {
+        run_ns = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)run_count;
+        if (run_ns < SMT_MIN_RUN_NS)
+        {
+            run_ns = SMT_MIN_RUN_NS;
+        }
+    }
+    bool verify = comp->options.cpu.verify;
+
+    logger_info("SMT: measuring siblings CPU %d and CPU %d, %d runs of %.2f s",
+                cpus[0], cpus[1], run_count, (double)run_ns / 1e9);
+
+    double solo[SMT_WORKLOAD_COUNT];
+    double matrix[SMT_WORKLOAD_COUNT][SMT_WORKLOAD_COUNT];
+
+    for (int i = 0; i < SMT_WORKLOAD_COUNT; i++)
+    {
+        if (!measure(cpus, &smt_workloads[i], 1, verify, run_ns, &solo[i]) || solo[i] <= 0.0)
+        {
+            logger_error("SMT: solo run of %s failed", cpu_stress_workload_name(smt_workloads[i]));
+            return false;
+        }
+        logger_metric("smt_solo", "workload=%s,cpu=%d,iterations_per_sec=%.1f",
+                      cpu_stress_workload_name(smt_workloads[i]), cpus[0], solo[i]);
+    }
+
+    for (int i = 0; i < SMT_WORKLOAD_COUNT; i++)
+    {
+        for (int j = i; j < SMT_WORKLOAD_COUNT; j++)
+        {
+            CpuWorkload pair[2] = {smt_workloads[i], smt_workloads[j]};
+            double rates[2];
+            if (!measure(cpus, pair, 2, verify, run_ns, rates))
+            {
+                logger_error("SMT: paired run %s + %s failed",
+                             cpu_stress_workload_name(pair[0]), cpu_stress_workload_name(pair[1]));
+                return false;
+            }
+
+            /*
+             * Siblings are symmetric, so one run fills both mirrored cells.
+             * On the diagonal both siblings ran the same workload, so the
+             * cell takes their mean.
+             */
+            if (i == j)
+            {
+                matrix[i][i] = (rates[0] + rates[1]) / 2.0 / solo[i];
+            }
+            else
+            {
+                matrix[i][j] = rates[0] / solo[i];
+                matrix[j][i] = rates[1] / solo[j];
+            }
+        }
+    }
+
+    char line[256];
+    int len = snprintf(line, sizeof(line), "SMT: %-8s", "run\\with");
+    for (int j = 0; j < SMT_WORKLOAD_COUNT; j++)
+    {
+        len += snprintf(line + len, sizeof(line) - (size_t)len, " %8s",
+                        cpu_stress_workload_name(smt_workloads[j]));
+    }
+    logger_info("%s", line);
+
+    for (int i = 0; i < SMT_WORKLOAD_COUNT; i++)
+    {
+        len = snprintf(line, sizeof(line), "SMT: %-8s", cpu_stress_workload_name(smt_workloads[i]));
+        for (int j = 0; j < SMT_WORKLOAD_COUNT; j++)
+        {
+            len += snprintf(line + len, sizeof(line) - (size_t)len, " %8.2f", matrix[i][j]);
+            logger_metric("smt_interference",
+                          "workload=%s,corunner=%s,cpu=%d,sibling=%d,relative_throughput=%.3f",
+                          cpu_stress_workload_name(smt_workloads[i]),
+                          cpu_stress_workload_name(smt_workloads[j]),
+                          cpus[0], cpus[1], matrix[i][j]);
+        }
+        logger_info("%s", line);
+    }
+
+    return true;
+}
+
+/* Private helper function to find two sibling hardware threads */
+static bool pick_core(const ComponentConfig *comp, int *cpu_a, int *cpu_b)
+{
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        return false;
+    }
+
+    bool found = false;
+    if (comp->options.cpu.core_count > 0)
+    {
+        int sibling = topology_smt_sibling(&topo, comp->options.cpu.cores[0]);
+        if (sibling >= 0)
+        {
+            *cpu_a = comp->options.cpu.cores[0];
+            *cpu_b = sibling;
+            found = true;
+        }
+    }
+
+    for (int i = 0; i < topo.count && !found; i++)
+    {
+        int sibling = topology_smt_sibling(&topo, topo.cpus[i].cpu);
+        if (sibling >= 0)
+        {
+            *cpu_a = topo.cpus[i].cpu;
+            *cpu_b = sibling;
+            found = true;
+        }
+    }
+
+    topology_free(&topo);
+    return found;
+}
+
+/*
+ * Private helper function to run one worker per entry (workload k on cpus[k])
+ * and report each worker's steady-state iterations per second.
+ */
+static bool measure(const int *cpus, const CpuWorkload *workloads, int count,
+                    bool verify, uint64_t run_ns, double *rates)
+{
+    CpuStress stress[2];
+    uint64_t before[2];
+    int started = 0;
+    bool ok = true;
+
+    for (int k = 0; k < count; k++)
+    {
+        if (!cpu_stress_start(&stress[k], &cpus[k], 1, workloads[k], verify))
+        {
+            ok = false;
+            break;
+        }
+        started++;
+    }
+
+    if (ok)
+    {
+        sleep_ns(SMT_WARMUP_NS);
+        uint64_t t0 = bench_now_ns();
+        for (int k = 0; k < count; k++)
+        {
+            before[k] = cpu_stress_iterations(&stress[k]);
+        }
+
+        sleep_ns(run_ns);
+
+        uint64_t elapsed = bench_now_ns() - t0;
+        for (int k = 0; k < count; k++)
+        {
+            rates[k] = (double)(cpu_stress_iterations(&stress[k]) - before[k]) * 1e9 / (double)elapsed;
+        }
+    }
+
+    for (int k = 0; k < started; k++)
+    {
+        cpu_stress_stop(&stress[k]);
+        if (stress[k].workers[0].mismatches > 0)
+        {
+            logger_error("SMT: CPU %d reported %llu verification mismatches",
+                         stress[k].workers[0].cpu,
+                         (unsigned long long)stress[k].workers[0].mismatches);
+            ok = false;
+        }
+        cpu_stress_free(&stress[k]);
+    }
+    return ok;
+}
+
+/* Private helper function to sleep for a number of nanoseconds */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    while (nanosleep(&ts, &ts) != 0)
+    {
+    }
+}
@@ -0,0 +1,382 @@
+/**
+ * Thread and Process Creation Test Implementation
+ *
+ * This file implements the creation rate benchmark. A set of spawner
+ * threads repeatedly creates and reaps one kind of task until the case
+ * budget expires; every create-to-reap interval is recorded as a latency
+ * sample and the total count gives operations per second.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+/* Include our header files */
+#include "spawn_test.h"
+#include "bench_util.h"
+#include "logger.h"
+
+/* Define constants */
+#define SPAWN_MAX_SAMPLES_PER_THREAD (1u << 17)
+#define SPAWN_MAX_SPAWNERS 64
+#define SPAWN_DEFAULT_CASE_NS 500000000ULL /* 0.5 s per case without a duration */
+#define SPAWN_MIN_CASE_NS 200000000ULL
+#define SPAWN_RSS_FRACTION 4 /* Never hold more than 1/4 of available memory */
+
+extern char **environ;
+
+/* Kinds of task creation under test */
+typedef enum
+{
+    SPAWN_THREAD,
+    SPAWN_FORK,
+    SPAWN_VFORK_EXEC,
+    SPAWN_POSIX_SPAWN,
+    SPAWN_CLONE
+} SpawnOp;
+
+/* Per-spawner state */
+typedef struct
+{
+    pthread_t thread;
+    SpawnOp op;
+    uint64_t deadline;
+    uint64_t *samples;
+    size_t sample_count;
+    uint64_t ops;
+    bool ok;
+} Spawner;
+
+static const char *const op_names[] = {
+    "pthread_create", "fork", "vfork_exec", "posix_spawn", "clone"};
+
+/* Parent resident set sizes for the clone cases, in MB */
+static const size_t rss_sizes_mb[] = {0, 64, 512, 2048, 8192};
+
+static const char *true_binary = NULL;
+
+/* Private helper function prototypes */
+static bool run_case(SpawnOp op, int spawners, size_t rss_mb, uint64_t budget_ns, uint64_t *samples);
+static void *spawner_main(void *arg);
+static bool spawn_once(SpawnOp op);
+static void *empty_thread(void *arg);
+static bool reap(pid_t pid);
+static const char *find_true_binary(void);
+static int build_levels(int *levels, int max);
+
+/**
+ * Run the creation rate suite
+ */
+bool spawn_test_run(const ComponentConfig *comp)
+{
+    int levels[16];
+    int level_count = build_levels(levels, 16);
+
+    true_binary = find_true_binary();
+    if (!true_binary)
+    {
+        logger_warning("Spawn: no 'true' binary found, skipping exec-based cases");
+    }
+
+    /* Only run clone sizes that fit comfortably in available memory */
+    size_t rss_limit_mb = (bench_mem_available() >> 20) / SPAWN_RSS_FRACTION;
+    int rss_count = 0;
+    for (size_t i = 0; i < sizeof(rss_sizes_mb) / sizeof(rss_sizes_mb[0]); i++)
+    {
+        if (rss_sizes_mb[i] <= rss_limit_mb)
+        {
+            rss_count++;
+        }
+    }
+
+    int ops_per_level = (true_binary ? 4 : 2) + rss_count;
+    int case_count = ops_per_level * level_count;
+    uint64_t budget_ns = SPAWN_DEFAULT_CASE_NS;
+    if (comp->duration > 0)
+    {
+        budget_ns = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)case_count;
+        if (budget_ns < SPAWN_MIN_CASE_NS)
+        {
+            budget_ns = SPAWN_MIN_CASE_NS;
+        }
+    }
+
+    uint64_t *samples = malloc(sizeof(uint64_t) * SPAWN_MAX_SAMPLES_PER_THREAD * (size_t)levels[level_count - 1]);
+    if (!samples)
+    {
+        logger_error("Spawn: failed to allocate sample buffer");
+        return false;
+    }
+
+    logger_info("Spawn: running %d cases, %.2f s each, up to %d spawners",
+                case_count, (double)budget_ns / 1e9, levels[level_count - 1]);
+
+    bool ok = true;
+    for (int l = 0; l < level_count; l++)
+    {
+        ok = run_case(SPAWN_THREAD, levels[l], 0, budget_ns, samples) && ok;
+        ok = run_case(SPAWN_FORK, levels[l], 0, budget_ns, samples) && ok;
+        if (true_binary)
+        {
+            ok = run_case(SPAWN_VFORK_EXEC, levels[l], 0, budget_ns, samples) && ok;
+            ok = run_case(SPAWN_POSIX_SPAWN, levels[l], 0, budget_ns, samples) && ok;
+        }
+    }
+
+    for (size_t i = 0; i < sizeof(rss_sizes_mb) / sizeof(rss_sizes_mb[0]); i++)
+    {
+        size_t size_mb = rss_sizes_mb[i];
+        if (size_mb > rss_limit_mb)
+        {
+            logger_info("Spawn: skipping clone with %zu MB resident, only %zu MB usable",
+                        size_mb, rss_limit_mb);
+            continue;
+        }
+
+        /* Touch every page so the child has page tables to copy */
+        void *ballast = NULL;
+        size_t bytes = size_mb << 20;
+        if (bytes > 0)
+        {
+            ballast = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (ballast == MAP_FAILED)
+            {
+                logger_warning("Spawn: unable to map %zu MB ballast: %s", size_mb, strerror(errno));
+                continue;
+            }
+            memset(ballast, 0xa5, bytes);
+        }
+
+        for (int l = 0; l < level_count; l++)
+        {
+            ok = run_case(SPAWN_CLONE, levels[l], size_mb, budget_ns, samples) && ok;
+        }
+
+        if (ballast)
+        {
+            munmap(ballast, bytes);
+        }
+    }
+
+    free(samples);
+    return ok;
+}
+
+/* Private helper function to run one operation at one concurrency level */
+static bool run_case(SpawnOp op, int spawners, size_t rss_mb, uint64_t budget_ns, uint64_t *samples)
+{
+    Spawner workers[SPAWN_MAX_SPAWNERS];
+    uint64_t start = bench_now_ns();
+    int started = 0;
+
+    for (int i = 0; i < spawners; i++)
+    {
+        workers[i] = (Spawner){0};
+        workers[i].op = op;
+        workers[i].deadline = start + budget_ns;
+        workers[i].samples = samples + (size_t)i * SPAWN_MAX_SAMPLES_PER_THREAD;
+
+        if (pthread_create(&workers[i].thread, NULL, spawner_main, &workers[i]) != 0)
+        {
+            logger_error("Spawn: failed to start spawner thread %d", i);
+            break;
+        }
+        started++;
+    }
+
+    bool ok = (started == spawners);
+    uint64_t total_ops = 0;
+    size_t total_samples = 0;
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].thread, NULL);
+        ok = ok && workers[i].ok;
+        total_ops += workers[i].ops;
+
+        /* Compact every spawner's samples into one contiguous run */
+        memmove(samples + total_samples, workers[i].samples, workers[i].sample_count * sizeof(uint64_t));
+        total_samples += workers[i].sample_count;
+    }
+    uint64_t elapsed = bench_now_ns() - start;
+
+    if (!ok)
+    {
+        logger_error("Spawn: %s with %d spawners failed", op_names[op], spawners);
+        return false;
+    }
+
+    LatencySummary summary;
+    bench_summarize(samples, total_samples, &summary);
+    double rate = elapsed > 0 ? (double)total_ops * 1e9 / (double)elapsed : 0.0;
+
+    logger_info("Spawn: %-14s rss %5zu MB, %2d spawners: %.0f ops/s, p50 %.1f us, p99 %.1f us",
+                op_names[op], rss_mb, spawners, rate,
+                (double)summary.p50 / 1000.0, (double)summary.p99 / 1000.0);
+    logger_metric("spawn_rate",
+                  "op=%s,rss_mb=%zu,spawners=%d,ops=%llu,ops_per_sec=%.1f,avg_ns=%.0f,p50_ns=%llu,"
+                  "p90_ns=%llu,p99_ns=%llu,p999_ns=%llu,max_ns=%llu",
+                  op_names[op], rss_mb, spawners, (unsigned long long)total_ops, rate, summary.mean,
+                  (unsigned long long)summary.p50, (unsigned long long)summary.p90,
+                  (unsigned long long)summary.p99, (unsigned long long)summary.p999,
+                  (unsigned long long)summary.max);
+    return true;
+}
+
+/* Private helper function: spawner thread loop */
+static void *spawner_main(void *arg)
+{
+    Spawner *sp = arg;
+    sp->ok = true;
+
+    for (;;)
+    {
+        uint64_t t0 = bench_now_ns();
+        if (t0 >= sp->deadline)
+        {
+            break;
+        }
+        if (!spawn_once(sp->op))
+        {
+            sp->ok = false;
+            break;
+        }
+
+        if (sp->sample_count < SPAWN_MAX_SAMPLES_PER_THREAD)
+        {
+            sp->samples[sp->sample_count++] = bench_now_ns() - t0;
+        }
+        sp->ops++;
+    }
+    return NULL;
+}
+
+/* Private helper function to create and reap one task */
+static bool spawn_once(SpawnOp op)
+{
+    char *const argv[] = {(char *)true_binary, NULL};
+    pid_t pid;
+
+    switch (op)
+    {
+    case SPAWN_THREAD:
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, empty_thread, NULL) != 0)
+        {
+            return false;
+        }
+        return pthread_join(thread, NULL) == 0;
+    }
+
+    case SPAWN_FORK:
+        pid = fork();
+        if (pid == 0)
+        {
+            _exit(0);
+        }
+        return reap(pid);
+
+    case SPAWN_VFORK_EXEC:
+        pid = vfork();
+        if (pid == 0)
+        {
+            execve(true_binary, argv, environ);
+            _exit(127);
+        }
+        return reap(pid);
+
+    case SPAWN_POSIX_SPAWN:
+        if (posix_spawn(&pid, true_binary, NULL, NULL, argv, environ) != 0)
+        {
+            return false;
+        }
+        return reap(pid);
+
+    case SPAWN_CLONE:
+        /* Without CLONE_VM this copies the address space like fork() */
+        pid = (pid_t)syscall(SYS_clone, SIGCHLD, NULL, NULL, NULL, NULL);
+        if (pid == 0)
+        {
+            _exit(0);
+        }
+        return reap(pid);
+
+    default:
+        return false;
+    }
+}
+
+/* Private helper function: body of the threads created by SPAWN_THREAD */
+static void *empty_thread(void *arg)
+{
+    return arg;
+}
+
+/* Private helper function to wait for a child and check it exited cleanly */
+static bool reap(pid_t pid)
+{
+    if (pid < 0)
+    {
+        return false;
+    }
+
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return false;
+        }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/* Private helper function to locate a trivial binary to exec */
+static const char *find_true_binary(void)
+{
+    static const char *const candidates[] = {"/bin/true", "/usr/bin/true"};
+    for (size_t i = 0; i < sizeof(candidates) / sizeof(candidates[0]); i++)
+    {
+        if (access(candidates[i], X_OK) == 0)
+        {
+            return candidates[i];
+        }
+    }
+    return NULL;
+}
+
+/* Private helper function to build 1, 2, 4, ... spawner counts up to the CPU count */
+static int build_levels(int *levels, int max)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus < 1)
+    {
+        cpus = 1;
+    }
+    if (cpus > SPAWN_MAX_SPAWNERS)
+    {
+        cpus = SPAWN_MAX_SPAWNERS;
+    }
+
+    int count = 0;
+    for (long n = 1; n < cpus && count < max - 1; n *= 2)
+    {
+        levels[count++] = (int)n;
+    }
+    levels[count++] = (int)cpus;
+    return count;
+}
@@ -1 +1,1762 @@
-# Storage testing functions
+/**
+ * Storage Test Implementation
+ *
+ * This file implements the storage I/O engine. The test files are written
+ * out sequentially first, synced and dropped from the page cache, then
+ * reopened (with O_DIRECT if requested) by every worker thread. Workers
+ * choose read or write by the read ratio and the offset by the access
+ * pattern, and record latencies into their own histograms. The sync and
+ * psync engines issue one blocking I/O at a time; the uring engine keeps
+ * a queue of I/Os in flight on a ring per thread, with registered buffers
+ * and files, submitting and reaping in batches. The main thread wakes
+ * once per interval, collects what every worker's histograms gained
+ * without stopping them and logs the merged rates and latency
+ * percentiles next to the CPU time the process used, so engines can be
+ * compared by IOPS per core. The whole run's histograms are saved next
+ * to the logs.
+ *
+ * With a target rate the workers run open-loop: every thread follows its
+ * own schedule of intended start times (evenly spaced or Poisson) and
+ * latency is measured from the intended start, so time spent behind
+ * schedule while the device stalls is counted instead of silently
+ * omitted.
+ *
+ * In verify mode every block carries a header naming its position, the
+ * generation (how many times it has been written) and the seed of its
+ * payload, protected by a CRC32C over the rest of the block. Each thread
+ * owns its stripe of blocks and the expected generation of every block,
+ * so each read is checked as it completes and the whole area is read
+ * back from the device once more at the end. A bad CRC is a torn or
+ * corrupted block, a header naming another block a misdirected write and
+ * an older generation a stale (lost) write.
+ *
+ * Written data, the layout included, comes from the data generator with
+ * the requested compressibility and share of duplicate blocks; every
+ * write generates its block afresh, so the device never sees one buffer
+ * over and over.
+ *
+ * Preconditioning follows the SNIA Solid State Storage PTS: after the
+ * layout every file is written sequentially once more (twice in all),
+ * then the workers run 100% random writes in rounds until the write
+ * IOPS of the last five rounds stay within 20% of their average and the
+ * best-fit line through them drifts by no more than 10%, or 25 rounds
+ * pass. Only then does the measured run start, so a fresh or trimmed
+ * SSD is not measured while its write performance is still falling.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/statvfs.h>
+
+/* Include our header files */
+#include "storage_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "crc32c.h"
+#include "data_gen.h"
+#include "histogram.h"
+#include "mem_buffer.h"
+#include "uring.h"
+#include "wal_test.h"
+#include "meta_test.h"
+
+/* Define constants */
+#define STORAGE_DEFAULT_FILE_SIZE (256ULL << 20)
+#define STORAGE_DEFAULT_BLOCK_SIZE 4096
+#define STORAGE_DEFAULT_READ_PCT 50
+#define STORAGE_DEFAULT_URING_DEPTH 32
+#define STORAGE_MAX_DEPTH 1024
+#define STORAGE_SQPOLL_IDLE_MS 1000
+#define STORAGE_MAX_FILES 1024
+#define STORAGE_MAX_THREADS 256
+#define STORAGE_DIRECT_ALIGN 4096          /* Buffer alignment that satisfies any logical block size */
+#define STORAGE_LAYOUT_CHUNK (1ULL << 20)
+#define STORAGE_INTERVAL_NS 1000000000ULL  /* 1 s */
+#define STORAGE_OPEN_WAIT_NS 10000000ULL   /* Longest open-loop sleep before checking the stop flag */
+#define STORAGE_LINE_SIZE 64
+#define STORAGE_BLOCK_MAGIC 0x4B425243U    /* "CRBK" */
+#define STORAGE_BUSY 0x80000000U           /* Generation flag: an I/O on the block is in flight */
+#define STORAGE_MAX_RECORDED 8             /* Corruptions kept per thread, and for the final pass */
+#define STORAGE_DEFAULT_ROUND_S 60         /* Preconditioning round length */
+#define STORAGE_SS_WINDOW 5                /* Rounds the steady-state test looks at */
+#define STORAGE_SS_MAX_ROUNDS 25           /* Rounds before giving up on steady state */
+#define STORAGE_SS_RANGE 0.20              /* Largest max-min spread in the window, share of its average */
+#define STORAGE_SS_SLOPE 0.10              /* Largest best-fit line excursion across the window, share of its average */
+
+typedef enum
+{
+    ENGINE_PSYNC,
+    ENGINE_SYNC,
+    ENGINE_URING,
+    ENGINE_COUNT
+} StorageEngine;
+
+typedef enum
+{
+    IO_READ,
+    IO_WRITE,
+    IO_DIR_COUNT
+} IoDir;
+
+typedef enum
+{
+    VERIFY_TORN,        /* CRC mismatch: partially written or corrupted */
+    VERIFY_STALE,       /* Valid block of an older generation: a lost write */
+    VERIFY_MISDIRECTED, /* Valid block that belongs somewhere else */
+    VERIFY_KIND_COUNT
+} VerifyKind;
+
+/* Start of every block in verify mode; the CRC covers everything after it */
+typedef struct
+{
+    uint32_t crc;
+    uint32_t magic;
+    uint64_t block;      /* Index of the block across all files */
+    uint64_t generation; /* Writes to the block so far, 0 for the layout */
+    uint64_t seed;       /* Payload generator seed */
+} BlockHeader;
+
+/* One block that failed its check */
+typedef struct
+{
+    uint64_t block;
+    VerifyKind kind;
+    uint64_t expected_gen;
+    uint64_t found_gen;
+    uint64_t found_block; /* Block the header claims to be */
+    int64_t bad_byte;     /* First byte that differs from the header's own payload, -1 if the header is damaged */
+} Corruption;
+
+/* Checks done and failures found by one thread or pass */
+typedef struct
+{
+    uint64_t checked;
+    uint64_t found[VERIFY_KIND_COUNT];
+    Corruption recorded[STORAGE_MAX_RECORDED];
+    int recorded_count;
+} VerifyLog;
+
+struct StorageJob;
+
+/* Per-thread state, one cache line apart */
+typedef struct
+{
+    pthread_t thread;
+    struct StorageJob *job;
+    int index;
+    int *fds;              /* This thread's descriptors, one per file */
+    MemBuffer buffer;      /* One block, or one per queue slot for uring */
+    Uring ring;            /* uring engine only */
+    uint64_t *slot_start;  /* Submission time per queue slot */
+    unsigned char *slot_dir;
+    uint64_t *slot_block;  /* Block per queue slot, verify mode only */
+    DataGen gen;           /* Write data */
+    uint64_t rng;
+    uint64_t cursor;       /* Next block of the sequential stripe */
+    uint64_t stripe_start;
+    uint64_t stripe_blocks;
+    double next_due;       /* Intended start of the next open-loop I/O, ns */
+    uint64_t issued;       /* Open-loop I/Os started, read by the main thread */
+    uint64_t max_lag;      /* Worst start behind schedule, swapped out by the main thread */
+    Histogram *live;       /* Latency per direction, recorded only by this thread */
+    Histogram *seen;       /* What the main thread has already collected from live */
+    VerifyLog verify;      /* Read checks, verify mode only */
+    int error;             /* errno of the failed I/O, 0 if none */
+} __attribute__((aligned(STORAGE_LINE_SIZE))) StorageWorker;
+
+/* Shared job description */
+typedef struct StorageJob
+{
+    StorageEngine engine;
+    unsigned queue_depth;
+    unsigned ring_flags;   /* IORING_SETUP_* for the uring engine */
+    int file_count;
+    size_t file_size;
+    size_t block_size;
+    uint64_t blocks_per_file;
+    int read_pct;
+    bool sequential;
+    double thread_rate;    /* Open-loop I/Os per second per thread, 0 for closed loop */
+    bool poisson;
+    uint64_t epoch;        /* Start of the open-loop schedule */
+    uint64_t rate_lag_max; /* Worst start behind schedule over the run, main thread only */
+    DataProfile data;      /* Write data targets and seed, verify payloads included */
+    bool verify;
+    uint32_t *generations; /* Expected generation per block, each written only by the owning thread */
+    bool stop;
+    StorageWorker *workers;
+    int thread_count;
+    Histogram *interval;   /* Scratch for one worker's interval, main thread only */
+    Histogram *merged;     /* All workers' interval, main thread only */
+    Histogram *totals;     /* Whole run per direction, main thread only */
+    uint64_t worst_p99[IO_DIR_COUNT];
+} StorageJob;
+
+static const char *const dir_names[IO_DIR_COUNT] = {"read", "write"};
+static const char *const engine_names[ENGINE_COUNT] = {"psync", "sync", "uring"};
+static const char *const verify_names[VERIFY_KIND_COUNT] = {"torn", "stale", "misdirected"};
+
+/* Private helper function prototypes */
+static bool create_files(StorageJob *job, const char *dir, char (*paths)[512]);
+static bool fill_file(StorageJob *job, int fd, int index, unsigned char *chunk, size_t chunk_size, DataGen *gen,
+                      bool report);
+static bool precondition(StorageJob *job, char (*paths)[512], bool direct, int round_s);
+static bool steady_state(const double *iops, int count, double *avg, double *range, double *excursion);
+static int start_workers(StorageJob *job);
+static bool stop_workers(StorageJob *job, int started);
+static bool workers_failed(StorageJob *job, int started);
+static uint64_t discard_interval(StorageJob *job, IoDir dir);
+static void collect_tail(StorageJob *job, int started);
+static void remove_files(char (*paths)[512], int count);
+static bool setup_worker(StorageWorker *worker, char (*paths)[512], bool direct);
+static void teardown_worker(StorageWorker *worker);
+static void *storage_worker(void *arg);
+static uint64_t next_io(StorageWorker *worker, IoDir *dir);
+static void run_sync(StorageWorker *worker);
+static void run_uring(StorageWorker *worker);
+static uint64_t take_slot(StorageWorker *worker, uint64_t now);
+static bool wait_until(StorageWorker *worker, uint64_t when);
+static void begin_io(StorageWorker *worker, uint64_t block, IoDir dir, unsigned char *buf);
+static void end_io(StorageWorker *worker, uint64_t block, IoDir dir, const unsigned char *buf);
+static void stamp_block(const StorageJob *job, DataGen *gen, unsigned char *buf, uint64_t block, uint64_t generation);
+static bool check_block(const StorageJob *job, const unsigned char *buf, uint64_t block, uint64_t generation,
+                        VerifyLog *log);
+static bool verify_files(StorageJob *job, char (*paths)[512], bool direct, VerifyLog *log);
+static void report_corruption(const StorageJob *job, char (*paths)[512], const VerifyLog *log, const char *phase);
+static void report_interval(StorageJob *job, double t_s, double secs, double cpu_s);
+static double cpu_seconds(void);
+static uint64_t next_random(uint64_t *state);
+static void sleep_ns(uint64_t ns);
+
+/**
+ * Run a storage component test
+ */
+bool storage_test_run(const ComponentConfig *comp)
+{
+    const StorageOptions *opts = &comp->options.storage;
+
+    if (strcmp(opts->workload, "wal") == 0)
+    {
+        return wal_test_run(comp);
+    }
+    if (strcmp(opts->workload, "meta") == 0)
+    {
+        return meta_test_run(comp);
+    }
+    if (opts->workload[0] != '\0' && strcmp(opts->workload, "io") != 0)
+    {
+        logger_error("Storage: unsupported workload '%s'", opts->workload);
+        return false;
+    }
+
+    size_t file_size = STORAGE_DEFAULT_FILE_SIZE;
+    if (opts->file_size[0] != '\0' && !bench_parse_size(opts->file_size, &file_size))
+    {
+        logger_error("Storage: invalid file size '%s'", opts->file_size);
+        return false;
+    }
+    size_t block_size = STORAGE_DEFAULT_BLOCK_SIZE;
+    if (opts->block_size[0] != '\0' && (!bench_parse_size(opts->block_size, &block_size) || block_size == 0))
+    {
+        logger_error("Storage: invalid block size '%s'", opts->block_size);
+        return false;
+    }
+    if (opts->direct_io && block_size % 512 != 0)
+    {
+        logger_error("Storage: O_DIRECT needs a block size that is a multiple of 512, got %zu", block_size);
+        return false;
+    }
+    if (file_size < block_size)
+    {
+        logger_error("Storage: file size %zu is smaller than the block size %zu", file_size, block_size);
+        return false;
+    }
+    file_size -= file_size % block_size;
+
+    int read_pct = opts->read_ratio < 0 ? STORAGE_DEFAULT_READ_PCT : opts->read_ratio;
+    if (read_pct > 100)
+    {
+        logger_error("Storage: read ratio %d out of range (0-100)", read_pct);
+        return false;
+    }
+
+    bool sequential = false;
+    if (strcmp(opts->pattern, "seq") == 0)
+    {
+        sequential = true;
+    }
+    else if (opts->pattern[0] != '\0' && strcmp(opts->pattern, "rand") != 0)
+    {
+        logger_error("Storage: invalid pattern '%s' (expected rand or seq)", opts->pattern);
+        return false;
+    }
+
+    StorageEngine engine = ENGINE_PSYNC;
+    if (opts->engine[0] != '\0')
+    {
+        int found = -1;
+        for (int i = 0; i < ENGINE_COUNT; i++)
+        {
+            if (strcmp(opts->engine, engine_names[i]) == 0)
+            {
+                found = i;
+            }
+        }
+        if (found < 0)
+        {
+            logger_error("Storage: invalid engine '%s' (expected psync, sync or uring)", opts->engine);
+            return false;
+        }
+        engine = (StorageEngine)found;
+    }
+    unsigned queue_depth = 1;
+    if (engine == ENGINE_URING)
+    {
+        queue_depth = opts->queue_depth > 0 ? (unsigned)opts->queue_depth : STORAGE_DEFAULT_URING_DEPTH;
+        if (queue_depth > STORAGE_MAX_DEPTH)
+        {
+            logger_error("Storage: queue depth %u above the maximum of %d", queue_depth, STORAGE_MAX_DEPTH);
+            return false;
+        }
+    }
+    else if (opts->queue_depth > 1 || opts->sqpoll || opts->iopoll)
+    {
+        logger_warning("Storage: qd:, sqp: and iop: only apply to the uring engine, ignoring them");
+    }
+    unsigned ring_flags = 0;
+    if (engine == ENGINE_URING && opts->sqpoll)
+    {
+        ring_flags |= IORING_SETUP_SQPOLL;
+    }
+    if (engine == ENGINE_URING && opts->iopoll)
+    {
+        if (!opts->direct_io)
+        {
+            logger_error("Storage: IOPOLL needs O_DIRECT (dio:true)");
+            return false;
+        }
+        ring_flags |= IORING_SETUP_IOPOLL;
+    }
+
+    if (opts->target_iops < 0)
+    {
+        logger_error("Storage: invalid target rate %d IOPS", opts->target_iops);
+        return false;
+    }
+    bool poisson = false;
+    if (strcmp(opts->arrival, "poisson") == 0)
+    {
+        poisson = true;
+    }
+    else if (opts->arrival[0] != '\0' && strcmp(opts->arrival, "const") != 0)
+    {
+        logger_error("Storage: invalid arrival process '%s' (expected const or poisson)", opts->arrival);
+        return false;
+    }
+    if (opts->arrival[0] != '\0' && opts->target_iops == 0)
+    {
+        logger_warning("Storage: arr: only applies to open-loop runs with iops:, ignoring it");
+    }
+
+    if (opts->compress_pct < 0 || opts->compress_pct > 100 || opts->dedupe_pct < 0 || opts->dedupe_pct > 100)
+    {
+        logger_error("Storage: compressibility %d%% and duplicate share %d%% must be 0-100", opts->compress_pct,
+                     opts->dedupe_pct);
+        return false;
+    }
+    if (opts->verify && opts->dedupe_pct > 0)
+    {
+        logger_warning("Storage: verify mode gives every block its own header, so dup: cannot apply; ignoring it");
+    }
+    if (opts->round_secs < 0)
+    {
+        logger_error("Storage: invalid preconditioning round length %d s", opts->round_secs);
+        return false;
+    }
+    int round_s = opts->round_secs > 0 ? opts->round_secs : STORAGE_DEFAULT_ROUND_S;
+    if (opts->round_secs > 0 && !opts->precondition)
+    {
+        logger_warning("Storage: pcr: only applies with pc:true, ignoring it");
+    }
+
+    int file_count = opts->file_count > 0 ? opts->file_count : 1;
+    if (file_count > STORAGE_MAX_FILES)
+    {
+        logger_error("Storage: at most %d files supported, %d requested", STORAGE_MAX_FILES, file_count);
+        return false;
+    }
+    int thread_count = opts->threads > 0 ? opts->threads : 1;
+    if (thread_count > STORAGE_MAX_THREADS)
+    {
+        logger_warning("Storage: limiting %d threads to %d", thread_count, STORAGE_MAX_THREADS);
+        thread_count = STORAGE_MAX_THREADS;
+    }
+    uint64_t total_blocks = (uint64_t)(file_size / block_size) * (uint64_t)file_count;
+    if (opts->verify && block_size < sizeof(BlockHeader))
+    {
+        logger_error("Storage: verify mode needs blocks of at least %zu bytes", sizeof(BlockHeader));
+        return false;
+    }
+    if (opts->verify && total_blocks / (uint64_t)thread_count <= queue_depth)
+    {
+        /* Every thread keeps to its own blocks and never has two I/Os on one block in flight */
+        logger_error("Storage: verify mode needs more than %u blocks per thread, the files hold %llu for %d threads",
+                     queue_depth, (unsigned long long)total_blocks, thread_count);
+        return false;
+    }
+
+    const char *dir = opts->directory[0] != '\0' ? opts->directory : ".";
+    struct statvfs fs;
+    if (statvfs(dir, &fs) != 0)
+    {
+        logger_error("Storage: cannot access directory '%s': %s", dir, strerror(errno));
+        return false;
+    }
+    uint64_t needed = (uint64_t)file_size * (uint64_t)file_count;
+    if ((uint64_t)fs.f_bavail * fs.f_frsize < needed)
+    {
+        logger_error("Storage: %llu MB needed in '%s', only %llu MB free", (unsigned long long)(needed >> 20), dir,
+                     (unsigned long long)(((uint64_t)fs.f_bavail * fs.f_frsize) >> 20));
+        return false;
+    }
+
+    char (*paths)[512] = calloc((size_t)file_count, sizeof(*paths));
+    StorageJob job;
+    memset(&job, 0, sizeof(job));
+    job.workers = aligned_alloc(STORAGE_LINE_SIZE, sizeof(StorageWorker) * (size_t)thread_count);
+    job.interval = malloc(sizeof(Histogram));
+    job.merged = malloc(sizeof(Histogram));
+    job.totals = malloc(sizeof(Histogram) * IO_DIR_COUNT);
+    job.generations = opts->verify ? calloc(total_blocks, sizeof(uint32_t)) : NULL;
+    if (!paths || !job.workers || !job.interval || !job.merged || !job.totals || (opts->verify && !job.generations))
+    {
+        logger_error("Storage: setup failed");
+        free(paths);
+        free(job.workers);
+        free(job.interval);
+        free(job.merged);
+        free(job.totals);
+        free(job.generations);
+        return false;
+    }
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        hist_init(&job.totals[d]);
+    }
+    memset(job.workers, 0, sizeof(StorageWorker) * (size_t)thread_count);
+    job.engine = engine;
+    job.queue_depth = queue_depth;
+    job.ring_flags = ring_flags;
+    job.file_count = file_count;
+    job.file_size = file_size;
+    job.block_size = block_size;
+    job.blocks_per_file = file_size / block_size;
+    job.read_pct = read_pct;
+    job.sequential = sequential;
+    job.thread_rate = (double)opts->target_iops / (double)thread_count;
+    job.poisson = poisson;
+    job.verify = opts->verify;
+    data_profile_init(&job.data, opts->compress_pct, opts->verify ? 0 : opts->dedupe_pct,
+                      opts->seed != 0 ? (uint64_t)opts->seed : (bench_now_ns() * 0x9E3779B97F4A7C15ULL) | 1);
+
+    logger_info("Storage: %d x %zu MB files in %s, %zu KB %s I/O, %d%% reads, %s engine, %d threads x qd %u%s%s%s",
+                file_count, file_size >> 20, dir, block_size >> 10, sequential ? "sequential" : "random",
+                read_pct, engine_names[engine], thread_count, queue_depth, opts->direct_io ? ", O_DIRECT" : "",
+                (ring_flags & IORING_SETUP_SQPOLL) ? ", SQPOLL" : "", (ring_flags & IORING_SETUP_IOPOLL) ? ", IOPOLL" : "");
+    if (opts->target_iops > 0)
+    {
+        logger_info("Storage: open loop at %d IOPS with %s arrivals, latency measured from the intended start",
+                    opts->target_iops, poisson ? "Poisson" : "constant");
+    }
+    logger_info("Storage: writing %d%% compressible data with %d%% duplicate blocks, seed 0x%llx",
+                job.data.compress_pct, job.data.dedupe_pct, (unsigned long long)job.data.seed);
+    if (job.verify)
+    {
+        logger_info("Storage: verify mode, CRC32C (%s) over every block", crc32c_impl());
+    }
+    if (opts->precondition)
+    {
+        logger_info("Storage: preconditioning with a sequential fill, then random writes in %d s rounds until "
+                    "steady state", round_s);
+    }
+
+    uint64_t layout_start = bench_now_ns();
+    if (!create_files(&job, dir, paths))
+    {
+        free(paths);
+        free(job.workers);
+        free(job.interval);
+        free(job.merged);
+        free(job.totals);
+        free(job.generations);
+        return false;
+    }
+    double layout_s = (double)(bench_now_ns() - layout_start) / 1e9;
+    logger_info("Storage: laid out %llu MB in %.1f s (%.1f MB/s)", (unsigned long long)(needed >> 20), layout_s,
+                (double)needed / 1048576.0 / layout_s);
+
+    bool ok = true;
+
+    /* Sequential and verifying threads each own a contiguous stripe across the files */
+    uint64_t stripe = total_blocks / (uint64_t)thread_count;
+    if (stripe == 0)
+    {
+        stripe = 1;
+    }
+
+    int started = 0;
+    for (int i = 0; ok && i < thread_count; i++)
+    {
+        StorageWorker *worker = &job.workers[i];
+        worker->job = &job;
+        worker->index = i;
+        worker->rng = (0x9E3779B97F4A7C15ULL * (uint64_t)(i + 1) ^ bench_now_ns()) | 1;
+        worker->stripe_start = ((uint64_t)i * stripe) % total_blocks;
+        worker->stripe_blocks = stripe;
+        data_gen_init(&worker->gen, &job.data, (uint64_t)i);
+        job.thread_count = i + 1;
+        if (!setup_worker(worker, paths, opts->direct_io))
+        {
+            ok = false;
+        }
+    }
+
+    if (ok && opts->precondition && !precondition(&job, paths, opts->direct_io, round_s))
+    {
+        ok = false;
+    }
+
+    /* The data summary covers the measured run only, so the layout and preconditioning writes are forgotten */
+    memset(job.data.pool_used, 0, sizeof(job.data.pool_used));
+    for (int i = 0; i < job.thread_count; i++)
+    {
+        DataGen *gen = &job.workers[i].gen;
+        gen->blocks = gen->duplicates = gen->bytes = gen->zero_bytes = 0;
+    }
+
+    /* Threads' constant-rate schedules are staggered so their I/Os interleave */
+    job.epoch = bench_now_ns();
+    for (int i = 0; ok && job.thread_rate > 0.0 && i < job.thread_count; i++)
+    {
+        job.workers[i].next_due = (double)job.epoch + 1e9 / job.thread_rate * (double)i / (double)job.thread_count;
+    }
+
+    if (ok)
+    {
+        started = start_workers(&job);
+        ok = started == job.thread_count;
+    }
+
+    uint64_t start = bench_now_ns();
+    double cpu_start = cpu_seconds();
+    uint64_t duration = (uint64_t)comp->duration * 1000000000ULL;
+    if (ok)
+    {
+        uint64_t last = start;
+        double last_cpu = cpu_start;
+        for (uint64_t next = start + STORAGE_INTERVAL_NS;; next += STORAGE_INTERVAL_NS)
+        {
+            uint64_t target = next < start + duration ? next : start + duration;
+            uint64_t now = bench_now_ns();
+            if (target > now)
+            {
+                sleep_ns(target - now);
+            }
+            now = bench_now_ns();
+            double cpu = cpu_seconds();
+            report_interval(&job, (double)(now - start) / 1e9, (double)(now - last) / 1e9, cpu - last_cpu);
+            last = now;
+            last_cpu = cpu;
+
+            if (workers_failed(&job, started) || now - start >= duration)
+            {
+                break;
+            }
+        }
+    }
+
+    if (!stop_workers(&job, started))
+    {
+        ok = false;
+    }
+
+    /* I/Os completed while the workers stopped count too; secs already covers that time */
+    collect_tail(&job, started);
+
+    if (started > 0)
+    {
+        double secs = (double)(bench_now_ns() - start) / 1e9;
+        double cores = (cpu_seconds() - cpu_start) / secs;
+        double iops = (double)(job.totals[IO_READ].count + job.totals[IO_WRITE].count) / secs;
+        for (int d = 0; d < IO_DIR_COUNT; d++)
+        {
+            LatencySummary summary;
+            hist_summarize(&job.totals[d], &summary);
+            logger_metric("storage_io_summary", "dir=%s,ops=%llu,iops=%.0f,mbps=%.2f,lat_mean_us=%.1f,"
+                          "lat_p50_us=%.1f,lat_p90_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,lat_p9999_us=%.1f,"
+                          "lat_max_us=%.1f,worst_interval_p99_us=%.1f",
+                          dir_names[d], (unsigned long long)summary.count, (double)summary.count / secs,
+                          (double)summary.count * (double)block_size / 1048576.0 / secs, summary.mean / 1e3,
+                          (double)summary.p50 / 1e3, (double)summary.p90 / 1e3, (double)summary.p99 / 1e3,
+                          (double)summary.p999 / 1e3, (double)summary.p9999 / 1e3, (double)summary.max / 1e3,
+                          (double)job.worst_p99[d] / 1e3);
+
+            char name[64];
+            snprintf(name, sizeof(name), "storage.%d.%s", comp->order, dir_names[d]);
+            if (summary.count > 0 && !hist_save(&job.totals[d], name))
+            {
+                logger_warning("Storage: could not save the %s latency histogram", dir_names[d]);
+            }
+        }
+        logger_metric("storage_io_cpu_summary", "engine=%s,iops=%.0f,cpu_cores=%.3f,iops_per_core=%.0f",
+                      engine_names[engine], iops, cores, cores > 0.0 ? iops / cores : 0.0);
+        if (job.thread_rate > 0.0)
+        {
+            logger_metric("storage_io_rate_summary", "arrival=%s,target_iops=%d,achieved_iops=%.0f,max_lag_us=%.1f",
+                          poisson ? "poisson" : "const", opts->target_iops, iops, (double)job.rate_lag_max / 1e3);
+            if (iops < 0.95 * (double)opts->target_iops)
+            {
+                logger_warning("Storage: achieved %.0f of %d requested IOPS; latencies include the time I/Os "
+                               "waited behind the schedule", iops, opts->target_iops);
+            }
+        }
+        logger_info("Storage: %.0f read IOPS, %.0f write IOPS over %.1f s, %.2f cores, %.0f IOPS per core",
+                    (double)job.totals[IO_READ].count / secs, (double)job.totals[IO_WRITE].count / secs, secs, cores,
+                    cores > 0.0 ? iops / cores : 0.0);
+    }
+
+    if (started > 0)
+    {
+        uint64_t blocks = 0, duplicates = 0, bytes = 0, zero_bytes = 0;
+        for (int i = 0; i < started; i++)
+        {
+            blocks += job.workers[i].gen.blocks;
+            duplicates += job.workers[i].gen.duplicates;
+            bytes += job.workers[i].gen.bytes;
+            zero_bytes += job.workers[i].gen.zero_bytes;
+        }
+        uint64_t distinct = blocks - duplicates + data_profile_pool_used(&job.data);
+        double compress_pct = bytes > 0 ? 100.0 * (double)zero_bytes / (double)bytes : 0.0;
+        double dedupe_pct = blocks > 0 ? 100.0 * (double)duplicates / (double)blocks : 0.0;
+        double compress_ratio = bytes > zero_bytes ? (double)bytes / (double)(bytes - zero_bytes) : 0.0;
+        double dedupe_ratio = distinct > 0 ? (double)blocks / (double)distinct : 0.0;
+        logger_metric("storage_data_summary", "compress_pct=%d,dedupe_pct=%d,seed=0x%llx,blocks=%llu,"
+                      "achieved_compress_pct=%.2f,achieved_dedupe_pct=%.2f,compress_ratio=%.2f,dedupe_ratio=%.2f",
+                      job.data.compress_pct, job.data.dedupe_pct, (unsigned long long)job.data.seed,
+                      (unsigned long long)blocks, compress_pct, dedupe_pct, compress_ratio, dedupe_ratio);
+        logger_info("Storage: wrote %llu blocks, %.1f%% compressible (ratio %.2f), %.1f%% duplicates "
+                    "(dedupe ratio %.2f)",
+                    (unsigned long long)blocks, compress_pct, compress_ratio, dedupe_pct, dedupe_ratio);
+    }
+
+    if (job.verify && started == job.thread_count && ok)
+    {
+        uint64_t run_checked = 0;
+        uint64_t found[VERIFY_KIND_COUNT] = {0};
+        for (int i = 0; i < started; i++)
+        {
+            run_checked += job.workers[i].verify.checked;
+            for (int k = 0; k < VERIFY_KIND_COUNT; k++)
+            {
+                found[k] += job.workers[i].verify.found[k];
+            }
+            report_corruption(&job, paths, &job.workers[i].verify, "run");
+        }
+
+        VerifyLog final_log;
+        memset(&final_log, 0, sizeof(final_log));
+        uint64_t pass_start = bench_now_ns();
+        if (!verify_files(&job, paths, opts->direct_io, &final_log))
+        {
+            ok = false;
+        }
+        double pass_s = (double)(bench_now_ns() - pass_start) / 1e9;
+        report_corruption(&job, paths, &final_log, "final");
+        uint64_t bad = 0;
+        for (int k = 0; k < VERIFY_KIND_COUNT; k++)
+        {
+            found[k] += final_log.found[k];
+            bad += found[k];
+        }
+
+        logger_metric("storage_verify_summary", "crc=%s,seed=0x%llx,checked_run=%llu,checked_final=%llu,torn=%llu,"
+                      "stale=%llu,misdirected=%llu,final_mbps=%.1f",
+                      crc32c_impl(), (unsigned long long)job.data.seed, (unsigned long long)run_checked,
+                      (unsigned long long)final_log.checked, (unsigned long long)found[VERIFY_TORN],
+                      (unsigned long long)found[VERIFY_STALE], (unsigned long long)found[VERIFY_MISDIRECTED],
+                      pass_s > 0.0 ? (double)final_log.checked * (double)block_size / 1048576.0 / pass_s : 0.0);
+        if (bad > 0)
+        {
+            logger_error("Storage: %llu bad blocks (%llu torn, %llu stale, %llu misdirected)", (unsigned long long)bad,
+                         (unsigned long long)found[VERIFY_TORN], (unsigned long long)found[VERIFY_STALE],
+                         (unsigned long long)found[VERIFY_MISDIRECTED]);
+            ok = false;
+        }
+        else
+        {
+            logger_info("Storage: verified %llu reads during the run and %llu blocks after it in %.1f s, no corruption",
+                        (unsigned long long)run_checked, (unsigned long long)final_log.checked, pass_s);
+        }
+    }
+
+    for (int i = 0; i < job.thread_count; i++)
+    {
+        teardown_worker(&job.workers[i]);
+    }
+    remove_files(paths, file_count);
+    free(paths);
+    free(job.workers);
+    free(job.interval);
+    free(job.merged);
+    free(job.totals);
+    free(job.generations);
+    return ok;
+}
+
+/*
+ * Private helper function: write every file out in full, sync it and drop
+ * it from the page cache. Chunks hold whole blocks, each generated on its
+ * own; in verify mode they are stamped as generation 0.
+ */
+static bool create_files(StorageJob *job, const char *dir, char (*paths)[512])
+{
+    int count = job->file_count;
+    size_t per_chunk = STORAGE_LAYOUT_CHUNK / job->block_size > 0 ? STORAGE_LAYOUT_CHUNK / job->block_size : 1;
+    size_t chunk_size = per_chunk * job->block_size;
+    MemBuffer chunk;
+    if (!mem_buffer_alloc(&chunk, chunk_size, STORAGE_DIRECT_ALIGN))
+    {
+        logger_error("Storage: setup failed");
+        return false;
+    }
+    DataGen layout;
+    data_gen_init(&layout, &job->data, UINT64_MAX);
+
+    for (int i = 0; i < count; i++)
+    {
+        snprintf(paths[i], sizeof(paths[i]), "%s/crucible.%d.%d", dir, (int)getpid(), i);
+        int fd = open(paths[i], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            logger_error("Storage: cannot create %s: %s", paths[i], strerror(errno));
+            paths[i][0] = '\0';
+            remove_files(paths, i);
+            mem_buffer_free(&chunk);
+            return false;
+        }
+
+        if (!fill_file(job, fd, i, chunk.data, chunk_size, &layout, false))
+        {
+            logger_error("Storage: writing %s failed: %s", paths[i], strerror(errno));
+            close(fd);
+            remove_files(paths, i + 1);
+            mem_buffer_free(&chunk);
+            return false;
+        }
+        fsync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+
+    mem_buffer_free(&chunk);
+    return true;
+}
+
+/*
+ * Private helper function: write one file from start to end in chunks of
+ * whole blocks, each generated on its own or, in verify mode, stamped
+ * with the block's current generation. With report set, the fill rate is
+ * logged once per interval.
+ */
+static bool fill_file(StorageJob *job, int fd, int index, unsigned char *chunk, size_t chunk_size, DataGen *gen,
+                      bool report)
+{
+    size_t size = job->file_size;
+    uint64_t start = bench_now_ns();
+    uint64_t last = start;
+    size_t last_done = 0;
+
+    for (size_t done = 0; done < size;)
+    {
+        size_t len = size - done < chunk_size ? size - done : chunk_size;
+        for (size_t off = 0; off < len; off += job->block_size)
+        {
+            uint64_t block = (uint64_t)index * job->blocks_per_file + (done + off) / job->block_size;
+            if (job->verify)
+            {
+                stamp_block(job, NULL, chunk + off, block, job->generations[block]);
+            }
+            else
+            {
+                data_gen_block(gen, chunk + off, job->block_size);
+            }
+        }
+        ssize_t written = pwrite(fd, chunk, len, (off_t)done);
+        if (written != (ssize_t)len)
+        {
+            if (written >= 0)
+            {
+                errno = EIO;
+            }
+            return false;
+        }
+        done += len;
+
+        uint64_t now = bench_now_ns();
+        if (report && (now - last >= STORAGE_INTERVAL_NS || done == size))
+        {
+            double secs = (double)(now - last) / 1e9;
+            logger_metric("storage_precondition", "phase=fill,file=%d,t_s=%.1f,mbps=%.1f,done_pct=%.1f", index,
+                          (double)(now - start) / 1e9, (double)(done - last_done) / 1048576.0 / secs,
+                          100.0 * (double)done / (double)size);
+            last = now;
+            last_done = done;
+        }
+    }
+    return true;
+}
+
+/*
+ * Private helper function: SNIA PTS preconditioning. Every file is
+ * written sequentially once more, then the workers run 100% random writes
+ * (closed loop) in rounds; after each round the write IOPS are logged and
+ * the last STORAGE_SS_WINDOW rounds tested for steady state. Reaching it
+ * is not required, the run just goes on with a warning. Latencies of this
+ * phase are discarded, and in verify mode the blocks' generations carry
+ * over to the measured run.
+ */
+static bool precondition(StorageJob *job, char (*paths)[512], bool direct, int round_s)
+{
+    size_t per_chunk = STORAGE_LAYOUT_CHUNK / job->block_size > 0 ? STORAGE_LAYOUT_CHUNK / job->block_size : 1;
+    size_t chunk_size = per_chunk * job->block_size;
+    MemBuffer chunk;
+    if (!mem_buffer_alloc(&chunk, chunk_size, STORAGE_DIRECT_ALIGN))
+    {
+        logger_error("Storage: setup failed");
+        return false;
+    }
+    DataGen fill;
+    data_gen_init(&fill, &job->data, UINT64_MAX - 1);
+
+    uint64_t fill_start = bench_now_ns();
+    for (int i = 0; i < job->file_count; i++)
+    {
+        int fd = open(paths[i], O_WRONLY | (direct ? O_DIRECT : 0));
+        if (fd < 0)
+        {
+            logger_error("Storage: cannot open %s%s: %s", paths[i], direct ? " with O_DIRECT" : "", strerror(errno));
+            mem_buffer_free(&chunk);
+            return false;
+        }
+        if (!fill_file(job, fd, i, chunk.data, chunk_size, &fill, true))
+        {
+            logger_error("Storage: preconditioning %s failed: %s", paths[i], strerror(errno));
+            close(fd);
+            mem_buffer_free(&chunk);
+            return false;
+        }
+        fsync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+    mem_buffer_free(&chunk);
+    double fill_s = (double)(bench_now_ns() - fill_start) / 1e9;
+    double fill_mb = (double)job->file_size * (double)job->file_count / 1048576.0;
+    logger_info("Storage: sequential fill of %.0f MB in %.1f s (%.1f MB/s)", fill_mb, fill_s, fill_mb / fill_s);
+
+    /* Random writes at full speed; the measured run's mix and rate are put back afterwards */
+    int read_pct = job->read_pct;
+    bool sequential = job->sequential;
+    double thread_rate = job->thread_rate;
+    job->read_pct = 0;
+    job->sequential = false;
+    job->thread_rate = 0.0;
+
+    int started = start_workers(job);
+    bool ok = started == job->thread_count;
+    double iops[STORAGE_SS_MAX_ROUNDS];
+    int rounds = 0;
+    bool steady = false;
+    double avg = 0.0, range = 0.0, excursion = 0.0;
+    uint64_t start = bench_now_ns();
+    uint64_t last = start;
+    while (ok && !steady && rounds < STORAGE_SS_MAX_ROUNDS)
+    {
+        uint64_t round_end = last + (uint64_t)round_s * 1000000000ULL;
+        uint64_t now;
+        while ((now = bench_now_ns()) < round_end && !workers_failed(job, started))
+        {
+            sleep_ns(round_end - now < STORAGE_INTERVAL_NS ? round_end - now : STORAGE_INTERVAL_NS);
+        }
+        if (workers_failed(job, started))
+        {
+            ok = false;
+            break;
+        }
+
+        now = bench_now_ns();
+        double secs = (double)(now - last) / 1e9;
+        iops[rounds] = (double)discard_interval(job, IO_WRITE) / secs;
+        last = now;
+        logger_metric("storage_precondition", "phase=random,round=%d,t_s=%.1f,iops=%.0f,mbps=%.2f", rounds + 1,
+                      (double)(now - start) / 1e9, iops[rounds],
+                      iops[rounds] * (double)job->block_size / 1048576.0);
+        logger_info("Storage: preconditioning round %d: %.0f write IOPS", rounds + 1, iops[rounds]);
+        rounds++;
+
+        if (rounds >= STORAGE_SS_WINDOW)
+        {
+            steady = steady_state(&iops[rounds - STORAGE_SS_WINDOW], STORAGE_SS_WINDOW, &avg, &range, &excursion);
+        }
+    }
+
+    if (!stop_workers(job, started))
+    {
+        ok = false;
+    }
+    discard_interval(job, IO_WRITE);
+    job->read_pct = read_pct;
+    job->sequential = sequential;
+    job->thread_rate = thread_rate;
+    if (!ok)
+    {
+        return false;
+    }
+
+    char window[STORAGE_SS_WINDOW * 16] = "";
+    size_t len = 0;
+    for (int r = rounds >= STORAGE_SS_WINDOW ? rounds - STORAGE_SS_WINDOW : 0; r < rounds; r++)
+    {
+        len += (size_t)snprintf(window + len, sizeof(window) - len, "%s%.0f", len > 0 ? ";" : "", iops[r]);
+    }
+    logger_metric("storage_steady_state", "reached=%s,rounds=%d,round_s=%d,window_avg_iops=%.0f,range_pct=%.1f,"
+                  "slope_pct=%.1f,window_iops=%s",
+                  steady ? "true" : "false", rounds, round_s, avg, range * 100.0, excursion * 100.0, window);
+    if (steady)
+    {
+        logger_info("Storage: steady state after %d rounds at %.0f write IOPS (range %.1f%%, slope %.1f%%)", rounds,
+                    avg, range * 100.0, excursion * 100.0);
+    }
+    else
+    {
+        logger_warning("Storage: no steady state after %d rounds (range %.1f%%, slope %.1f%% of %.0f IOPS), "
+                       "measuring anyway", rounds, range * 100.0, excursion * 100.0, avg);
+    }
+    return true;
+}
+
+/*
+ * Private helper function: SNIA steady-state test. The spread of the
+ * window (max - min) must stay within STORAGE_SS_RANGE of its average,
+ * and the least-squares line through it may move by no more than
+ * STORAGE_SS_SLOPE of the average from the first round to the last.
+ */
+static bool steady_state(const double *iops, int count, double *avg, double *range, double *excursion)
+{
+    double sum = 0.0, min = iops[0], max = iops[0];
+    for (int i = 0; i < count; i++)
+    {
+        sum += iops[i];
+        min = iops[i] < min ? iops[i] : min;
+        max = iops[i] > max ? iops[i] : max;
+    }
+    *avg = sum / count;
+
+    double x_mean = (double)(count - 1) / 2.0;
+    double sxy = 0.0, sxx = 0.0;
+    for (int i = 0; i < count; i++)
+    {
+        sxy += ((double)i - x_mean) * (iops[i] - *avg);
+        sxx += ((double)i - x_mean) * ((double)i - x_mean);
+    }
+    double slope = sxx > 0.0 ? sxy / sxx : 0.0;
+
+    if (*avg <= 0.0)
+    {
+        *range = 0.0;
+        *excursion = 0.0;
+        return false;
+    }
+    *range = (max - min) / *avg;
+    *excursion = fabs(slope) * (double)(count - 1) / *avg;
+    return *range <= STORAGE_SS_RANGE && *excursion <= STORAGE_SS_SLOPE;
+}
+
+/* Private helper function: clear the stop flag and start every worker, returning how many started */
+static int start_workers(StorageJob *job)
+{
+    __atomic_store_n(&job->stop, false, __ATOMIC_RELAXED);
+    for (int i = 0; i < job->thread_count; i++)
+    {
+        if (pthread_create(&job->workers[i].thread, NULL, storage_worker, &job->workers[i]) != 0)
+        {
+            logger_error("Storage: failed to start thread %d", i);
+            return i;
+        }
+    }
+    return job->thread_count;
+}
+
+/* Private helper function: stop and join the started workers, logging failed I/O; false if any failed */
+static bool stop_workers(StorageJob *job, int started)
+{
+    bool ok = true;
+    __atomic_store_n(&job->stop, true, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(job->workers[i].thread, NULL);
+        if (job->workers[i].error != 0)
+        {
+            logger_error("Storage: thread %d I/O failed: %s%s", i, strerror(job->workers[i].error),
+                         job->workers[i].error == EOPNOTSUPP && (job->ring_flags & IORING_SETUP_IOPOLL)
+                             ? " (device has no poll queues for IOPOLL)"
+                             : "");
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/* Private helper function: whether any started worker has hit an I/O error */
+static bool workers_failed(StorageJob *job, int started)
+{
+    for (int i = 0; i < started; i++)
+    {
+        if (__atomic_load_n(&job->workers[i].error, __ATOMIC_RELAXED) != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Private helper function: collect one direction's I/Os since the last collection without keeping them */
+static uint64_t discard_interval(StorageJob *job, IoDir dir)
+{
+    uint64_t count = 0;
+    for (int i = 0; i < job->thread_count; i++)
+    {
+        hist_collect(&job->workers[i].live[dir], &job->workers[i].seen[dir], job->interval);
+        count += job->interval->count;
+    }
+    return count;
+}
+
+/* Private helper function: fold what the stopped workers recorded after the last interval into the run totals */
+static void collect_tail(StorageJob *job, int started)
+{
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        for (int i = 0; i < started; i++)
+        {
+            hist_collect(&job->workers[i].live[d], &job->workers[i].seen[d], job->interval);
+            hist_merge(&job->totals[d], job->interval);
+        }
+    }
+}
+
+/* Private helper function: delete the test files that were created */
+static void remove_files(char (*paths)[512], int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (paths[i][0] != '\0')
+        {
+            unlink(paths[i]);
+        }
+    }
+}
+
+/* Private helper function: open a worker's files and allocate its buffers (and ring), logging failures */
+static bool setup_worker(StorageWorker *worker, char (*paths)[512], bool direct)
+{
+    StorageJob *job = worker->job;
+    int index = worker->index;
+
+    worker->ring.fd = -1;
+    worker->fds = malloc(sizeof(int) * (size_t)job->file_count);
+    for (int i = 0; worker->fds && i < job->file_count; i++)
+    {
+        worker->fds[i] = -1;
+    }
+    worker->live = malloc(sizeof(Histogram) * IO_DIR_COUNT);
+    worker->seen = malloc(sizeof(Histogram) * IO_DIR_COUNT);
+    for (int d = 0; worker->live && worker->seen && d < IO_DIR_COUNT; d++)
+    {
+        hist_init(&worker->live[d]);
+        hist_init(&worker->seen[d]);
+    }
+    worker->slot_start = calloc(job->queue_depth, sizeof(uint64_t));
+    worker->slot_dir = calloc(job->queue_depth, 1);
+    worker->slot_block = calloc(job->queue_depth, sizeof(uint64_t));
+    if (!worker->fds || !worker->live || !worker->seen || !worker->slot_start || !worker->slot_dir ||
+        !worker->slot_block ||
+        !mem_buffer_alloc(&worker->buffer, job->block_size * job->queue_depth, STORAGE_DIRECT_ALIGN))
+    {
+        logger_error("Storage: cannot allocate buffers for thread %d", index);
+        return false;
+    }
+
+    /* Every thread has its own descriptors, which the sync engine's file offset needs */
+    for (int i = 0; i < job->file_count; i++)
+    {
+        worker->fds[i] = open(paths[i], O_RDWR | (direct ? O_DIRECT : 0));
+        if (worker->fds[i] < 0)
+        {
+            logger_error("Storage: cannot open %s%s: %s", paths[i], direct ? " with O_DIRECT" : "", strerror(errno));
+            return false;
+        }
+    }
+
+    if (job->engine != ENGINE_URING)
+    {
+        return true;
+    }
+
+    if (!uring_init(&worker->ring, job->queue_depth, job->ring_flags, STORAGE_SQPOLL_IDLE_MS))
+    {
+        logger_error("Storage: io_uring setup failed for thread %d: %s%s", index, strerror(errno),
+                     errno == EPERM ? " (SQPOLL may need CAP_SYS_NICE on older kernels)" : "");
+        return false;
+    }
+
+    struct iovec iovs[STORAGE_MAX_DEPTH];
+    for (unsigned slot = 0; slot < job->queue_depth; slot++)
+    {
+        iovs[slot].iov_base = (char *)worker->buffer.data + slot * job->block_size;
+        iovs[slot].iov_len = job->block_size;
+    }
+    if (!uring_register_buffers(&worker->ring, iovs, job->queue_depth))
+    {
+        logger_error("Storage: registering buffers failed for thread %d: %s%s", index, strerror(errno),
+                     errno == ENOMEM ? " (RLIMIT_MEMLOCK too low?)" : "");
+        return false;
+    }
+    if (!uring_register_files(&worker->ring, worker->fds, (unsigned)job->file_count))
+    {
+        logger_error("Storage: registering files failed for thread %d: %s", index, strerror(errno));
+        return false;
+    }
+    if (job->thread_rate > 0.0 && !(worker->ring.features & IORING_FEAT_EXT_ARG))
+    {
+        logger_error("Storage: open-loop uring needs timed waits (IORING_FEAT_EXT_ARG, Linux 5.11 or later)");
+        return false;
+    }
+    return true;
+}
+
+/* Private helper function: release everything setup_worker() acquired */
+static void teardown_worker(StorageWorker *worker)
+{
+    uring_exit(&worker->ring);
+    if (worker->fds)
+    {
+        for (int i = 0; i < worker->job->file_count; i++)
+        {
+            if (worker->fds[i] >= 0)
+            {
+                close(worker->fds[i]);
+            }
+        }
+    }
+    free(worker->fds);
+    free(worker->live);
+    free(worker->seen);
+    free(worker->slot_start);
+    free(worker->slot_dir);
+    free(worker->slot_block);
+    mem_buffer_free(&worker->buffer);
+}
+
+/* Private helper function: worker thread, runs its engine until stopped */
+static void *storage_worker(void *arg)
+{
+    StorageWorker *worker = arg;
+    if (worker->job->thread_rate > 0.0)
+    {
+        /* Wake up on schedule rather than up to the default 50 us late */
+        prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+    }
+    if (worker->job->engine == ENGINE_URING)
+    {
+        run_uring(worker);
+    }
+    else
+    {
+        run_sync(worker);
+    }
+    return NULL;
+}
+
+/* Private helper function: pick the next block by the access pattern and the direction by the read ratio */
+static uint64_t next_io(StorageWorker *worker, IoDir *dir)
+{
+    StorageJob *job = worker->job;
+    uint64_t total_blocks = job->blocks_per_file * (uint64_t)job->file_count;
+
+    /* A verifying thread stays inside its stripe and skips blocks it already has an I/O on */
+    uint64_t block;
+    do
+    {
+        if (job->sequential)
+        {
+            block = (worker->stripe_start + worker->cursor) % total_blocks;
+            worker->cursor = (worker->cursor + 1) % worker->stripe_blocks;
+        }
+        else if (job->verify)
+        {
+            block = worker->stripe_start + next_random(&worker->rng) % worker->stripe_blocks;
+        }
+        else
+        {
+            block = next_random(&worker->rng) % total_blocks;
+        }
+    } while (job->verify && (job->generations[block] & STORAGE_BUSY));
+    *dir = (int)(next_random(&worker->rng) % 100) < job->read_pct ? IO_READ : IO_WRITE;
+    return block;
+}
+
+/*
+ * Private helper function: one blocking I/O at a time, pread/pwrite or
+ * lseek plus read/write. Open-loop threads sleep until the next intended
+ * start and, once behind, issue back to back until they catch up.
+ */
+static void run_sync(StorageWorker *worker)
+{
+    StorageJob *job = worker->job;
+
+    while (!__atomic_load_n(&job->stop, __ATOMIC_RELAXED))
+    {
+        if (job->thread_rate > 0.0 && !wait_until(worker, (uint64_t)worker->next_due))
+        {
+            break;
+        }
+
+        IoDir dir;
+        uint64_t block = next_io(worker, &dir);
+        int fd = worker->fds[block / job->blocks_per_file];
+        off_t offset = (off_t)((block % job->blocks_per_file) * job->block_size);
+        begin_io(worker, block, dir, worker->buffer.data);
+
+        uint64_t t0 = bench_now_ns();
+        if (job->thread_rate > 0.0)
+        {
+            t0 = take_slot(worker, t0);
+        }
+        ssize_t done;
+        if (job->engine == ENGINE_PSYNC)
+        {
+            done = dir == IO_READ ? pread(fd, worker->buffer.data, job->block_size, offset)
+                                  : pwrite(fd, worker->buffer.data, job->block_size, offset);
+        }
+        else if (lseek(fd, offset, SEEK_SET) == offset)
+        {
+            done = dir == IO_READ ? read(fd, worker->buffer.data, job->block_size)
+                                  : write(fd, worker->buffer.data, job->block_size);
+        }
+        else
+        {
+            done = -1;
+        }
+        uint64_t latency = bench_now_ns() - t0;
+
+        if (done != (ssize_t)job->block_size)
+        {
+            __atomic_store_n(&worker->error, done < 0 ? errno : EIO, __ATOMIC_RELAXED);
+            break;
+        }
+
+        hist_record(&worker->live[dir], latency);
+        end_io(worker, block, dir, worker->buffer.data);
+    }
+}
+
+/*
+ * Private helper function: keep queue_depth I/Os in flight on the ring.
+ * Each pass tops the queue up, submits the batch and waits for at least
+ * one completion in the same system call, then reaps everything that has
+ * completed. After a failure or the stop flag no new I/O is queued, but
+ * the loop runs on until the ring is drained so no buffer is released
+ * while the kernel still owns it. Open-loop threads only queue I/Os whose
+ * intended start has passed and wait for a completion no longer than
+ * until the next one is due; I/Os that find every slot busy wait, and
+ * that wait is part of their latency.
+ */
+static void run_uring(StorageWorker *worker)
+{
+    StorageJob *job = worker->job;
+    unsigned free_slots[STORAGE_MAX_DEPTH];
+    struct io_uring_cqe *cqes[STORAGE_MAX_DEPTH];
+    unsigned free_count = job->queue_depth;
+    unsigned queued = 0;   /* Prepared, not yet taken by the kernel */
+    unsigned inflight = 0; /* Taken by the kernel, not yet completed */
+    int error = 0;
+
+    for (unsigned slot = 0; slot < job->queue_depth; slot++)
+    {
+        free_slots[slot] = slot;
+    }
+
+    bool open = job->thread_rate > 0.0;
+    for (;;)
+    {
+        bool stopping = error != 0 || __atomic_load_n(&job->stop, __ATOMIC_RELAXED);
+        uint64_t now = bench_now_ns();
+        while (!stopping && free_count > 0 && (!open || (uint64_t)worker->next_due <= now))
+        {
+            struct io_uring_sqe *sqe = uring_get_sqe(&worker->ring);
+            if (!sqe)
+            {
+                break;
+            }
+            unsigned slot = free_slots[--free_count];
+            IoDir dir;
+            uint64_t block = next_io(worker, &dir);
+            unsigned char *buf = (unsigned char *)worker->buffer.data + slot * job->block_size;
+            begin_io(worker, block, dir, buf);
+
+            sqe->opcode = dir == IO_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+            sqe->flags = IOSQE_FIXED_FILE;
+            sqe->fd = (int)(block / job->blocks_per_file);
+            sqe->addr = (uint64_t)(uintptr_t)buf;
+            sqe->len = (uint32_t)job->block_size;
+            sqe->off = (block % job->blocks_per_file) * job->block_size;
+            sqe->buf_index = (uint16_t)slot;
+            sqe->user_data = slot;
+            worker->slot_start[slot] = open ? take_slot(worker, now) : now;
+            worker->slot_dir[slot] = (unsigned char)dir;
+            worker->slot_block[slot] = block;
+            queued++;
+        }
+        if (inflight + queued == 0)
+        {
+            if (stopping || !open || !wait_until(worker, (uint64_t)worker->next_due))
+            {
+                break;
+            }
+            continue;
+        }
+
+        int ret;
+        if (open && !stopping && free_count > 0)
+        {
+            uint64_t due = (uint64_t)worker->next_due;
+            uint64_t timeout = due > now ? due - now : 1;
+            ret = uring_submit_timeout(&worker->ring, 1,
+                                       timeout < STORAGE_OPEN_WAIT_NS ? timeout : STORAGE_OPEN_WAIT_NS);
+        }
+        else
+        {
+            ret = uring_submit(&worker->ring, 1);
+        }
+        if (ret < 0)
+        {
+            /* Nothing can be reaped from a ring the kernel refuses to enter */
+            error = -ret;
+            break;
+        }
+        queued -= (unsigned)ret;
+        inflight += (unsigned)ret;
+
+        unsigned count = uring_peek_batch(&worker->ring, cqes, job->queue_depth);
+        now = bench_now_ns();
+        for (unsigned i = 0; i < count; i++)
+        {
+            unsigned slot = (unsigned)cqes[i]->user_data;
+            int res = cqes[i]->res;
+            if (res == (int)job->block_size)
+            {
+                hist_record(&worker->live[worker->slot_dir[slot]], now - worker->slot_start[slot]);
+                end_io(worker, worker->slot_block[slot], (IoDir)worker->slot_dir[slot],
+                       (unsigned char *)worker->buffer.data + slot * job->block_size);
+            }
+            else if (error == 0)
+            {
+                error = res < 0 ? -res : EIO;
+            }
+            free_slots[free_count++] = slot;
+        }
+        uring_cq_advance(&worker->ring, count);
+        inflight -= count;
+    }
+
+    if (error != 0)
+    {
+        __atomic_store_n(&worker->error, error, __ATOMIC_RELAXED);
+    }
+}
+
+/* Private helper function: claim the next open-loop start time, tracking how far behind schedule it is issued */
+static uint64_t take_slot(StorageWorker *worker, uint64_t now)
+{
+    StorageJob *job = worker->job;
+    uint64_t intended = (uint64_t)worker->next_due;
+
+    double gap = 1e9 / job->thread_rate;
+    if (job->poisson)
+    {
+        double u = (double)(next_random(&worker->rng) >> 11) * (1.0 / 9007199254740992.0);
+        gap *= -log(1.0 - u);
+    }
+    worker->next_due += gap;
+
+    __atomic_store_n(&worker->issued, worker->issued + 1, __ATOMIC_RELAXED);
+    if (now > intended && now - intended > __atomic_load_n(&worker->max_lag, __ATOMIC_RELAXED))
+    {
+        __atomic_store_n(&worker->max_lag, now - intended, __ATOMIC_RELAXED);
+    }
+    return intended;
+}
+
+/* Private helper function: sleep until an absolute time, returning false if the job is stopped first */
+static bool wait_until(StorageWorker *worker, uint64_t when)
+{
+    for (;;)
+    {
+        if (__atomic_load_n(&worker->job->stop, __ATOMIC_RELAXED))
+        {
+            return false;
+        }
+        uint64_t now = bench_now_ns();
+        if (now >= when)
+        {
+            return true;
+        }
+        uint64_t until = when - now > STORAGE_OPEN_WAIT_NS ? now + STORAGE_OPEN_WAIT_NS : when;
+        struct timespec ts = {(time_t)(until / 1000000000ULL), (long)(until % 1000000000ULL)};
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    }
+}
+
+/* Private helper function: generate a block about to be written; in verify mode stamp it and mark the block busy */
+static void begin_io(StorageWorker *worker, uint64_t block, IoDir dir, unsigned char *buf)
+{
+    StorageJob *job = worker->job;
+    if (!job->verify)
+    {
+        if (dir == IO_WRITE)
+        {
+            data_gen_block(&worker->gen, buf, job->block_size);
+        }
+        return;
+    }
+    uint32_t generation = job->generations[block];
+    if (dir == IO_WRITE)
+    {
+        stamp_block(job, &worker->gen, buf, block, generation + 1);
+    }
+    job->generations[block] = generation | STORAGE_BUSY;
+}
+
+/* Private helper function: in verify mode, check a block just read, or move the block to its new generation */
+static void end_io(StorageWorker *worker, uint64_t block, IoDir dir, const unsigned char *buf)
+{
+    StorageJob *job = worker->job;
+    if (!job->verify)
+    {
+        return;
+    }
+    uint32_t generation = job->generations[block] & ~STORAGE_BUSY;
+    if (dir == IO_WRITE)
+    {
+        generation++;
+    }
+    else
+    {
+        check_block(job, buf, block, generation, &worker->verify);
+    }
+    job->generations[block] = generation;
+}
+
+/*
+ * Private helper function: fill a block with the payload of one
+ * generation, then its header and CRC. Writes during the run are counted
+ * by the thread's generator; the layout passes none.
+ */
+static void stamp_block(const StorageJob *job, DataGen *gen, unsigned char *buf, uint64_t block, uint64_t generation)
+{
+    BlockHeader header;
+    header.crc = 0;
+    header.magic = STORAGE_BLOCK_MAGIC;
+    header.block = block;
+    header.generation = generation;
+    header.seed = job->data.seed ^ (block * 0x9E3779B97F4A7C15ULL) ^ (generation * 0xC2B2AE3D27D4EB4FULL);
+
+    if (gen)
+    {
+        data_gen_block_seed(gen, buf + sizeof(header), job->block_size - sizeof(header), header.seed);
+    }
+    else
+    {
+        data_gen_fill(&job->data, buf + sizeof(header), job->block_size - sizeof(header), header.seed);
+    }
+    memcpy(buf, &header, sizeof(header));
+    header.crc = crc32c(0, buf + sizeof(header.crc), job->block_size - sizeof(header.crc));
+    memcpy(buf, &header.crc, sizeof(header.crc));
+}
+
+/*
+ * Private helper function: check a block against the block and generation
+ * expected at its offset, recording a failure. For a torn block whose
+ * header is intact the payload is regenerated from the header's seed to
+ * find the first byte that differs.
+ */
+static bool check_block(const StorageJob *job, const unsigned char *buf, uint64_t block, uint64_t generation,
+                        VerifyLog *log)
+{
+    BlockHeader header;
+    memcpy(&header, buf, sizeof(header));
+    log->checked++;
+
+    VerifyKind kind;
+    if (header.magic != STORAGE_BLOCK_MAGIC ||
+        crc32c(0, buf + sizeof(header.crc), job->block_size - sizeof(header.crc)) != header.crc)
+    {
+        kind = VERIFY_TORN;
+    }
+    else if (header.block != block)
+    {
+        kind = VERIFY_MISDIRECTED;
+    }
+    else if (header.generation != generation)
+    {
+        kind = VERIFY_STALE;
+    }
+    else
+    {
+        return true;
+    }
+
+    log->found[kind]++;
+    if (log->recorded_count < STORAGE_MAX_RECORDED)
+    {
+        Corruption *bad = &log->recorded[log->recorded_count++];
+        bad->block = block;
+        bad->kind = kind;
+        bad->expected_gen = generation;
+        bad->found_gen = header.generation;
+        bad->found_block = header.block;
+        bad->bad_byte = header.magic == STORAGE_BLOCK_MAGIC ? 0 : -1;
+        size_t payload = job->block_size - sizeof(header);
+        unsigned char *expected = kind == VERIFY_TORN && bad->bad_byte == 0 ? malloc(payload) : NULL;
+        if (expected)
+        {
+            data_gen_fill(&job->data, expected, payload, header.seed);
+            for (size_t off = 0; off < payload; off++)
+            {
+                if (buf[sizeof(header) + off] != expected[off])
+                {
+                    bad->bad_byte = (int64_t)(sizeof(header) + off);
+                    break;
+                }
+            }
+            free(expected);
+        }
+    }
+    return false;
+}
+
+/*
+ * Private helper function: after the run, flush the files, drop them from
+ * the page cache and read every block back in large chunks, checking it
+ * against its final generation.
+ */
+static bool verify_files(StorageJob *job, char (*paths)[512], bool direct, VerifyLog *log)
+{
+    size_t per_chunk = STORAGE_LAYOUT_CHUNK / job->block_size > 0 ? STORAGE_LAYOUT_CHUNK / job->block_size : 1;
+    size_t chunk_size = per_chunk * job->block_size;
+    MemBuffer buffer;
+    if (!mem_buffer_alloc(&buffer, chunk_size, STORAGE_DIRECT_ALIGN))
+    {
+        logger_error("Storage: cannot allocate the verify buffer");
+        return false;
+    }
+
+    for (int i = 0; i < job->file_count; i++)
+    {
+        int fd = open(paths[i], O_RDONLY | (direct ? O_DIRECT : 0));
+        if (fd < 0)
+        {
+            logger_error("Storage: cannot reopen %s to verify it: %s", paths[i], strerror(errno));
+            mem_buffer_free(&buffer);
+            return false;
+        }
+        fsync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+
+        for (uint64_t first = 0; first < job->blocks_per_file; first += per_chunk)
+        {
+            uint64_t count = job->blocks_per_file - first < per_chunk ? job->blocks_per_file - first : per_chunk;
+            size_t len = (size_t)count * job->block_size;
+            ssize_t done = pread(fd, buffer.data, len, (off_t)(first * job->block_size));
+            if (done != (ssize_t)len)
+            {
+                logger_error("Storage: reading %s back failed: %s", paths[i],
+                             done < 0 ? strerror(errno) : "short read");
+                close(fd);
+                mem_buffer_free(&buffer);
+                return false;
+            }
+            for (uint64_t b = 0; b < count; b++)
+            {
+                uint64_t block = (uint64_t)i * job->blocks_per_file + first + b;
+                check_block(job, (const unsigned char *)buffer.data + b * job->block_size, block,
+                            job->generations[block] & ~STORAGE_BUSY, log);
+            }
+        }
+        close(fd);
+    }
+
+    mem_buffer_free(&buffer);
+    return true;
+}
+
+/* Private helper function: log the recorded corruptions of one thread or pass with their file offsets */
+static void report_corruption(const StorageJob *job, char (*paths)[512], const VerifyLog *log, const char *phase)
+{
+    uint64_t total = 0;
+    for (int k = 0; k < VERIFY_KIND_COUNT; k++)
+    {
+        total += log->found[k];
+    }
+
+    for (int e = 0; e < log->recorded_count; e++)
+    {
+        const Corruption *bad = &log->recorded[e];
+        const char *path = paths[bad->block / job->blocks_per_file];
+        unsigned long long offset = (unsigned long long)((bad->block % job->blocks_per_file) * job->block_size);
+
+        char where[64] = "header damaged";
+        if (bad->bad_byte >= 0)
+        {
+            snprintf(where, sizeof(where), "first bad byte at +%lld", (long long)bad->bad_byte);
+        }
+        logger_error("Storage: %s block in %s at offset %llu (%s check): expected block %llu generation %llu, "
+                     "found block %llu generation %llu%s%s",
+                     verify_names[bad->kind], path, offset, phase, (unsigned long long)bad->block,
+                     (unsigned long long)bad->expected_gen, (unsigned long long)bad->found_block,
+                     (unsigned long long)bad->found_gen, bad->kind == VERIFY_TORN ? ", " : "",
+                     bad->kind == VERIFY_TORN ? where : "");
+        logger_metric("storage_verify_error", "phase=%s,kind=%s,file=%s,offset=%llu,expected_block=%llu,"
+                      "expected_gen=%llu,found_block=%llu,found_gen=%llu,bad_byte=%lld",
+                      phase, verify_names[bad->kind], path, offset, (unsigned long long)bad->block,
+                      (unsigned long long)bad->expected_gen, (unsigned long long)bad->found_block,
+                      (unsigned long long)bad->found_gen, (long long)bad->bad_byte);
+    }
+    if (total > (uint64_t)log->recorded_count)
+    {
+        logger_error("Storage: %llu more bad blocks in the %s check not listed",
+                     (unsigned long long)(total - (uint64_t)log->recorded_count), phase);
+    }
+}
+
+/* Private helper function: collect every worker's histograms without stopping them, log one interval */
+static void report_interval(StorageJob *job, double t_s, double secs, double cpu_s)
+{
+    double iops[IO_DIR_COUNT], mbps[IO_DIR_COUNT];
+    LatencySummary summary[IO_DIR_COUNT];
+
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        hist_init(job->merged);
+        for (int i = 0; i < job->thread_count; i++)
+        {
+            hist_collect(&job->workers[i].live[d], &job->workers[i].seen[d], job->interval);
+            hist_merge(job->merged, job->interval);
+        }
+        hist_merge(&job->totals[d], job->merged);
+
+        hist_summarize(job->merged, &summary[d]);
+        iops[d] = secs > 0.0 ? (double)summary[d].count / secs : 0.0;
+        mbps[d] = secs > 0.0 ? (double)summary[d].count * (double)job->block_size / 1048576.0 / secs : 0.0;
+        if (summary[d].p99 > job->worst_p99[d])
+        {
+            job->worst_p99[d] = summary[d].p99;
+        }
+    }
+
+    double cores = secs > 0.0 ? cpu_s / secs : 0.0;
+    double per_core = cores > 0.0 ? (iops[IO_READ] + iops[IO_WRITE]) / cores : 0.0;
+
+    logger_info("Storage: %5.0fs read %8.0f IOPS %8.1f MB/s avg %7.1f us p99 %7.1f us | "
+                "write %8.0f IOPS %8.1f MB/s avg %7.1f us p99 %7.1f us | %.2f cores",
+                t_s, iops[IO_READ], mbps[IO_READ], summary[IO_READ].mean / 1e3, (double)summary[IO_READ].p99 / 1e3,
+                iops[IO_WRITE], mbps[IO_WRITE], summary[IO_WRITE].mean / 1e3, (double)summary[IO_WRITE].p99 / 1e3,
+                cores);
+    for (int d = 0; d < IO_DIR_COUNT; d++)
+    {
+        logger_metric("storage_io", "t_s=%.1f,dir=%s,iops=%.0f,mbps=%.2f,lat_mean_us=%.1f,lat_p50_us=%.1f,"
+                      "lat_p90_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,lat_p9999_us=%.1f,lat_max_us=%.1f",
+                      t_s, dir_names[d], iops[d], mbps[d], summary[d].mean / 1e3, (double)summary[d].p50 / 1e3,
+                      (double)summary[d].p90 / 1e3, (double)summary[d].p99 / 1e3, (double)summary[d].p999 / 1e3,
+                      (double)summary[d].p9999 / 1e3, (double)summary[d].max / 1e3);
+    }
+    logger_metric("storage_io_cpu", "t_s=%.1f,engine=%s,cpu_cores=%.3f,iops_per_core=%.0f",
+                  t_s, engine_names[job->engine], cores, per_core);
+
+    if (job->thread_rate > 0.0)
+    {
+        /* Backlog: I/Os the schedule has made due that no thread has started yet */
+        uint64_t issued = 0, lag = 0;
+        for (int i = 0; i < job->thread_count; i++)
+        {
+            issued += __atomic_load_n(&job->workers[i].issued, __ATOMIC_RELAXED);
+            uint64_t worker_lag = __atomic_exchange_n(&job->workers[i].max_lag, 0, __ATOMIC_RELAXED);
+            lag = worker_lag > lag ? worker_lag : lag;
+        }
+        double target = job->thread_rate * (double)job->thread_count;
+        double due = target * (double)(bench_now_ns() - job->epoch) / 1e9;
+        double backlog = due > (double)issued ? due - (double)issued : 0.0;
+        if (lag > job->rate_lag_max)
+        {
+            job->rate_lag_max = lag;
+        }
+        logger_metric("storage_io_rate", "t_s=%.1f,target_iops=%.0f,achieved_iops=%.0f,backlog=%.0f,max_lag_us=%.1f",
+                      t_s, target, iops[IO_READ] + iops[IO_WRITE], backlog, (double)lag / 1e3);
+    }
+}
+
+/* Private helper function: user plus system CPU time of the whole process, io_uring threads included */
+static double cpu_seconds(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0.0;
+    }
+    return (double)usage.ru_utime.tv_sec + (double)usage.ru_utime.tv_usec / 1e6 +
+           (double)usage.ru_stime.tv_sec + (double)usage.ru_stime.tv_usec / 1e6;
+}
+
+/* Private helper function: xorshift64* generator */
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+/* Private helper function: sleep for a number of nanoseconds */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}
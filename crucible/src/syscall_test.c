@@ -0,0 +1,341 @@
+/**
+ * Syscall Overhead Test Implementation
+ *
+ * This file times batches of back-to-back calls for each probe and reports
+ * the cost per call. Batching keeps the clock reads out of the result; the
+ * per-batch averages are then summarized into percentiles.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/utsname.h>
+
+/* Include our header files */
+#include "syscall_test.h"
+#include "bench_util.h"
+#include "cpu_stress.h"
+#include "logger.h"
+#include "topology.h"
+
+/* Define constants */
+#define SYSCALL_BATCH 256
+#define SYSCALL_MAX_BATCHES (1u << 18)
+#define SYSCALL_WARMUP_BATCHES 16
+#define SYSCALL_DEFAULT_CASE_NS 500000000ULL /* 0.5 s per case without a duration */
+#define SYSCALL_MIN_CASE_NS 100000000ULL
+#define VULNERABILITIES_DIR "/sys/devices/system/cpu/vulnerabilities"
+
+/* State shared by the probes */
+typedef struct
+{
+    int zero_fd;         /* Open descriptor on /dev/zero */
+    uint32_t futex_word; /* Futex nobody ever waits on */
+    size_t page_size;
+    char buffer[8];
+} ProbeContext;
+
+/* One measured kernel entry; returns false if the call failed */
+typedef bool (*ProbeFunc)(ProbeContext *ctx);
+
+typedef struct
+{
+    const char *name;
+    ProbeFunc func;
+} Probe;
+
+/* Private helper function prototypes */
+static bool probe_getpid(ProbeContext *ctx);
+static bool probe_clock_gettime(ProbeContext *ctx);
+static bool probe_read_zero(ProbeContext *ctx);
+static bool probe_futex_wake(ProbeContext *ctx);
+static bool probe_mmap_munmap(ProbeContext *ctx);
+static bool probe_sched_yield(ProbeContext *ctx);
+static bool measure_probe(const Probe *probe, ProbeContext *ctx, const char *load,
+                          uint64_t budget_ns, uint64_t *samples);
+static bool run_pass(ProbeContext *ctx, const char *load, uint64_t budget_ns, uint64_t *samples);
+static void log_environment(void);
+
+static const Probe probes[] = {
+    {"getpid", probe_getpid},
+    {"clock_gettime", probe_clock_gettime},
+    {"read_dev_zero", probe_read_zero},
+    {"futex_wake", probe_futex_wake},
+    {"mmap_munmap", probe_mmap_munmap},
+    {"sched_yield", probe_sched_yield},
+};
+#define PROBE_COUNT ((int)(sizeof(probes) / sizeof(probes[0])))
+
+/**
+ * Run the syscall overhead suite
+ */
+bool syscall_test_run(const ComponentConfig *comp)
+{
+    CpuTopology topo;
+    if (!topology_load(&topo))
+    {
+        logger_error("Syscall: unable to read CPU topology");
+        return false;
+    }
+
+    int cpu = topo.cpus[0].cpu;
+    if (comp->options.cpu.core_count > 0 && topology_find(&topo, comp->options.cpu.cores[0]))
+    {
+        cpu = comp->options.cpu.cores[0];
+    }
+
+    /* Every online CPU except the measuring one carries load in the stress pass */
+    int *others = malloc(sizeof(int) * (size_t)topo.count);
+    int other_count = 0;
+    if (!others)
+    {
+        topology_free(&topo);
+        return false;
+    }
+    for (int i = 0; i < topo.count; i++)
+    {
+        if (topo.cpus[i].cpu != cpu)
+        {
+            others[other_count++] = topo.cpus[i].cpu;
+        }
+    }
+    topology_free(&topo);
+
+    uint64_t budget_ns = SYSCALL_DEFAULT_CASE_NS;
+    if (comp->duration > 0)
+    {
+        budget_ns = (uint64_t)comp->duration * 1000000000ULL / (uint64_t)(PROBE_COUNT * 2);
+        if (budget_ns < SYSCALL_MIN_CASE_NS)
+        {
+            budget_ns = SYSCALL_MIN_CASE_NS;
+        }
+    }
+
+    ProbeContext ctx = {0};
+    ctx.page_size = (size_t)sysconf(_SC_PAGESIZE);
+    ctx.zero_fd = open("/dev/zero", O_RDONLY);
+    uint64_t *samples = malloc(sizeof(uint64_t) * SYSCALL_MAX_BATCHES);
+    if (ctx.zero_fd < 0 || !samples)
+    {
+        logger_error("Syscall: setup failed: %s", strerror(errno));
+        if (ctx.zero_fd >= 0)
+        {
+            close(ctx.zero_fd);
+        }
+        free(samples);
+        free(others);
+        return false;
+    }
+
+    log_environment();
+
+    bool saved_affinity = false;
+    cpu_set_t original;
+    if (sched_getaffinity(0, sizeof(original), &original) == 0)
+    {
+        saved_affinity = true;
+    }
+    bench_pin_cpu(cpu);
+    logger_info("Syscall: measuring on CPU %d, %.2f s per case", cpu, (double)budget_ns / 1e9);
+
+    bool ok = run_pass(&ctx, "idle", budget_ns, samples);
+
+    if (other_count == 0)
+    {
+        logger_warning("Syscall: no CPUs besides %d are online, skipping stress pass", cpu);
+    }
+    else
+    {
+        CpuStress stress;
+        if (!cpu_stress_start(&stress, others, other_count, CPU_WORK_INT, false))
+        {
+            logger_error("Syscall: failed to start stress workers");
+            ok = false;
+        }
+        else
+        {
+            logger_info("Syscall: loading %d other CPUs", other_count);
+            ok = run_pass(&ctx, "stress", budget_ns, samples) && ok;
+            cpu_stress_stop(&stress);
+            cpu_stress_free(&stress);
+        }
+    }
+
+    if (saved_affinity)
+    {
+        sched_setaffinity(0, sizeof(original), &original);
+    }
+
+    close(ctx.zero_fd);
+    free(samples);
+    free(others);
+    return ok;
+}
+
+/* Private helper function to measure every probe under one load condition */
+static bool run_pass(ProbeContext *ctx, const char *load, uint64_t budget_ns, uint64_t *samples)
+{
+    bool ok = true;
+    for (int i = 0; i < PROBE_COUNT; i++)
+    {
+        if (!measure_probe(&probes[i], ctx, load, budget_ns, samples))
+        {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+/* Private helper function to time batches of one probe until the budget runs out */
+static bool measure_probe(const Probe *probe, ProbeContext *ctx, const char *load,
+                          uint64_t budget_ns, uint64_t *samples)
+{
+    for (int b = 0; b < SYSCALL_WARMUP_BATCHES; b++)
+    {
+        for (int i = 0; i < SYSCALL_BATCH; i++)
+        {
+            if (!probe->func(ctx))
+            {
+                logger_error("Syscall: %s failed: %s", probe->name, strerror(errno));
+                return false;
+            }
+        }
+    }
+
+    size_t batches = 0;
+    uint64_t start = bench_now_ns();
+    uint64_t deadline = start + budget_ns;
+    uint64_t now = start;
+
+    while (now < deadline && batches < SYSCALL_MAX_BATCHES)
+    {
+        uint64_t t0 = bench_now_ns();
+        for (int i = 0; i < SYSCALL_BATCH; i++)
+        {
+            probe->func(ctx);
+        }
+        now = bench_now_ns();
+        samples[batches++] = now - t0;
+    }
+
+    LatencySummary summary;
+    bench_summarize(samples, batches, &summary);
+
+    /* Samples are batch totals; scale them to a single call */
+    double per_call_avg = summary.mean / SYSCALL_BATCH;
+    double per_call_min = (double)summary.min / SYSCALL_BATCH;
+    double per_call_p50 = (double)summary.p50 / SYSCALL_BATCH;
+    double per_call_p99 = (double)summary.p99 / SYSCALL_BATCH;
+    double per_call_max = (double)summary.max / SYSCALL_BATCH;
+
+    logger_info("Syscall: %-13s %-6s avg %.1f ns, p50 %.1f ns, p99 %.1f ns",
+                probe->name, load, per_call_avg, per_call_p50, per_call_p99);
+    logger_metric("syscall_cost",
+                  "syscall=%s,load=%s,calls=%llu,avg_ns=%.2f,min_ns=%.2f,p50_ns=%.2f,p99_ns=%.2f,max_ns=%.2f",
+                  probe->name, load, (unsigned long long)batches * SYSCALL_BATCH,
+                  per_call_avg, per_call_min, per_call_p50, per_call_p99, per_call_max);
+    return true;
+}
+
+/* Private helper function to record the kernel and mitigation state with the results */
+static void log_environment(void)
+{
+    struct utsname uts;
+    if (uname(&uts) == 0)
+    {
+        logger_info("Syscall: kernel %s %s (%s)", uts.sysname, uts.release, uts.machine);
+        logger_metric("syscall_env", "kernel=%s,machine=%s", uts.release, uts.machine);
+    }
+
+    DIR *dir = opendir(VULNERABILITIES_DIR);
+    if (dir == NULL)
+    {
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+
+        char path[512];
+        char status[256];
+        snprintf(path, sizeof(path), VULNERABILITIES_DIR "/%s", entry->d_name);
+        FILE *file = fopen(path, "r");
+        if (file == NULL)
+        {
+            continue;
+        }
+        if (fgets(status, sizeof(status), file) != NULL)
+        {
+            status[strcspn(status, "\n")] = '\0';
+            logger_info("Syscall: mitigation %s: %s", entry->d_name, status);
+        }
+        fclose(file);
+    }
+    closedir(dir);
+}
+
+/* Private helper function: raw getpid, bypassing any libc caching */
+static bool probe_getpid(ProbeContext *ctx)
+{
+    (void)ctx;
+    return syscall(SYS_getpid) > 0;
+}
+
+/* Private helper function: clock_gettime, normally served by the vDSO */
+static bool probe_clock_gettime(ProbeContext *ctx)
+{
+    (void)ctx;
+    struct timespec ts;
+    return clock_gettime(CLOCK_MONOTONIC, &ts) == 0;
+}
+
+/* Private helper function: small read from /dev/zero */
+static bool probe_read_zero(ProbeContext *ctx)
+{
+    return read(ctx->zero_fd, ctx->buffer, sizeof(ctx->buffer)) == (ssize_t)sizeof(ctx->buffer);
+}
+
+/* Private helper function: futex wake with nobody waiting */
+static bool probe_futex_wake(ProbeContext *ctx)
+{
+    return syscall(SYS_futex, &ctx->futex_word, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0) >= 0;
+}
+
+/* Private helper function: map and unmap one anonymous page */
+static bool probe_mmap_munmap(ProbeContext *ctx)
+{
+    void *page = mmap(NULL, ctx->page_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (page == MAP_FAILED)
+    {
+        return false;
+    }
+    return munmap(page, ctx->page_size) == 0;
+}
+
+/* Private helper function: yield the CPU */
+static bool probe_sched_yield(ProbeContext *ctx)
+{
+    (void)ctx;
+    return sched_yield() == 0;
+}
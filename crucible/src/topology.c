@@ -0,0 +1,382 @@
+/**
+ * CPU Topology Implementation
+ *
+ * This file reads /sys/devices/system/cpu and /sys/devices/system/node to
+ * build a table of online logical CPUs with their core, package and NUMA
+ * node. Tests use it to choose CPU placements.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+
+/* Include our header file */
+#include "topology.h"
+
+/* Define constants */
+#define SYSFS_CPU_DIR "/sys/devices/system/cpu"
+#define SYSFS_NODE_DIR "/sys/devices/system/node"
+#define MAX_CPUS 4096
+#define MAX_LIST_LENGTH 4096
+
+/* Private helper function prototypes */
+static bool read_line(const char *path, char *buffer, size_t size);
+static int read_int(const char *path, int fallback);
+static void assign_nodes(CpuTopology *topo);
+
+/**
+ * Load the CPU topology from sysfs
+ */
+bool topology_load(CpuTopology *topo)
+{
+    memset(topo, 0, sizeof(*topo));
+
+    char list[MAX_LIST_LENGTH];
+    if (!read_line(SYSFS_CPU_DIR "/online", list, sizeof(list)))
+    {
+        return false;
+    }
+
+    int *online = malloc(sizeof(int) * MAX_CPUS);
+    if (!online)
+    {
+        return false;
+    }
+
+    int count = topology_parse_cpulist(list, online, MAX_CPUS);
+    if (count <= 0)
+    {
+        free(online);
+        return false;
+    }
+
+    topo->cpus = calloc((size_t)count, sizeof(CpuInfo));
+    if (!topo->cpus)
+    {
+        free(online);
+        return false;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        char path[256];
+        CpuInfo *info = &topo->cpus[i];
+        info->cpu = online[i];
+        info->node = -1;
+
+        /* Fall back to one core per CPU if the topology files are missing */
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/topology/core_id", info->cpu);
+        info->core_id = read_int(path, info->cpu);
+
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/topology/physical_package_id", info->cpu);
+        info->package_id = read_int(path, 0);
+    }
+    topo->count = count;
+    free(online);
+
+    assign_nodes(topo);
+    return true;
+}
+
+/**
+ * Release memory held by a topology
+ */
+void topology_free(CpuTopology *topo)
+{
+    free(topo->cpus);
+    topo->cpus = NULL;
+    topo->count = 0;
+}
+
+/**
+ * Parse a kernel CPU list string
+ */
+int topology_parse_cpulist(const char *list, int *cpus, int max)
+{
+    int count = 0;
+    const char *p = list;
+
+    while (*p && *p != '\n')
+    {
+        if (!isdigit((unsigned char)*p))
+        {
+            return -1;
+        }
+
+        char *end;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (*end == '-')
+        {
+            p = end + 1;
+            if (!isdigit((unsigned char)*p))
+            {
+                return -1;
+            }
+            last = strtol(p, &end, 10);
+        }
+        if (last < first)
+        {
+            return -1;
+        }
+
+        for (long cpu = first; cpu <= last && count < max; cpu++)
+        {
+            cpus[count++] = (int)cpu;
+        }
+
+        p = end;
+        if (*p == ',')
+        {
+            p++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * Look up a logical CPU
+ */
+const CpuInfo *topology_find(const CpuTopology *topo, int cpu)
+{
+    for (int i = 0; i < topo->count; i++)
+    {
+        if (topo->cpus[i].cpu == cpu)
+        {
+            return &topo->cpus[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Read the SMT siblings of a CPU
+ */
+int topology_thread_siblings(int cpu, int *siblings, int max)
+{
+    char path[256];
+    char list[MAX_LIST_LENGTH];
+    snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/topology/thread_siblings_list", cpu);
+    if (!read_line(path, list, sizeof(list)))
+    {
+        return -1;
+    }
+    return topology_parse_cpulist(list, siblings, max);
+}
+
+/**
+ * Find an SMT sibling of a CPU
+ */
+int topology_smt_sibling(const CpuTopology *topo, int cpu)
+{
+    const CpuInfo *self = topology_find(topo, cpu);
+    if (!self)
+    {
+        return -1;
+    }
+
+    /* Prefer the kernel's own sibling list, it accounts for die and cluster IDs */
+    int siblings[64];
+    int count = topology_thread_siblings(cpu, siblings, 64);
+    if (count >= 0)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (siblings[i] != cpu && topology_find(topo, siblings[i]))
+            {
+                return siblings[i];
+            }
+        }
+        return -1;
+    }
+
+    for (int i = 0; i < topo->count; i++)
+    {
+        const CpuInfo *other = &topo->cpus[i];
+        if (other->cpu != cpu &&
+            other->package_id == self->package_id &&
+            other->core_id == self->core_id)
+        {
+            return other->cpu;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Find a CPU on another core of the same package
+ */
+int topology_same_package_cpu(const CpuTopology *topo, int cpu)
+{
+    const CpuInfo *self = topology_find(topo, cpu);
+    if (!self)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < topo->count; i++)
+    {
+        const CpuInfo *other = &topo->cpus[i];
+        if (other->package_id == self->package_id &&
+            other->core_id != self->core_id)
+        {
+            return other->cpu;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Find a CPU on a different package
+ */
+int topology_other_package_cpu(const CpuTopology *topo, int cpu)
+{
+    const CpuInfo *self = topology_find(topo, cpu);
+    if (!self)
+    {
+        return -1;
+    }
+
+    for (int i = 0; i < topo->count; i++)
+    {
+        if (topo->cpus[i].package_id != self->package_id)
+        {
+            return topo->cpus[i].cpu;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Read the size of a data cache level
+ */
+size_t topology_cache_size(int cpu, int level)
+{
+    for (int index = 0;; index++)
+    {
+        char path[256];
+        char buffer[64];
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/cache/index%d/type", cpu, index);
+        if (!read_line(path, buffer, sizeof(buffer)))
+        {
+            return 0; /* Ran out of cache entries */
+        }
+        if (strcmp(buffer, "Instruction") == 0)
+        {
+            continue;
+        }
+
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/cache/index%d/level", cpu, index);
+        if (read_int(path, -1) != level)
+        {
+            continue;
+        }
+
+        /* Sizes are reported like "48K" */
+        snprintf(path, sizeof(path), SYSFS_CPU_DIR "/cpu%d/cache/index%d/size", cpu, index);
+        if (!read_line(path, buffer, sizeof(buffer)))
+        {
+            return 0;
+        }
+        char *end;
+        unsigned long value = strtoul(buffer, &end, 10);
+        switch (*end)
+        {
+        case 'K':
+            return (size_t)value << 10;
+        case 'M':
+            return (size_t)value << 20;
+        case 'G':
+            return (size_t)value << 30;
+        default:
+            return (size_t)value;
+        }
+    }
+}
+
+/* Private helper function to read the first line of a sysfs file */
+static bool read_line(const char *path, char *buffer, size_t size)
+{
+    FILE *file = fopen(path, "r");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool ok = (fgets(buffer, (int)size, file) != NULL);
+    fclose(file);
+
+    if (ok)
+    {
+        buffer[strcspn(buffer, "\n")] = '\0';
+    }
+    return ok;
+}
+
+/* Private helper function to read an integer sysfs attribute */
+static int read_int(const char *path, int fallback)
+{
+    char buffer[64];
+    if (!read_line(path, buffer, sizeof(buffer)))
+    {
+        return fallback;
+    }
+    return atoi(buffer);
+}
+
+/* Private helper function to map CPUs to NUMA nodes via nodeN/cpulist */
+static void assign_nodes(CpuTopology *topo)
+{
+    DIR *dir = opendir(SYSFS_NODE_DIR);
+    if (dir == NULL)
+    {
+        return; /* Kernel built without NUMA support */
+    }
+
+    int *cpus = malloc(sizeof(int) * MAX_CPUS);
+    if (!cpus)
+    {
+        closedir(dir);
+        return;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        if (strncmp(entry->d_name, "node", 4) != 0 ||
+            !isdigit((unsigned char)entry->d_name[4]))
+        {
+            continue;
+        }
+
+        int node = atoi(entry->d_name + 4);
+        char path[512];
+        char list[MAX_LIST_LENGTH];
+        snprintf(path, sizeof(path), SYSFS_NODE_DIR "/%s/cpulist", entry->d_name);
+        if (!read_line(path, list, sizeof(list)))
+        {
+            continue;
+        }
+
+        int count = topology_parse_cpulist(list, cpus, MAX_CPUS);
+        for (int i = 0; i < count; i++)
+        {
+            for (int j = 0; j < topo->count; j++)
+            {
+                if (topo->cpus[j].cpu == cpus[i])
+                {
+                    topo->cpus[j].node = node;
+                }
+            }
+        }
+    }
+
+    free(cpus);
+    closedir(dir);
+}
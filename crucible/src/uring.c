@@ -0,0 +1,316 @@
+/**
+ * io_uring Wrapper Implementation
+ *
+ * This file sets up io_uring rings through syscall() and maps their queues.
+ * The kernel and the application share the ring indices, so every head
+ * and tail the other side writes is loaded with acquire ordering and every
+ * index we publish is stored with release ordering. With SQPOLL a full
+ * fence separates publishing the tail from checking whether the poll
+ * thread went to sleep.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+/* Include our header file */
+#include "uring.h"
+
+/* Private helper function prototypes */
+static int submit(Uring *ring, unsigned wait_nr, uint64_t timeout_ns);
+static int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void *arg,
+                     size_t arg_size);
+
+/**
+ * Create a ring
+ */
+bool uring_init(Uring *ring, unsigned entries, unsigned flags, unsigned sq_idle_ms)
+{
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = flags;
+    if (flags & IORING_SETUP_SQPOLL)
+    {
+        params.sq_thread_idle = sq_idle_ms;
+    }
+
+    int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0)
+    {
+        return false;
+    }
+    ring->fd = fd;
+    ring->flags = flags;
+    ring->features = params.features;
+
+    ring->sq_map_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring->cq_map_size > ring->sq_map_size)
+        {
+            ring->sq_map_size = ring->cq_map_size;
+        }
+        ring->cq_map_size = ring->sq_map_size;
+    }
+
+    ring->sq_map = mmap(NULL, ring->sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                        IORING_OFF_SQ_RING);
+    if (ring->sq_map == MAP_FAILED)
+    {
+        ring->sq_map = NULL;
+        uring_exit(ring);
+        return false;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring->cq_map = ring->sq_map;
+    }
+    else
+    {
+        ring->cq_map = mmap(NULL, ring->cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                            IORING_OFF_CQ_RING);
+        if (ring->cq_map == MAP_FAILED)
+        {
+            ring->cq_map = NULL;
+            uring_exit(ring);
+            return false;
+        }
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                      IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED)
+    {
+        ring->sqes = NULL;
+        uring_exit(ring);
+        return false;
+    }
+
+    char *sq = ring->sq_map;
+    ring->sq_head = (unsigned *)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned *)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)(sq + params.sq_off.ring_mask);
+    ring->sq_flags = (unsigned *)(sq + params.sq_off.flags);
+    ring->sq_array = (unsigned *)(sq + params.sq_off.array);
+    ring->sq_entries = params.sq_entries;
+    ring->sqe_tail = *ring->sq_tail;
+
+    char *cq = ring->cq_map;
+    ring->cq_head = (unsigned *)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned *)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)(cq + params.cq_off.cqes);
+    ring->cq_entries = params.cq_entries;
+
+    /* SQ slots map one-to-one onto SQEs, so the index array is filled once */
+    for (unsigned i = 0; i < ring->sq_entries; i++)
+    {
+        ring->sq_array[i] = i;
+    }
+    return true;
+}
+
+/**
+ * Register fixed buffers
+ */
+bool uring_register_buffers(Uring *ring, const struct iovec *iovs, unsigned count)
+{
+    return syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iovs, count) == 0;
+}
+
+/**
+ * Register fixed files
+ */
+bool uring_register_files(Uring *ring, const int *fds, unsigned count)
+{
+    return syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_FILES, fds, count) == 0;
+}
+
+/**
+ * Get a free submission queue entry
+ */
+struct io_uring_sqe *uring_get_sqe(Uring *ring)
+{
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (ring->sqe_tail - head >= ring->sq_entries)
+    {
+        return NULL;
+    }
+
+    struct io_uring_sqe *sqe = &ring->sqes[ring->sqe_tail & *ring->sq_mask];
+    ring->sqe_tail++;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+/**
+ * Submit prepared entries and optionally wait for completions
+ */
+int uring_submit(Uring *ring, unsigned wait_nr)
+{
+    return submit(ring, wait_nr, 0);
+}
+
+/**
+ * Submit prepared entries and wait for completions, with a timeout
+ */
+int uring_submit_timeout(Uring *ring, unsigned wait_nr, uint64_t timeout_ns)
+{
+    if (!(ring->features & IORING_FEAT_EXT_ARG))
+    {
+        return -EOPNOTSUPP;
+    }
+    return submit(ring, wait_nr, timeout_ns > 0 ? timeout_ns : 1);
+}
+
+/**
+ * Peek at available completions
+ */
+unsigned uring_peek_batch(Uring *ring, struct io_uring_cqe **cqes, unsigned max)
+{
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    unsigned count = 0;
+    while (head + count != tail && count < max)
+    {
+        cqes[count] = &ring->cqes[(head + count) & *ring->cq_mask];
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Mark completions as consumed
+ */
+void uring_cq_advance(Uring *ring, unsigned count)
+{
+    if (count > 0)
+    {
+        __atomic_store_n(ring->cq_head, *ring->cq_head + count, __ATOMIC_RELEASE);
+    }
+}
+
+/**
+ * Tear down a ring
+ */
+void uring_exit(Uring *ring)
+{
+    if (ring->sqes)
+    {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_map && ring->cq_map != ring->sq_map)
+    {
+        munmap(ring->cq_map, ring->cq_map_size);
+    }
+    if (ring->sq_map)
+    {
+        munmap(ring->sq_map, ring->sq_map_size);
+    }
+    if (ring->fd >= 0)
+    {
+        close(ring->fd);
+    }
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+/*
+ * Private helper function: publish new entries and enter the kernel if
+ * needed; timeout_ns 0 waits forever. Entries the kernel has not consumed
+ * yet, including ones an earlier short submit left in the ring, are
+ * counted against its head, so they are passed on again.
+ */
+static int submit(Uring *ring, unsigned wait_nr, uint64_t timeout_ns)
+{
+    /* The poll thread takes everything published, so there only new entries count as submitted */
+    int submitted = (int)(ring->sqe_tail - *ring->sq_tail);
+    if (submitted > 0)
+    {
+        __atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+    }
+    unsigned pending = ring->sqe_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+
+    unsigned flags = 0;
+    bool enter = wait_nr > 0 || (ring->flags & IORING_SETUP_IOPOLL);
+    if (ring->flags & IORING_SETUP_SQPOLL)
+    {
+        /* The poll thread picks up the new tail on its own unless it went idle */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        if (__atomic_load_n(ring->sq_flags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP)
+        {
+            flags |= IORING_ENTER_SQ_WAKEUP;
+            enter = true;
+        }
+        pending = 0;
+    }
+    else if (pending > 0)
+    {
+        enter = true;
+    }
+    if (wait_nr > 0 || (ring->flags & IORING_SETUP_IOPOLL))
+    {
+        flags |= IORING_ENTER_GETEVENTS;
+    }
+    if (!enter)
+    {
+        return (ring->flags & IORING_SETUP_SQPOLL) ? submitted : 0;
+    }
+
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    const void *arg_ptr = NULL;
+    size_t arg_size = 0;
+    if (timeout_ns > 0 && wait_nr > 0)
+    {
+        ts.tv_sec = (long long)(timeout_ns / 1000000000ULL);
+        ts.tv_nsec = (long long)(timeout_ns % 1000000000ULL);
+        memset(&arg, 0, sizeof(arg));
+        arg.ts = (uint64_t)(uintptr_t)&ts;
+        arg_ptr = &arg;
+        arg_size = sizeof(arg);
+        flags |= IORING_ENTER_EXT_ARG;
+    }
+
+    for (;;)
+    {
+        /* The kernel skips the wait when it consumes fewer entries than offered */
+        int ret = sys_enter(ring->fd, pending, wait_nr, flags, arg_ptr, arg_size);
+        if (ret >= 0)
+        {
+            return (ring->flags & IORING_SETUP_SQPOLL) ? submitted : ret;
+        }
+        if ((errno == ETIME && arg_ptr) || errno == EAGAIN || errno == EBUSY)
+        {
+            /* Timed out, or short of resources for now: the entries stay queued for the next call */
+            return (ring->flags & IORING_SETUP_SQPOLL) ? submitted : 0;
+        }
+        if (errno != EINTR)
+        {
+            return -errno;
+        }
+    }
+}
+
+/* Private helper function to enter the kernel for a ring */
+static int sys_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void *arg,
+                     size_t arg_size)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
@@ -0,0 +1,656 @@
+/**
+ * Write-Ahead Log Test Implementation
+ *
+ * This file implements the write-ahead log workload. Committer threads
+ * generate a record, hand it to the log and wait until it is durable.
+ * Records wait in one slot per committer, numbered by a log sequence.
+ * A committer that finds no write in progress becomes the leader: it
+ * takes the oldest waiting records (up to the group-commit limit), drops
+ * the lock, appends them with one write and one sync, then wakes the
+ * others, whose records may have been part of the batch. With a limit of
+ * one every commit pays for its own sync; with more, commits that arrive
+ * while a sync is running share the next one, which is how databases
+ * turn sync latency into throughput.
+ *
+ * The log is one segment. Once it is full the leader starts over at its
+ * beginning: an extending log is truncated first, so every write extends
+ * the file again and every sync commits metadata, while a preallocated
+ * log overwrites blocks in place. The main thread wakes once per
+ * interval and logs the commit rate and the latencies every committer
+ * recorded in its own histograms.
+ *
+ * Author: Your Name
+ * Date: March 20, 2025
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/statvfs.h>
+
+/* Include our header files */
+#include "wal_test.h"
+#include "bench_util.h"
+#include "logger.h"
+#include "data_gen.h"
+#include "histogram.h"
+#include "mem_buffer.h"
+
+/* Define constants */
+#define WAL_DEFAULT_SEGMENT (64ULL << 20)
+#define WAL_DEFAULT_RECORD 4096
+#define WAL_MAX_THREADS 256
+#define WAL_DIRECT_ALIGN 4096          /* Buffer alignment that satisfies any logical block size */
+#define WAL_ZERO_CHUNK (1ULL << 20)
+#define WAL_INTERVAL_NS 1000000000ULL  /* 1 s */
+#define WAL_LINE_SIZE 64
+
+typedef enum
+{
+    SYNC_FSYNC,
+    SYNC_FDATASYNC,
+    SYNC_DSYNC,
+    SYNC_RANGE,
+    SYNC_METHOD_COUNT
+} SyncMethod;
+
+typedef enum
+{
+    PREALLOC_NONE,
+    PREALLOC_FALLOC,
+    PREALLOC_ZERO,
+    PREALLOC_COUNT
+} Prealloc;
+
+typedef enum
+{
+    WAL_COMMIT, /* Record handed over until durable */
+    WAL_SYNC,   /* One batch's write plus sync, recorded by its leader */
+    WAL_HIST_COUNT
+} WalHist;
+
+struct WalJob;
+
+/* Per-committer state, one cache line apart */
+typedef struct
+{
+    pthread_t thread;
+    struct WalJob *job;
+    int index;
+    MemBuffer record;  /* Next record, generated outside the lock */
+    DataGen gen;
+    Histogram *live;   /* Latency per WalHist, recorded only by this thread */
+    Histogram *seen;   /* What the main thread has already collected from live */
+} __attribute__((aligned(WAL_LINE_SIZE))) WalCommitter;
+
+/* Shared log */
+typedef struct WalJob
+{
+    int fd;
+    SyncMethod method;
+    Prealloc prealloc;
+    size_t record_size;
+    size_t segment_size;
+    unsigned group;           /* Most records per write and sync */
+    pthread_mutex_t lock;
+    pthread_cond_t flushed;   /* Signalled whenever a batch is done */
+    MemBuffer slots;          /* Waiting records, slot = sequence % committers */
+    MemBuffer batch;          /* The leader's copy of the batch being written */
+    uint64_t next_seq;        /* Sequence of the next record, under the lock */
+    uint64_t durable_seq;     /* Records durable so far, written under the lock */
+    uint64_t syncs;           /* Batches written, written under the lock */
+    uint64_t wraps;           /* Times the segment started over, leader only */
+    bool flushing;            /* A leader is writing a batch */
+    size_t offset;            /* Next write position in the segment, leader only */
+    int error;                /* errno of the failed write or sync, 0 if none */
+    bool stop;
+    DataProfile data;
+    WalCommitter *committers;
+    int committer_count;
+    Histogram *interval;      /* Scratch for one committer's interval, main thread only */
+    Histogram *merged;        /* All committers' interval, main thread only */
+    Histogram *totals;        /* Whole run per WalHist, main thread only */
+} WalJob;
+
+static const char *const method_names[SYNC_METHOD_COUNT] = {"fsync", "fdatasync", "dsync", "sfr"};
+static const char *const prealloc_names[PREALLOC_COUNT] = {"none", "falloc", "zero"};
+static const char *const hist_names[WAL_HIST_COUNT] = {"commit", "sync"};
+
+/* Private helper function prototypes */
+static bool parse_choice(const char *value, const char *const *names, int count, int fallback, int *choice);
+static bool prepare_log(WalJob *job, const char *path);
+static void *wal_committer(void *arg);
+static void flush_batch(WalCommitter *committer);
+static int write_batch(WalJob *job, const void *buf, size_t len);
+static void report_interval(WalJob *job, double t_s, double secs, uint64_t records, uint64_t syncs);
+static void collect_tail(WalJob *job);
+static void release_job(WalJob *job);
+static void sleep_ns(uint64_t ns);
+
+/**
+ * Run the write-ahead log test
+ */
+bool wal_test_run(const ComponentConfig *comp)
+{
+    const StorageOptions *opts = &comp->options.storage;
+
+    size_t segment_size = WAL_DEFAULT_SEGMENT;
+    if (opts->file_size[0] != '\0' && !bench_parse_size(opts->file_size, &segment_size))
+    {
+        logger_error("WAL: invalid segment size '%s'", opts->file_size);
+        return false;
+    }
+    size_t record_size = WAL_DEFAULT_RECORD;
+    if (opts->block_size[0] != '\0' && (!bench_parse_size(opts->block_size, &record_size) || record_size == 0))
+    {
+        logger_error("WAL: invalid record size '%s'", opts->block_size);
+        return false;
+    }
+    if (opts->direct_io && record_size % 512 != 0)
+    {
+        logger_error("WAL: O_DIRECT needs a record size that is a multiple of 512, got %zu", record_size);
+        return false;
+    }
+
+    int method;
+    if (!parse_choice(opts->sync_method, method_names, SYNC_METHOD_COUNT, SYNC_FDATASYNC, &method))
+    {
+        logger_error("WAL: invalid sync method '%s' (expected fsync, fdatasync, dsync or sfr)", opts->sync_method);
+        return false;
+    }
+    int prealloc;
+    if (!parse_choice(opts->prealloc, prealloc_names, PREALLOC_COUNT, PREALLOC_NONE, &prealloc))
+    {
+        logger_error("WAL: invalid preallocation '%s' (expected none, falloc or zero)", opts->prealloc);
+        return false;
+    }
+    if (opts->compress_pct < 0 || opts->compress_pct > 100)
+    {
+        logger_error("WAL: compressibility %d%% must be 0-100", opts->compress_pct);
+        return false;
+    }
+
+    int committer_count = opts->threads > 0 ? opts->threads : 1;
+    if (committer_count > WAL_MAX_THREADS)
+    {
+        logger_warning("WAL: limiting %d committers to %d", committer_count, WAL_MAX_THREADS);
+        committer_count = WAL_MAX_THREADS;
+    }
+    if (opts->group_commit < 0)
+    {
+        logger_error("WAL: invalid group commit limit %d", opts->group_commit);
+        return false;
+    }
+    /* Every committer has at most one record waiting, so no batch can be larger */
+    unsigned group = opts->group_commit > 0 ? (unsigned)opts->group_commit : 1;
+    if (group > (unsigned)committer_count)
+    {
+        group = (unsigned)committer_count;
+    }
+    segment_size -= segment_size % record_size;
+    if (segment_size < record_size * group)
+    {
+        logger_error("WAL: segment of %zu bytes cannot hold a batch of %u records of %zu bytes", segment_size, group,
+                     record_size);
+        return false;
+    }
+
+    const char *dir = opts->directory[0] != '\0' ? opts->directory : ".";
+    struct statvfs fs;
+    if (statvfs(dir, &fs) != 0)
+    {
+        logger_error("WAL: cannot access directory '%s': %s", dir, strerror(errno));
+        return false;
+    }
+    if ((uint64_t)fs.f_bavail * fs.f_frsize < segment_size)
+    {
+        logger_error("WAL: %zu MB needed in '%s', only %llu MB free", segment_size >> 20, dir,
+                     (unsigned long long)(((uint64_t)fs.f_bavail * fs.f_frsize) >> 20));
+        return false;
+    }
+
+    WalJob job;
+    memset(&job, 0, sizeof(job));
+    job.fd = -1;
+    job.method = (SyncMethod)method;
+    job.prealloc = (Prealloc)prealloc;
+    job.record_size = record_size;
+    job.segment_size = segment_size;
+    job.group = group;
+    job.committer_count = committer_count;
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.flushed, NULL);
+    data_profile_init(&job.data, opts->compress_pct, 0,
+                      opts->seed != 0 ? (uint64_t)opts->seed : (bench_now_ns() * 0x9E3779B97F4A7C15ULL) | 1);
+
+    job.committers = aligned_alloc(WAL_LINE_SIZE, sizeof(WalCommitter) * (size_t)committer_count);
+    job.interval = malloc(sizeof(Histogram));
+    job.merged = malloc(sizeof(Histogram));
+    job.totals = malloc(sizeof(Histogram) * WAL_HIST_COUNT);
+    bool ok = job.committers && job.interval && job.merged && job.totals &&
+              mem_buffer_alloc(&job.slots, record_size * (size_t)committer_count, WAL_DIRECT_ALIGN) &&
+              mem_buffer_alloc(&job.batch, record_size * group, WAL_DIRECT_ALIGN);
+    if (job.committers)
+    {
+        memset(job.committers, 0, sizeof(WalCommitter) * (size_t)committer_count);
+    }
+    for (int i = 0; ok && i < committer_count; i++)
+    {
+        WalCommitter *committer = &job.committers[i];
+        committer->job = &job;
+        committer->index = i;
+        committer->live = malloc(sizeof(Histogram) * WAL_HIST_COUNT);
+        committer->seen = malloc(sizeof(Histogram) * WAL_HIST_COUNT);
+        ok = committer->live && committer->seen && mem_buffer_alloc(&committer->record, record_size, WAL_DIRECT_ALIGN);
+        for (int h = 0; ok && h < WAL_HIST_COUNT; h++)
+        {
+            hist_init(&committer->live[h]);
+            hist_init(&committer->seen[h]);
+        }
+        data_gen_init(&committer->gen, &job.data, (uint64_t)i);
+    }
+    if (!ok)
+    {
+        logger_error("WAL: setup failed");
+        release_job(&job);
+        return false;
+    }
+    for (int h = 0; h < WAL_HIST_COUNT; h++)
+    {
+        hist_init(&job.totals[h]);
+    }
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s/crucible.%d.wal", dir, (int)getpid());
+    job.fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | (job.method == SYNC_DSYNC ? O_DSYNC : 0) |
+                            (opts->direct_io ? O_DIRECT : 0), 0644);
+    if (job.fd < 0)
+    {
+        logger_error("WAL: cannot create %s%s: %s", path, opts->direct_io ? " with O_DIRECT" : "", strerror(errno));
+        release_job(&job);
+        return false;
+    }
+
+    logger_info("WAL: %zu byte records, %s, %d committers, up to %u records per sync, %zu MB %s segment%s",
+                record_size, method_names[job.method], committer_count, group, segment_size >> 20,
+                job.prealloc == PREALLOC_NONE ? "extending" : prealloc_names[job.prealloc],
+                opts->direct_io ? ", O_DIRECT" : "");
+    if (job.method == SYNC_RANGE)
+    {
+        logger_warning("WAL: sync_file_range flushes neither metadata nor the device cache; commits are not durable");
+    }
+    if (!prepare_log(&job, path))
+    {
+        unlink(path);
+        release_job(&job);
+        return false;
+    }
+
+    int started = 0;
+    for (int i = 0; i < committer_count; i++)
+    {
+        if (pthread_create(&job.committers[i].thread, NULL, wal_committer, &job.committers[i]) != 0)
+        {
+            logger_error("WAL: failed to start committer %d", i);
+            ok = false;
+            break;
+        }
+        started++;
+    }
+
+    uint64_t start = bench_now_ns();
+    uint64_t duration = (uint64_t)comp->duration * 1000000000ULL;
+    if (ok)
+    {
+        uint64_t last = start, last_records = 0, last_syncs = 0;
+        for (uint64_t next = start + WAL_INTERVAL_NS;; next += WAL_INTERVAL_NS)
+        {
+            uint64_t target = next < start + duration ? next : start + duration;
+            uint64_t now = bench_now_ns();
+            if (target > now)
+            {
+                sleep_ns(target - now);
+            }
+            now = bench_now_ns();
+            uint64_t records = __atomic_load_n(&job.durable_seq, __ATOMIC_RELAXED);
+            uint64_t syncs = __atomic_load_n(&job.syncs, __ATOMIC_RELAXED);
+            report_interval(&job, (double)(now - start) / 1e9, (double)(now - last) / 1e9, records - last_records,
+                            syncs - last_syncs);
+            last = now;
+            last_records = records;
+            last_syncs = syncs;
+
+            if (__atomic_load_n(&job.error, __ATOMIC_RELAXED) != 0 || now - start >= duration)
+            {
+                break;
+            }
+        }
+    }
+
+    __atomic_store_n(&job.stop, true, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(job.committers[i].thread, NULL);
+    }
+    uint64_t end = bench_now_ns();
+    if (job.error != 0)
+    {
+        logger_error("WAL: writing or syncing the log failed: %s", strerror(job.error));
+        ok = false;
+    }
+
+    if (started > 0)
+    {
+        /* Commits made durable after the last interval are in durable_seq and syncs, so the totals take them too */
+        collect_tail(&job);
+        double secs = (double)(end - start) / 1e9;
+        LatencySummary commit, sync;
+        hist_summarize(&job.totals[WAL_COMMIT], &commit);
+        hist_summarize(&job.totals[WAL_SYNC], &sync);
+        double batch = job.syncs > 0 ? (double)job.durable_seq / (double)job.syncs : 0.0;
+        logger_metric("storage_wal_summary", "method=%s,prealloc=%s,record_bytes=%zu,committers=%d,group=%u,"
+                      "commits=%llu,commits_per_s=%.0f,mbps=%.2f,syncs=%llu,batch_mean=%.2f,wraps=%llu,"
+                      "lat_mean_us=%.1f,lat_p50_us=%.1f,lat_p90_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,"
+                      "lat_p9999_us=%.1f,lat_max_us=%.1f,sync_mean_us=%.1f,sync_p50_us=%.1f,sync_p99_us=%.1f,"
+                      "sync_max_us=%.1f",
+                      method_names[job.method], prealloc_names[job.prealloc], record_size, committer_count, group,
+                      (unsigned long long)commit.count, (double)commit.count / secs,
+                      (double)commit.count * (double)record_size / 1048576.0 / secs, (unsigned long long)job.syncs,
+                      batch, (unsigned long long)job.wraps, commit.mean / 1e3, (double)commit.p50 / 1e3,
+                      (double)commit.p90 / 1e3, (double)commit.p99 / 1e3, (double)commit.p999 / 1e3,
+                      (double)commit.p9999 / 1e3, (double)commit.max / 1e3, sync.mean / 1e3,
+                      (double)sync.p50 / 1e3, (double)sync.p99 / 1e3, (double)sync.max / 1e3);
+        logger_info("WAL: %.0f commits/s over %.1f s, %.2f records per sync, commit p50 %.1f us p99 %.1f us, "
+                    "sync p99 %.1f us",
+                    (double)commit.count / secs, secs, batch, (double)commit.p50 / 1e3, (double)commit.p99 / 1e3,
+                    (double)sync.p99 / 1e3);
+
+        for (int h = 0; h < WAL_HIST_COUNT; h++)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "storage.%d.%s", comp->order, hist_names[h]);
+            if (job.totals[h].count > 0 && !hist_save(&job.totals[h], name))
+            {
+                logger_warning("WAL: could not save the %s latency histogram", hist_names[h]);
+            }
+        }
+    }
+
+    unlink(path);
+    release_job(&job);
+    return ok;
+}
+
+/* Private helper function: look an option value up in a name table, an empty value giving the fallback */
+static bool parse_choice(const char *value, const char *const *names, int count, int fallback, int *choice)
+{
+    if (value[0] == '\0')
+    {
+        *choice = fallback;
+        return true;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(value, names[i]) == 0)
+        {
+            *choice = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Private helper function: allocate the segment as requested and make the
+ * new file durable, so the measurement starts from a committed log.
+ */
+static bool prepare_log(WalJob *job, const char *path)
+{
+    if (job->prealloc != PREALLOC_NONE && fallocate(job->fd, 0, 0, (off_t)job->segment_size) != 0)
+    {
+        logger_error("WAL: cannot preallocate %s: %s", path, strerror(errno));
+        return false;
+    }
+    if (job->prealloc == PREALLOC_ZERO)
+    {
+        MemBuffer zeros;
+        if (!mem_buffer_alloc(&zeros, WAL_ZERO_CHUNK, WAL_DIRECT_ALIGN))
+        {
+            logger_error("WAL: setup failed");
+            return false;
+        }
+        memset(zeros.data, 0, WAL_ZERO_CHUNK);
+        for (size_t done = 0; done < job->segment_size;)
+        {
+            size_t len = job->segment_size - done < WAL_ZERO_CHUNK ? job->segment_size - done : WAL_ZERO_CHUNK;
+            ssize_t written = pwrite(job->fd, zeros.data, len, (off_t)done);
+            if (written != (ssize_t)len)
+            {
+                logger_error("WAL: zeroing %s failed: %s", path, written < 0 ? strerror(errno) : "short write");
+                mem_buffer_free(&zeros);
+                return false;
+            }
+            done += len;
+        }
+        mem_buffer_free(&zeros);
+    }
+    if (fsync(job->fd) != 0)
+    {
+        logger_error("WAL: syncing %s failed: %s", path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Private helper function: committer thread. Each commit generates a
+ * record, queues it and waits until a batch containing it is durable,
+ * writing that batch itself whenever no other committer is.
+ */
+static void *wal_committer(void *arg)
+{
+    WalCommitter *committer = arg;
+    WalJob *job = committer->job;
+    unsigned char *slots = job->slots.data;
+
+    while (!__atomic_load_n(&job->stop, __ATOMIC_RELAXED))
+    {
+        data_gen_block(&committer->gen, committer->record.data, job->record_size);
+
+        uint64_t t0 = bench_now_ns();
+        pthread_mutex_lock(&job->lock);
+        uint64_t seq = job->next_seq++;
+        memcpy(slots + (seq % (uint64_t)job->committer_count) * job->record_size, committer->record.data,
+               job->record_size);
+        while (job->error == 0 && job->durable_seq <= seq)
+        {
+            if (job->flushing)
+            {
+                pthread_cond_wait(&job->flushed, &job->lock);
+            }
+            else
+            {
+                flush_batch(committer);
+            }
+        }
+        bool failed = job->error != 0;
+        pthread_mutex_unlock(&job->lock);
+        if (failed)
+        {
+            break;
+        }
+        hist_record(&committer->live[WAL_COMMIT], bench_now_ns() - t0);
+    }
+    return NULL;
+}
+
+/*
+ * Private helper function: lead one batch. Called with the lock held; the
+ * oldest waiting records are copied out, the lock is dropped for the
+ * write and sync and taken again to publish the result.
+ */
+static void flush_batch(WalCommitter *committer)
+{
+    WalJob *job = committer->job;
+    const unsigned char *slots = job->slots.data;
+    uint64_t first = job->durable_seq;
+    uint64_t count = job->next_seq - first < job->group ? job->next_seq - first : job->group;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        memcpy((unsigned char *)job->batch.data + i * job->record_size,
+               slots + ((first + i) % (uint64_t)job->committer_count) * job->record_size, job->record_size);
+    }
+    job->flushing = true;
+    pthread_mutex_unlock(&job->lock);
+
+    uint64_t t0 = bench_now_ns();
+    int error = write_batch(job, job->batch.data, (size_t)count * job->record_size);
+    if (error == 0)
+    {
+        hist_record(&committer->live[WAL_SYNC], bench_now_ns() - t0);
+    }
+
+    pthread_mutex_lock(&job->lock);
+    job->flushing = false;
+    if (error != 0)
+    {
+        __atomic_store_n(&job->error, error, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_store_n(&job->durable_seq, first + count, __ATOMIC_RELAXED);
+        __atomic_store_n(&job->syncs, job->syncs + 1, __ATOMIC_RELAXED);
+    }
+    pthread_cond_broadcast(&job->flushed);
+}
+
+/* Private helper function: append one batch to the segment and make it durable, returning an errno or 0 */
+static int write_batch(WalJob *job, const void *buf, size_t len)
+{
+    if (job->offset + len > job->segment_size)
+    {
+        /* A full extending segment is cut back so the next writes extend it again */
+        if (job->prealloc == PREALLOC_NONE && ftruncate(job->fd, 0) != 0)
+        {
+            return errno;
+        }
+        job->offset = 0;
+        job->wraps++;
+    }
+
+    ssize_t written = pwrite(job->fd, buf, len, (off_t)job->offset);
+    if (written != (ssize_t)len)
+    {
+        return written < 0 ? errno : EIO;
+    }
+    int ret = 0;
+    switch (job->method)
+    {
+    case SYNC_FSYNC:
+        ret = fsync(job->fd);
+        break;
+    case SYNC_FDATASYNC:
+        ret = fdatasync(job->fd);
+        break;
+    case SYNC_RANGE:
+        ret = sync_file_range(job->fd, (off_t)job->offset, (off_t)len,
+                              SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+        break;
+    default:
+        /* O_DSYNC: the write returned once durable */
+        break;
+    }
+    if (ret != 0)
+    {
+        return errno;
+    }
+    job->offset += len;
+    return 0;
+}
+
+/* Private helper function: collect every committer's histograms without stopping them, log one interval */
+static void report_interval(WalJob *job, double t_s, double secs, uint64_t records, uint64_t syncs)
+{
+    LatencySummary summary[WAL_HIST_COUNT];
+
+    for (int h = 0; h < WAL_HIST_COUNT; h++)
+    {
+        hist_init(job->merged);
+        for (int i = 0; i < job->committer_count; i++)
+        {
+            hist_collect(&job->committers[i].live[h], &job->committers[i].seen[h], job->interval);
+            hist_merge(job->merged, job->interval);
+        }
+        hist_merge(&job->totals[h], job->merged);
+        hist_summarize(job->merged, &summary[h]);
+    }
+
+    double commits = secs > 0.0 ? (double)summary[WAL_COMMIT].count / secs : 0.0;
+    double mbps = commits * (double)job->record_size / 1048576.0;
+    double sync_rate = secs > 0.0 ? (double)syncs / secs : 0.0;
+    double batch = syncs > 0 ? (double)records / (double)syncs : 0.0;
+
+    logger_info("WAL: %5.0fs %8.0f commits/s %7.1f MB/s %7.0f syncs/s batch %5.2f | commit avg %8.1f us "
+                "p99 %8.1f us | sync avg %8.1f us p99 %8.1f us",
+                t_s, commits, mbps, sync_rate, batch, summary[WAL_COMMIT].mean / 1e3,
+                (double)summary[WAL_COMMIT].p99 / 1e3, summary[WAL_SYNC].mean / 1e3,
+                (double)summary[WAL_SYNC].p99 / 1e3);
+    logger_metric("storage_wal", "t_s=%.1f,commits_per_s=%.0f,mbps=%.2f,syncs_per_s=%.0f,batch_mean=%.2f,"
+                  "lat_mean_us=%.1f,lat_p50_us=%.1f,lat_p99_us=%.1f,lat_p999_us=%.1f,lat_max_us=%.1f,"
+                  "sync_p50_us=%.1f,sync_p99_us=%.1f",
+                  t_s, commits, mbps, sync_rate, batch, summary[WAL_COMMIT].mean / 1e3,
+                  (double)summary[WAL_COMMIT].p50 / 1e3, (double)summary[WAL_COMMIT].p99 / 1e3,
+                  (double)summary[WAL_COMMIT].p999 / 1e3, (double)summary[WAL_COMMIT].max / 1e3,
+                  (double)summary[WAL_SYNC].p50 / 1e3, (double)summary[WAL_SYNC].p99 / 1e3);
+}
+
+/* Private helper function: fold what the joined committers recorded after the last interval into the totals */
+static void collect_tail(WalJob *job)
+{
+    for (int h = 0; h < WAL_HIST_COUNT; h++)
+    {
+        for (int i = 0; i < job->committer_count; i++)
+        {
+            hist_collect(&job->committers[i].live[h], &job->committers[i].seen[h], job->interval);
+            hist_merge(&job->totals[h], job->interval);
+        }
+    }
+}
+
+/* Private helper function: close the log and free everything wal_test_run() allocated */
+static void release_job(WalJob *job)
+{
+    if (job->fd >= 0)
+    {
+        close(job->fd);
+    }
+    for (int i = 0; job->committers && i < job->committer_count; i++)
+    {
+        free(job->committers[i].live);
+        free(job->committers[i].seen);
+        mem_buffer_free(&job->committers[i].record);
+    }
+    mem_buffer_free(&job->slots);
+    mem_buffer_free(&job->batch);
+    free(job->committers);
+    free(job->interval);
+    free(job->merged);
+    free(job->totals);
+    pthread_mutex_destroy(&job->lock);
+    pthread_cond_destroy(&job->flushed);
+}
+
+/* Private helper function: sleep for a relative time */
+static void sleep_ns(uint64_t ns)
+{
+    struct timespec ts = {(time_t)(ns / 1000000000ULL), (long)(ns % 1000000000ULL)};
+    nanosleep(&ts, NULL);
+}